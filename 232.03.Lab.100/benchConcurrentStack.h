@@ -0,0 +1,119 @@
+/***********************************************************************
+ * Header:
+ *    BENCH CONCURRENT STACK
+ * Summary:
+ *    Benchmarks for concurrent_stack against a stack behind a mutex
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>      // for uint64_t
+#include <mutex>        // for std::mutex
+#include <thread>       // for std::thread
+#include <atomic>       // for std::atomic
+#include <vector>       // for std::vector, to hold the threads
+#include <string>       // for std::string
+#include "concurrent_stack.h"
+#include "stack.h"
+#include "../232.10.Lab.100/benchmark.h"
+
+/***************************************************
+ * LOCKED STACK
+ * custom::stack with a mutex around it: what the
+ * freelists and work pools use today
+ ***************************************************/
+template <class T>
+class LockedStack
+{
+public:
+   void push(const T & t)
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      s.push(t);
+   }
+   bool try_pop(T & t)
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (s.empty())
+         return false;
+      t = s.top();
+      s.pop();
+      return true;
+   }
+
+private:
+   std::mutex         mutex;
+   custom::stack<T>   s;
+};
+
+/***************************************************
+ * BENCH CONCURRENT STACK
+ ***************************************************/
+class BenchConcurrentStack : public Benchmark
+{
+public:
+   void run()
+   {
+      bench_throughput();
+   }
+
+   /***************************************
+    * THROUGHPUT
+    * 1 to 64 threads each push a value and pop one,
+    * over and over, 4M operations in all. The stack
+    * starts with 1000 values, so a pop rarely finds it
+    * empty. Every operation touches the same head, so
+    * this is the worst case for either.
+    ***************************************/
+   void bench_throughput()
+   {
+      header("ConcurrentStack", "4M push and try_pop, split over the threads, M ops/s");
+      for (int numThreads = 1; numThreads <= 64; numThreads *= 2)
+      {
+         std::string threads = std::to_string(numThreads) +
+            (numThreads == 1 ? " thread" : " threads");
+         row(threads + ", mutex",     throughput<LockedStack<uint64_t>>(numThreads),
+             "M ops/s");
+         row(threads + ", lock-free", throughput<custom::concurrent_stack<uint64_t>>(numThreads),
+             "M ops/s");
+      }
+   }
+
+private:
+   template <class Stack>
+   double throughput(int numThreads)
+   {
+      const size_t numOps = 4000000;
+      const size_t perThread = numOps / 2 / numThreads;
+      Stack s;
+      for (uint64_t i = 0; i < 1000; i++)
+         s.push(i);
+
+      std::atomic<bool> go(false);
+      std::atomic<uint64_t> total(0);
+      std::vector<std::thread> threads;
+      double ms = time([&]()
+      {
+         for (int t = 0; t < numThreads; t++)
+            threads.emplace_back([&]()
+            {
+               while (!go.load())
+                  std::this_thread::yield();
+               uint64_t sum = 0;
+               uint64_t value = 0;
+               for (size_t i = 0; i < perThread; i++)
+               {
+                  s.push(i);
+                  if (s.try_pop(value))
+                     sum += value;
+               }
+               total += sum;
+            });
+         go = true;
+         for (std::thread & thread : threads)
+            thread.join();
+      });
+      doNotOptimize(total.load());
+      return 2.0 * perThread * numThreads / ms / 1000.0;
+   }
+};
@@ -0,0 +1,159 @@
+/***********************************************************************
+ * Header:
+ *    BENCH FORK JOIN
+ * Summary:
+ *    Scaling benchmarks for the fork-join scheduler
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>      // for uint64_t
+#include <string>       // for std::string
+#include "fork_join.h"
+#include "../232.06.Lab.100/bnode.h"   // for BNode, and its serial copy()
+#include "../232.10.Lab.100/benchmark.h"
+
+/***************************************************
+ * BENCH FORK JOIN
+ ***************************************************/
+class BenchForkJoin : public Benchmark
+{
+public:
+   void run()
+   {
+      bench_fib();
+      bench_tree();
+   }
+
+   /***************************************
+    * FIB
+    * fib(36), spawning one branch of every call until
+    * n drops below 16: about 29K tasks, each about a
+    * microsecond of work. What it measures is the cost
+    * of a spawn, a sync, and a steal.
+    ***************************************/
+   void bench_fib()
+   {
+      header("ForkJoin", "fib(36), spawning above n = 16, ms");
+      uint64_t result = 0;
+      row("serial", time([&]() { result = fibSerial(36); }), "ms");
+      doNotOptimize(result);
+      for (unsigned numThreads : { 1u, 2u, 4u, 8u })
+      {
+         custom::fork_join_pool pool(numThreads);
+         row(threads(numThreads), time([&]() { result = fib(pool, 36); }), "ms");
+         doNotOptimize(result);
+      }
+   }
+
+   /***************************************
+    * TREE
+    * A complete binary tree of 4M BNodes. Sum it, and
+    * copy it, spawning the left subtree of every node
+    * in the top 12 levels: 4K tasks. A traversal is
+    * bound by memory rather than arithmetic, so it
+    * scales less well than fib.
+    ***************************************/
+   void bench_tree()
+   {
+      const int depth = 22;
+      BNode<uint64_t> * tree = build(depth, 1);
+
+      header("ForkJoin", "sum of a 4M-node BNode tree, ms");
+      uint64_t total = 0;
+      row("serial", time([&]() { total = sumSerial(tree); }), "ms");
+      doNotOptimize(total);
+      for (unsigned numThreads : { 1u, 2u, 4u, 8u })
+      {
+         custom::fork_join_pool pool(numThreads);
+         row(threads(numThreads), time([&]() { total = sum(pool, tree, 12); }), "ms");
+         doNotOptimize(total);
+      }
+
+      header("ForkJoin", "copy of a 4M-node BNode tree, ms");
+      BNode<uint64_t> * duplicate = nullptr;
+      row("serial, copy()", time([&]() { duplicate = copy(tree); }), "ms");
+      clear(duplicate);
+      for (unsigned numThreads : { 1u, 2u, 4u, 8u })
+      {
+         custom::fork_join_pool pool(numThreads);
+         row(threads(numThreads), time([&]() { duplicate = copyTree(pool, tree, 12); }), "ms");
+         clear(duplicate);
+      }
+
+      clear(tree);
+   }
+
+private:
+   static std::string threads(unsigned num)
+   {
+      return "fork_join, " + std::to_string(num) + (num == 1 ? " thread" : " threads");
+   }
+
+   static uint64_t fibSerial(int n)
+   {
+      return n < 2 ? n : fibSerial(n - 1) + fibSerial(n - 2);
+   }
+
+   static uint64_t fib(custom::fork_join_pool & pool, int n)
+   {
+      if (n < 16)
+         return fibSerial(n);
+      uint64_t left;
+      custom::task_group group(pool);
+      group.spawn([&]() { left = fib(pool, n - 1); });
+      uint64_t right = fib(pool, n - 2);
+      group.sync();
+      return left + right;
+   }
+
+   // a complete tree of the given depth, numbered as a heap is
+   static BNode<uint64_t> * build(int depth, uint64_t number)
+   {
+      if (depth == 0)
+         return nullptr;
+      BNode<uint64_t> * p = new BNode<uint64_t>(number);
+      p->pLeft  = build(depth - 1, 2 * number);
+      p->pRight = build(depth - 1, 2 * number + 1);
+      if (p->pLeft)
+         p->pLeft->pParent = p;
+      if (p->pRight)
+         p->pRight->pParent = p;
+      return p;
+   }
+
+   static uint64_t sumSerial(const BNode<uint64_t> * p)
+   {
+      return p == nullptr ? 0 : p->data + sumSerial(p->pLeft) + sumSerial(p->pRight);
+   }
+
+   static uint64_t sum(custom::fork_join_pool & pool, const BNode<uint64_t> * p, int levels)
+   {
+      if (p == nullptr || levels == 0)
+         return sumSerial(p);
+      uint64_t left;
+      custom::task_group group(pool);
+      group.spawn([&]() { left = sum(pool, p->pLeft, levels - 1); });
+      uint64_t right = sum(pool, p->pRight, levels - 1);
+      group.sync();
+      return p->data + left + right;
+   }
+
+   // copy() from bnode.h, with the left subtree spawned
+   static BNode<uint64_t> * copyTree(custom::fork_join_pool & pool,
+                                     const BNode<uint64_t> * pSrc, int levels)
+   {
+      if (pSrc == nullptr || levels == 0)
+         return copy(pSrc);
+      BNode<uint64_t> * pNew = new BNode<uint64_t>(pSrc->data);
+      custom::task_group group(pool);
+      group.spawn([&]() { pNew->pLeft = copyTree(pool, pSrc->pLeft, levels - 1); });
+      pNew->pRight = copyTree(pool, pSrc->pRight, levels - 1);
+      group.sync();
+      if (pNew->pLeft)
+         pNew->pLeft->pParent = pNew;
+      if (pNew->pRight)
+         pNew->pRight->pParent = pNew;
+      return pNew;
+   }
+};
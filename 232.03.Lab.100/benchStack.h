@@ -0,0 +1,265 @@
+/***********************************************************************
+ * Header:
+ *    BENCH STACK
+ * Summary:
+ *    Benchmarks for stack over each container it can adapt
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>      // for uint64_t
+#include <vector>       // for std::vector
+#include <deque>        // for std::deque, what std::stack adapts
+#include <memory>       // for std::allocator
+#include <random>       // for std::mt19937
+#include "stack.h"
+#include "chunked_list.h"                // for custom::chunked_list
+#include "vector.h"                     // for custom::vector and custom::small_vector
+#include "../232.10.Lab.100/deque.h"    // for custom::deque
+#include "../232.10.Lab.100/benchmark.h"
+
+/***************************************************
+ * COUNTING ALLOCATOR
+ * std::allocator that counts every allocate(), and the
+ * bytes still out, so a benchmark can say how often a
+ * container went to the heap and how much it holds
+ ***************************************************/
+template <class T>
+struct CountingAllocator : std::allocator<T>
+{
+   template <class U>
+   struct rebind { typedef CountingAllocator<U> other; };
+
+   CountingAllocator() = default;
+   template <class U>
+   CountingAllocator(const CountingAllocator<U> &) {}
+
+   T * allocate(size_t num)
+   {
+      numAllocations()++;
+      numBytes() += num * sizeof(T);
+      return std::allocator<T>::allocate(num);
+   }
+   void deallocate(T * p, size_t num)
+   {
+      numBytes() -= num * sizeof(T);
+      std::allocator<T>::deallocate(p, num);
+   }
+
+   static size_t & numAllocations()
+   {
+      static size_t num = 0;
+      return num;
+   }
+   static size_t & numBytes()
+   {
+      static size_t num = 0;
+      return num;
+   }
+};
+
+/***************************************************
+ * FRAME
+ * What a depth-first search keeps on its stack: the
+ * node, and which of its edges to follow next
+ ***************************************************/
+struct Frame
+{
+   Frame(uint64_t node) : node(node), edge(0) {}
+   uint64_t node;
+   uint64_t edge;
+};
+
+/***************************************************
+ * PINNED FRAME
+ * A frame that vector may not move with memcpy, as one
+ * holding a pointer into itself would be: vector has
+ * to copy it element by element on every growth
+ ***************************************************/
+struct PinnedFrame : Frame
+{
+   PinnedFrame(uint64_t node) : Frame(node) {}
+};
+
+template <>
+struct custom::is_trivially_relocatable<PinnedFrame> : std::false_type {};
+
+/***************************************************
+ * BENCH STACK
+ ***************************************************/
+class BenchStack : public Benchmark
+{
+public:
+   void run()
+   {
+      bench_deep();
+      bench_shallow();
+      bench_retention();
+      bench_depth();
+   }
+
+   /***************************************
+    * DEEP
+    * Push 10M values, then pop them all: the
+    * container grows to its full size once
+    ***************************************/
+   void bench_deep()
+   {
+      header("Stack", "push 10M 8-byte values, then pop them all");
+      deep<custom::vector<uint64_t>>            ("custom::vector");
+      deep<custom::deque<uint64_t>>             ("custom::deque");
+      deep<custom::small_vector<uint64_t, 32>>  ("custom::small_vector<32>");
+      deep<std::vector<uint64_t>>               ("std::vector");
+      deep<std::deque<uint64_t>>                ("std::deque");
+   }
+
+   /***************************************
+    * SHALLOW
+    * Push 16, pop 16, 5M times over, the way a
+    * depth-first search or an expression evaluator
+    * uses a stack. It empties every round, so the
+    * cost of emptying shows: a vector gives back its
+    * buffer then, and has to grow it again. A small
+    * vector never leaves its inline room.
+    ***************************************/
+   void bench_shallow()
+   {
+      header("Stack", "push 16 then pop 16, 5M times");
+      shallow<custom::vector<uint64_t>>            ("custom::vector");
+      shallow<custom::deque<uint64_t>>             ("custom::deque");
+      shallow<custom::small_vector<uint64_t, 32>>  ("custom::small_vector<32>");
+      shallow<std::vector<uint64_t>>               ("std::vector");
+      shallow<std::deque<uint64_t>>                ("std::deque");
+   }
+
+   /***************************************
+    * RETENTION
+    * 200K requests, each pushing a random 0 to 4000
+    * values and popping them all, as a parser or a
+    * graph search serving one request at a time does.
+    * Halfway through, one request goes 1M deep. Shows
+    * how often each retention policy goes back to the
+    * heap, and how much buffer it holds at the end.
+    ***************************************/
+   void bench_retention()
+   {
+      header("Stack", "200K requests of 0 to 4000 pushes, then pop to empty");
+      oscillate<custom::shrink_on_empty>      ("shrink_on_empty");
+      oscillate<custom::retain_always>        ("retain_always");
+      oscillate<custom::retain_watermark<64>> ("retain_watermark<64>");
+   }
+
+   /***************************************
+    * DEPTH
+    * A depth-first search 20M frames deep: 320MB of
+    * stack. A vector copies everything at each doubling,
+    * and holds the old buffer and the new one while it
+    * does. custom::vector remaps the pages of frames it
+    * may memcpy instead, but has to copy pinned ones.
+    * A chunked_list links one more 16KB block.
+    ***************************************/
+   void bench_depth()
+   {
+      header("Stack", "push of 20M 16-byte frames, peak RSS and each push timed");
+      depth<Frame, std::vector<Frame>>                 ("std::vector");
+      depth<PinnedFrame, custom::vector<PinnedFrame>>  ("custom::vector, pinned, copied");
+      depth<Frame, custom::vector<Frame>>              ("custom::vector, mremap");
+      depth<Frame, custom::chunked_list<Frame>>        ("custom::chunked_list");
+   }
+
+private:
+   template <class T, class Container>
+   void depth(const std::string & label)
+   {
+      const size_t num = 20000000;
+      long kb = peakKB([&]()
+      {
+         custom::stack<T, Container> s;
+         for (size_t i = 0; i < num; i++)
+            s.push(T(i));
+         doNotOptimize(s.top().node);
+      });
+      row(label, kb / 1024.0, "MB peak RSS");
+
+      custom::stack<T, Container> s;
+      histogram(num, [&](size_t i) { s.push(T(i)); });
+   }
+
+   template <class R>
+   void oscillate(const std::string & label)
+   {
+      typedef custom::vector<uint64_t, CountingAllocator<uint64_t>> Container;
+      const size_t requests = 200000;
+      std::mt19937 random(232);
+      std::uniform_int_distribution<size_t> depth(0, 4000);
+
+      custom::stack<uint64_t, Container, R> s;
+      CountingAllocator<uint64_t>::numAllocations() = 0;
+      CountingAllocator<uint64_t>::numBytes() = 0;
+      uint64_t sum = 0;
+      double ms = time([&]()
+      {
+         for (size_t r = 0; r < requests; r++)
+         {
+            size_t num = (r == requests / 2) ? 1000000 : depth(random);
+            for (size_t i = 0; i < num; i++)
+               s.push(i);
+            while (!s.empty())
+            {
+               sum += s.top();
+               s.pop();
+            }
+         }
+      });
+      doNotOptimize(sum);
+      row(label, ms, "ms");
+      row("   allocations per 1000 requests",
+          1000.0 * CountingAllocator<uint64_t>::numAllocations() / requests, "allocs");
+      row("   KB held at the end",
+          (long)(CountingAllocator<uint64_t>::numBytes() / 1024), "KB");
+   }
+
+   template <class Container>
+   void deep(const std::string & label)
+   {
+      const size_t num = 10000000;
+      uint64_t sum = 0;
+      double ms = time([&]()
+      {
+         custom::stack<uint64_t, Container> s;
+         for (size_t i = 0; i < num; i++)
+            s.push(i);
+         while (!s.empty())
+         {
+            sum += s.top();
+            s.pop();
+         }
+      });
+      doNotOptimize(sum);
+      row(label, 2.0 * num / ms / 1000.0, "M ops/s");
+   }
+
+   template <class Container>
+   void shallow(const std::string & label)
+   {
+      const size_t rounds = 5000000;
+      const size_t depth = 16;
+      uint64_t sum = 0;
+      double ms = time([&]()
+      {
+         custom::stack<uint64_t, Container> s;
+         for (size_t r = 0; r < rounds; r++)
+         {
+            for (size_t i = 0; i < depth; i++)
+               s.push(r + i);
+            for (size_t i = 0; i < depth; i++)
+            {
+               sum += s.top();
+               s.pop();
+            }
+         }
+      });
+      doNotOptimize(sum);
+      row(label, 2.0 * rounds * depth / ms / 1000.0, "M ops/s");
+   }
+};
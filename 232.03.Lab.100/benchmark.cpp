@@ -0,0 +1,25 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Driver to measure the performance of stack.h over each
+ *    container it can adapt, of concurrent_stack.h, and of fork_join.h.
+ *    Build with optimizations on; timings from a debug build mean little.
+ ************************************************************************/
+
+#include "benchStack.h"        // for the stack benchmarks
+#include "benchConcurrentStack.h" // for the concurrent stack benchmarks
+#include "benchForkJoin.h"     // for the fork-join scheduler benchmarks
+
+/**********************************************************************
+ * MAIN
+ * Run each of the benchmarks in turn
+ ***********************************************************************/
+int main()
+{
+   BenchStack().run();
+   BenchConcurrentStack().run();
+   BenchForkJoin().run();
+
+   return 0;
+}
@@ -0,0 +1,313 @@
+/***********************************************************************
+ * Header:
+ *    CHUNKED LIST
+ * Summary:
+ *    A container for the back of a stack: a linked list of fixed-size
+ *    blocks. Growing it links one more block; nothing already in it is
+ *    ever moved, so a push costs the same whether it is the first or
+ *    the fifty-millionth, and the stack never needs its old and new
+ *    buffers at once.
+ *
+ *    This will contain the class definition of:
+ *        chunked_list           : The blocks, the newest on top
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>      // because I am paranoid
+#include <cstddef>      // for size_t
+#include <new>          // for placement new
+#include <utility>      // for std::move, std::forward, and std::swap
+
+class TestChunkedList; // forward declaration for unit tests
+class TestStack;       // and for the stack tests
+
+namespace custom
+{
+
+/**************************************************
+ * CHUNKED LIST
+ * Blocks of N elements, each pointing at the one
+ * below it. Only the top block is ever partly full.
+ *
+ *    top -> [ g h . . ] -> [ c d e f ] -> [ a b c d ]
+ *
+ * A block popped empty is kept as a spare rather than
+ * freed, so a stack that bobs up and down across a
+ * block boundary does not allocate and free a block
+ * each time it crosses. One spare, no more: a stack
+ * that shrinks a long way gives the rest back as it
+ * goes.
+ *
+ * N defaults to a block of about 16KB.
+ *************************************************/
+template <class T, size_t N = (16384 / sizeof(T) > 4 ? 16384 / sizeof(T) : 4)>
+class chunked_list
+{
+   friend class ::TestChunkedList; // give unit tests access to the privates
+   friend class ::TestStack;       // and the stack tests, to see its blocks
+   static_assert(N > 0, "a block holds at least one element");
+
+   struct Block
+   {
+      T * slots() { return reinterpret_cast<T *>(bytes); }
+
+      Block * below;
+      alignas(T) unsigned char bytes[N * sizeof(T)];
+   };
+
+public:
+   typedef T value_type;
+
+   //
+   // Construct
+   //
+
+   chunked_list() : top(nullptr), spare(nullptr), numTop(0), numElements(0) {}
+   chunked_list(const chunked_list & rhs);
+   chunked_list(chunked_list && rhs) noexcept;
+   ~chunked_list();
+
+   //
+   // Assign
+   //
+
+   chunked_list & operator = (const chunked_list & rhs);
+   chunked_list & operator = (chunked_list && rhs) noexcept;
+   void swap(chunked_list & rhs) noexcept
+   {
+      std::swap(top,         rhs.top);
+      std::swap(spare,       rhs.spare);
+      std::swap(numTop,      rhs.numTop);
+      std::swap(numElements, rhs.numElements);
+   }
+
+   //
+   // Access
+   //
+
+   T & back()
+   {
+      assert(!empty());
+      return top->slots()[numTop - 1];
+   }
+   const T & back() const
+   {
+      assert(!empty());
+      return top->slots()[numTop - 1];
+   }
+
+   //
+   // Insert
+   //
+
+   void push_back(const T & t) { emplace_back(t);            }
+   void push_back(T && t)      { emplace_back(std::move(t)); }
+   template <class ... Args>
+   void emplace_back(Args && ... args);
+
+   //
+   // Remove
+   //
+
+   void pop_back();
+   void clear();
+
+   // free the spare block
+   void shrink_to_fit()
+   {
+      delete spare;
+      spare = nullptr;
+   }
+
+   //
+   // Status
+   //
+
+   size_t size()  const { return numElements;      }
+   bool   empty() const { return numElements == 0; }
+
+   // how many elements fit in one block
+   static constexpr size_t blockSize() { return N; }
+
+private:
+   Block * takeBlock()
+   {
+      if (spare == nullptr)
+         return new Block;
+      Block * b = spare;
+      spare = nullptr;
+      return b;
+   }
+   void giveBlock(Block * b)
+   {
+      if (spare == nullptr)
+         spare = b;
+      else
+         delete b;
+   }
+
+   Block * top;           // the newest block, the only one partly full
+   Block * spare;         // an empty block, kept for the next push past a boundary
+   size_t  numTop;        // how many elements are in the top block
+   size_t  numElements;   // how many in all
+};
+
+/*****************************************
+ * CHUNKED LIST :: COPY CONSTRUCTOR
+ * Push each element in turn, bottom first
+ ****************************************/
+template <class T, size_t N>
+chunked_list <T, N> :: chunked_list(const chunked_list & rhs) : chunked_list()
+{
+   // the blocks are linked top down, so collect them bottom up first
+   size_t numBlocks = (rhs.numElements + N - 1) / N;
+   const Block ** blocks = new const Block * [numBlocks];
+   size_t i = numBlocks;
+   for (const Block * b = rhs.top; b != nullptr; b = b->below)
+      blocks[--i] = b;
+
+   try
+   {
+      for (i = 0; i < numBlocks; i++)
+      {
+         size_t num = (i + 1 == numBlocks) ? rhs.numTop : N;
+         const T * slots = reinterpret_cast<const T *>(blocks[i]->bytes);
+         for (size_t j = 0; j < num; j++)
+            push_back(slots[j]);
+      }
+   }
+   catch (...)
+   {
+      delete [] blocks;
+      clear();
+      shrink_to_fit();
+      throw;
+   }
+   delete [] blocks;
+}
+
+/*****************************************
+ * CHUNKED LIST :: MOVE CONSTRUCTOR
+ * Take the blocks, the spare too
+ ****************************************/
+template <class T, size_t N>
+chunked_list <T, N> :: chunked_list(chunked_list && rhs) noexcept : chunked_list()
+{
+   swap(rhs);
+}
+
+/*****************************************
+ * CHUNKED LIST :: DESTRUCTOR
+ ****************************************/
+template <class T, size_t N>
+chunked_list <T, N> :: ~chunked_list()
+{
+   clear();
+   shrink_to_fit();
+}
+
+/*****************************************
+ * CHUNKED LIST :: ASSIGN
+ * Copy into a new list, then trade with it
+ ****************************************/
+template <class T, size_t N>
+chunked_list <T, N> & chunked_list <T, N> :: operator = (const chunked_list & rhs)
+{
+   if (this != &rhs)
+   {
+      chunked_list copy(rhs);
+      swap(copy);
+   }
+   return *this;
+}
+
+template <class T, size_t N>
+chunked_list <T, N> & chunked_list <T, N> :: operator = (chunked_list && rhs) noexcept
+{
+   if (this != &rhs)
+   {
+      clear();
+      shrink_to_fit();
+      swap(rhs);
+   }
+   return *this;
+}
+
+/*****************************************
+ * CHUNKED LIST :: EMPLACE BACK
+ * Into the top block if it has room, else into a
+ * new one, which is linked in only once the element
+ * is built. If building it throws, nothing changed.
+ ****************************************/
+template <class T, size_t N>
+template <class ... Args>
+void chunked_list <T, N> :: emplace_back(Args && ... args)
+{
+   if (top != nullptr && numTop < N)
+   {
+      new (top->slots() + numTop) T(std::forward<Args>(args)...);
+      numTop++;
+   }
+   else
+   {
+      Block * b = takeBlock();
+      try
+      {
+         new (b->slots()) T(std::forward<Args>(args)...);
+      }
+      catch (...)
+      {
+         giveBlock(b);
+         throw;
+      }
+      b->below = top;
+      top = b;
+      numTop = 1;
+   }
+   numElements++;
+}
+
+/*****************************************
+ * CHUNKED LIST :: POP BACK
+ * A block emptied becomes the spare, and the full
+ * one below it the top
+ ****************************************/
+template <class T, size_t N>
+void chunked_list <T, N> :: pop_back()
+{
+   assert(!empty());
+   top->slots()[--numTop].~T();
+   numElements--;
+   if (numTop == 0)
+   {
+      Block * b = top;
+      top = b->below;
+      numTop = (top == nullptr) ? 0 : N;
+      giveBlock(b);
+   }
+}
+
+/*****************************************
+ * CHUNKED LIST :: CLEAR
+ * Destroy every element and free every block but
+ * the spare
+ ****************************************/
+template <class T, size_t N>
+void chunked_list <T, N> :: clear()
+{
+   while (top != nullptr)
+   {
+      T * slots = top->slots();
+      for (size_t i = 0; i < numTop; i++)
+         slots[i].~T();
+      Block * below = top->below;
+      giveBlock(top);
+      top = below;
+      numTop = N;
+   }
+   numTop = 0;
+   numElements = 0;
+}
+
+} // namespace custom
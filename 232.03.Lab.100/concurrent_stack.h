@@ -0,0 +1,242 @@
+/***********************************************************************
+ * Module:
+ *    Concurrent Stack
+ * Summary:
+ *    A stack any number of threads can push onto and pop from at
+ *    once, without a lock
+ *
+ *    This will contain the class definition of:
+ *       concurrent_stack  : a lock-free (Treiber) stack
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>       // for std::atomic
+#include <cstdint>      // for uint64_t and uintptr_t
+#include <cstddef>      // for size_t
+#include <utility>      // for std::move
+#include "vector.h"          // for custom::vector, what pop_all() returns
+#include "hazard_pointer.h"  // for hazard_domain
+
+class TestConcurrentStack; // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * CONCURRENT STACK
+ * A singly-linked list whose head is swapped in with
+ * compare-and-swap. Two things make that safe:
+ *
+ *    ABA    The head is a tagged pointer: the node's
+ *           address, with a count of changes to the
+ *           head in the bits the address does not use.
+ *           A pop that read the head, stalled while
+ *           that node was popped and another pushed at
+ *           the same address, fails its compare-and-swap
+ *           because the count has moved on.
+ *    reuse  A pop reads head->next before it knows it
+ *           has won. Popped nodes are retired through
+ *           hazard pointers, so one is not deleted while
+ *           another thread might still read it.
+ *************************************************/
+template <class T>
+class concurrent_stack
+{
+   friend class ::TestConcurrentStack; // give unit tests access to the privates
+
+   struct Node
+   {
+      template <class U>
+      Node(U && value) : value(std::forward<U>(value)), next(nullptr) {}
+      T      value;
+      Node * next;
+   };
+
+public:
+   typedef T value_type;
+
+   concurrent_stack() : head(0) {}
+   concurrent_stack(const concurrent_stack &) = delete;
+   concurrent_stack & operator = (const concurrent_stack &) = delete;
+   ~concurrent_stack();
+
+   //
+   // Insert
+   //
+
+   void push(const T & t) { pushNode(new Node(t));            }
+   void push(T && t)      { pushNode(new Node(std::move(t))); }
+
+   //
+   // Remove
+   //
+
+   // take the top into t, or return false if there is none
+   bool try_pop(T & t);
+
+   // take everything at once, the top first
+   custom::vector<T> pop_all();
+
+   //
+   // Status
+   //
+
+   // true when nothing was on the stack a moment ago
+   bool empty() const { return pointerOf(head.load()) == nullptr; }
+
+private:
+   // the head packs a pointer and a tag into 64 bits. A 64-bit
+   // address uses only its low 48 bits, a 32-bit one all 32.
+   static constexpr int      pointerBits = sizeof(void *) == 8 ? 48 : 32;
+   static constexpr uint64_t pointerMask = (uint64_t(1) << pointerBits) - 1;
+
+   static Node * pointerOf(uint64_t head)
+   {
+      return reinterpret_cast<Node *>(static_cast<uintptr_t>(head & pointerMask));
+   }
+   static uint64_t retag(uint64_t head, Node * node)
+   {
+      uint64_t tag = (head >> pointerBits) + 1;
+      return (tag << pointerBits) | (reinterpret_cast<uintptr_t>(node) & pointerMask);
+   }
+
+   void pushNode(Node * node);
+
+   std::atomic<uint64_t> head;
+};
+
+/*****************************************
+ * CONCURRENT STACK :: DESTRUCTOR
+ * No other thread can be using the stack now,
+ * so what is left can be deleted outright
+ ****************************************/
+template <class T>
+concurrent_stack <T> :: ~concurrent_stack()
+{
+   Node * node = pointerOf(head.load(std::memory_order_acquire));
+   while (node != nullptr)
+   {
+      Node * next = node->next;
+      delete node;
+      node = next;
+   }
+}
+
+/*****************************************
+ * CONCURRENT STACK :: PUSH NODE
+ * Point the node at the head, then swing the head
+ * to the node, trying again if it moved meanwhile.
+ * A push never reads through the head, so it needs
+ * no hazard.
+ ****************************************/
+template <class T>
+void concurrent_stack <T> :: pushNode(Node * node)
+{
+   uint64_t top = head.load(std::memory_order_relaxed);
+   do
+      node->next = pointerOf(top);
+   while (!head.compare_exchange_weak(top, retag(top, node),
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed));
+}
+
+/*****************************************
+ * CONCURRENT STACK :: TRY POP
+ * Publish the top as hazardous, and check it is still
+ * the top, before reading its next. Whoever wins the
+ * swap owns the node: it moves the value out and
+ * retires the node. If the move throws, the node is
+ * retired all the same.
+ ****************************************/
+template <class T>
+bool concurrent_stack <T> :: try_pop(T & t)
+{
+   hazard_domain & domain = hazard_domain::shared();
+   std::atomic<const void *> & hazard = domain.hazard();
+
+   Node * node;
+   uint64_t top = head.load();
+   for (;;)
+   {
+      node = pointerOf(top);
+      if (node == nullptr)
+      {
+         hazard.store(nullptr, std::memory_order_release);
+         return false;
+      }
+
+      hazard.store(node);
+      uint64_t again = head.load();
+      if (again != top)
+      {
+         top = again;
+         continue;
+      }
+
+      if (head.compare_exchange_weak(top, retag(top, node->next)))
+         break;
+   }
+   hazard.store(nullptr, std::memory_order_release);
+
+   try
+   {
+      t = std::move(node->value);
+   }
+   catch (...)
+   {
+      domain.retire(node);
+      throw;
+   }
+   domain.retire(node);
+   return true;
+}
+
+/*****************************************
+ * CONCURRENT STACK :: POP ALL
+ * One swap detaches the whole list. Other threads
+ * may still be reading nodes in it, so each is
+ * retired rather than deleted. The room for the
+ * values is reserved up front; should that or a
+ * move throw, the nodes not yet retired still are.
+ ****************************************/
+template <class T>
+custom::vector<T> concurrent_stack <T> :: pop_all()
+{
+   custom::vector<T> values;
+   uint64_t top = head.load();
+   while (pointerOf(top) != nullptr &&
+          !head.compare_exchange_weak(top, retag(top, nullptr)))
+      ;
+
+   hazard_domain & domain = hazard_domain::shared();
+   Node * node = pointerOf(top);
+   try
+   {
+      size_t num = 0;
+      for (Node * p = node; p != nullptr; p = p->next)
+         num++;
+      values.reserve(num);
+
+      while (node != nullptr)
+      {
+         values.push_back(std::move(node->value));
+         Node * next = node->next;
+         domain.retire(node);
+         node = next;
+      }
+   }
+   catch (...)
+   {
+      while (node != nullptr)
+      {
+         Node * next = node->next;
+         domain.retire(node);
+         node = next;
+      }
+      throw;
+   }
+   return values;
+}
+
+} // namespace custom
@@ -0,0 +1,427 @@
+/***********************************************************************
+ * Header:
+ *    FORK JOIN
+ * Summary:
+ *    A work-stealing scheduler for recursive, divide-and-conquer work:
+ *    copying a tree, sorting, summing a range. A task spawns its
+ *    halves and syncs on them. Each worker keeps the tasks it spawns
+ *    on its own work_stealing_deque and works on the newest, while
+ *    idle workers steal the oldest, so threads share one lock-free
+ *    deque each instead of one locked stack between them.
+ *
+ *    Nothing here depends on a particular container, so any
+ *    container's parallel algorithms can include this header.
+ *
+ *    This will contain the class definition of:
+ *        fork_join_pool         : The workers and their deques
+ *        task_group             : spawn() and sync()
+ *        parallel_for           : Split a range into tasks
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>            // because I am paranoid
+#include <thread>             // for std::thread
+#include <mutex>              // for std::mutex
+#include <condition_variable> // for std::condition_variable
+#include <atomic>             // for std::atomic
+#include <chrono>             // for std::chrono::milliseconds
+#include <exception>          // for std::exception_ptr
+#include <memory>             // for std::unique_ptr
+#include <utility>            // for std::forward
+#include <type_traits>        // for std::decay
+#include <vector>             // for std::vector, to hold the workers
+#include <cstddef>            // for size_t
+#include "work_stealing_deque.h"
+
+class TestForkJoin; // forward declaration for unit tests
+
+namespace custom
+{
+
+class task_group;
+
+namespace detail
+{
+
+/*****************************************
+ * TASK
+ * One spawned function, and the group waiting on it
+ ****************************************/
+struct task
+{
+   task(task_group & group) : group(group) {}
+   virtual ~task() {}
+   virtual void execute() = 0;
+
+   task_group & group;
+};
+
+template <class F>
+struct task_of : task
+{
+   task_of(task_group & group, F && f) : task(group), f(std::forward<F>(f)) {}
+   void execute() override { f(); }
+
+   typename std::decay<F>::type f;
+};
+
+} // namespace detail
+
+/*****************************************
+ * FORK JOIN POOL
+ * numThreads - 1 worker threads, each with a deque.
+ * One more deque, the master's, belongs to whichever
+ * outside thread is running a task_group on the pool:
+ * one at a time, as with thread_pool's jobs. The
+ * master works too, so a pool of 1 has no workers
+ * and runs every task on the caller.
+ *
+ * An idle worker steals from a random deque, and after
+ * a while sleeps until a spawn wakes it. A spawn only
+ * touches the sleepers' lock when someone is asleep.
+ ****************************************/
+class fork_join_pool
+{
+   friend class ::TestForkJoin; // give unit tests access to the privates
+   friend class task_group;
+public:
+   explicit fork_join_pool(unsigned numThreads = defaultThreads());
+   fork_join_pool(const fork_join_pool &) = delete;
+   fork_join_pool & operator = (const fork_join_pool &) = delete;
+   ~fork_join_pool();
+
+   // the pool everyone shares, one thread per core
+   static fork_join_pool & shared()
+   {
+      static fork_join_pool pool;
+      return pool;
+   }
+
+   static unsigned defaultThreads()
+   {
+      unsigned num = std::thread::hardware_concurrency();
+      return (num == 0) ? 1 : num;
+   }
+
+   // the workers and the master
+   unsigned size() const { return (unsigned)deques.size(); }
+
+private:
+   struct alignas(64) Worker
+   {
+      Worker(fork_join_pool & pool, unsigned index) :
+         pool(pool), index(index), seed(index * 2654435761u + 1) {}
+
+      fork_join_pool &                     pool;
+      unsigned                             index;  // 0 is the master
+      unsigned                             seed;   // picks whom to steal from
+      work_stealing_deque<detail::task *>  deque;
+   };
+
+   // the calling thread's Worker, if it is one of ours
+   static Worker * & current()
+   {
+      thread_local Worker * worker = nullptr;
+      return worker;
+   }
+
+   void push(detail::task * t);
+   detail::task * find(Worker & me);
+   static void execute(detail::task * t);
+   void workerLoop(Worker & me);
+
+   std::vector<std::unique_ptr<Worker>> deques;      // [0] is the master's
+   std::vector<std::thread>             threads;
+   std::mutex                           masterMutex; // one outside thread at a time
+   std::mutex                           sleepMutex;  // guards the sleepers
+   std::condition_variable              wake;        // a task was spawned, or we are stopping
+   std::atomic<unsigned>                numSleeping;
+   std::atomic<bool>                    stopping;
+};
+
+/*****************************************
+ * TASK GROUP
+ * spawn(f) hands f to the pool; sync() waits for
+ * every f spawned on this group, running tasks
+ * itself rather than blocking. The first exception
+ * a task throws is rethrown by sync(). A group
+ * syncs when it goes out of scope.
+ ****************************************/
+class task_group
+{
+   friend class ::TestForkJoin; // give unit tests access to the privates
+   friend class fork_join_pool;
+public:
+   explicit task_group(fork_join_pool & pool = fork_join_pool::shared());
+   task_group(const task_group &) = delete;
+   task_group & operator = (const task_group &) = delete;
+   ~task_group();
+
+   template <class F>
+   void spawn(F && f)
+   {
+      pending.fetch_add(1, std::memory_order_relaxed);
+      pool.push(new detail::task_of<F>(*this, std::forward<F>(f)));
+   }
+
+   void sync();
+
+private:
+   void wait();
+   void finished(std::exception_ptr thrown);
+
+   fork_join_pool &              pool;
+   fork_join_pool::Worker *      previous;  // the thread's Worker before this group
+   bool                          master;    // did this group take the master deque?
+   std::atomic<size_t>           pending;   // spawned and not yet finished
+   std::atomic<bool>             failed;
+   std::exception_ptr            error;     // the first task to throw
+};
+
+/*****************************************
+ * FORK JOIN POOL :: CONSTRUCTOR
+ ****************************************/
+inline fork_join_pool :: fork_join_pool(unsigned numThreads) : numSleeping(0), stopping(false)
+{
+   if (numThreads == 0)
+      numThreads = 1;
+   for (unsigned i = 0; i < numThreads; i++)
+      deques.emplace_back(new Worker(*this, i));
+   for (unsigned i = 1; i < numThreads; i++)
+      threads.emplace_back([this, i]() { workerLoop(*deques[i]); });
+}
+
+/*****************************************
+ * FORK JOIN POOL :: DESTRUCTOR
+ * Every task_group has synced, so the deques are empty
+ ****************************************/
+inline fork_join_pool :: ~fork_join_pool()
+{
+   {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      stopping = true;
+   }
+   wake.notify_all();
+   for (std::thread & thread : threads)
+      thread.join();
+}
+
+/*****************************************
+ * FORK JOIN POOL :: PUSH
+ * Onto the calling worker's own deque, then wake a
+ * sleeper if there is one to take it. The caller is
+ * a worker, or the outside thread holding the master
+ * deque: spawn from inside a task or a task_group.
+ ****************************************/
+inline void fork_join_pool :: push(detail::task * t)
+{
+   assert(current() != nullptr && &current()->pool == this);
+   current()->deque.push(t);
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+   if (numSleeping.load(std::memory_order_relaxed) != 0)
+   {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      wake.notify_one();
+   }
+}
+
+/*****************************************
+ * FORK JOIN POOL :: FIND
+ * The newest task of our own, else the oldest of
+ * someone else's, trying each deque once from a
+ * random start
+ ****************************************/
+inline detail::task * fork_join_pool :: find(Worker & me)
+{
+   detail::task * t;
+   if (me.deque.pop(t))
+      return t;
+
+   unsigned num = size();
+   me.seed = me.seed * 1103515245u + 12345u;
+   unsigned start = (me.seed >> 16) % num;
+   for (unsigned i = 0; i < num; i++)
+   {
+      unsigned victim = (start + i) % num;
+      if (victim != me.index && deques[victim]->deque.steal(t))
+         return t;
+   }
+   return nullptr;
+}
+
+/*****************************************
+ * FORK JOIN POOL :: EXECUTE
+ * Run a task, and tell its group. The group may be
+ * gone the moment it hears, so the task is freed
+ * first.
+ ****************************************/
+inline void fork_join_pool :: execute(detail::task * t)
+{
+   std::exception_ptr thrown;
+   try
+   {
+      t->execute();
+   }
+   catch (...)
+   {
+      thrown = std::current_exception();
+   }
+   task_group & group = t->group;
+   delete t;
+   group.finished(thrown);
+}
+
+/*****************************************
+ * FORK JOIN POOL :: WORKER LOOP
+ * Run tasks until the pool stops. Having found
+ * nothing many times over, sleep until a spawn, or
+ * for a millisecond in case its wake-up was missed.
+ ****************************************/
+inline void fork_join_pool :: workerLoop(Worker & me)
+{
+   current() = &me;
+   unsigned idle = 0;
+   while (!stopping.load(std::memory_order_relaxed))
+   {
+      detail::task * t = find(me);
+      if (t != nullptr)
+      {
+         execute(t);
+         idle = 0;
+         continue;
+      }
+      if (++idle < 64)
+      {
+         std::this_thread::yield();
+         continue;
+      }
+
+      std::unique_lock<std::mutex> lock(sleepMutex);
+      numSleeping++;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      bool any = false;
+      for (unsigned i = 0; i < size() && !any; i++)
+         any = !deques[i]->deque.empty();
+      if (!any && !stopping)
+         wake.wait_for(lock, std::chrono::milliseconds(1));
+      numSleeping--;
+      idle = 0;
+   }
+   current() = nullptr;
+}
+
+/*****************************************
+ * TASK GROUP :: CONSTRUCTOR
+ * A thread that is not one of the pool's takes the
+ * master deque, waiting if another outside thread has
+ * it. Groups nested inside that one find it theirs.
+ ****************************************/
+inline task_group :: task_group(fork_join_pool & pool) :
+   pool(pool), previous(fork_join_pool::current()), master(false),
+   pending(0), failed(false)
+{
+   if (previous == nullptr || &previous->pool != &pool)
+   {
+      pool.masterMutex.lock();
+      fork_join_pool::current() = pool.deques[0].get();
+      master = true;
+   }
+}
+
+/*****************************************
+ * TASK GROUP :: DESTRUCTOR
+ * Wait for what is left, and give back the master
+ * deque if we took it. An exception nobody synced
+ * for is dropped: a destructor cannot throw it.
+ ****************************************/
+inline task_group :: ~task_group()
+{
+   wait();
+   if (master)
+   {
+      fork_join_pool::current() = previous;
+      pool.masterMutex.unlock();
+   }
+}
+
+/*****************************************
+ * TASK GROUP :: SYNC
+ ****************************************/
+inline void task_group :: sync()
+{
+   wait();
+   if (error)
+   {
+      std::exception_ptr thrown = error;
+      error = nullptr;
+      failed = false;
+      std::rethrow_exception(thrown);
+   }
+}
+
+/*****************************************
+ * TASK GROUP :: WAIT
+ * Run tasks, ours or anyone's, until ours are done
+ ****************************************/
+inline void task_group :: wait()
+{
+   fork_join_pool::Worker & me = *fork_join_pool::current();
+   while (pending.load(std::memory_order_acquire) != 0)
+   {
+      detail::task * t = pool.find(me);
+      if (t != nullptr)
+         fork_join_pool::execute(t);
+      else
+         std::this_thread::yield();
+   }
+}
+
+/*****************************************
+ * TASK GROUP :: FINISHED
+ * One task is done. Keep the first exception.
+ ****************************************/
+inline void task_group :: finished(std::exception_ptr thrown)
+{
+   if (thrown && !failed.exchange(true))
+      error = thrown;
+   pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+/*****************************************
+ * PARALLEL FOR
+ * Call f(i) for every i in [begin, end), splitting
+ * the range in half, and half again, until a piece
+ * is no bigger than grain. A grain of 0 picks one
+ * that gives each thread about 8 pieces.
+ ****************************************/
+template <class Function>
+void parallel_for(size_t begin, size_t end, size_t grain, Function f,
+                  fork_join_pool & pool = fork_join_pool::shared())
+{
+   if (begin >= end)
+      return;
+   if (grain == 0)
+      grain = (end - begin) / (8 * pool.size()) + 1;
+
+   struct Split
+   {
+      static void run(size_t begin, size_t end, size_t grain, Function & f,
+                      fork_join_pool & pool)
+      {
+         task_group group(pool);
+         while (end - begin > grain)
+         {
+            size_t middle = begin + (end - begin) / 2;
+            group.spawn([=, &f, &pool]() { run(middle, end, grain, f, pool); });
+            end = middle;
+         }
+         for (size_t i = begin; i < end; i++)
+            f(i);
+         group.sync();
+      }
+   };
+   Split::run(begin, end, grain, f, pool);
+}
+
+} // namespace custom
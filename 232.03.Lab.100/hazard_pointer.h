@@ -0,0 +1,194 @@
+/***********************************************************************
+ * Header:
+ *    HAZARD POINTER
+ * Summary:
+ *    Safe memory reclamation for lock-free containers. A thread about
+ *    to read a node another thread may unlink and delete first
+ *    publishes the node's address in its hazard slot. Unlinked nodes
+ *    are retired rather than deleted, and a retired node is deleted
+ *    only once no slot holds its address.
+ *
+ *    This will contain the class definition of:
+ *        hazard_domain          : The slots, and the nodes waiting on them
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>       // for std::atomic
+#include <mutex>        // for std::mutex, guarding the orphans
+#include <vector>       // for std::vector, to hold the retired nodes
+#include <algorithm>    // for std::sort and std::binary_search
+#include <stdexcept>    // for std::runtime_error
+#include <cstddef>      // for size_t
+
+class TestConcurrentStack; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * HAZARD DOMAIN
+ * One slot per thread, claimed the first time the
+ * thread asks for it and given back when it exits.
+ * Each thread keeps its own list of retired nodes and
+ * only looks at the slots once that list is long,
+ * so a scan's cost is spread over many retirements.
+ * A thread that exits with nodes still hazardous
+ * leaves them as orphans for the next scan to adopt.
+ ****************************************/
+class hazard_domain
+{
+   friend class ::TestConcurrentStack; // give unit tests access to the privates
+public:
+   static const size_t maxThreads = 256;
+
+   // the domain every lock-free container shares
+   static hazard_domain & shared()
+   {
+      static hazard_domain domain;
+      return domain;
+   }
+
+   ~hazard_domain()
+   {
+      for (const Retired & node : orphans)
+         node.destroy(node.p);
+   }
+
+   // the calling thread's slot: store a pointer in it before
+   // reading through it, and nullptr once done
+   std::atomic<const void *> & hazard() { return record().slot->pointer; }
+
+   // delete p once no thread's slot holds it
+   template <class T>
+   void retire(T * p)
+   {
+      Record & mine = record();
+      mine.retired.push_back({ p, [](void * p) { delete static_cast<T *>(p); } });
+      if (mine.retired.size() >= scanThreshold())
+         scan(mine.retired);
+   }
+
+private:
+   hazard_domain() : numSlots(0), numOrphans(0) {}
+   hazard_domain(const hazard_domain &) = delete;
+   hazard_domain & operator = (const hazard_domain &) = delete;
+
+   struct alignas(64) Slot           // one per cache line: they are written often
+   {
+      std::atomic<const void *> pointer { nullptr };
+      std::atomic<bool>         owned   { false };
+   };
+
+   struct Retired
+   {
+      void * p;
+      void (* destroy)(void *);
+   };
+
+   // what one thread holds: its slot and what it has retired
+   struct Record
+   {
+      Record(hazard_domain & domain) : domain(domain), slot(domain.claim()) {}
+      ~Record();
+
+      hazard_domain &      domain;
+      Slot *               slot;
+      std::vector<Retired> retired;
+   };
+
+   Record & record()
+   {
+      thread_local Record mine(*this);
+      return mine;
+   }
+
+   // twice the slots in use: at least half of each scan is freed
+   size_t scanThreshold() const { return 2 * numSlots.load(std::memory_order_relaxed) + 16; }
+
+   Slot * claim();
+   void scan(std::vector<Retired> & retired);
+
+   Slot                 slots[maxThreads];
+   std::atomic<size_t>  numSlots;      // slots [0, numSlots) have ever been claimed
+   std::mutex           orphanMutex;   // guards orphans
+   std::vector<Retired> orphans;       // retired by threads that have exited
+   std::atomic<size_t>  numOrphans;    // orphans.size(), read without the lock
+};
+
+/*****************************************
+ * HAZARD DOMAIN :: CLAIM
+ * Find a slot no running thread owns
+ ****************************************/
+inline hazard_domain::Slot * hazard_domain :: claim()
+{
+   for (size_t i = 0; i < maxThreads; i++)
+   {
+      bool owned = false;
+      if (!slots[i].owned.load(std::memory_order_relaxed) &&
+          slots[i].owned.compare_exchange_strong(owned, true))
+      {
+         size_t num = numSlots.load();
+         while (num < i + 1 && !numSlots.compare_exchange_weak(num, i + 1))
+            ;
+         return slots + i;
+      }
+   }
+   throw std::runtime_error("ERROR: more threads than hazard_domain::maxThreads");
+}
+
+/*****************************************
+ * HAZARD DOMAIN :: SCAN
+ * Delete every retired node no slot holds, keeping
+ * the rest for next time. Adopts any orphans first.
+ ****************************************/
+inline void hazard_domain :: scan(std::vector<Retired> & retired)
+{
+   if (numOrphans.load(std::memory_order_relaxed) != 0 && orphanMutex.try_lock())
+   {
+      retired.insert(retired.end(), orphans.begin(), orphans.end());
+      orphans.clear();
+      numOrphans.store(0, std::memory_order_relaxed);
+      orphanMutex.unlock();
+   }
+
+   // every address some thread is about to read through
+   std::vector<const void *> hazards;
+   size_t num = numSlots.load();
+   hazards.reserve(num);
+   for (size_t i = 0; i < num; i++)
+   {
+      const void * p = slots[i].pointer.load();
+      if (p != nullptr)
+         hazards.push_back(p);
+   }
+   std::sort(hazards.begin(), hazards.end());
+
+   size_t kept = 0;
+   for (size_t i = 0; i < retired.size(); i++)
+      if (std::binary_search(hazards.begin(), hazards.end(), (const void *)retired[i].p))
+         retired[kept++] = retired[i];
+      else
+         retired[i].destroy(retired[i].p);
+   retired.resize(kept);
+}
+
+/*****************************************
+ * HAZARD DOMAIN :: RECORD :: DESTRUCTOR
+ * The thread is exiting: free what it can, leave
+ * the rest as orphans, and give back the slot.
+ ****************************************/
+inline hazard_domain::Record :: ~Record()
+{
+   slot->pointer.store(nullptr);
+   domain.scan(retired);
+   if (!retired.empty())
+   {
+      std::lock_guard<std::mutex> lock(domain.orphanMutex);
+      domain.orphans.insert(domain.orphans.end(), retired.begin(), retired.end());
+      domain.numOrphans.store(domain.orphans.size(), std::memory_order_relaxed);
+   }
+   slot->owned.store(false, std::memory_order_release);
+}
+
+} // namespace custom
@@ -14,109 +14,294 @@
  *
  *    This will contain the class definition of:
  *       stack             : similar to std::stack
+ *       shrink_on_empty,
+ *       retain_always,
+ *       retain_watermark  : What a stack keeps of its buffer when it empties
+ *       chunked_stack     : A stack on a chunked_list, which never relocates
  * Author
  *    <your names here>
  ************************************************************************/
 
 #pragma once
 
-#include <cassert>  // because I am paranoid
-//#include "vector.h"
-#include <vector>
+#include <cassert>     // because I am paranoid
+#include <cstddef>     // for size_t
+#include <utility>     // for std::move and std::declval
+#include <type_traits> // for std::void_t, std::is_same, and the nothrow traits
+#include <cstdint>     // for SIZE_MAX
+#include "vector.h"
+#include "chunked_list.h"
 
 class TestStack; // forward declaration for unit tests
 
 namespace custom
 {
 
+namespace detail
+{
+
+/*****************************************
+ * IS STACK CONTAINER
+ * Can a stack of T keep its elements in a C? It needs
+ *    c.back()          the top, as a T &
+ *    c.push_back(t)    from a const T & and from a T &&
+ *    c.pop_back()      remove the top
+ *    c.size()          how many
+ *    c.empty()         whether none
+ *    c.swap(c)         trade contents with another
+ * custom::vector, custom::deque, custom::small_vector,
+ * std::vector, std::deque, and std::list all qualify.
+ ****************************************/
+template <class C, class T, class = void>
+struct is_stack_container : std::false_type {};
+
+template <class C, class T>
+struct is_stack_container<C, T, std::void_t<
+   decltype(std::declval<C &>().back()),
+   decltype(std::declval<C &>().push_back(std::declval<const T &>())),
+   decltype(std::declval<C &>().push_back(std::declval<T &&>())),
+   decltype(std::declval<C &>().pop_back()),
+   decltype(std::declval<const C &>().size()),
+   decltype(std::declval<const C &>().empty()),
+   decltype(std::declval<C &>().swap(std::declval<C &>()))>> :
+   std::is_same<decltype(std::declval<C &>().back()), T &> {};
+
+/*****************************************
+ * HAS SHRINK TO FIT
+ * Can C give back its unused capacity? A deque or a
+ * list frees as it goes, so has nothing to give back.
+ ****************************************/
+template <class C, class = void>
+struct has_shrink_to_fit : std::false_type {};
+
+template <class C>
+struct has_shrink_to_fit<C, std::void_t<decltype(std::declval<C &>().shrink_to_fit())>> :
+   std::true_type {};
+
+/*****************************************
+ * IS RESERVABLE
+ * Can C say how much room it has, and be given
+ * more? Then it can be trimmed to any size, not
+ * just down to what it holds.
+ ****************************************/
+template <class C, class = void>
+struct is_reservable : std::false_type {};
+
+template <class C>
+struct is_reservable<C, std::void_t<
+   decltype(std::declval<const C &>().capacity()),
+   decltype(std::declval<C &>().reserve(size_t()))>> : std::true_type {};
+
+} // namespace detail
+
+/*****************************************
+ * RETENTION POLICIES
+ * What a stack keeps of its container's buffer each time
+ * it empties. Each has pushed(size), told the size after
+ * every push, and emptied(): how many elements' worth of
+ * room to keep, or keepAll.
+ ****************************************/
+inline constexpr size_t keepAll = SIZE_MAX;
+
+// give the buffer back every time: the least memory, but a stack
+// that fills and empties over and over grows its buffer every time
+struct shrink_on_empty
+{
+   void   pushed(size_t) {}
+   size_t emptied()      { return 0; }
+};
+
+// never give it back: no allocations once the buffer has grown to
+// its largest, but one huge burst holds memory until trim()
+struct retain_always
+{
+   void   pushed(size_t) {}
+   size_t emptied()      { return keepAll; }
+};
+
+// keep twice the most the stack held in the last Window times it
+// emptied. A stack that swings between 0 and a few thousand keeps
+// its buffer; one that held a million once gives most of it back
+// Window empties later.
+template <size_t Window = 64>
+struct retain_watermark
+{
+   static_assert(Window > 0, "the window must span at least one emptying");
+
+   retain_watermark() : peak(0), numEmptied(0) {}
+
+   void pushed(size_t size)
+   {
+      if (size > peak)
+         peak = size;
+   }
+   size_t emptied()
+   {
+      if (++numEmptied < Window)
+         return keepAll;
+      size_t keep = 2 * peak;
+      peak = 0;
+      numEmptied = 0;
+      return keep;
+   }
+
+   size_t peak;         // the most elements since the window began
+   size_t numEmptied;   // how many times the stack has emptied in it
+};
+
 /**************************************************
  * STACK
- * First-in-Last-out data structure
+ * First-in-Last-out data structure. The top is the
+ * back of the Container, which is custom::vector unless
+ * another is named, just as std::stack adapts a deque.
+ * R is the retention policy, asked what to keep of the
+ * buffer whenever pop() empties the stack.
  *************************************************/
-template<class T>
+template <class T, class Container = custom::vector<T>, class R = shrink_on_empty>
 class stack
 {
    friend class ::TestStack; // give unit tests access to the privates
+   static_assert(detail::is_stack_container<Container, T>::value,
+                 "a stack's container needs back() of T&, push_back(), pop_back(), "
+                 "size(), empty(), and swap()");
 public:
-  
-   // 
+   typedef Container container_type;
+   typedef T         value_type;
+   typedef R         retention_type;
+
+   //
    // Construct
-   // 
+   //
 
-   stack() : container() {}
-   stack(const stack<T>& rhs) : container(rhs.container) {}
-   stack(stack<T>&& rhs) noexcept : container(std::move(rhs.container)) {}
-   stack(const std::vector<T>& rhs) : container(rhs) {}
-   stack(std::vector<T>&& rhs) noexcept : container(std::move(rhs)) {}
+   stack() : container(), retention() {}
+   stack(const stack & rhs) : container(rhs.container), retention(rhs.retention) {}
+   stack(stack && rhs) noexcept(std::is_nothrow_move_constructible<Container>::value) :
+      container(std::move(rhs.container)), retention(rhs.retention) {}
+   explicit stack(const Container & rhs) : container(rhs), retention() {}
+   explicit stack(Container && rhs) noexcept(std::is_nothrow_move_constructible<Container>::value) :
+      container(std::move(rhs)), retention() {}
 
    //
    // Assign
    //
 
-   stack <T> & operator = (const stack <T> & rhs)
+   stack & operator = (const stack & rhs)
    {
-       if (this != &rhs)
+      if (this != &rhs)
+      {
          container = rhs.container;
-	   return *this;
+         retention = rhs.retention;
+      }
+      return *this;
    }
-   stack <T>& operator = (stack <T> && rhs)
+   stack & operator = (stack && rhs) noexcept(std::is_nothrow_move_assignable<Container>::value)
    {
-       if (this != &rhs)
+      if (this != &rhs)
+      {
          container = std::move(rhs.container);
-	   return *this;
+         retention = rhs.retention;
+      }
+      return *this;
    }
-   void swap(stack <T>& rhs)
+   void swap(stack & rhs)
    {
-	   container.swap(rhs.container);
+      container.swap(rhs.container);
+      std::swap(retention, rhs.retention);
    }
 
-   // 
+   //
    // Access
    //
 
-   T& top()       {
-      //assert(!empty());
+   T & top()
+   {
+      assert(!empty());
       return container.back();
    }
-
-   const T& top() const { 
-      //assert(!empty());
+   const T & top() const
+   {
+      assert(!empty());
       return container.back();
    }
 
-   // 
+   //
    // Insert
-   // 
+   //
 
-   void push(const T& t) { container.push_back(t); }
-   void push(T&& t) { container.push_back(std::move(t)); }
+   void push(const T & t)
+   {
+      container.push_back(t);
+      retention.pushed(container.size());
+   }
+   void push(T && t)
+   {
+      container.push_back(std::move(t));
+      retention.pushed(container.size());
+   }
 
    //
    // Remove
    //
 
-   void pop() 
+   void pop()
    {
       if (empty())
-        return;
+         return;
       container.pop_back();
       if (container.empty())
-        container.shrink_to_fit();
+      {
+         size_t keep = retention.emptied();
+         if (keep != keepAll)
+            trimTo(keep);
+      }
    }
 
+   // give back the room past the elements the stack holds now,
+   // whatever the retention policy
+   void trim() { trimTo(size()); }
+
    //
    // Status
    //
-   size_t  size () const { return container.size(); }
-   bool empty() const { return container.empty(); }
-   
-private:
-   
-  std::vector<T> container;  // underlying container
-};
 
+   size_t size()  const { return container.size();  }
+   bool   empty() const { return container.empty(); }
 
+private:
+   // give back the buffer past room for num elements, as far as
+   // the container allows. A buffer no bigger is left alone.
+   void trimTo(size_t num)
+   {
+      if constexpr (detail::has_shrink_to_fit<Container>::value)
+      {
+         if constexpr (detail::is_reservable<Container>::value)
+         {
+            if (container.capacity() <= num)
+               return;
+            container.shrink_to_fit();
+            if (num > container.size())
+               container.reserve(num);
+         }
+         else if (num <= container.size())
+            container.shrink_to_fit();
+      }
+   }
 
-} // custom namespace
+   Container container;  // underlying container
+   R         retention;  // what to keep of the buffer when the stack empties
+};
 
+/**************************************************
+ * CHUNKED STACK
+ * A stack whose push never copies what is already on
+ * it: for stacks tens of millions deep, where a vector
+ * doubling would copy them all and, for a moment,
+ * hold them twice. The blocks are freed as the stack
+ * shrinks, so by the time it empties only the spare
+ * is left. It keeps that one: a stack that bobs
+ * between empty and a few elements never allocates.
+ *************************************************/
+template <class T, class R = retain_always>
+using chunked_stack = stack<T, chunked_list<T>, R>;
 
+} // custom namespace
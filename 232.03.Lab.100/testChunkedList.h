@@ -0,0 +1,270 @@
+/***********************************************************************
+ * Header:
+ *    TEST CHUNKED LIST
+ * Summary:
+ *    Unit tests for chunked_list
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "chunked_list.h"
+#include "unitTest.h"
+#include "spy.h"
+
+class TestChunkedList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructCopy_spanning();
+      test_constructMove_spanning();
+      test_destructor_spy();
+
+      // Assign
+      test_assignCopy_fullToFull();
+
+      // Insert
+      test_pushback_fillsBlock();
+      test_pushback_newBlock();
+      test_pushback_spyNeverMoves();
+      test_pushback_alias();
+
+      // Remove
+      test_popback_keepsSpare();
+      test_popback_boundaryNoAlloc();
+      test_popback_freesSecondSpare();
+
+      report("ChunkedList");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor: no blocks
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::chunked_list<int, 4> c;
+      // verify
+      assertUnit(c.top == nullptr);
+      assertUnit(c.spare == nullptr);
+      assertUnit(c.numTop == 0);
+      assertUnit(c.size() == 0);
+      assertUnit(c.empty());
+   }  // teardown
+
+   // a copy of three blocks' worth is in order, bottom to top
+   void test_constructCopy_spanning()
+   {  // setup
+      custom::chunked_list<int, 4> c = filled(10);
+      // exercise
+      custom::chunked_list<int, 4> copy(c);
+      // verify
+      assertUnit(copy.size() == 10);
+      assertUnit(copy.numTop == 2);
+      assertUnit(copy.top != c.top);
+      assertUnit(values(copy, 10));
+      assertUnit(values(c, 10));
+   }  // teardown
+
+   // a move takes the blocks and leaves nothing behind
+   void test_constructMove_spanning()
+   {  // setup
+      custom::chunked_list<int, 4> c = filled(10);
+      void * top = c.top;
+      // exercise
+      custom::chunked_list<int, 4> moved(std::move(c));
+      // verify
+      assertUnit(moved.top == top);
+      assertUnit(c.top == nullptr);
+      assertUnit(c.empty());
+      assertUnit(values(moved, 10));
+   }  // teardown
+
+   // every Spy in every block is destroyed
+   void test_destructor_spy()
+   {  // setup
+      {
+         custom::chunked_list<Spy, 4> c;
+         for (int i = 0; i < 10; i++)
+            c.push_back(Spy(i));
+         Spy::reset();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 10);
+      assertUnit(Spy::numDelete() == 10);
+   }  // teardown
+
+   /***************************************
+    * ASSIGN
+    ***************************************/
+
+   // assigning replaces what was there
+   void test_assignCopy_fullToFull()
+   {  // setup
+      custom::chunked_list<int, 4> c = filled(10);
+      custom::chunked_list<int, 4> other = filled(3);
+      // exercise
+      other = c;
+      // verify
+      assertUnit(values(other, 10));
+      assertUnit(values(c, 10));
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the first pushes fill one block
+   void test_pushback_fillsBlock()
+   {  // setup
+      custom::chunked_list<int, 4> c;
+      // exercise
+      c.push_back(26);
+      c.push_back(49);
+      c.push_back(67);
+      // verify
+      //    top -> [ 26 49 67 . ]
+      assertUnit(c.top != nullptr);
+      assertUnit(c.top->below == nullptr);
+      assertUnit(c.numTop == 3);
+      assertUnit(c.back() == 67);
+   }  // teardown
+
+   // a push onto a full block links a new one above it
+   void test_pushback_newBlock()
+   {  // setup
+      custom::chunked_list<int, 4> c = filled(4);
+      void * full = c.top;
+      // exercise
+      c.push_back(4);
+      // verify
+      //    top -> [ 4 . . . ] -> [ 0 1 2 3 ]
+      assertUnit(c.top != full);
+      assertUnit(c.top->below == full);
+      assertUnit(c.numTop == 1);
+      assertUnit(c.size() == 5);
+      assertUnit(c.back() == 4);
+   }  // teardown
+
+   // growing never moves or copies what is already there
+   void test_pushback_spyNeverMoves()
+   {  // setup
+      custom::chunked_list<Spy, 4> c;
+      for (int i = 0; i < 4; i++)
+         c.push_back(Spy(i));
+      Spy * first = &c.top->slots()[0];
+      Spy::reset();
+      // exercise
+      for (int i = 4; i < 100; i++)
+         c.push_back(Spy(i));
+      // verify
+      assertUnit(Spy::numCopyMove() == 96);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(*first == Spy(0));
+   }  // teardown
+
+   // push a copy of the back onto a full block
+   void test_pushback_alias()
+   {  // setup
+      custom::chunked_list<int, 4> c = filled(4);
+      // exercise
+      c.push_back(c.back());
+      // verify
+      assertUnit(c.back() == 3);
+      assertUnit(c.size() == 5);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // popping a block empty keeps it as the spare
+   void test_popback_keepsSpare()
+   {  // setup
+      custom::chunked_list<int, 4> c = filled(5);
+      void * second = c.top;
+      // exercise
+      c.pop_back();
+      // verify
+      //    top -> [ 0 1 2 3 ]     spare -> [ . . . . ]
+      assertUnit(c.spare == second);
+      assertUnit(c.numTop == 4);
+      assertUnit(c.back() == 3);
+   }  // teardown
+
+   // back and forth over a boundary reuses the spare
+   void test_popback_boundaryNoAlloc()
+   {  // setup
+      custom::chunked_list<Spy, 4> c;
+      for (int i = 0; i < 4; i++)
+         c.push_back(Spy(i));
+      c.push_back(Spy(4));
+      c.pop_back();
+      void * spare = c.spare;
+      // exercise
+      for (int i = 0; i < 10; i++)
+      {
+         c.push_back(Spy(i));
+         assertUnit(c.top == spare);
+         assertUnit(c.spare == nullptr);
+         c.pop_back();
+      }
+      // verify
+      assertUnit(c.spare == spare);
+      assertUnit(c.size() == 4);
+   }  // teardown
+
+   // only one spare: the next block popped empty is freed
+   void test_popback_freesSecondSpare()
+   {  // setup
+      custom::chunked_list<int, 4> c = filled(9);
+      // exercise
+      for (int i = 0; i < 5; i++)
+         c.pop_back();
+      // verify
+      //    top -> [ 0 1 2 3 ]     spare -> [ . . . . ]
+      assertUnit(c.spare != nullptr);
+      assertUnit(c.top->below == nullptr);
+      assertUnit(values(c, 4));
+      c.shrink_to_fit();
+      assertUnit(c.spare == nullptr);
+   }  // teardown
+
+private:
+   // 0 ... num - 1, pushed one at a time
+   static custom::chunked_list<int, 4> filled(int num)
+   {
+      custom::chunked_list<int, 4> c;
+      for (int i = 0; i < num; i++)
+         c.push_back(i);
+      return c;
+   }
+
+   // does c hold 0 ... num - 1? Pops a copy to see.
+   static bool values(const custom::chunked_list<int, 4> & c, int num)
+   {
+      if (c.size() != (size_t)num)
+         return false;
+      custom::chunked_list<int, 4> copy(c);
+      for (int i = num - 1; i >= 0; i--)
+      {
+         if (copy.back() != i)
+            return false;
+         copy.pop_back();
+      }
+      return true;
+   }
+};
+
+#endif // DEBUG
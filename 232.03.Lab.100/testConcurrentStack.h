@@ -0,0 +1,355 @@
+/***********************************************************************
+ * Header:
+ *    TEST CONCURRENT STACK
+ * Summary:
+ *    Unit tests for concurrent_stack and hazard_domain
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "concurrent_stack.h"
+#include "hazard_pointer.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <thread>     // for std::thread
+#include <vector>     // for std::vector
+#include <algorithm>  // for std::sort
+#include <stdexcept>  // for std::runtime_error
+
+class TestConcurrentStack : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_destructor_spy();
+
+      // Insert
+      test_push_tagsHead();
+
+      // Remove
+      test_tryPop_empty();
+      test_tryPop_standard();
+      test_tryPop_aba();
+      test_tryPop_throwRetires();
+      test_popAll_standard();
+      test_popAll_empty();
+      test_popAll_throwRetires();
+
+      // Reclaim
+      test_retire_hazardKeeps();
+      test_retire_orphanAdopted();
+
+      // Threads
+      test_threads_everyValueOnce();
+
+      report("ConcurrentStack");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor: a null head with a tag of 0
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::concurrent_stack<int> s;
+      // verify
+      assertUnit(s.head.load() == 0);
+      assertUnit(s.empty());
+   }  // teardown
+
+   // what is still on the stack is destroyed with it
+   void test_destructor_spy()
+   {  // setup
+      {
+         custom::concurrent_stack<Spy> s;
+         s.push(Spy(26));
+         s.push(Spy(49));
+         s.push(Spy(67));
+         Spy::reset();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(Spy::numDelete() == 3);
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // each push points the head at the new node and bumps the tag
+   void test_push_tagsHead()
+   {  // setup
+      custom::concurrent_stack<int> s;
+      // exercise
+      s.push(26);
+      s.push(49);
+      // verify
+      //    head  [ tag 2 | * ] -> 49 -> 26 -> null
+      uint64_t head = s.head.load();
+      assertUnit(head >> s.pointerBits == 2);
+      assertUnit(s.pointerOf(head)->value == 49);
+      assertUnit(s.pointerOf(head)->next->value == 26);
+      assertUnit(s.pointerOf(head)->next->next == nullptr);
+   }  // teardown
+
+   /***************************************
+    * TRY POP
+    ***************************************/
+
+   // nothing to pop: false, and the value is untouched
+   void test_tryPop_empty()
+   {  // setup
+      custom::concurrent_stack<int> s;
+      int value = 99;
+      // exercise
+      bool popped = s.try_pop(value);
+      // verify
+      assertUnit(!popped);
+      assertUnit(value == 99);
+   }  // teardown
+
+   // last in, first out
+   void test_tryPop_standard()
+   {  // setup
+      custom::concurrent_stack<int> s;
+      s.push(26);
+      s.push(49);
+      s.push(67);
+      int value = 0;
+      // exercise
+      // verify
+      assertUnit(s.try_pop(value) && value == 67);
+      assertUnit(s.try_pop(value) && value == 49);
+      assertUnit(s.try_pop(value) && value == 26);
+      assertUnit(!s.try_pop(value));
+      assertUnit(s.empty());
+   }  // teardown
+
+   // pop the top and push another: even if the new node lands at
+   // the old one's address, the head is not what it was
+   void test_tryPop_aba()
+   {  // setup
+      custom::concurrent_stack<int> s;
+      s.push(26);
+      s.push(49);
+      uint64_t before = s.head.load();
+      int value = 0;
+      // exercise
+      s.try_pop(value);
+      s.push(67);
+      // verify
+      uint64_t after = s.head.load();
+      assertUnit(after != before);
+      assertUnit(after >> s.pointerBits == 4);
+      assertUnit(s.pointerOf(after)->value == 67);
+   }  // teardown
+
+   // the move out throws: the node is retired, not leaked
+   void test_tryPop_throwRetires()
+   {  // setup
+      custom::hazard_domain & domain = custom::hazard_domain::shared();
+      std::vector<custom::hazard_domain::Retired> & retired = domain.record().retired;
+      domain.scan(retired);
+      Brittle::numLive = 0;
+      custom::concurrent_stack<Brittle> s;
+      s.push(Brittle(26));
+      s.push(Brittle(49));
+      Brittle value;
+      Brittle::numUntilThrow = 1;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         s.try_pop(value);
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      domain.scan(retired);
+      // verify
+      //    value and 26: the node that held 49 is gone
+      assertUnit(thrown);
+      assertUnit(Brittle::numLive == 2);
+      assertUnit(s.try_pop(value) && value.value == 26);
+   }  // teardown
+
+   // pop_all takes everything, the top first
+   void test_popAll_standard()
+   {  // setup
+      custom::concurrent_stack<int> s;
+      for (int i = 0; i < 5; i++)
+         s.push(i);
+      // exercise
+      custom::vector<int> values = s.pop_all();
+      // verify
+      assertUnit(values.size() == 5);
+      assertUnit(values[0] == 4);
+      assertUnit(values[4] == 0);
+      assertUnit(s.empty());
+      assertUnit(s.head.load() >> s.pointerBits == 6);
+   }  // teardown
+
+   // pop_all of nothing leaves the head alone
+   void test_popAll_empty()
+   {  // setup
+      custom::concurrent_stack<int> s;
+      // exercise
+      custom::vector<int> values = s.pop_all();
+      // verify
+      assertUnit(values.empty());
+      assertUnit(s.head.load() == 0);
+   }  // teardown
+
+   // a move throws part way: every node is retired all the same
+   void test_popAll_throwRetires()
+   {  // setup
+      custom::hazard_domain & domain = custom::hazard_domain::shared();
+      std::vector<custom::hazard_domain::Retired> & retired = domain.record().retired;
+      domain.scan(retired);
+      Brittle::numLive = 0;
+      custom::concurrent_stack<Brittle> s;
+      for (int i = 0; i < 5; i++)
+         s.push(Brittle(i));
+      Brittle::numUntilThrow = 3;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         s.pop_all();
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      domain.scan(retired);
+      // verify
+      assertUnit(thrown);
+      assertUnit(Brittle::numLive == 0);
+      assertUnit(s.empty());
+   }  // teardown
+
+   /***************************************
+    * RECLAIM
+    ***************************************/
+
+   // a retired node a slot holds survives a scan, until let go
+   void test_retire_hazardKeeps()
+   {  // setup
+      custom::hazard_domain & domain = custom::hazard_domain::shared();
+      std::vector<custom::hazard_domain::Retired> & retired = domain.record().retired;
+      domain.scan(retired);
+      Spy * p = new Spy(26);
+      domain.hazard().store(p);
+      Spy::reset();
+      // exercise
+      domain.retire(p);
+      domain.scan(retired);
+      // verify
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(retired.size() == 1);
+      domain.hazard().store(nullptr);
+      domain.scan(retired);
+      assertUnit(Spy::numDestructor() == 1);
+      assertUnit(retired.empty());
+   }  // teardown
+
+   // a thread that exits holding a node someone else is reading
+   // leaves it as an orphan, and a later scan frees it
+   void test_retire_orphanAdopted()
+   {  // setup
+      custom::hazard_domain & domain = custom::hazard_domain::shared();
+      std::vector<custom::hazard_domain::Retired> & retired = domain.record().retired;
+      domain.scan(retired);
+      Spy * p = new Spy(26);
+      domain.hazard().store(p);
+      Spy::reset();
+      // exercise
+      std::thread([&]() { domain.retire(p); }).join();
+      // verify
+      assertUnit(domain.numOrphans.load() == 1);
+      assertUnit(Spy::numDestructor() == 0);
+      domain.hazard().store(nullptr);
+      domain.scan(retired);
+      assertUnit(domain.numOrphans.load() == 0);
+      assertUnit(Spy::numDestructor() == 1);
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // 4 threads push and pop at once: every value comes off
+   // exactly once, by try_pop or by the pop_all at the end
+   void test_threads_everyValueOnce()
+   {  // setup
+      const int numThreads = 4;
+      const int perThread = 20000;
+      custom::concurrent_stack<int> s;
+      std::vector<std::vector<int>> popped(numThreads);
+      // exercise
+      std::vector<std::thread> threads;
+      for (int t = 0; t < numThreads; t++)
+         threads.emplace_back([&, t]()
+         {
+            int value;
+            for (int i = 0; i < perThread; i++)
+            {
+               s.push(t * perThread + i);
+               if (i % 3 != 0 && s.try_pop(value))
+                  popped[t].push_back(value);
+            }
+         });
+      for (std::thread & thread : threads)
+         thread.join();
+      // verify
+      std::vector<int> all;
+      for (const std::vector<int> & mine : popped)
+         all.insert(all.end(), mine.begin(), mine.end());
+      for (int value : s.pop_all())
+         all.push_back(value);
+      std::sort(all.begin(), all.end());
+      bool once = all.size() == (size_t)(numThreads * perThread);
+      for (size_t i = 0; once && i < all.size(); i++)
+         once = all[i] == (int)i;
+      assertUnit(once);
+   }  // teardown
+
+private:
+   /*************************************************************
+    * BRITTLE
+    * Counts how many are alive. Once numUntilThrow is set, the
+    * copy or move that brings it to 0 throws.
+    *************************************************************/
+   struct Brittle
+   {
+      Brittle(int value = 0)          : value(value)     {          numLive++; }
+      Brittle(const Brittle & rhs)    : value(rhs.value) { check(); numLive++; }
+      Brittle(Brittle && rhs)         : value(rhs.value) { check(); numLive++; }
+      ~Brittle()                                         { numLive--;          }
+      Brittle & operator = (const Brittle & rhs) { check(); value = rhs.value; return *this; }
+      Brittle & operator = (Brittle && rhs)      { check(); value = rhs.value; return *this; }
+
+      static void check()
+      {
+         if (numUntilThrow > 0 && --numUntilThrow == 0)
+            throw std::runtime_error("brittle");
+      }
+
+      int value;
+      static inline int numLive = 0;
+      static inline int numUntilThrow = 0;
+   };
+};
+
+#endif // DEBUG
@@ -0,0 +1,211 @@
+/***********************************************************************
+ * Header:
+ *    TEST FORK JOIN
+ * Summary:
+ *    Unit tests for fork_join_pool, task_group, and parallel_for
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "fork_join.h"
+#include "unitTest.h"
+
+#include <atomic>     // for std::atomic
+#include <stdexcept>  // for std::runtime_error
+#include <thread>     // for std::this_thread
+#include <vector>     // for std::vector
+
+class TestForkJoin : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_one();
+      test_construct_four();
+
+      // Spawn and sync
+      test_spawn_runsOnCaller();
+      test_spawn_masterReleased();
+      test_sync_nested();
+      test_sync_rethrows();
+      test_sync_fourThreads();
+
+      // Parallel for
+      test_parallelFor_everyIndexOnce();
+      test_parallelFor_empty();
+
+      report("ForkJoin");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // a pool of 1 is the master's deque and no threads
+   void test_construct_one()
+   {  // setup
+      // exercise
+      custom::fork_join_pool pool(1);
+      // verify
+      assertUnit(pool.size() == 1);
+      assertUnit(pool.threads.empty());
+      assertUnit(pool.deques[0]->index == 0);
+   }  // teardown
+
+   // a pool of 4 is 3 workers besides the master
+   void test_construct_four()
+   {  // setup
+      // exercise
+      custom::fork_join_pool pool(4);
+      // verify
+      assertUnit(pool.size() == 4);
+      assertUnit(pool.threads.size() == 3);
+      assertUnit(pool.deques[3]->index == 3);
+   }  // teardown
+
+   /***************************************
+    * SPAWN AND SYNC
+    ***************************************/
+
+   // with no workers, the caller runs everything it spawns, at sync
+   void test_spawn_runsOnCaller()
+   {  // setup
+      custom::fork_join_pool pool(1);
+      std::thread::id caller = std::this_thread::get_id();
+      int numRun = 0;
+      bool here = true;
+      // exercise
+      {
+         custom::task_group group(pool);
+         for (int i = 0; i < 10; i++)
+            group.spawn([&]()
+            {
+               numRun++;
+               here = here && std::this_thread::get_id() == caller;
+            });
+         assertUnit(pool.deques[0]->deque.size() == 10);
+         assertUnit(group.pending.load() == 10);
+         group.sync();
+         // verify
+         assertUnit(group.pending.load() == 0);
+      }
+      assertUnit(numRun == 10);
+      assertUnit(here);
+   }  // teardown
+
+   // the outside thread has the master deque only while a group lives
+   void test_spawn_masterReleased()
+   {  // setup
+      custom::fork_join_pool pool(1);
+      assertUnit(custom::fork_join_pool::current() == nullptr);
+      // exercise
+      {
+         custom::task_group outer(pool);
+         assertUnit(outer.master);
+         custom::task_group inner(pool);
+         assertUnit(!inner.master);
+         assertUnit(custom::fork_join_pool::current() == pool.deques[0].get());
+      }
+      // verify
+      assertUnit(custom::fork_join_pool::current() == nullptr);
+      assertUnit(pool.masterMutex.try_lock());
+      pool.masterMutex.unlock();
+   }  // teardown
+
+   // fib(20) by spawning one half and doing the other
+   void test_sync_nested()
+   {  // setup
+      custom::fork_join_pool pool(1);
+      // exercise
+      long result = fib(pool, 20);
+      // verify
+      assertUnit(result == 6765);
+   }  // teardown
+
+   // the first exception a task throws comes out of sync
+   void test_sync_rethrows()
+   {  // setup
+      custom::fork_join_pool pool(1);
+      custom::task_group group(pool);
+      int numRun = 0;
+      group.spawn([&]() { numRun++; });
+      group.spawn([&]() { numRun++; throw std::runtime_error("task"); });
+      group.spawn([&]() { numRun++; });
+      bool thrown = false;
+      // exercise
+      try
+      {
+         group.sync();
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(numRun == 3);
+      assertUnit(group.error == nullptr);
+   }  // teardown
+
+   // fib(22) on 4 threads: the same answer however it is stolen
+   void test_sync_fourThreads()
+   {  // setup
+      custom::fork_join_pool pool(4);
+      // exercise
+      long result = fib(pool, 22);
+      // verify
+      assertUnit(result == 17711);
+   }  // teardown
+
+   /***************************************
+    * PARALLEL FOR
+    ***************************************/
+
+   // every index is visited exactly once
+   void test_parallelFor_everyIndexOnce()
+   {  // setup
+      custom::fork_join_pool pool(4);
+      const size_t num = 10000;
+      std::vector<std::atomic<int>> visits(num);
+      for (std::atomic<int> & visit : visits)
+         visit = 0;
+      // exercise
+      custom::parallel_for(0, num, 16, [&](size_t i) { visits[i]++; }, pool);
+      // verify
+      bool once = true;
+      for (size_t i = 0; i < num; i++)
+         once = once && visits[i].load() == 1;
+      assertUnit(once);
+   }  // teardown
+
+   // an empty range calls nothing
+   void test_parallelFor_empty()
+   {  // setup
+      custom::fork_join_pool pool(1);
+      int numRun = 0;
+      // exercise
+      custom::parallel_for(5, 5, 0, [&](size_t) { numRun++; }, pool);
+      // verify
+      assertUnit(numRun == 0);
+   }  // teardown
+
+private:
+   static long fib(custom::fork_join_pool & pool, int n)
+   {
+      if (n < 2)
+         return n;
+      long left;
+      custom::task_group group(pool);
+      group.spawn([&]() { left = fib(pool, n - 1); });
+      long right = fib(pool, n - 2);
+      group.sync();
+      return left + right;
+   }
+};
+
+#endif // DEBUG
@@ -2,7 +2,7 @@
  * Header:
  *    Test
  * Summary:
- *    Driver to test stack.h
+ *    Driver to test stack.h, concurrent_stack.h, and fork_join.h
  * Author
  *    Br. Helfrich
  ************************************************************************/
@@ -14,6 +14,10 @@
 
 #include "testStack.h"       // for the stack unit tests
 #include "testSpy.h"         // for the spy unit tests
+#include "testConcurrentStack.h" // for the concurrent stack unit tests
+#include "testWorkStealingDeque.h" // for the work-stealing deque unit tests
+#include "testForkJoin.h"       // for the fork-join scheduler unit tests
+#include "testChunkedList.h"    // for the chunked list unit tests
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -26,6 +30,10 @@ int main()
    // unit tests
    TestSpy().run();
    TestStack().run();
+   TestConcurrentStack().run();
+   TestWorkStealingDeque().run();
+   TestForkJoin().run();
+   TestChunkedList().run();
 #endif // DEBUG
   
    return 0;
@@ -11,6 +11,7 @@
 
 #ifdef DEBUG
 #include "stack.h"
+#include "../232.10.Lab.100/deque.h" // for a stack on a deque
 #include "unitTest.h"
 #include "spy.h"
 
@@ -21,6 +22,8 @@
 #include <stack>
 #include <vector>
 #include <list>
+#include <deque>
+#include <type_traits>
 
 
 class TestStack : public UnitTest
@@ -80,6 +83,19 @@ public:
       test_empty_empty();
       test_empty_standard();
 
+      // Container
+      test_container_deque();
+      test_container_list();
+      test_container_chunked();
+      test_container_nothrowMove();
+
+      // Retention
+      test_retention_shrinkOnEmpty();
+      test_retention_alwaysNoRegrow();
+      test_retention_watermarkDelayed();
+      test_retention_chunkedKeepsBlock();
+      test_trim_standard();
+
       report("Stack");
    }
    
@@ -1227,6 +1243,189 @@ public:
 	  assertEmptyFixture(s);
    }
    
+   /***************************************
+    * CONTAINER
+    ***************************************/
+
+   // a stack on a deque: the top is the deque's back
+   void test_container_deque()
+   {  // setup
+      custom::stack<Spy, custom::deque<Spy>> s;
+      // exercise
+      s.push(Spy(26));
+      s.push(Spy(49));
+      s.push(Spy(67));
+      s.pop();
+      // verify
+      //    +----+----+
+      //    | 26 | 49 |
+      //    +----+----+
+      assertUnit(s.size() == 2);
+      assertUnit(s.top() == Spy(49));
+      assertUnit(s.container.front() == Spy(26));
+   }  // teardown
+
+   // a list has no capacity to shrink, so emptying it just empties it
+   void test_container_list()
+   {  // setup
+      custom::stack<int, std::list<int>> s(std::list<int>{ 26, 49 });
+      // exercise
+      s.pop();
+      s.pop();
+      s.pop();
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.container.empty());
+   }  // teardown
+
+   // a chunked_stack: deep, then most of the way back down
+   void test_container_chunked()
+   {  // setup
+      custom::chunked_stack<Spy> s;
+      // exercise
+      for (int i = 0; i < 5000; i++)
+         s.push(Spy(i));
+      for (int i = 0; i < 4000; i++)
+         s.pop();
+      // verify
+      assertUnit(s.size() == 1000);
+      assertUnit(s.top() == Spy(999));
+      assertUnit(s.container.size() == 1000);
+   }  // teardown
+
+   // a move promises not to throw only when the container's move does
+   void test_container_nothrowMove()
+   {  // setup
+      typedef custom::stack<int, std::deque<int>>           DequeStack;
+      typedef custom::stack<int, custom::chunked_list<int>> ChunkedStack;
+      // exercise
+      // verify
+      assertUnit(std::is_nothrow_move_constructible<DequeStack>::value ==
+                 std::is_nothrow_move_constructible<std::deque<int>>::value);
+      assertUnit((std::is_nothrow_constructible<DequeStack, std::deque<int> &&>::value ==
+                  std::is_nothrow_move_constructible<std::deque<int>>::value));
+      assertUnit(std::is_nothrow_move_assignable<DequeStack>::value ==
+                 std::is_nothrow_move_assignable<std::deque<int>>::value);
+      assertUnit(std::is_nothrow_move_constructible<ChunkedStack>::value);
+      assertUnit(std::is_nothrow_move_assignable<ChunkedStack>::value);
+   }  // teardown
+
+   /***************************************
+    * RETENTION
+    ***************************************/
+
+   // the default: the buffer goes back when the stack empties, so
+   // filling it again relocates every Spy through each doubling
+   void test_retention_shrinkOnEmpty()
+   {  // setup
+      custom::stack<Spy> s;
+      fillAndEmpty(s, 4);
+      assertUnit(s.container.capacity() == 0);
+      Spy::reset();
+      // exercise
+      fillAndEmpty(s, 4);
+      // verify
+      //    4 moved in, then 1 + 2 relocated growing 1 -> 2 -> 4
+      assertUnit(Spy::numCopyMove() == 7);
+      assertUnit(s.container.capacity() == 0);
+   }  // teardown
+
+   // keep the buffer: filling it again moves each Spy in and no more
+   void test_retention_alwaysNoRegrow()
+   {  // setup
+      custom::stack<Spy, custom::vector<Spy>, custom::retain_always> s;
+      fillAndEmpty(s, 4);
+      assertUnit(s.container.capacity() == 4);
+      Spy::reset();
+      // exercise
+      fillAndEmpty(s, 4);
+      // verify
+      assertUnit(Spy::numCopyMove() == 4);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numDestructor() == 8);
+      assertUnit(s.container.capacity() == 4);
+   }  // teardown
+
+   // one burst of 100, then small rounds: the buffer is kept through
+   // the window the burst is in, and trimmed at the end of the next
+   void test_retention_watermarkDelayed()
+   {  // setup
+      custom::stack<Spy, custom::vector<Spy>, custom::retain_watermark<4>> s;
+      fillAndEmpty(s, 100);
+      // exercise
+      for (int round = 0; round < 3; round++)
+         fillAndEmpty(s, 2);
+      assertUnit(s.container.capacity() == 128);   // the window's peak was 100
+      for (int round = 0; round < 3; round++)
+         fillAndEmpty(s, 2);
+      assertUnit(s.container.capacity() == 128);
+      fillAndEmpty(s, 2);
+      // verify
+      assertUnit(s.container.capacity() == 4);     // twice this window's peak of 2
+      assertUnit(s.retention.peak == 0);
+      assertUnit(s.retention.numEmptied == 0);
+   }  // teardown
+
+   // a chunked stack keeps its last block when it empties, so going
+   // from empty to one element and back never allocates a block
+   void test_retention_chunkedKeepsBlock()
+   {  // setup
+      custom::chunked_stack<int> s;
+      s.push(26);
+      void * block = s.container.top;
+      int numAllocated = 0;
+      // exercise
+      for (int i = 0; i < 100; i++)
+      {
+         s.pop();
+         if (s.container.spare != block)
+            numAllocated++;
+         s.push(i);
+         if (s.container.top != block)
+            numAllocated++;
+      }
+      s.pop();
+      // verify
+      //    top -> nullptr     spare -> [ . . . . ]
+      assertUnit(numAllocated == 0);
+      assertUnit(s.empty());
+      assertUnit(s.container.spare == block);
+   }  // teardown
+
+   // trim gives back the room past the top, whatever the policy
+   void test_trim_standard()
+   {  // setup
+      custom::stack<Spy, custom::vector<Spy>, custom::retain_always> s;
+      s.push(Spy(26));
+      s.push(Spy(49));
+      s.push(Spy(67));
+      assertUnit(s.container.capacity() == 4);
+      // exercise
+      s.trim();
+      // verify
+      assertUnit(s.container.capacity() == 3);
+      assertUnit(s.top() == Spy(67));
+      s.pop();
+      s.pop();
+      s.pop();
+      assertUnit(s.container.capacity() == 3);
+      s.trim();
+      assertUnit(s.container.capacity() == 0);
+   }  // teardown
+
+   /*************************************************************
+    * FILL AND EMPTY
+    * Push num Spies, then pop them all: one request's worth
+    *************************************************************/
+   template <class Stack>
+   void fillAndEmpty(Stack & s, int num)
+   {
+      for (int i = 0; i < num; i++)
+         s.push(Spy(i));
+      while (!s.empty())
+         s.pop();
+   }
+
    /*************************************************************
     * SETUP STANDARD FIXTURE
     *      0    1    2    3
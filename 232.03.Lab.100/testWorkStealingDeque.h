@@ -0,0 +1,245 @@
+/***********************************************************************
+ * Header:
+ *    TEST WORK STEALING DEQUE
+ * Summary:
+ *    Unit tests for work_stealing_deque
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "work_stealing_deque.h"
+#include "unitTest.h"
+
+#include <thread>     // for std::thread
+#include <atomic>     // for std::atomic
+#include <vector>     // for std::vector
+#include <algorithm>  // for std::sort
+
+class TestWorkStealingDeque : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_roundsUp();
+
+      // Owner
+      test_push_standard();
+      test_pop_lifo();
+      test_pop_empty();
+      test_push_grows();
+
+      // Thieves
+      test_steal_fifo();
+      test_steal_empty();
+      test_stealPop_lastOne();
+
+      // Threads
+      test_threads_everyValueOnce();
+
+      report("WorkStealingDeque");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor: room for 256, nothing in it
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::work_stealing_deque<int> d;
+      // verify
+      assertUnit(d.buffer.load()->capacity == 256);
+      assertUnit(d.buffer.load()->previous == nullptr);
+      assertUnit(d.top.load() == 0);
+      assertUnit(d.bottom.load() == 0);
+      assertUnit(d.empty());
+   }  // teardown
+
+   // the capacity is a power of two, so an index wraps with a mask
+   void test_construct_roundsUp()
+   {  // setup
+      // exercise
+      custom::work_stealing_deque<int> d(5);
+      // verify
+      assertUnit(d.buffer.load()->capacity == 8);
+   }  // teardown
+
+   /***************************************
+    * OWNER
+    ***************************************/
+
+   // a push goes in at bottom
+   void test_push_standard()
+   {  // setup
+      custom::work_stealing_deque<int> d(4);
+      // exercise
+      d.push(26);
+      d.push(49);
+      // verify
+      //    top bottom
+      //     v   v
+      //   [ 26 49 . . ]
+      assertUnit(d.top.load() == 0);
+      assertUnit(d.bottom.load() == 2);
+      assertUnit(d.size() == 2);
+      assertUnit(d.buffer.load()->get(1) == 49);
+   }  // teardown
+
+   // the owner takes the newest first
+   void test_pop_lifo()
+   {  // setup
+      custom::work_stealing_deque<int> d(4);
+      d.push(26);
+      d.push(49);
+      d.push(67);
+      int value = 0;
+      // exercise
+      // verify
+      assertUnit(d.pop(value) && value == 67);
+      assertUnit(d.pop(value) && value == 49);
+      assertUnit(d.pop(value) && value == 26);
+      assertUnit(d.empty());
+   }  // teardown
+
+   // nothing to pop: false, and bottom is put back
+   void test_pop_empty()
+   {  // setup
+      custom::work_stealing_deque<int> d(4);
+      int value = 99;
+      // exercise
+      bool popped = d.pop(value);
+      // verify
+      assertUnit(!popped);
+      assertUnit(value == 99);
+      assertUnit(d.bottom.load() == 0);
+      assertUnit(d.top.load() == 0);
+   }  // teardown
+
+   // a full buffer is copied into one twice the size, and kept
+   void test_push_grows()
+   {  // setup
+      custom::work_stealing_deque<int> d(2);
+      int value = 0;
+      d.push(0);
+      d.push(1);
+      d.steal(value);
+      d.push(2);
+      // exercise
+      //    top bottom                 top   bottom
+      //     v   v                      v     v
+      //   [ 2 1 ]     becomes    [ . 1 2 . ]
+      d.push(3);
+      // verify
+      assertUnit(d.buffer.load()->capacity == 4);
+      assertUnit(d.buffer.load()->previous != nullptr);
+      assertUnit(d.buffer.load()->previous->capacity == 2);
+      assertUnit(d.steal(value) && value == 1);
+      assertUnit(d.steal(value) && value == 2);
+      assertUnit(d.steal(value) && value == 3);
+      assertUnit(d.empty());
+   }  // teardown
+
+   /***************************************
+    * THIEVES
+    ***************************************/
+
+   // a thief takes the oldest first
+   void test_steal_fifo()
+   {  // setup
+      custom::work_stealing_deque<int> d(4);
+      d.push(26);
+      d.push(49);
+      d.push(67);
+      int value = 0;
+      // exercise
+      // verify
+      assertUnit(d.steal(value) && value == 26);
+      assertUnit(d.top.load() == 1);
+      assertUnit(d.pop(value) && value == 67);
+      assertUnit(d.steal(value) && value == 49);
+      assertUnit(d.empty());
+   }  // teardown
+
+   // nothing to steal: false
+   void test_steal_empty()
+   {  // setup
+      custom::work_stealing_deque<int> d(4);
+      int value = 99;
+      // exercise
+      bool stolen = d.steal(value);
+      // verify
+      assertUnit(!stolen);
+      assertUnit(value == 99);
+   }  // teardown
+
+   // popping the last one moves top, just as a steal would,
+   // so a thief that comes after finds nothing
+   void test_stealPop_lastOne()
+   {  // setup
+      custom::work_stealing_deque<int> d(4);
+      d.push(26);
+      int value = 0;
+      // exercise
+      bool popped = d.pop(value);
+      // verify
+      assertUnit(popped && value == 26);
+      assertUnit(d.top.load() == 1);
+      assertUnit(d.bottom.load() == 1);
+      assertUnit(!d.steal(value));
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // the owner pushes and pops while 3 thieves steal: every
+   // value comes out exactly once
+   void test_threads_everyValueOnce()
+   {  // setup
+      const int num = 100000;
+      const int numThieves = 3;
+      custom::work_stealing_deque<int> d(16);
+      std::vector<std::vector<int>> taken(numThieves + 1);
+      std::atomic<bool> done(false);
+      // exercise
+      std::vector<std::thread> thieves;
+      for (int t = 1; t <= numThieves; t++)
+         thieves.emplace_back([&, t]()
+         {
+            int value;
+            while (!done.load() || !d.empty())
+               if (d.steal(value))
+                  taken[t].push_back(value);
+         });
+      int value;
+      for (int i = 0; i < num; i++)
+      {
+         d.push(i);
+         if (i % 4 == 0 && d.pop(value))
+            taken[0].push_back(value);
+      }
+      while (d.pop(value))
+         taken[0].push_back(value);
+      done = true;
+      for (std::thread & thief : thieves)
+         thief.join();
+      // verify
+      std::vector<int> all;
+      for (const std::vector<int> & mine : taken)
+         all.insert(all.end(), mine.begin(), mine.end());
+      std::sort(all.begin(), all.end());
+      bool once = all.size() == (size_t)num;
+      for (size_t i = 0; once && i < all.size(); i++)
+         once = all[i] == (int)i;
+      assertUnit(once);
+   }  // teardown
+};
+
+#endif // DEBUG
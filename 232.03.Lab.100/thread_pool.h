@@ -0,0 +1,232 @@
+/***********************************************************************
+ * Header:
+ *    THREAD POOL
+ * Summary:
+ *    A fixed set of worker threads that bulk operations, such as
+ *    filling or copying a huge vector, can split their work across.
+ *    Starting a thread costs tens of microseconds, so the threads
+ *    are started once and then wait for work.
+ *
+ *    This will contain the class definition of:
+ *        parallelism            : When and how widely to split work
+ *        thread_pool            : The worker threads
+ ************************************************************************/
+
+#pragma once
+
+#include <thread>             // for std::thread
+#include <mutex>              // for std::mutex
+#include <condition_variable> // for std::condition_variable
+#include <atomic>             // for std::atomic
+#include <functional>         // for std::function
+#include <exception>          // for std::exception_ptr
+#include <vector>             // for std::vector, to hold the workers
+#include <cstddef>            // for size_t
+
+namespace custom
+{
+
+/*****************************************
+ * PARALLELISM
+ * Work on fewer than threshold bytes is done on the
+ * calling thread: below that, waking the workers costs
+ * more than they save. Above it, the work is split into
+ * one piece per thread.
+ ****************************************/
+struct parallelism
+{
+   size_t   threshold;        // the smallest job, in bytes, worth splitting
+   unsigned threads;          // how many threads share a job, the caller included
+
+   static parallelism & settings()
+   {
+      static parallelism current = { 16 << 20, defaultThreads() };
+      return current;
+   }
+
+   static unsigned defaultThreads()
+   {
+      unsigned num = std::thread::hardware_concurrency();
+      return (num == 0) ? 1 : num;
+   }
+};
+
+/*****************************************
+ * THREAD POOL
+ * run(num, task) calls task(0) ... task(num - 1), spread
+ * over the workers and the calling thread, and returns
+ * when all are done. One job runs at a time. A task that
+ * itself calls run() does its work serially rather than
+ * waiting on workers that are busy running it.
+ ****************************************/
+class thread_pool
+{
+public:
+   // the pool everyone shares. It starts empty and adds
+   // workers the first time a job is split that many ways.
+   static thread_pool & shared()
+   {
+      static thread_pool pool;
+      return pool;
+   }
+
+   ~thread_pool()
+   {
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         stopping = true;
+      }
+      wake.notify_all();
+      for (std::thread & worker : workers)
+         worker.join();
+   }
+
+   // is the calling thread in the middle of a task?
+   static bool inTask() { return insideTask(); }
+
+   void run(size_t num, const std::function<void(size_t)> & task);
+
+private:
+   thread_pool() : job(nullptr), generation(0), numActive(0), stopping(false) {}
+
+   static const size_t maxWorkers = 255;
+
+   static bool & insideTask()
+   {
+      thread_local bool inside = false;
+      return inside;
+   }
+
+   // one call to run(): it lives on the caller's stack
+   struct Job
+   {
+      const std::function<void(size_t)> & task;
+      size_t              numTasks;
+      std::atomic<size_t> next;       // the next task to hand out
+      std::atomic<size_t> pending;    // tasks not yet finished
+      std::exception_ptr  error;      // the first task to throw
+   };
+
+   void workerLoop();
+   void work(Job & job);
+
+   std::vector<std::thread> workers;
+   std::mutex               jobMutex;   // one job at a time
+   std::mutex               mutex;      // guards the members below
+   std::condition_variable  wake;       // a job is ready, or we are stopping
+   std::condition_variable  done;       // the job is finished
+   Job *                    job;        // the job running now, if any
+   unsigned long            generation; // counts jobs, so a worker joins each once
+   unsigned                 numActive;  // workers holding on to the job
+   bool                     stopping;
+};
+
+/*****************************************
+ * THREAD POOL :: RUN
+ * Hand out the tasks and join in until they are
+ * all done. The first exception a task throws is
+ * rethrown here, after every task has finished.
+ ****************************************/
+inline void thread_pool :: run(size_t num, const std::function<void(size_t)> & task)
+{
+   if (num == 0)
+      return;
+
+   // nested, or nothing to share: do it all here
+   if (insideTask() || num == 1)
+   {
+      bool outer = insideTask();
+      insideTask() = true;
+      try
+      {
+         for (size_t i = 0; i < num; i++)
+            task(i);
+      }
+      catch (...)
+      {
+         insideTask() = outer;
+         throw;
+      }
+      insideTask() = outer;
+      return;
+   }
+
+   std::lock_guard<std::mutex> oneJob(jobMutex);
+
+   // one worker per task besides the one we do ourselves
+   while (workers.size() + 1 < num && workers.size() < maxWorkers)
+      workers.emplace_back([this]() { workerLoop(); });
+
+   Job current { task, num, { 0 }, { num }, nullptr };
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      job = &current;
+      generation++;
+   }
+   wake.notify_all();
+
+   work(current);
+
+   // wait for the tasks, and for every worker to let go of the job
+   std::unique_lock<std::mutex> lock(mutex);
+   done.wait(lock, [&]() { return current.pending == 0 && numActive == 0; });
+   job = nullptr;
+   if (current.error)
+      std::rethrow_exception(current.error);
+}
+
+/*****************************************
+ * THREAD POOL :: WORK
+ * Take tasks until there are none left
+ ****************************************/
+inline void thread_pool :: work(Job & job)
+{
+   insideTask() = true;
+   for (size_t i = job.next++; i < job.numTasks; i = job.next++)
+   {
+      try
+      {
+         job.task(i);
+      }
+      catch (...)
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         if (!job.error)
+            job.error = std::current_exception();
+      }
+      if (--job.pending == 0)
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         done.notify_all();
+      }
+   }
+   insideTask() = false;
+}
+
+/*****************************************
+ * THREAD POOL :: WORKER LOOP
+ * Sleep until there is a job, help with it, repeat
+ ****************************************/
+inline void thread_pool :: workerLoop()
+{
+   unsigned long seen = 0;
+   std::unique_lock<std::mutex> lock(mutex);
+   while (true)
+   {
+      wake.wait(lock, [&]() { return stopping || (job != nullptr && generation != seen); });
+      if (stopping)
+         return;
+      seen = generation;
+      Job & mine = *job;
+      numActive++;
+      lock.unlock();
+
+      work(mine);
+
+      lock.lock();
+      if (--numActive == 0)
+         done.notify_all();
+   }
+}
+
+} // namespace custom
@@ -15,6 +15,12 @@
  *    This will contain the class definition of:
  *        vector                 : A class that represents a Vector
  *        vector::iterator       : An interator through Vector
+ *        vector::const_iterator : A read-only interator through Vector
+ *        small_vector           : A Vector that keeps N elements inline
+ *        grow_double, grow_half,
+ *        grow_page              : How much a Vector grows when it is full
+ *        aligned_allocator      : Buffers on a cache-line or page boundary
+ *        aligned_vector         : A Vector whose buffer is over-aligned
  * Author
  *    <your names here>
  ************************************************************************/
@@ -23,9 +29,24 @@
 
 #include <cassert>  // because I am paranoid
 #include <new>      // std::bad_alloc
-#include <memory>   // for std::allocator
+#include <memory>   // for std::allocator and std::allocator_traits
+#if __has_include(<memory_resource>)
+#include <memory_resource> // for std::pmr::polymorphic_allocator
+#endif
+#include <utility>  // for std::move and std::swap
+#include <cstring>  // for std::memcpy and std::memmove
+#include <algorithm>// for std::move_backward and std::rotate
+#include <iterator> // for std::distance, std::iterator_traits, std::reverse_iterator
+#include <cstddef>  // for std::ptrdiff_t
+#include <type_traits>
+#include "thread_pool.h" // for splitting huge fills and copies across threads
+#ifdef __linux__
+#include <sys/mman.h> // for mmap and mremap
+#include <unistd.h>   // for sysconf
+#endif
 
 class TestVector; // forward declaration for unit tests
+class TestSmallVector;
 class TestStack;
 class TestPQueue;
 class TestHash;
@@ -34,28 +55,161 @@ namespace custom
 {
 
 /*****************************************
- * VECTOR
- * Just like the std :: vector <T> class
+ * IS TRIVIALLY RELOCATABLE
+ * Can an object be moved to a new address with a
+ * plain memcpy, leaving nothing to destroy at the
+ * old one? True for trivially copyable types.
+ * Specialize to opt in other types, such as ones
+ * that own a heap pointer but never point at themselves:
+ *    template <>
+ *    struct custom::is_trivially_relocatable<Mine> : std::true_type {};
  ****************************************/
 template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+/*****************************************
+ * GROWTH POLICIES
+ * How big the buffer gets when a vector runs out of room.
+ * Each has grow(capacity, needed, size): the new capacity,
+ * at least needed, for elements of size bytes.
+ ****************************************/
+
+// double: the fewest reallocations, but up to half the buffer may sit idle
+struct grow_double
+{
+   static size_t grow(size_t capacity, size_t needed, size_t)
+   {
+      size_t doubled = (capacity == 0) ? 1 : capacity * 2;
+      return (doubled > needed) ? doubled : needed;
+   }
+};
+
+// half again: at most a third idle, and freed blocks can be reused
+struct grow_half
+{
+   static size_t grow(size_t capacity, size_t needed, size_t)
+   {
+      size_t half = capacity + capacity / 2;
+      if (half <= capacity)
+         half = capacity + 1;
+      return (half > needed) ? half : needed;
+   }
+};
+
+// half again, then filled out to whole pages once the buffer spans more than one
+struct grow_page
+{
+   static const size_t pageSize = 4096;
+   static size_t grow(size_t capacity, size_t needed, size_t size)
+   {
+      size_t num = grow_half::grow(capacity, needed, size);
+      size_t bytes = num * size;
+      if (bytes <= pageSize)
+         return num;
+      bytes = (bytes + pageSize - 1) / pageSize * pageSize;
+      return bytes / size;
+   }
+};
+
+/*****************************************
+ * ALIGNED ALLOCATOR
+ * Every buffer starts on an Alignment-byte boundary,
+ * or alignof(T) if that is stricter: 64 puts it on a
+ * cache line, so no vector load of up to 64 bytes from
+ * the front of the buffer ever straddles two lines;
+ * 4096 puts it on a page.
+ ****************************************/
+template <typename T, size_t Alignment = 64>
+struct aligned_allocator
+{
+   static_assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0,
+                 "alignment must be a power of two");
+   typedef T              value_type;
+   typedef std::true_type is_always_equal;
+   static const size_t alignment = (Alignment > alignof(T)) ? Alignment : alignof(T);
+
+   template <class U>
+   struct rebind { typedef aligned_allocator<U, Alignment> other; };
+
+   aligned_allocator() noexcept {}
+   template <class U>
+   aligned_allocator(const aligned_allocator<U, Alignment> &) noexcept {}
+
+   T * allocate(size_t num)
+   {
+      if (num > (size_t)-1 / sizeof(T))
+         throw std::bad_array_new_length();
+      return static_cast<T *>(::operator new(num * sizeof(T), std::align_val_t(alignment)));
+   }
+   void deallocate(T * p, size_t) noexcept
+   {
+      ::operator delete(p, std::align_val_t(alignment));
+   }
+
+   template <class U>
+   bool operator == (const aligned_allocator<U, Alignment> &) const { return true;  }
+   template <class U>
+   bool operator != (const aligned_allocator<U, Alignment> &) const { return false; }
+};
+
+/*****************************************
+ * ALLOCATOR ALIGNMENT
+ * The boundary every buffer from an allocator of type
+ * A is known to start on. Only alignof(T) in general.
+ ****************************************/
+template <typename A>
+struct allocator_alignment
+{
+   static const size_t value = alignof(typename std::allocator_traits<A>::value_type);
+};
+
+template <typename T, size_t Alignment>
+struct allocator_alignment<aligned_allocator<T, Alignment>>
+{
+   static const size_t value = aligned_allocator<T, Alignment>::alignment;
+};
+
+template <typename A>
+struct is_aligned_allocator : std::false_type {};
+template <typename T, size_t Alignment>
+struct is_aligned_allocator<aligned_allocator<T, Alignment>> : std::true_type {};
+
+/*****************************************
+ * VECTOR
+ * Just like the std :: vector <T> class.
+ * The buffer comes from an allocator of type A, so it can
+ * live in an arena or a std::pmr memory resource.
+ * G is the growth policy, used whenever push_back,
+ * emplace, or insert find the buffer full.
+ ****************************************/
+template <typename T, typename A = std::allocator<T>, typename G = grow_double>
 class vector
 {
    friend class ::TestVector; // give unit tests access to the privates
    friend class ::TestStack;
    friend class ::TestPQueue;
    friend class ::TestHash;
+   typedef std::allocator_traits<A> AllocTraits;
+   static_assert(std::is_same<typename AllocTraits::value_type, T>::value,
+                 "the allocator must allocate T");
+   static_assert(std::is_same<typename AllocTraits::pointer, T *>::value,
+                 "the allocator must hand out plain pointers");
 public:
-   
-   // 
+   typedef A allocator_type;
+
+   //
    // Construct
    //
 
    vector();
-   vector(size_t numElements                );
-   vector(size_t numElements, const T & t   );
-   vector(const std::initializer_list<T>& l );
+   explicit vector(const A & a);
+   vector(size_t numElements,                const A & a = A());
+   vector(size_t numElements, const T & t,   const A & a = A());
+   vector(const std::initializer_list<T>& l, const A & a = A());
    vector(const vector &  rhs);
+   vector(const vector &  rhs, const A & a);
    vector(      vector && rhs);
+   vector(      vector && rhs, const A & a);
    ~vector();
 
    //
@@ -64,18 +218,42 @@ public:
 
    void swap(vector& rhs)
    {
+      // allocators travel with their buffers only if they say so;
+      // otherwise they had better be interchangeable
+      if constexpr (AllocTraits::propagate_on_container_swap::value)
+         std::swap(alloc, rhs.alloc);
+      else
+         assert(AllocTraits::is_always_equal::value || alloc == rhs.alloc);
+		std::swap(data, rhs.data);
+		std::swap(numCapacity, rhs.numCapacity);
+		std::swap(numElements, rhs.numElements);
 
    }
    vector & operator = (const vector & rhs);
    vector& operator = (vector&& rhs);
+   template <class InputIterator>
+   void assign(InputIterator first, InputIterator last);
 
    //
    // Iterator
    //
 
    class iterator;
-   iterator       begin() { return iterator(); }
-   iterator       end() { return iterator(); }
+   class const_iterator;
+   typedef std::reverse_iterator<iterator>       reverse_iterator;
+   typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+   iterator       begin() { return (numElements == 0) ? iterator(nullptr) : iterator(data); }
+	iterator       end() { return (numElements == 0) ? iterator(nullptr) : iterator(data + numElements); }
+   const_iterator begin()  const { return cbegin(); }
+   const_iterator end()    const { return cend();   }
+   const_iterator cbegin() const { return (numElements == 0) ? const_iterator(nullptr) : const_iterator(data); }
+   const_iterator cend()   const { return (numElements == 0) ? const_iterator(nullptr) : const_iterator(data + numElements); }
+   reverse_iterator       rbegin()        { return reverse_iterator(end());         }
+   reverse_iterator       rend()          { return reverse_iterator(begin());       }
+   const_reverse_iterator rbegin()  const { return const_reverse_iterator(cend());  }
+   const_reverse_iterator rend()    const { return const_reverse_iterator(cbegin());}
+   const_reverse_iterator crbegin() const { return const_reverse_iterator(cend());  }
+   const_reverse_iterator crend()   const { return const_reverse_iterator(cbegin());}
 
    //
    // Access
@@ -94,6 +272,14 @@ public:
 
    void push_back(const T& t);
    void push_back(T&& t);
+   template <class ... Args>
+   T& emplace_back(Args&& ... args);
+   template <class ... Args>
+   iterator emplace(iterator pos, Args&& ... args);
+   template <class InputIterator>
+   iterator insert(iterator pos, InputIterator first, InputIterator last);
+   template <class InputIterator>
+   void append(InputIterator first, InputIterator last);
    void reserve(size_t newCapacity);
    void resize(size_t newElements);
    void resize(size_t newElements, const T& t);
@@ -104,26 +290,126 @@ public:
 
    void clear()
    {
+      destroy(data, data + numElements);
+	   numElements = 0;
    }
    void pop_back()
    {
+       if (numElements > 0)
+		   AllocTraits::destroy(alloc, data + --numElements);
    }
+   iterator erase(iterator first, iterator last);
    void shrink_to_fit();
 
    //
    // Status
    //
 
-   size_t  size()          const { return 999;}
-   size_t  capacity()      const { return 999;}
-   bool empty()            const { return true;}
-   
+   size_t  size()          const {return numElements;}
+   size_t  capacity()      const {return numCapacity;}
+   bool empty()            const {return numElements == 0;}
+   A    get_allocator()    const {return alloc;}
+
    // adjust the size of the buffer
-   
+
    // vector-specific interfaces
-   
+
+   // every buffer this vector has, through every reallocation,
+   // starts on a boundary of this many bytes
+   static constexpr size_t alignment = allocator_alignment<A>::value;
+
+   // the buffer, with that promise passed on to the compiler so
+   // it can use aligned loads and stores. nullptr when there is
+   // no buffer.
+   T * aligned_data()
+   {
+#if defined(__GNUC__) || defined(__clang__)
+      return static_cast<T *>(__builtin_assume_aligned(data, alignment));
+#else
+      return data;
+#endif
+   }
+   const T * aligned_data() const
+   {
+#if defined(__GNUC__) || defined(__clang__)
+      return static_cast<const T *>(__builtin_assume_aligned(data, alignment));
+#else
+      return data;
+#endif
+   }
+
 private:
-   
+
+   // raw storage: capacity is allocated but never constructed
+   T *  allocate(size_t num);
+   void deallocate(T * p, size_t num);
+   void release();
+
+   // construct or destroy elements in place within raw storage
+   template <class ... Args>
+   void uninitializedFill(T * first, T * last, const Args & ... args);
+   template <class InputIterator>
+   void uninitializedCopy(InputIterator first, InputIterator last, T * dest);
+   void destroy(T * first, T * last);
+
+   // construct a huge range in pieces, one per thread; see parallelism.
+   // Only plain data from an allocator with no state is safe to build on
+   // several threads at once: a copy constructor may touch shared state,
+   // and a memory_resource need not be thread-safe.
+   static constexpr bool canParallel = std::is_trivially_copyable<T>::value &&
+      (std::is_same<A, std::allocator<T>>::value || is_aligned_allocator<A>::value);
+   static bool isParallel(size_t num)
+   {
+      return canParallel &&
+             num * sizeof(T) >= parallelism::settings().threshold &&
+             parallelism::settings().threads > 1 &&
+             !thread_pool::inTask();
+   }
+   template <class Construct>
+   void constructInParallel(T * first, size_t num, Construct construct);
+
+   // move [first, last) into raw storage at dest, leaving the source raw
+   void relocate(T * first, T * last, T * dest);
+   void relocateAround(T * newData, size_t index, size_t count);
+   void reallocate(size_t newCapacity);
+
+   // grow the buffer, building the new element at index along the way
+   size_t nextCapacity(size_t numNeeded) const
+   {
+      return G::grow(numCapacity, numNeeded, sizeof(T));
+   }
+   template <class ... Args>
+   T *  reallocateEmplace(size_t index, Args&& ... args);
+
+   // where an iterator points, as an index into data
+   size_t indexOf(const iterator & it) const { return (it.p == nullptr) ? 0 : it.p - data; }
+
+   // is the iterator at least a forward iterator, so it can be measured first?
+   template <class Iterator>
+   static constexpr bool isForward = std::is_base_of<std::forward_iterator_tag,
+      typename std::iterator_traits<Iterator>::iterator_category>::value;
+
+   // relocation may move only if a throw cannot strand half the elements
+   static constexpr bool relocateByMove =
+      is_trivially_relocatable<T>::value ||
+      std::is_nothrow_move_constructible<T>::value ||
+      !std::is_copy_constructible<T>::value;
+
+   // huge buffers of trivially relocatable elements come straight from
+   // the kernel, so growing them remaps pages instead of copying bytes.
+   // Mapped pages are page-aligned, which keeps an aligned_allocator's promise.
+#ifdef __linux__
+   static constexpr bool canMap = is_trivially_relocatable<T>::value &&
+      (std::is_same<A, std::allocator<T>>::value ||
+       (is_aligned_allocator<A>::value && allocator_alignment<A>::value <= 4096));
+#else
+   static constexpr bool canMap = false;
+#endif
+   static const size_t mapThreshold = 1 << 20; // bytes
+   static bool   isMapped(size_t num) { return canMap && num * sizeof(T) >= mapThreshold; }
+   static size_t mapBytes(size_t num);
+
+   A    alloc;                // source of the raw, unconstructed buffer
    T *  data;                 // user data, a dynamically-allocated array
    size_t  numCapacity;       // the capacity of the array
    size_t  numElements;       // the number of items currently used
@@ -131,266 +417,849 @@ private:
 
 /**************************************************
  * VECTOR ITERATOR
- * An iterator through vector.  You only need to
- * support the following:
- *   1. Constructors (default and copy)
- *   2. Not equals operator
- *   3. Increment (prefix and postfix)
- *   4. Dereference
- * This particular iterator is a bi-directional meaning
- * that ++ and -- both work.  Not all iterators are that way.
+ * An iterator through vector. The elements sit in one
+ * contiguous buffer, so this is a random-access iterator:
+ * it can jump by any distance in constant time, measure
+ * the distance to another iterator, and be compared for order.
+ * That lets std::sort, std::lower_bound, and the parallel
+ * algorithms take their fast paths on our vector.
  *************************************************/
-template <typename T>
-class vector <T> ::iterator
+template <typename T, typename A, typename G>
+class vector <T, A, G> ::iterator
 {
+   friend class vector <T, A, G>;
    friend class ::TestVector; // give unit tests access to the privates
    friend class ::TestStack;
    friend class ::TestPQueue;
    friend class ::TestHash;
 public:
+   // what std::iterator_traits reports about us
+   typedef std::random_access_iterator_tag iterator_category;
+#ifdef __cpp_lib_ranges
+   typedef std::contiguous_iterator_tag    iterator_concept;
+#endif
+   typedef T                               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef T *                             pointer;
+   typedef T &                             reference;
+
    // constructors, destructors, and assignment operator
-   iterator()                           { this->p = new T; }
-   iterator(T* p)                       { this->p = new T; }
-   iterator(const iterator& rhs)        { this->p = new T; }
-   iterator(size_t index, vector<T>& v) { this->p = new T; }
+	iterator()                           { this->p = nullptr; }
+	iterator(T* p)                       { this->p = p; }
+   iterator(const iterator& rhs)        { this->p = rhs.p; }
+	iterator(size_t index, vector& v) { this->p = &(v.data[index]); }
    iterator& operator = (const iterator& rhs)
-   {
-      this->p = new T;
-      return *this;
-   }
+	{
+		if(this != &rhs)
+			this->p = rhs.p;
+		return *this;
+	}
 
    // equals, not equals operator
-   bool operator != (const iterator& rhs) const { return true; }
-   bool operator == (const iterator& rhs) const { return true; }
+   bool operator != (const iterator& rhs) const { return p != rhs.p; }
+   bool operator == (const iterator& rhs) const { return p == rhs.p; }
+
+   // relative order
+   bool operator <  (const iterator& rhs) const { return p <  rhs.p; }
+   bool operator >  (const iterator& rhs) const { return p >  rhs.p; }
+   bool operator <= (const iterator& rhs) const { return p <= rhs.p; }
+   bool operator >= (const iterator& rhs) const { return p >= rhs.p; }
 
    // dereference operator
-   T& operator * ()
+   T& operator * () const
+   {
+      return *p;
+   }
+   T* operator -> () const
+   {
+      return p;
+   }
+   T& operator [] (difference_type n) const
    {
-      return *(new T);
+      return p[n];
    }
 
    // prefix increment
    iterator& operator ++ ()
    {
+      ++p;
       return *this;
    }
 
    // postfix increment
-   iterator operator ++ (int postfix)
+   iterator operator ++ (int)
    {
-      return *this;
+	   iterator temp(*this);
+	   ++(*this);
+      return temp;
    }
 
    // prefix decrement
    iterator& operator -- ()
    {
+	   --p;
       return *this;
    }
 
    // postfix decrement
-   iterator operator -- (int postfix)
+   iterator operator -- (int)
+   {
+	  iterator temp = *this;
+	  --(*this);
+	  return temp; // return the unincremented version
+   }
+
+   // jump by n
+   iterator& operator += (difference_type n) { p += n; return *this; }
+   iterator& operator -= (difference_type n) { p -= n; return *this; }
+   iterator  operator +  (difference_type n) const { return iterator(p + n); }
+   iterator  operator -  (difference_type n) const { return iterator(p - n); }
+   friend iterator operator + (difference_type n, const iterator& it) { return it + n; }
+
+   // distance between two iterators
+   difference_type operator - (const iterator& rhs) const { return p - rhs.p; }
+
+private:
+	T* p; // pointer being encapsulated
+};
+
+/**************************************************
+ * VECTOR CONST ITERATOR
+ * The same as iterator, but the elements it visits
+ * cannot be changed. Any iterator converts to one.
+ *************************************************/
+template <typename T, typename A, typename G>
+class vector <T, A, G> ::const_iterator
+{
+   friend class vector <T, A, G>;
+   friend class ::TestVector; // give unit tests access to the privates
+   friend class ::TestStack;
+   friend class ::TestPQueue;
+   friend class ::TestHash;
+public:
+   // what std::iterator_traits reports about us
+   typedef std::random_access_iterator_tag iterator_category;
+#ifdef __cpp_lib_ranges
+   typedef std::contiguous_iterator_tag    iterator_concept;
+#endif
+   typedef T                               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef const T *                       pointer;
+   typedef const T &                       reference;
+
+   // constructors, destructors, and assignment operator
+   const_iterator()                            : p(nullptr)  {}
+   const_iterator(const T* p)                  : p(p)        {}
+   const_iterator(const iterator& rhs)         : p(rhs.p)    {}
+   const_iterator(const const_iterator& rhs)   : p(rhs.p)    {}
+   const_iterator& operator = (const const_iterator& rhs)
    {
+      p = rhs.p;
       return *this;
    }
 
+   // equals, not equals operator: friends so an iterator on either side converts
+   friend bool operator != (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p != rhs.p; }
+   friend bool operator == (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p == rhs.p; }
+
+   // relative order
+   friend bool operator <  (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p <  rhs.p; }
+   friend bool operator >  (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p >  rhs.p; }
+   friend bool operator <= (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p <= rhs.p; }
+   friend bool operator >= (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p >= rhs.p; }
+
+   // dereference operator
+   const T& operator * ()                   const { return *p;  }
+   const T* operator -> ()                  const { return p;   }
+   const T& operator [] (difference_type n) const { return p[n];}
+
+   // increment and decrement
+   const_iterator& operator ++ ()    { ++p; return *this; }
+   const_iterator  operator ++ (int) { const_iterator temp(*this); ++p; return temp; }
+   const_iterator& operator -- ()    { --p; return *this; }
+   const_iterator  operator -- (int) { const_iterator temp(*this); --p; return temp; }
+
+   // jump by n
+   const_iterator& operator += (difference_type n) { p += n; return *this; }
+   const_iterator& operator -= (difference_type n) { p -= n; return *this; }
+   const_iterator  operator +  (difference_type n) const { return const_iterator(p + n); }
+   const_iterator  operator -  (difference_type n) const { return const_iterator(p - n); }
+   friend const_iterator operator + (difference_type n, const const_iterator& it) { return it + n; }
+
+   // distance between two iterators
+   difference_type operator - (const const_iterator& rhs) const { return p - rhs.p; }
+
 private:
-   T* p;
+   const T* p; // pointer being encapsulated
 };
 
 /*****************************************
- * VECTOR :: DEFAULT constructors
- * Default constructor: set the number of elements,
- * construct each element, and copy the values over
+ * VECTOR :: ALLOCATE
+ * Get raw storage for num elements. Nothing is
+ * constructed: only [0, numElements) ever is.
  ****************************************/
-template <typename T>
-vector <T> :: vector()
+template <typename T, typename A, typename G>
+T * vector <T, A, G> :: allocate(size_t num)
 {
-   data = new T[10];
-   numCapacity = 99;
-   numElements = 99;
+#ifdef __linux__
+   if (isMapped(num))
+   {
+      void * p = mmap(nullptr, mapBytes(num), PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p == MAP_FAILED)
+         throw std::bad_alloc();
+      return static_cast<T *>(p);
+   }
+#endif
+   return (num == 0) ? nullptr : AllocTraits::allocate(alloc, num);
 }
 
 /*****************************************
- * VECTOR :: NON-DEFAULT constructors
- * non-default constructor: set the number of elements,
- * construct each element, and copy the values over
+ * VECTOR :: DEALLOCATE
+ * Give raw storage back. The elements must
+ * already have been destroyed.
  ****************************************/
-template <typename T>
-vector <T> :: vector(size_t num, const T & t) 
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: deallocate(T * p, size_t num)
 {
-   data = new T[10];
-   numCapacity = 99;
-   numElements = 99;
+#ifdef __linux__
+   if (isMapped(num))
+   {
+      munmap(p, mapBytes(num));
+      return;
+   }
+#endif
+   if (p != nullptr)
+      AllocTraits::deallocate(alloc, p, num);
 }
 
 /*****************************************
- * VECTOR :: INITIALIZATION LIST constructors
- * Create a vector with an initialization list.
+ * VECTOR :: MAP BYTES
+ * The size of a mapped buffer of num elements,
+ * rounded up to whole pages
  ****************************************/
-template <typename T>
-vector <T> :: vector(const std::initializer_list<T> & l) 
+template <typename T, typename A, typename G>
+size_t vector <T, A, G> :: mapBytes(size_t num)
 {
-   data = new T[10];
-   numCapacity = 99;
-   numElements = 99;
+#ifdef __linux__
+   static const size_t pageSize = sysconf(_SC_PAGESIZE);
+#else
+   static const size_t pageSize = 4096;
+#endif
+   return (num * sizeof(T) + pageSize - 1) / pageSize * pageSize;
 }
 
 /*****************************************
- * VECTOR :: NON-DEFAULT constructors
- * non-default constructor: set the number of elements,
- * construct each element, and copy the values over
+ * VECTOR :: RELEASE
+ * Destroy every element and give the buffer back,
+ * leaving an empty vector with no capacity
  ****************************************/
-template <typename T>
-vector <T> :: vector(size_t num) 
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: release()
 {
-   data = new T[10];
-   numCapacity = 99;
-   numElements = 99;
+   destroy(data, data + numElements);
+   deallocate(data, numCapacity);
+   data = nullptr;
+   numCapacity = 0;
+   numElements = 0;
 }
 
 /*****************************************
- * VECTOR :: COPY CONSTRUCTOR
- * Allocate the space for numElements and
- * call the copy constructor on each element
+ * VECTOR :: UNINITIALIZED FILL
+ * Construct [first, last) in raw storage from args:
+ * nothing means value-initialize, one value means copy.
+ * If one constructor throws, the ones before it are undone.
+ * A huge range is split across threads.
  ****************************************/
-template <typename T>
-vector <T> :: vector (const vector & rhs) 
+template <typename T, typename A, typename G>
+template <class ... Args>
+void vector <T, A, G> :: uninitializedFill(T * first, T * last, const Args & ... args)
 {
-   data = new T[10];
-   numCapacity = 99;
-   numElements = 99;
+   if (isParallel(last - first))
+   {
+      constructInParallel(first, last - first, [&](T * begin, T * end)
+      {
+         uninitializedFill(begin, end, args...);
+      });
+      return;
+   }
+
+   T * p = first;
+   try
+   {
+      for (; p != last; ++p)
+         AllocTraits::construct(alloc, p, args...);
+   }
+   catch (...)
+   {
+      destroy(first, p);
+      throw;
+   }
 }
 
 /*****************************************
- * VECTOR :: MOVE CONSTRUCTOR
- * Steal the values from the RHS and set it to zero.
+ * VECTOR :: UNINITIALIZED COPY
+ * Copy-construct [first, last) into the raw storage at dest.
+ * A huge copy from another buffer is split across threads.
  ****************************************/
-template <typename T>
-vector <T> :: vector (vector && rhs)
+template <typename T, typename A, typename G>
+template <class InputIterator>
+void vector <T, A, G> :: uninitializedCopy(InputIterator first, InputIterator last, T * dest)
 {
-   data = new T[10];
-   numCapacity = 99;
-   numElements = 99;
+   if constexpr (std::is_pointer<InputIterator>::value)
+   {
+      if (isParallel(last - first))
+      {
+         constructInParallel(dest, last - first, [&](T * begin, T * end)
+         {
+            uninitializedCopy(first + (begin - dest), first + (end - dest), begin);
+         });
+         return;
+      }
+   }
+
+   T * p = dest;
+   try
+   {
+      for (; first != last; ++first, ++p)
+         AllocTraits::construct(alloc, p, *first);
+   }
+   catch (...)
+   {
+      destroy(dest, p);
+      throw;
+   }
 }
 
 /*****************************************
- * VECTOR :: DESTRUCTOR
- * Call the destructor for each element from 0..numElements
- * and then free the memory
+ * VECTOR :: CONSTRUCT IN PARALLEL
+ * Split [first, first + num) into one contiguous piece per
+ * thread and have construct(begin, end) build each piece on
+ * the thread pool. A fresh buffer has no physical pages yet,
+ * so each page is first touched, and therefore placed, by the
+ * thread that will fill it. If any piece throws, the pieces
+ * that finished are destroyed and the exception is rethrown;
+ * the piece that threw has already undone itself.
  ****************************************/
-template <typename T>
-vector <T> :: ~vector()
+template <typename T, typename A, typename G>
+template <class Construct>
+void vector <T, A, G> :: constructInParallel(T * first, size_t num, Construct construct)
 {
-   
+   size_t numPieces = parallelism::settings().threads;
+   std::unique_ptr<bool[]> built(new bool[numPieces]());
+   auto begin = [&](size_t i) { return first + num * i / numPieces; };
+
+   try
+   {
+      thread_pool::shared().run(numPieces, [&](size_t i)
+      {
+         construct(begin(i), begin(i + 1));
+         built[i] = true;
+      });
+   }
+   catch (...)
+   {
+      for (size_t i = 0; i < numPieces; i++)
+         if (built[i])
+            destroy(begin(i), begin(i + 1));
+      throw;
+   }
 }
 
-/***************************************
- * VECTOR :: RESIZE
- * This method will adjust the size to newElements.
- * This will either grow or shrink newElements.
- *     INPUT  : newCapacity the size of the new buffer
- *     OUTPUT :
- **************************************/
-template <typename T>
-void vector <T> :: resize(size_t newElements)
+/*****************************************
+ * VECTOR :: DESTROY
+ * Call the destructor on [first, last), leaving raw storage
+ ****************************************/
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: destroy(T * first, T * last)
 {
-   
+   for (; first != last; ++first)
+      AllocTraits::destroy(alloc, first);
 }
 
-template <typename T>
-void vector <T> :: resize(size_t newElements, const T & t)
+/*****************************************
+ * VECTOR :: RELOCATE
+ * Move [first, last) into the raw storage at dest and
+ * destroy the originals. Trivially relocatable types take
+ * one memcpy, types with a noexcept move are moved, and
+ * everything else is copied so a throw leaves the source intact.
+ ****************************************/
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: relocate(T * first, T * last, T * dest)
 {
-   
+   if constexpr (is_trivially_relocatable<T>::value)
+   {
+      if (first != last)
+         std::memcpy(static_cast<void *>(dest), static_cast<const void *>(first),
+                     (last - first) * sizeof(T));
+   }
+   else if constexpr (relocateByMove)
+   {
+      for (T * p = first; p != last; ++p, ++dest)
+         AllocTraits::construct(alloc, dest, std::move(*p));
+      destroy(first, last);
+   }
+   else
+   {
+      uninitializedCopy(first, last, dest);
+      destroy(first, last);
+   }
 }
 
-/***************************************
- * VECTOR :: RESERVE
- * This method will grow the current buffer
- * to newCapacity.  It will also copy all
- * the data from the old buffer into the new
- *     INPUT  : newCapacity the size of the new buffer
- *     OUTPUT :
- **************************************/
-template <typename T>
-void vector <T> :: reserve(size_t newCapacity)
+/*****************************************
+ * VECTOR :: RELOCATE AROUND
+ * Relocate the live elements into newData, leaving a gap
+ * of count raw slots at index. If a copy throws, whatever
+ * was built in newData is destroyed and the source stays whole.
+ ****************************************/
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: relocateAround(T * newData, size_t index, size_t count)
 {
-   numCapacity = 99;
+   if constexpr (relocateByMove)
+   {
+      relocate(data, data + index, newData);
+      relocate(data + index, data + numElements, newData + index + count);
+   }
+   else
+   {
+      uninitializedCopy(data, data + index, newData);
+      try
+      {
+         uninitializedCopy(data + index, data + numElements, newData + index + count);
+      }
+      catch (...)
+      {
+         destroy(newData, newData + index);
+         throw;
+      }
+      destroy(data, data + numElements);
+   }
 }
 
-/***************************************
- * VECTOR :: SHRINK TO FIT
- * Get rid of any extra capacity
- *     INPUT  :
- *     OUTPUT :
- **************************************/
-template <typename T>
-void vector <T> :: shrink_to_fit()
+/*****************************************
+ * VECTOR :: REALLOCATE
+ * Relocate the live elements into a new buffer of
+ * exactly newCapacity and free the old one
+ ****************************************/
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: reallocate(size_t newCapacity)
 {
-   
-}
+   assert(newCapacity >= numElements);
+
+#ifdef __linux__
+   // both buffers are mappings: let the kernel move the pages
+   if (isMapped(numCapacity) && isMapped(newCapacity))
+   {
+      void * p = mremap(data, mapBytes(numCapacity), mapBytes(newCapacity), MREMAP_MAYMOVE);
+      if (p == MAP_FAILED)
+         throw std::bad_alloc();
+      data = static_cast<T *>(p);
+      numCapacity = newCapacity;
+      return;
+   }
+#endif
+
+   // allocate new buffer
+   T * newData = allocate(newCapacity);
 
+   // relocate existing elements
+   try
+   {
+      relocate(data, data + numElements, newData);
+   }
+   catch (...)
+   {
+      deallocate(newData, newCapacity);
+      throw;
+   }
 
+   // clean up old buffer
+   deallocate(data, numCapacity);
+
+   // update pointers and capacity
+   data = newData;
+   numCapacity = newCapacity;
+}
 
 /*****************************************
- * VECTOR :: SUBSCRIPT
- * Read-Write access
+ * VECTOR :: REALLOCATE EMPLACE
+ * Grow to the next capacity with a new element built
+ * from args at index. The element is constructed before
+ * anything moves, so args may refer into this vector.
+ * Returns the address of the new element.
  ****************************************/
-template <typename T>
-T & vector <T> :: operator [] (size_t index)
+template <typename T, typename A, typename G>
+template <class ... Args>
+T * vector <T, A, G> :: reallocateEmplace(size_t index, Args&& ... args)
 {
-   return *(new T);
-   
-}
+   size_t newCapacity = nextCapacity(numElements + 1);
 
-/******************************************
- * VECTOR :: SUBSCRIPT
- * Read-Write access
- *****************************************/
-template <typename T>
-const T & vector <T> :: operator [] (size_t index) const
-{
-   return *(new T);
+   // a mapped buffer grows in place, so build the element first:
+   // args may refer into the pages about to be remapped
+   if constexpr (canMap)
+   {
+      if (isMapped(numCapacity))
+      {
+         T t(std::forward<Args>(args)...);
+         reallocate(newCapacity);
+         std::memmove(static_cast<void *>(data + index + 1),
+                      static_cast<const void *>(data + index),
+                      (numElements - index) * sizeof(T));
+         AllocTraits::construct(alloc, data + index, std::move(t));
+         ++numElements;
+         return data + index;
+      }
+   }
+
+   T * newData = allocate(newCapacity);
+   T * pNew = newData + index;
+
+   // construct the new element in its final place
+   try
+   {
+      AllocTraits::construct(alloc, pNew, std::forward<Args>(args)...);
+   }
+   catch (...)
+   {
+      deallocate(newData, newCapacity);
+      throw;
+   }
+
+   // relocate the elements on either side of it
+   try
+   {
+      relocateAround(newData, index, 1);
+   }
+   catch (...)
+   {
+      AllocTraits::destroy(alloc, pNew);
+      deallocate(newData, newCapacity);
+      throw;
+   }
+
+   // clean up old buffer
+   deallocate(data, numCapacity);
+   data = newData;
+   numCapacity = newCapacity;
+   ++numElements;
+   return pNew;
 }
 
 /*****************************************
- * VECTOR :: FRONT
- * Read-Write access
+ * VECTOR :: DEFAULT constructors
+ * Default constructor: set the number of elements,
+ * construct each element, and copy the values over
  ****************************************/
-template <typename T>
-T & vector <T> :: front ()
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector() : alloc()
 {
-   
-   return *(new T);
+   data = nullptr;
+   numCapacity = 0;
+   numElements = 0;
 }
 
-/******************************************
- * VECTOR :: FRONT
- * Read-Write access
- *****************************************/
-template <typename T>
-const T & vector <T> :: front () const
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector(const A & a) : alloc(a)
 {
-   return *(new T);
+   data = nullptr;
+   numCapacity = 0;
+   numElements = 0;
 }
 
 /*****************************************
- * VECTOR :: FRONT
- * Read-Write access
+ * VECTOR :: NON-DEFAULT constructors
+ * non-default constructor: set the number of elements,
+ * construct each element, and copy the values over
  ****************************************/
-template <typename T>
-T & vector <T> :: back()
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector(size_t num, const T & t, const A & a) : alloc(a)
 {
-   return *(new T);
+   data = allocate(num);
+   numCapacity = num;
+   numElements = num;
+
+   try
+   {
+      uninitializedFill(data, data + num, t); // copy-initialize
+   }
+   catch (...)
+   {
+      deallocate(data, num);
+      throw;
+   }
 }
 
-/******************************************
- * VECTOR :: FRONT
- * Read-Write access
- *****************************************/
-template <typename T>
-const T & vector <T> :: back() const
+/*****************************************
+ * VECTOR :: INITIALIZATION LIST constructors
+ * Create a vector with an initialization list.
+ ****************************************/
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector(const std::initializer_list<T> & l, const A & a) : alloc(a)
+{
+   numElements = l.size();
+   numCapacity = numElements;
+   data = allocate(numCapacity);
+
+   try
+   {
+      uninitializedCopy(l.begin(), l.end(), data);
+   }
+   catch (...)
+   {
+      deallocate(data, numCapacity);
+      throw;
+   }
+}
+
+/*****************************************
+ * VECTOR :: NON-DEFAULT constructors
+ * non-default constructor: set the number of elements,
+ * construct each element, and copy the values over
+ ****************************************/
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector(size_t num, const A & a) : alloc(a)
+{
+   data = allocate(num);
+   numCapacity = num;
+   numElements = num;
+
+   try
+   {
+      uninitializedFill(data, data + num); // default-initialize
+   }
+   catch (...)
+   {
+      deallocate(data, num);
+      throw;
+   }
+}
+
+/*****************************************
+ * VECTOR :: COPY CONSTRUCTOR
+ * Allocate the space for numElements and
+ * call the copy constructor on each element.
+ * The allocator decides what its copy should be.
+ ****************************************/
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector (const vector & rhs) :
+   vector(rhs, AllocTraits::select_on_container_copy_construction(rhs.alloc))
+{
+}
+
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector (const vector & rhs, const A & a) : alloc(a)
+{
+   numElements = rhs.numElements;
+   numCapacity = rhs.numElements;
+   data = allocate(numCapacity);
+
+   try
+   {
+      uninitializedCopy(rhs.data, rhs.data + numElements, data);
+   }
+   catch (...)
+   {
+      deallocate(data, numCapacity);
+      throw;
+   }
+}
+
+/*****************************************
+ * VECTOR :: MOVE CONSTRUCTOR
+ * Steal the values from the RHS and set it to zero.
+ ****************************************/
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector (vector && rhs) : alloc(std::move(rhs.alloc))
+{
+   data = rhs.data;
+   numCapacity = rhs.numCapacity;
+   numElements = rhs.numElements;
+	rhs.data = nullptr;
+	rhs.numCapacity = 0;
+	rhs.numElements = 0;
+
+}
+
+/*****************************************
+ * VECTOR :: MOVE CONSTRUCTOR
+ * Steal the buffer if our allocator can free it.
+ * Otherwise, move the elements one at a time into
+ * a buffer of our own.
+ ****************************************/
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector (vector && rhs, const A & a) : alloc(a)
+{
+   data = nullptr;
+   numCapacity = 0;
+   numElements = 0;
+
+   if (AllocTraits::is_always_equal::value || alloc == rhs.alloc)
+      swap(rhs);
+   else
+   {
+      reserve(rhs.numElements);
+      for (size_t i = 0; i < rhs.numElements; ++i)
+         emplace_back(std::move(rhs.data[i]));
+   }
+}
+
+/*****************************************
+ * VECTOR :: DESTRUCTOR
+ * Call the destructor for each element from 0..numElements
+ * and then free the memory
+ ****************************************/
+template <typename T, typename A, typename G>
+vector <T, A, G> :: ~vector()
 {
-   return *(new T);
+   release();
+}
+
+/***************************************
+ * VECTOR :: RESIZE
+ * This method will adjust the size to newElements.
+ * This will either grow or shrink newElements.
+ *     INPUT  : newCapacity the size of the new buffer
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: resize(size_t newElements)
+{
+    if (newElements < numElements)
+   {
+      destroy(data + newElements, data + numElements);
+      numElements = newElements;
+   }
+   else if (newElements > numElements)
+   {
+      if (newElements > numCapacity)
+         reserve(newElements);
+      uninitializedFill(data + numElements, data + newElements);
+      numElements = newElements;
+   }
+
+}
+
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: resize(size_t newElements, const T & t)
+{
+    if (newElements < numElements)
+   {
+      destroy(data + newElements, data + numElements);
+      numElements = newElements;
+   }
+   else if (newElements > numElements)
+   {
+      if (newElements > numCapacity)
+         reserve(newElements);
+      uninitializedFill(data + numElements, data + newElements, t);
+      numElements = newElements;
+	}
+
+}
+
+/***************************************
+ * VECTOR :: RESERVE
+ * This method will grow the current buffer
+ * to newCapacity.  It will also relocate all
+ * the data from the old buffer into the new.
+ * Only the numElements live items are constructed
+ * in the new buffer; the rest stays raw.
+ *     INPUT  : newCapacity the size of the new buffer
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: reserve(size_t newCapacity)
+{
+   if (newCapacity <= numCapacity)
+      return; // no need to grow
+
+   reallocate(newCapacity);
+
+}
+
+/***************************************
+ * VECTOR :: SHRINK TO FIT
+ * Get rid of any extra capacity
+ *     INPUT  :
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: shrink_to_fit()
+{
+    if (numElements == numCapacity)
+      return;
+   if (numElements == 0)
+   {
+      deallocate(data, numCapacity);
+      data = nullptr;
+      numCapacity = 0;
+      return;
+   }
+   reallocate(numElements);
+
+}
+
+
+
+/*****************************************
+ * VECTOR :: SUBSCRIPT
+ * Read-Write access
+ ****************************************/
+template <typename T, typename A, typename G>
+T & vector <T, A, G> :: operator [] (size_t index)
+{
+   return *(data + index);
+}
+
+/******************************************
+ * VECTOR :: SUBSCRIPT
+ * Read-Write access
+ *****************************************/
+template <typename T, typename A, typename G>
+const T & vector <T, A, G> :: operator [] (size_t index) const
+{
+	return *(data + index);
+}
+
+/*****************************************
+ * VECTOR :: FRONT
+ * Read-Write access
+ ****************************************/
+template <typename T, typename A, typename G>
+T & vector <T, A, G> :: front ()
+{
+
+   return data[0];
+}
+
+/******************************************
+ * VECTOR :: FRONT
+ * Read-Write access
+ *****************************************/
+template <typename T, typename A, typename G>
+const T & vector <T, A, G> :: front () const
+{
+   return data[0];
+}
+
+/*****************************************
+ * VECTOR :: FRONT
+ * Read-Write access
+ ****************************************/
+template <typename T, typename A, typename G>
+T & vector <T, A, G> :: back()
+{
+   return data[numElements - 1];
+}
+
+/******************************************
+ * VECTOR :: FRONT
+ * Read-Write access
+ *****************************************/
+template <typename T, typename A, typename G>
+const T & vector <T, A, G> :: back() const
+{
+   return data[numElements - 1];
 }
 
 /***************************************
@@ -401,41 +1270,941 @@ const T & vector <T> :: back() const
  *     INPUT  : 't' the new element to be added
  *     OUTPUT : *this
  **************************************/
-template <typename T>
-void vector <T> :: push_back (const T & t)
+template <typename T, typename A, typename G>
+void vector <T, A, G> ::push_back(const T& t)
 {
-   
+   emplace_back(t);
 }
 
-template <typename T>
-void vector <T> ::push_back(T && t)
+template <typename T, typename A, typename G>
+void vector <T, A, G> ::push_back(T && t)
+{
+   emplace_back(std::move(t));
+}
+
+/***************************************
+ * VECTOR :: EMPLACE BACK
+ * Construct a new element at the end of the buffer
+ * directly from args: no temporary is built and moved.
+ *     INPUT  : args the constructor parameters of T
+ *     OUTPUT : a reference to the new element
+ **************************************/
+template <typename T, typename A, typename G>
+template <class ... Args>
+T & vector <T, A, G> ::emplace_back(Args&& ... args)
+{
+   if (numElements == numCapacity)
+      return *reallocateEmplace(numElements, std::forward<Args>(args)...);
+
+   AllocTraits::construct(alloc, data + numElements, std::forward<Args>(args)...);
+   ++numElements;
+   return data[numElements - 1];
+}
+
+/***************************************
+ * VECTOR :: EMPLACE
+ * Construct a new element from args just before pos,
+ * shifting the later elements back one slot.
+ * When the buffer must grow, the element is built in
+ * place in the new buffer. Otherwise a middle insert
+ * builds it first and moves it into the opened slot,
+ * because args may refer to an element being shifted.
+ *     INPUT  : pos  where the new element goes
+ *              args the constructor parameters of T
+ *     OUTPUT : an iterator to the new element
+ **************************************/
+template <typename T, typename A, typename G>
+template <class ... Args>
+typename vector <T, A, G> ::iterator vector <T, A, G> ::emplace(iterator pos, Args&& ... args)
 {
-   
-   
+   size_t index = (pos.p == nullptr) ? 0 : pos.p - data;
+   assert(index <= numElements);
+
+   if (numElements == numCapacity)
+      return iterator(reallocateEmplace(index, std::forward<Args>(args)...));
+
+   if (index == numElements)
+   {
+      AllocTraits::construct(alloc, data + numElements, std::forward<Args>(args)...);
+      ++numElements;
+      return iterator(data + index);
+   }
+
+   T t(std::forward<Args>(args)...);
+   AllocTraits::construct(alloc, data + numElements, std::move(data[numElements - 1]));
+   ++numElements;
+   std::move_backward(data + index, data + numElements - 2, data + numElements - 1);
+   data[index] = std::move(t);
+   return iterator(data + index);
+}
+
+/***************************************
+ * VECTOR :: INSERT
+ * Insert copies of [first, last) just before pos.
+ * A forward range is measured first so the buffer grows
+ * at most once and the tail shifts back exactly once:
+ * with one memmove when T is trivially relocatable.
+ * A single-pass range is appended and rotated into place.
+ *     INPUT  : pos         where the new elements go
+ *              first, last the range to copy
+ *     OUTPUT : an iterator to the first new element
+ **************************************/
+template <typename T, typename A, typename G>
+template <class InputIterator>
+typename vector <T, A, G> ::iterator vector <T, A, G> ::insert(iterator pos,
+                                                  InputIterator first,
+                                                  InputIterator last)
+{
+   size_t index = indexOf(pos);
+   assert(index <= numElements);
+
+   if constexpr (!isForward<InputIterator>)
+   {
+      size_t oldElements = numElements;
+      for (; first != last; ++first)
+         emplace_back(*first);
+      std::rotate(data + index, data + oldElements, data + numElements);
+      return iterator(data + index);
+   }
+   else
+   {
+      size_t count = std::distance(first, last);
+      if (count == 0)
+         return iterator(data + index);
+
+      // not enough room: build the new elements in a new buffer
+      if (numElements + count > numCapacity)
+      {
+         size_t newCapacity = nextCapacity(numElements + count);
+         T * newData = allocate(newCapacity);
+         try
+         {
+            uninitializedCopy(first, last, newData + index);
+            try
+            {
+               relocateAround(newData, index, count);
+            }
+            catch (...)
+            {
+               destroy(newData + index, newData + index + count);
+               throw;
+            }
+         }
+         catch (...)
+         {
+            deallocate(newData, newCapacity);
+            throw;
+         }
+         deallocate(data, numCapacity);
+         data = newData;
+         numCapacity = newCapacity;
+         numElements += count;
+         return iterator(data + index);
+      }
+
+      T * pInsert = data + index;
+      T * end = data + numElements;
+      size_t numAfter = numElements - index;
+
+      // trivially relocatable: slide the tail back and copy into the gap
+      if constexpr (is_trivially_relocatable<T>::value)
+      {
+         std::memmove(static_cast<void *>(pInsert + count), static_cast<const void *>(pInsert),
+                      numAfter * sizeof(T));
+         try
+         {
+            uninitializedCopy(first, last, pInsert);
+         }
+         catch (...)
+         {
+            std::memmove(static_cast<void *>(pInsert), static_cast<const void *>(pInsert + count),
+                         numAfter * sizeof(T));
+            throw;
+         }
+         numElements += count;
+      }
+      // the tail is longer than the range: some of it moves into raw
+      // storage and the rest slides back over live elements
+      else if (numAfter > count)
+      {
+         uninitializedCopy(std::make_move_iterator(end - count),
+                           std::make_move_iterator(end), end);
+         numElements += count;
+         std::move_backward(pInsert, end - count, end);
+         std::copy(first, last, pInsert);
+      }
+      // the range is longer than the tail: the whole tail moves into
+      // raw storage, as does the part of the range that reaches past end
+      else
+      {
+         InputIterator mid = first;
+         std::advance(mid, numAfter);
+         uninitializedCopy(mid, last, end);
+         numElements += count - numAfter;
+         uninitializedCopy(std::make_move_iterator(pInsert),
+                           std::make_move_iterator(end), pInsert + count);
+         numElements += numAfter;
+         std::copy(first, mid, pInsert);
+      }
+      return iterator(pInsert);
+   }
+}
+
+/***************************************
+ * VECTOR :: APPEND
+ * Copy [first, last) onto the end, growing at most
+ * once when the range can be measured up front
+ *     INPUT  : first, last the range to copy
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A, typename G>
+template <class InputIterator>
+void vector <T, A, G> ::append(InputIterator first, InputIterator last)
+{
+   if constexpr (isForward<InputIterator>)
+      insert(end(), first, last);
+   else
+      for (; first != last; ++first)
+         emplace_back(*first);
+}
+
+/***************************************
+ * VECTOR :: ASSIGN
+ * Replace the contents with copies of [first, last),
+ * reusing the buffer when it is already big enough
+ *     INPUT  : first, last the range to copy
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A, typename G>
+template <class InputIterator>
+void vector <T, A, G> ::assign(InputIterator first, InputIterator last)
+{
+   if constexpr (!isForward<InputIterator>)
+   {
+      clear();
+      for (; first != last; ++first)
+         emplace_back(*first);
+   }
+   else
+   {
+      size_t count = std::distance(first, last);
+      if (count > numCapacity)
+      {
+         // allocate new buffer
+         T * newData = allocate(count);
+         try
+         {
+            uninitializedCopy(first, last, newData);
+         }
+         catch (...)
+         {
+            deallocate(newData, count);
+            throw;
+         }
+         destroy(data, data + numElements);
+         deallocate(data, numCapacity);
+         data = newData;
+         numCapacity = count;
+         numElements = count;
+      }
+      else if (count > numElements)
+      {
+         // assign over the live elements, construct into the raw tail
+         InputIterator mid = first;
+         std::advance(mid, numElements);
+         std::copy(first, mid, data);
+         uninitializedCopy(mid, last, data + numElements);
+         numElements = count;
+      }
+      else
+      {
+         // assign over the first count, destroy the leftovers
+         std::copy(first, last, data);
+         destroy(data + count, data + numElements);
+         numElements = count;
+      }
+   }
+}
+
+/***************************************
+ * VECTOR :: ERASE
+ * Remove [first, last), closing the gap with one pass
+ * over the tail: a memmove when T is trivially relocatable
+ *     INPUT  : first, last the elements to remove
+ *     OUTPUT : an iterator to the element after the last removed
+ **************************************/
+template <typename T, typename A, typename G>
+typename vector <T, A, G> ::iterator vector <T, A, G> ::erase(iterator first, iterator last)
+{
+   size_t iFirst = indexOf(first);
+   size_t iLast  = indexOf(last);
+   assert(iFirst <= iLast && iLast <= numElements);
+   if (iFirst == iLast)
+      return iterator(data + iFirst);
+
+   size_t numAfter = numElements - iLast;
+   if constexpr (is_trivially_relocatable<T>::value)
+   {
+      destroy(data + iFirst, data + iLast);
+      std::memmove(static_cast<void *>(data + iFirst), static_cast<const void *>(data + iLast),
+                   numAfter * sizeof(T));
+   }
+   else
+   {
+      std::move(data + iLast, data + numElements, data + iFirst);
+      destroy(data + iFirst + numAfter, data + numElements);
+   }
+   numElements -= iLast - iFirst;
+   return iterator(data + iFirst);
 }
 
 /***************************************
  * VECTOR :: ASSIGNMENT
  * This operator will copy the contents of the
- * rhs onto *this, growing the buffer as needed
+ * rhs onto *this, growing the buffer as needed.
+ * If the allocator propagates on copy, our buffer must
+ * go back to the old allocator before we take the new one.
  *     INPUT  : rhs the vector to copy from
  *     OUTPUT : *this
  **************************************/
-template <typename T>
-vector <T> & vector <T> :: operator = (const vector & rhs)
+template <typename T, typename A, typename G>
+vector <T, A, G> & vector <T, A, G> :: operator = (const vector & rhs)
+{
+
+   if (this == &rhs)
+      return *this;
+
+   if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
+   {
+      if (!AllocTraits::is_always_equal::value && alloc != rhs.alloc)
+         release();
+      alloc = rhs.alloc;
+   }
+
+   if (numCapacity >= rhs.numElements)
+   {
+      // reuse existing buffer: assign over the live elements,
+      // construct into the raw tail, and destroy the leftovers
+      size_t numCommon = (numElements < rhs.numElements) ? numElements : rhs.numElements;
+      for (size_t i = 0; i < numCommon; ++i)
+         data[i] = rhs.data[i];
+      uninitializedCopy(rhs.data + numCommon, rhs.data + rhs.numElements, data + numCommon);
+      if (rhs.numElements < numElements)
+         destroy(data + rhs.numElements, data + numElements);
+
+      numElements = rhs.numElements;
+      // keep numCapacity unchanged
+   }
+   else
+   {
+      // allocate new buffer
+      T * newData = allocate(rhs.numElements);
+      try
+      {
+         uninitializedCopy(rhs.data, rhs.data + rhs.numElements, newData);
+      }
+      catch (...)
+      {
+         deallocate(newData, rhs.numElements);
+         throw;
+      }
+
+      destroy(data, data + numElements);
+      deallocate(data, numCapacity);
+      data = newData;
+      numCapacity = rhs.numElements;
+      numElements = rhs.numElements;
+   }
+
+   return *this;
+
+
+
+}
+/***************************************
+ * VECTOR :: MOVE ASSIGNMENT
+ * Steal the buffer of rhs. That is only possible when
+ * the allocator comes along or the two allocators are
+ * interchangeable; otherwise the elements are moved over
+ *     INPUT  : rhs the vector to move from
+ *     OUTPUT : *this
+ **************************************/
+template <typename T, typename A, typename G>
+vector <T, A, G>& vector <T, A, G> :: operator = (vector&& rhs)
 {
-   
+
+   if (this == &rhs)
+      return *this; // protect against self-assignment
+
+   if constexpr (!AllocTraits::propagate_on_container_move_assignment::value &&
+                 !AllocTraits::is_always_equal::value)
+   {
+      if (alloc != rhs.alloc)
+      {
+         assign(std::make_move_iterator(rhs.data),
+                std::make_move_iterator(rhs.data + rhs.numElements));
+         rhs.clear();
+         return *this;
+      }
+   }
+
+   // Clean up existing data
+   release();
+   if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+      alloc = std::move(rhs.alloc);
+
+   // Steal resources
+   data = rhs.data;
+   numElements = rhs.numElements;
+   numCapacity = rhs.numCapacity;
+
+   // Leave rhs in a valid empty state
+   rhs.data = nullptr;
+   rhs.numElements = 0;
+   rhs.numCapacity = 0;
+
    return *this;
+
 }
-template <typename T>
-vector <T>& vector <T> :: operator = (vector&& rhs)
+
+
+
+
+/*****************************************
+ * SMALL VECTOR
+ * A vector that keeps its first N elements inside the
+ * object itself and only goes to the heap when it outgrows
+ * them. Most vectors are small, so most never allocate.
+ * It shares vector's iterators and interface.
+ ****************************************/
+template <typename T, size_t N>
+class small_vector
+{
+   static_assert(N > 0, "a small_vector needs room for at least one element");
+   friend class ::TestSmallVector; // give unit tests access to the privates
+   typedef std::allocator<T> Alloc;
+   typedef std::allocator_traits<Alloc> AllocTraits;
+public:
+   typedef typename vector <T> ::iterator               iterator;
+   typedef typename vector <T> ::const_iterator         const_iterator;
+   typedef typename vector <T> ::reverse_iterator       reverse_iterator;
+   typedef typename vector <T> ::const_reverse_iterator const_reverse_iterator;
+
+   //
+   // Construct
+   //
+
+   small_vector() : data(inlineData()), numCapacity(N), numElements(0) {}
+   small_vector(size_t num);
+   small_vector(size_t num, const T & t);
+   small_vector(const std::initializer_list<T> & l);
+   small_vector(const small_vector &  rhs);
+   small_vector(      small_vector && rhs);
+   ~small_vector() { release(); }
+
+   //
+   // Assign
+   //
+
+   small_vector & operator = (const small_vector &  rhs);
+   small_vector & operator = (      small_vector && rhs);
+   void swap(small_vector & rhs);
+   template <class InputIterator>
+   void assign(InputIterator first, InputIterator last)
+   {
+      clear();
+      append(first, last);
+   }
+
+   //
+   // Iterator
+   //
+
+   iterator       begin()        { return iterator(data);                     }
+   iterator       end()          { return iterator(data + numElements);       }
+   const_iterator begin()  const { return const_iterator(data);               }
+   const_iterator end()    const { return const_iterator(data + numElements); }
+   const_iterator cbegin() const { return begin();                            }
+   const_iterator cend()   const { return end();                              }
+   reverse_iterator       rbegin()        { return reverse_iterator(end());         }
+   reverse_iterator       rend()          { return reverse_iterator(begin());       }
+   const_reverse_iterator rbegin()  const { return const_reverse_iterator(end());   }
+   const_reverse_iterator rend()    const { return const_reverse_iterator(begin()); }
+
+   //
+   // Access
+   //
+
+         T & operator [] (size_t index)       { return data[index];           }
+   const T & operator [] (size_t index) const { return data[index];           }
+         T & front()                          { return data[0];               }
+   const T & front()                    const { return data[0];               }
+         T & back()                           { return data[numElements - 1]; }
+   const T & back()                     const { return data[numElements - 1]; }
+
+   //
+   // Insert
+   //
+
+   void push_back(const T & t) { emplace_back(t);            }
+   void push_back(T && t)      { emplace_back(std::move(t)); }
+   template <class ... Args>
+   T & emplace_back(Args && ... args);
+   template <class ... Args>
+   iterator emplace(iterator pos, Args && ... args);
+   template <class InputIterator>
+   iterator insert(iterator pos, InputIterator first, InputIterator last);
+   template <class InputIterator>
+   void append(InputIterator first, InputIterator last);
+   void reserve(size_t newCapacity);
+   void resize(size_t newElements);
+   void resize(size_t newElements, const T & t);
+
+   //
+   // Remove
+   //
+
+   void clear()
+   {
+      destroy(data, data + numElements);
+      numElements = 0;
+   }
+   void pop_back()
+   {
+      if (numElements > 0)
+         AllocTraits::destroy(alloc, data + --numElements);
+   }
+   iterator erase(iterator first, iterator last);
+   void shrink_to_fit();
+
+   //
+   // Status
+   //
+
+   size_t size()     const { return numElements; }
+   size_t capacity() const { return numCapacity; }
+   bool   empty()    const { return numElements == 0; }
+
+private:
+
+   // the inline buffer, and are we using it right now?
+   T *       inlineData()       { return reinterpret_cast<T *>(buffer);       }
+   const T * inlineData() const { return reinterpret_cast<const T *>(buffer); }
+   bool      isInline()   const { return data == inlineData();                }
+
+   // construct, destroy, and move elements within raw storage
+   template <class ... Args>
+   void uninitializedFill(T * first, T * last, const Args & ... args);
+   void destroy(T * first, T * last);
+   void relocate(T * first, T * last, T * dest);
+
+   // move into a buffer of newCapacity: the inline one if it fits
+   void reallocate(size_t newCapacity);
+   size_t nextCapacity(size_t numNeeded) const
+   {
+      return (numCapacity * 2 > numNeeded) ? numCapacity * 2 : numNeeded;
+   }
+
+   // destroy everything and go back to the empty inline buffer
+   void release();
+
+   // take the elements of rhs, stealing its heap buffer if it has one
+   void steal(small_vector & rhs);
+
+   alignas(T) unsigned char buffer[N * sizeof(T)]; // the inline elements
+   Alloc   alloc;             // source of the heap buffer, once we spill
+   T *     data;              // either the inline buffer or the heap
+   size_t  numCapacity;       // N while inline
+   size_t  numElements;       // the number of items currently used
+};
+
+/*****************************************
+ * SMALL VECTOR :: NON-DEFAULT constructors
+ * Start inline; spill to the heap only if num > N
+ ****************************************/
+template <typename T, size_t N>
+small_vector <T, N> :: small_vector(size_t num) : small_vector()
 {
+   reserve(num);
+   uninitializedFill(data, data + num);
+   numElements = num;
+}
 
+template <typename T, size_t N>
+small_vector <T, N> :: small_vector(size_t num, const T & t) : small_vector()
+{
+   reserve(num);
+   uninitializedFill(data, data + num, t);
+   numElements = num;
+}
+
+/*****************************************
+ * SMALL VECTOR :: INITIALIZATION LIST constructor
+ ****************************************/
+template <typename T, size_t N>
+small_vector <T, N> :: small_vector(const std::initializer_list<T> & l) : small_vector()
+{
+   append(l.begin(), l.end());
+}
+
+/*****************************************
+ * SMALL VECTOR :: COPY CONSTRUCTOR
+ ****************************************/
+template <typename T, size_t N>
+small_vector <T, N> :: small_vector(const small_vector & rhs) : small_vector()
+{
+   append(rhs.begin(), rhs.end());
+}
+
+/*****************************************
+ * SMALL VECTOR :: MOVE CONSTRUCTOR
+ * A heap buffer is stolen. Inline elements
+ * cannot be: they are moved one at a time.
+ ****************************************/
+template <typename T, size_t N>
+small_vector <T, N> :: small_vector(small_vector && rhs) : small_vector()
+{
+   steal(rhs);
+}
+
+/*****************************************
+ * SMALL VECTOR :: ASSIGNMENT
+ ****************************************/
+template <typename T, size_t N>
+small_vector <T, N> & small_vector <T, N> :: operator = (const small_vector & rhs)
+{
+   if (this != &rhs)
+      assign(rhs.begin(), rhs.end());
    return *this;
 }
 
+template <typename T, size_t N>
+small_vector <T, N> & small_vector <T, N> :: operator = (small_vector && rhs)
+{
+   if (this != &rhs)
+   {
+      release();
+      steal(rhs);
+   }
+   return *this;
+}
 
+/*****************************************
+ * SMALL VECTOR :: SWAP
+ * Two heap buffers trade pointers. When either side
+ * is inline, its elements have to move instead.
+ ****************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: swap(small_vector & rhs)
+{
+   if (this == &rhs)
+      return;
+
+   if (!isInline() && !rhs.isInline())
+   {
+      std::swap(data, rhs.data);
+      std::swap(numCapacity, rhs.numCapacity);
+      std::swap(numElements, rhs.numElements);
+      return;
+   }
 
+   small_vector temp(std::move(rhs));
+   rhs = std::move(*this);
+   *this = std::move(temp);
+}
+
+/*****************************************
+ * SMALL VECTOR :: STEAL
+ * Take the elements of rhs, which is left empty and inline.
+ * We must be empty and inline ourselves.
+ ****************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: steal(small_vector & rhs)
+{
+   assert(isInline() && numElements == 0);
+
+   if (rhs.isInline())
+   {
+      relocate(rhs.data, rhs.data + rhs.numElements, data);
+      numElements = rhs.numElements;
+   }
+   else
+   {
+      data = rhs.data;
+      numCapacity = rhs.numCapacity;
+      numElements = rhs.numElements;
+      rhs.data = rhs.inlineData();
+      rhs.numCapacity = N;
+   }
+   rhs.numElements = 0;
+}
+
+/*****************************************
+ * SMALL VECTOR :: RELEASE
+ ****************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: release()
+{
+   destroy(data, data + numElements);
+   if (!isInline())
+      AllocTraits::deallocate(alloc, data, numCapacity);
+   data = inlineData();
+   numCapacity = N;
+   numElements = 0;
+}
+
+/*****************************************
+ * SMALL VECTOR :: UNINITIALIZED FILL
+ * Construct [first, last) in raw storage from args,
+ * undoing the ones already built if one throws
+ ****************************************/
+template <typename T, size_t N>
+template <class ... Args>
+void small_vector <T, N> :: uninitializedFill(T * first, T * last, const Args & ... args)
+{
+   T * p = first;
+   try
+   {
+      for (; p != last; ++p)
+         AllocTraits::construct(alloc, p, args...);
+   }
+   catch (...)
+   {
+      destroy(first, p);
+      throw;
+   }
+}
+
+/*****************************************
+ * SMALL VECTOR :: DESTROY
+ ****************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: destroy(T * first, T * last)
+{
+   for (; first != last; ++first)
+      AllocTraits::destroy(alloc, first);
+}
+
+/*****************************************
+ * SMALL VECTOR :: RELOCATE
+ * Move [first, last) into raw storage at dest and
+ * destroy the originals: one memcpy when T allows it.
+ * If a copy throws, the ones already built at dest are
+ * destroyed and the originals are left as they were.
+ ****************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: relocate(T * first, T * last, T * dest)
+{
+   if constexpr (is_trivially_relocatable<T>::value)
+   {
+      if (first != last)
+         std::memcpy(static_cast<void *>(dest), static_cast<const void *>(first),
+                     (last - first) * sizeof(T));
+   }
+   else
+   {
+      T * p = first;
+      try
+      {
+         for (; p != last; ++p)
+            AllocTraits::construct(alloc, dest + (p - first), std::move_if_noexcept(*p));
+      }
+      catch (...)
+      {
+         destroy(dest, dest + (p - first));
+         throw;
+      }
+      destroy(first, last);
+   }
+}
+
+/*****************************************
+ * SMALL VECTOR :: REALLOCATE
+ * Move the elements into a heap buffer of newCapacity,
+ * or back into the inline buffer if they fit there
+ ****************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: reallocate(size_t newCapacity)
+{
+   assert(newCapacity >= numElements);
+   bool toInline = newCapacity <= N;
+   if (toInline && isInline())
+      return;
+
+   T * newData = toInline ? inlineData() : AllocTraits::allocate(alloc, newCapacity);
+   try
+   {
+      relocate(data, data + numElements, newData);
+   }
+   catch (...)
+   {
+      if (!toInline)
+         AllocTraits::deallocate(alloc, newData, newCapacity);
+      throw;
+   }
+
+   if (!isInline())
+      AllocTraits::deallocate(alloc, data, numCapacity);
+   data = newData;
+   numCapacity = toInline ? N : newCapacity;
+}
+
+/*****************************************
+ * SMALL VECTOR :: RESERVE
+ ****************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: reserve(size_t newCapacity)
+{
+   if (newCapacity > numCapacity)
+      reallocate(newCapacity);
+}
+
+/*****************************************
+ * SMALL VECTOR :: SHRINK TO FIT
+ * Return to the inline buffer when the elements fit
+ ****************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: shrink_to_fit()
+{
+   if (!isInline() && numElements < numCapacity)
+      reallocate(numElements);
+}
+
+/*****************************************
+ * SMALL VECTOR :: RESIZE
+ ****************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: resize(size_t newElements)
+{
+   if (newElements < numElements)
+      destroy(data + newElements, data + numElements);
+   else
+   {
+      reserve(newElements);
+      uninitializedFill(data + numElements, data + newElements);
+   }
+   numElements = newElements;
+}
+
+template <typename T, size_t N>
+void small_vector <T, N> :: resize(size_t newElements, const T & t)
+{
+   if (newElements < numElements)
+      destroy(data + newElements, data + numElements);
+   else
+   {
+      reserve(newElements);
+      uninitializedFill(data + numElements, data + newElements, t);
+   }
+   numElements = newElements;
+}
+
+/*****************************************
+ * SMALL VECTOR :: EMPLACE BACK
+ * Build the element first so args may refer into us
+ * even when we are about to move to the heap
+ ****************************************/
+template <typename T, size_t N>
+template <class ... Args>
+T & small_vector <T, N> :: emplace_back(Args && ... args)
+{
+   if (numElements == numCapacity)
+   {
+      T t(std::forward<Args>(args)...);
+      reallocate(nextCapacity(numElements + 1));
+      AllocTraits::construct(alloc, data + numElements, std::move(t));
+   }
+   else
+      AllocTraits::construct(alloc, data + numElements, std::forward<Args>(args)...);
+   return data[numElements++];
+}
+
+/*****************************************
+ * SMALL VECTOR :: EMPLACE
+ * Build at the back, then rotate into place
+ ****************************************/
+template <typename T, size_t N>
+template <class ... Args>
+typename small_vector <T, N> ::iterator
+small_vector <T, N> :: emplace(iterator pos, Args && ... args)
+{
+   size_t index = &*pos - data;
+   assert(index <= numElements);
+   emplace_back(std::forward<Args>(args)...);
+   std::rotate(data + index, data + numElements - 1, data + numElements);
+   return iterator(data + index);
+}
+
+/*****************************************
+ * SMALL VECTOR :: INSERT
+ * Copy [first, last) onto the back, then rotate into place
+ ****************************************/
+template <typename T, size_t N>
+template <class InputIterator>
+typename small_vector <T, N> ::iterator
+small_vector <T, N> :: insert(iterator pos, InputIterator first, InputIterator last)
+{
+   size_t index = &*pos - data;
+   assert(index <= numElements);
+   size_t oldElements = numElements;
+   append(first, last);
+   std::rotate(data + index, data + oldElements, data + numElements);
+   return iterator(data + index);
+}
+
+/*****************************************
+ * SMALL VECTOR :: APPEND
+ * A forward range grows the buffer at most once
+ ****************************************/
+template <typename T, size_t N>
+template <class InputIterator>
+void small_vector <T, N> :: append(InputIterator first, InputIterator last)
+{
+   if constexpr (std::is_base_of<std::forward_iterator_tag,
+                 typename std::iterator_traits<InputIterator>::iterator_category>::value)
+   {
+      size_t count = std::distance(first, last);
+      if (numElements + count > numCapacity)
+         reallocate(nextCapacity(numElements + count));
+   }
+   for (; first != last; ++first)
+      emplace_back(*first);
+}
+
+/*****************************************
+ * SMALL VECTOR :: ERASE
+ ****************************************/
+template <typename T, size_t N>
+typename small_vector <T, N> ::iterator
+small_vector <T, N> :: erase(iterator first, iterator last)
+{
+   T * pFirst = &*first;
+   T * pLast  = &*last;
+   T * pEnd   = std::move(pLast, data + numElements, pFirst);
+   destroy(pEnd, data + numElements);
+   numElements = pEnd - data;
+   return iterator(pFirst);
+}
+
+#if __has_include(<memory_resource>)
+namespace pmr
+{
+/*****************************************
+ * PMR VECTOR
+ * A vector whose buffer comes from a std::pmr::memory_resource
+ ****************************************/
+template <typename T>
+using vector = custom::vector <T, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+#endif
+
+/*****************************************
+ * ALIGNED VECTOR
+ * A vector whose buffer always starts on an
+ * Alignment-byte boundary; see aligned_data()
+ ****************************************/
+template <typename T, size_t Alignment = 64>
+using aligned_vector = vector <T, aligned_allocator<T, Alignment>>;
 
 } // namespace custom
 
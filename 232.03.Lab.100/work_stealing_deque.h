@@ -0,0 +1,233 @@
+/***********************************************************************
+ * Header:
+ *    WORK STEALING DEQUE
+ * Summary:
+ *    The deque each worker of a fork-join scheduler keeps its tasks in.
+ *    The worker that owns it pushes and pops at the bottom, LIFO, with
+ *    no lock and, almost always, no atomic read-modify-write. Other
+ *    workers steal from the top, FIFO, where the oldest and usually
+ *    biggest tasks are.
+ *
+ *    This will contain the class definition of:
+ *        work_stealing_deque    : a Chase-Lev deque
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>       // for std::atomic
+#include <cstdint>      // for int64_t
+#include <cstddef>      // for size_t
+#include <type_traits>  // for std::is_trivially_copyable
+
+class TestWorkStealingDeque; // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * WORK STEALING DEQUE
+ * Chase and Lev's circular deque, with the memory
+ * orders of Le, Pop, Cohen and Zappa Nardelli. top
+ * only ever grows, and only by compare-and-swap, so
+ * the owner and a thief racing for the last element
+ * settle it there. bottom is written by the owner
+ * alone.
+ *
+ *    top                 bottom
+ *     v                     v
+ *   [ . . a b c d e . . . . . ]   steal() takes a,
+ *                                 pop() takes e
+ *
+ * When the owner finds the buffer full it copies the
+ * elements into one twice the size. A thief may still
+ * be reading the old one, so old buffers are kept
+ * until the deque is destroyed: together they are
+ * never bigger than the last one.
+ *
+ * T is copied in and out of shared slots as a whole,
+ * so it must be trivially copyable: a task pointer.
+ *************************************************/
+template <class T>
+class work_stealing_deque
+{
+   friend class ::TestWorkStealingDeque; // give unit tests access to the privates
+   static_assert(std::is_trivially_copyable<T>::value,
+                 "a work_stealing_deque holds trivially copyable values, such as pointers");
+
+   struct Buffer
+   {
+      Buffer(int64_t capacity, Buffer * previous) :
+         capacity(capacity), slots(new std::atomic<T>[capacity]), previous(previous) {}
+      ~Buffer() { delete [] slots; }
+
+      T    get(int64_t i) const     { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+      void put(int64_t i, T t)      { slots[i & (capacity - 1)].store(t, std::memory_order_relaxed); }
+
+      int64_t           capacity;   // always a power of two
+      std::atomic<T> *  slots;
+      Buffer *          previous;   // the one this replaced, kept for thieves
+   };
+
+public:
+   explicit work_stealing_deque(size_t capacity = 256);
+   work_stealing_deque(const work_stealing_deque &) = delete;
+   work_stealing_deque & operator = (const work_stealing_deque &) = delete;
+   ~work_stealing_deque();
+
+   //
+   // The owner
+   //
+
+   void push(T t);
+   bool pop(T & t);
+
+   //
+   // Thieves
+   //
+
+   // take the oldest element into t. false if there was none,
+   // or if another thread took it first
+   bool steal(T & t);
+
+   //
+   // Status
+   //
+
+   // how many elements were in the deque a moment ago
+   size_t size() const
+   {
+      int64_t num = bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_relaxed);
+      return num < 0 ? 0 : (size_t)num;
+   }
+   bool empty() const { return size() == 0; }
+
+private:
+   Buffer * grow(Buffer * old, int64_t b, int64_t t);
+
+   alignas(64) std::atomic<int64_t>  top;     // next to steal; thieves write it
+   alignas(64) std::atomic<int64_t>  bottom;  // next to push; the owner writes it
+   std::atomic<Buffer *>             buffer;
+};
+
+/*****************************************
+ * WORK STEALING DEQUE :: CONSTRUCTOR
+ * Room for capacity elements, rounded up to a
+ * power of two so an index wraps with a mask
+ ****************************************/
+template <class T>
+work_stealing_deque <T> :: work_stealing_deque(size_t capacity) : top(0), bottom(0)
+{
+   int64_t num = 2;
+   while ((size_t)num < capacity)
+      num *= 2;
+   buffer.store(new Buffer(num, nullptr), std::memory_order_relaxed);
+}
+
+/*****************************************
+ * WORK STEALING DEQUE :: DESTRUCTOR
+ * Free the buffer and every one it replaced
+ ****************************************/
+template <class T>
+work_stealing_deque <T> :: ~work_stealing_deque()
+{
+   Buffer * b = buffer.load(std::memory_order_relaxed);
+   while (b != nullptr)
+   {
+      Buffer * previous = b->previous;
+      delete b;
+      b = previous;
+   }
+}
+
+/*****************************************
+ * WORK STEALING DEQUE :: PUSH
+ * Write the slot, then publish it by moving bottom.
+ * Only the owner calls this.
+ ****************************************/
+template <class T>
+void work_stealing_deque <T> :: push(T value)
+{
+   int64_t b = bottom.load(std::memory_order_relaxed);
+   int64_t t = top.load(std::memory_order_acquire);
+   Buffer * a = buffer.load(std::memory_order_relaxed);
+   if (b - t > a->capacity - 1)
+      a = grow(a, b, t);
+   a->put(b, value);
+   bottom.store(b + 1, std::memory_order_release);
+}
+
+/*****************************************
+ * WORK STEALING DEQUE :: POP
+ * Claim the bottom slot by moving bottom down, then
+ * look at top. If a thief could be after the same
+ * element, the last one, race it with a
+ * compare-and-swap on top. Only the owner calls this.
+ ****************************************/
+template <class T>
+bool work_stealing_deque <T> :: pop(T & value)
+{
+   int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+   Buffer * a = buffer.load(std::memory_order_relaxed);
+   bottom.store(b, std::memory_order_relaxed);
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+   int64_t t = top.load(std::memory_order_relaxed);
+
+   // empty: put bottom back
+   if (t > b)
+   {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+   }
+
+   value = a->get(b);
+   if (t < b)
+      return true;
+
+   // the last one: whoever moves top first has it
+   bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+   bottom.store(b + 1, std::memory_order_relaxed);
+   return won;
+}
+
+/*****************************************
+ * WORK STEALING DEQUE :: STEAL
+ * Read top, then bottom. If there is something
+ * between them, read it and try to move top past it.
+ ****************************************/
+template <class T>
+bool work_stealing_deque <T> :: steal(T & value)
+{
+   int64_t t = top.load(std::memory_order_acquire);
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+   int64_t b = bottom.load(std::memory_order_acquire);
+   if (t >= b)
+      return false;
+
+   Buffer * a = buffer.load(std::memory_order_acquire);
+   T taken = a->get(t);
+   if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed))
+      return false;
+   value = taken;
+   return true;
+}
+
+/*****************************************
+ * WORK STEALING DEQUE :: GROW
+ * Copy [t, b) into a buffer twice the size, at the
+ * same indices, and publish it. The old one stays
+ * readable for any thief still holding it.
+ ****************************************/
+template <class T>
+typename work_stealing_deque <T> :: Buffer *
+work_stealing_deque <T> :: grow(Buffer * old, int64_t b, int64_t t)
+{
+   Buffer * bigger = new Buffer(old->capacity * 2, old);
+   for (int64_t i = t; i < b; i++)
+      bigger->put(i, old->get(i));
+   buffer.store(bigger, std::memory_order_release);
+   return bigger;
+}
+
+} // namespace custom
@@ -0,0 +1,90 @@
+/***********************************************************************
+ * Header:
+ *    BENCH BITVECTOR
+ * Summary:
+ *    Benchmarks for bitvector
+ ************************************************************************/
+
+#pragma once
+
+#include <random>       // for std::mt19937
+#include "bitvector.h"
+#include "vector.h"
+#include "benchmark.h"
+
+/***************************************************
+ * BENCH BITVECTOR
+ ***************************************************/
+class BenchBitvector : public Benchmark
+{
+public:
+   void run()
+   {
+      bench_count();
+   }
+
+   /***************************************
+    * COUNT
+    * 100M flags, one in a hundred set, as a byte each
+    * and as a bit each: how much memory they take, how
+    * long counting them takes, and how long visiting
+    * each set one takes
+    ***************************************/
+   void bench_count()
+   {
+      const size_t num = 100000000;
+      const int repeat = 10;
+      header("Bitvector", "100M flags, 1% set, counted and visited 10 times");
+
+      custom::vector<bool> bytes(num);
+      custom::bitvector bits(num);
+      std::mt19937 random(232);
+      for (size_t i = 0; i < num; i++)
+         if (random() % 100 == 0)
+         {
+            bytes[i] = true;
+            bits.set(i);
+         }
+
+      row("vector<bool>: memory", (long)(bytes.capacity() * sizeof(bool) / 1024), "KB");
+      row("   bitvector", (long)(bits.bytes() / 1024), "KB");
+
+      row("count: vector<bool> loop", time([&]()
+      {
+         for (int r = 0; r < repeat; r++)
+         {
+            size_t total = 0;
+            for (size_t i = 0; i < num; i++)
+               total += bytes[i];
+            doNotOptimize(total);
+         }
+      }), "ms");
+      row("   bitvector::count", time([&]()
+      {
+         for (int r = 0; r < repeat; r++)
+            doNotOptimize(bits.count());
+      }), "ms");
+
+      row("visit set: vector<bool> loop", time([&]()
+      {
+         for (int r = 0; r < repeat; r++)
+         {
+            size_t last = 0;
+            for (size_t i = 0; i < num; i++)
+               if (bytes[i])
+                  last = i;
+            doNotOptimize(last);
+         }
+      }), "ms");
+      row("   bitvector::find_next", time([&]()
+      {
+         for (int r = 0; r < repeat; r++)
+         {
+            size_t last = 0;
+            for (size_t i = bits.find_first(); i < num; i = bits.find_next(i + 1))
+               last = i;
+            doNotOptimize(last);
+         }
+      }), "ms");
+   }
+};
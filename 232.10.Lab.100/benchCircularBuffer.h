@@ -0,0 +1,99 @@
+/***********************************************************************
+ * Header:
+ *    BENCH CIRCULAR BUFFER
+ * Summary:
+ *    Benchmarks for circular_buffer
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>      // for uint64_t
+#include "circular_buffer.h"
+#include "../232.05.Lab.100/list.h"  // for custom::list, the queue it replaces
+#include "benchmark.h"
+
+/***************************************************
+ * BENCH CIRCULAR BUFFER
+ ***************************************************/
+class BenchCircularBuffer : public Benchmark
+{
+public:
+   void run()
+   {
+      bench_queue();
+   }
+
+   /***************************************
+    * QUEUE
+    * A work queue that holds about 1000 items: push one
+    * on the back, take one off the front, 50M times.
+    * list allocates a node for every push and frees
+    * it on every pop; the circular buffer never does.
+    ***************************************/
+   void bench_queue()
+   {
+      const size_t num = 50000000;
+      const size_t depth = 1000;
+      const size_t batch = 64;
+      header("CircularBuffer", "50M push_back/pop_front pairs, 1000 deep");
+
+      uint64_t sum = 0;
+      double msList = time([&]()
+      {
+         custom::list<uint64_t> queue;
+         for (size_t i = 0; i < depth; i++)
+            queue.push_back(i);
+         for (size_t i = 0; i < num; i++)
+         {
+            queue.push_back(i);
+            sum += queue.front();
+            queue.pop_front();
+         }
+         while (!queue.empty())
+            queue.pop_front();
+      });
+      doNotOptimize(sum);
+      row("list", msList, "ms");
+      row("", num / msList / 1000.0, "M items/s");
+
+      sum = 0;
+      double msRing = time([&]()
+      {
+         custom::circular_buffer<uint64_t> queue(depth + 1);
+         for (size_t i = 0; i < depth; i++)
+            queue.push_back(i);
+         for (size_t i = 0; i < num; i++)
+         {
+            queue.push_back(i);
+            sum += queue.front();
+            queue.pop_front();
+         }
+      });
+      doNotOptimize(sum);
+      row("circular_buffer", msRing, "ms");
+      row("", num / msRing / 1000.0, "M items/s");
+
+      // the same traffic, 64 items at a time
+      sum = 0;
+      double msBulk = time([&]()
+      {
+         custom::circular_buffer<uint64_t> queue(depth + batch);
+         uint64_t in[batch];
+         uint64_t out[batch];
+         for (size_t i = 0; i < depth; i++)
+            queue.push_back(i);
+         for (size_t i = 0; i < num; i += batch)
+         {
+            for (size_t j = 0; j < batch; j++)
+               in[j] = i + j;
+            queue.push_n(in, batch);
+            queue.pop_n(out, batch);
+            for (size_t j = 0; j < batch; j++)
+               sum += out[j];
+         }
+      });
+      doNotOptimize(sum);
+      row("circular_buffer push_n/pop_n", msBulk, "ms");
+      row("", num / msBulk / 1000.0, "M items/s");
+   }
+};
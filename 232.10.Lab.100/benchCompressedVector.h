@@ -0,0 +1,125 @@
+/***********************************************************************
+ * Header:
+ *    BENCH COMPRESSED VECTOR
+ * Summary:
+ *    Benchmarks for compressed_vector
+ ************************************************************************/
+
+#pragma once
+
+#include <random>       // for std::mt19937_64 and std::exponential_distribution
+#include <string>       // for std::string
+#include <cstdint>      // for uint64_t
+#include "compressed_vector.h"
+#include "vector.h"
+#include "benchmark.h"
+
+/***************************************************
+ * BENCH COMPRESSED VECTOR
+ * Each column is 10M values, compressed once, then
+ * decoded 10 times over. GB/s counts the 8 bytes of
+ * every value decoded.
+ ***************************************************/
+class BenchCompressedVector : public Benchmark
+{
+public:
+   void run()
+   {
+      const size_t num = 10000000;
+      std::mt19937_64 random(232);
+      custom::vector<uint64_t> column(num);
+
+      // synthetic: a clock ticking every millisecond
+      uint64_t value = 1700000000000000000;
+      for (size_t i = 0; i < num; i++)
+         column[i] = value += 1000000;
+      bench_column("steady 1ms timestamps", column);
+
+      // synthetic: sorted IDs with gaps of 1 to 16
+      value = 0;
+      for (size_t i = 0; i < num; i++)
+         column[i] = value += 1 + random() % 16;
+      bench_column("IDs, gaps of 1 to 16", column);
+
+      // real-shaped: nanosecond event times, mostly in bursts
+      // a couple of microseconds apart, with quiet spells between
+      std::exponential_distribution<double> burst(1.0 / 2000.0);
+      std::exponential_distribution<double> quiet(1.0 / 200000.0);
+      value = 1700000000000000000;
+      for (size_t i = 0; i < num; i++)
+         column[i] = value += (uint64_t)((random() % 10 == 0) ? quiet(random) : burst(random));
+      bench_column("bursty event timestamps", column);
+
+      // real-shaped: IDs handed out in order, now and then
+      // skipping ahead to a fresh range
+      value = 0;
+      for (size_t i = 0; i < num; i++)
+         column[i] = value += (random() % 100 == 0) ? random() % 1000000 : 1;
+      bench_column("IDs, mostly dense", column);
+
+      // worst case: nothing to squeeze
+      for (size_t i = 0; i < num; i++)
+         column[i] = random();
+      bench_column("random 64-bit", column);
+
+      custom::simd::setLevel(custom::simd::AVX2);
+   }
+
+   /***************************************
+    * COLUMN
+    * How small the column gets, how fast it decodes
+    * in bulk at each level and through the iterator,
+    * and how long one element takes through the
+    * block table
+    ***************************************/
+   void bench_column(const std::string & name, const custom::vector<uint64_t> & column)
+   {
+      const int repeat = 10;
+      const size_t num = column.size();
+      const double gb = (double)(num * sizeof(uint64_t) * repeat) / 1e9;
+      header("CompressedVector", name);
+
+      custom::compressed_vector cv(column);
+      row("compression ratio", (double)(num * sizeof(uint64_t)) / cv.bytes(), "x");
+      row("   bits per value", (double)cv.bytes() * 8 / num, "bits");
+
+      custom::vector<uint64_t> out(num);
+      const char * names[] = { "decode: scalar", "decode: scalar", "decode: AVX2" };
+      for (int level = custom::simd::SSE2; level <= custom::simd::supported(); level++)
+      {
+         custom::simd::setLevel((custom::simd::Level)level);
+         double ms = time([&]()
+         {
+            for (int r = 0; r < repeat; r++)
+            {
+               cv.decode(out);
+               doNotOptimize(out[num - 1]);
+            }
+         });
+         row(names[level], gb / (ms / 1000.0), "GB/s");
+      }
+
+      double ms = time([&]()
+      {
+         for (int r = 0; r < repeat; r++)
+         {
+            uint64_t total = 0;
+            for (auto it = cv.begin(); it != cv.end(); ++it)
+               total += *it;
+            doNotOptimize(total);
+         }
+      });
+      row("iterate", gb / (ms / 1000.0), "GB/s");
+
+      const size_t numLookups = 1000000;
+      std::mt19937_64 random(232);
+      ms = time([&]()
+      {
+         uint64_t total = 0;
+         for (size_t i = 0; i < numLookups; i++)
+            total += cv[random() % num];
+         doNotOptimize(total);
+      });
+      row("random access", ms * 1000000.0 / numLookups, "ns");
+   }
+};
@@ -0,0 +1,92 @@
+/***********************************************************************
+ * Header:
+ *    BENCH DEQUE
+ * Summary:
+ *    Benchmarks for deque
+ ************************************************************************/
+
+#pragma once
+
+#include <string>       // for std::string
+#include <cstdint>      // for uint64_t
+#include "deque.h"
+#include "vector.h"
+#include "benchmark.h"
+#include "benchVector.h" // for Unmapped
+
+/***************************************************
+ * BENCH DEQUE
+ ***************************************************/
+class BenchDeque : public Benchmark
+{
+public:
+   void run()
+   {
+      bench_pushback();
+      bench_pushfront();
+   }
+
+   /***************************************
+    * PUSH BACK
+    * Push 40M 8-byte values one at a time and time each
+    * push. A vector that fills up copies everything it
+    * holds, so its worst push grows with its size. A
+    * deque that fills up only starts another block.
+    ***************************************/
+   void bench_pushback()
+   {
+      const size_t num = 40000000;
+      header("Deque", "push_back of 40M 8-byte values");
+
+      pushBack<custom::vector<Unmapped>>("vector, copied", num);
+      pushBack<custom::vector<uint64_t>>("vector, mremap", num);
+      pushBack<custom::deque<uint64_t>> ("deque",          num);
+   }
+
+   /***************************************
+    * PUSH FRONT
+    * Build a 1M-element queue from the front. vector
+    * has no push_front: inserting at begin() moves every
+    * element, so it is run on 1/100th the elements.
+    ***************************************/
+   void bench_pushfront()
+   {
+      const size_t num = 1000000;
+      header("Deque", "push_front of 1M 8-byte values");
+
+      double msVector = time([&]()
+      {
+         custom::vector<uint64_t> v;
+         for (size_t i = 0; i < num / 100; i++)
+            v.emplace(v.begin(), i);
+         doNotOptimize(v.front());
+      });
+      row("vector::emplace(begin()), 10K", msVector, "ms");
+
+      double msDeque = time([&]()
+      {
+         custom::deque<uint64_t> d;
+         for (size_t i = 0; i < num; i++)
+            d.push_front(i);
+         doNotOptimize(d.front());
+      });
+      row("deque::push_front, 1M", msDeque, "ms");
+   }
+
+private:
+   template <class Container>
+   void pushBack(const std::string & label, size_t num)
+   {
+      double ms = time([&]()
+      {
+         Container c;
+         for (size_t i = 0; i < num; i++)
+            c.push_back(i);
+         doNotOptimize(c.back());
+      });
+      row(label, ms, "ms total");
+
+      Container c;
+      latency(num, [&](size_t i) { c.push_back(i); });
+   }
+};
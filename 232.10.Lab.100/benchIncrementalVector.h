@@ -0,0 +1,109 @@
+/***********************************************************************
+ * Header:
+ *    BENCH INCREMENTAL VECTOR
+ * Summary:
+ *    Benchmarks for incremental_vector
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>      // for uint64_t
+#include "incremental_vector.h"
+#include "vector.h"
+#include "benchVector.h" // for Unmapped, which vector has to copy to grow
+#include "benchmark.h"
+
+/***************************************************
+ * BENCH INCREMENTAL VECTOR
+ ***************************************************/
+class BenchIncrementalVector : public Benchmark
+{
+public:
+   void run()
+   {
+      bench_latency();
+      bench_access();
+   }
+
+   /***************************************
+    * LATENCY
+    * Push 40M 8-byte values one at a time, timing each
+    * push on its own. A doubling vector's pushes are almost
+    * all quick, but the one that lands on a full buffer
+    * copies or remaps all of it: 256MB by the last
+    * doubling. The incremental vector spreads that
+    * work over the pushes that follow. Timing calls
+    * that do nothing at all first shows how much of the
+    * tail is the clock and the machine.
+    ***************************************/
+   void bench_latency()
+   {
+      header("IncrementalVector", "push_back of 40M 8-byte values, each timed");
+      row("nothing, the clock alone", 0.0, "ms total");
+      histogram(40000000, [](size_t) {});
+      pushBack<custom::vector<Unmapped>>            ("vector, 2x, copied");
+      pushBack<custom::vector<uint64_t>>            ("vector, 2x, mremap");
+      pushBack<custom::incremental_vector<uint64_t>>("incremental_vector");
+   }
+
+   /***************************************
+    * ACCESS
+    * What the test on every access costs: sum 32M
+    * values by index, from a vector, from an incremental
+    * vector with no move on, and from one where a move
+    * has just begun and nearly every element is still
+    * in the old buffer.
+    ***************************************/
+   void bench_access()
+   {
+      const size_t num = 1 << 25;
+      header("IncrementalVector", "sum of 32M 8-byte values by index");
+
+      custom::vector<uint64_t> v;
+      custom::incremental_vector<uint64_t> settled;
+      custom::incremental_vector<uint64_t> moving;
+      for (size_t i = 0; i < num; i++)
+      {
+         v.push_back(i);
+         settled.push_back(i);
+         moving.push_back(i);
+      }
+      moving.push_back(num);
+      moving.pop_back();
+
+      row("vector",                       sum(v,       num), "ms");
+      row("incremental_vector",           sum(settled, num), "ms");
+      row("incremental_vector, mid-move", sum(moving,  num), "ms");
+   }
+
+private:
+   template <class Container>
+   void pushBack(const std::string & label)
+   {
+      const size_t num = 40000000;
+      double ms = time([&]()
+      {
+         Container c;
+         for (size_t i = 0; i < num; i++)
+            c.push_back(i);
+         doNotOptimize(c.back());
+      });
+      row(label, ms, "ms total");
+
+      Container c;
+      histogram(num, [&](size_t i) { c.push_back(i); });
+   }
+
+   template <class Container>
+   double sum(const Container & c, size_t num)
+   {
+      uint64_t total = 0;
+      double ms = time([&]()
+      {
+         for (size_t i = 0; i < num; i++)
+            total += (uint64_t)c[i];
+      });
+      doNotOptimize(total);
+      return ms;
+   }
+};
@@ -0,0 +1,109 @@
+/***********************************************************************
+ * Header:
+ *    BENCH MAPPED VECTOR
+ * Summary:
+ *    Benchmarks for mapped_vector
+ ************************************************************************/
+
+#pragma once
+
+#include "mapped_vector.h"
+
+#ifdef MAPPED_VECTOR
+
+#include <cstdio>       // for std::remove
+#include <fstream>      // for std::ifstream and std::ofstream
+#include <random>       // for std::mt19937
+#include "vector.h"
+#include "benchmark.h"
+
+/***************************************************
+ * BENCH MAPPED VECTOR
+ ***************************************************/
+class BenchMappedVector : public Benchmark
+{
+public:
+   void run()
+   {
+      bench_startup();
+   }
+
+   /***************************************
+    * STARTUP
+    * Get a 10M double table into memory at the start
+    * of a run: parse it from text, read it from a binary
+    * file, or map a mapped_vector file that is already
+    * laid out the way memory wants it
+    ***************************************/
+   void bench_startup()
+   {
+      const size_t num = 10000000;
+      const char * textPath   = "benchMappedVector.txt";
+      const char * binaryPath = "benchMappedVector.bin";
+      const char * mappedPath = "benchMappedVector.map";
+      header("MappedVector", "load a table of 10M doubles");
+
+      // the same table, saved three ways
+      std::remove(mappedPath);
+      {
+         std::mt19937 random(232);
+         std::uniform_real_distribution<double> dist(0.0, 1000.0);
+         std::ofstream text(textPath);
+         std::ofstream binary(binaryPath, std::ios::binary);
+         custom::mapped_vector<double> mapped(mappedPath);
+         text.precision(17);
+         for (size_t i = 0; i < num; i++)
+         {
+            double d = dist(random);
+            text << d << '\n';
+            binary.write(reinterpret_cast<const char *>(&d), sizeof(d));
+            mapped.push_back(d);
+         }
+      }
+
+      double msText = time([&]()
+      {
+         std::ifstream fin(textPath);
+         custom::vector<double> v;
+         double d;
+         while (fin >> d)
+            v.push_back(d);
+         doNotOptimize(v.back());
+      });
+      row("parse text into vector", msText, "ms");
+
+      double msBinary = time([&]()
+      {
+         std::ifstream fin(binaryPath, std::ios::binary);
+         custom::vector<double> v(num);
+         fin.read(reinterpret_cast<char *>(&v[0]), num * sizeof(double));
+         doNotOptimize(v.back());
+      });
+      row("read binary into vector", msBinary, "ms");
+
+      double msMap = time([&]()
+      {
+         custom::mapped_vector<double> v(mappedPath);
+         doNotOptimize(v.back());
+      });
+      row("open mapped_vector", msMap, "ms");
+
+      // opening is nearly free; paying for the pages comes on first touch
+      double msScan = time([&]()
+      {
+         custom::mapped_vector<double> v(mappedPath);
+         v.advise(custom::mapped_vector<double>::SEQUENTIAL);
+         double sum = 0.0;
+         for (double d : v)
+            sum += d;
+         doNotOptimize(sum);
+      });
+      row("open mapped_vector and scan it", msScan, "ms");
+
+      std::remove(textPath);
+      std::remove(binaryPath);
+      std::remove(mappedPath);
+   }
+};
+
+#endif // MAPPED_VECTOR
@@ -0,0 +1,113 @@
+/***********************************************************************
+ * Header:
+ *    BENCH PACKED INT VECTOR
+ * Summary:
+ *    Benchmarks for packed_int_vector
+ ************************************************************************/
+
+#pragma once
+
+#include <random>       // for std::mt19937
+#include <cstdint>      // for uint32_t and uint64_t
+#include "packed_int_vector.h"
+#include "vector.h"
+#include "benchmark.h"
+
+/***************************************************
+ * BENCH PACKED INT VECTOR
+ ***************************************************/
+class BenchPackedIntVector : public Benchmark
+{
+public:
+   void run()
+   {
+      bench_scan();
+      custom::simd::setLevel(custom::simd::AVX2);
+   }
+
+   /***************************************
+    * SCAN
+    * Sum 50M 20-bit IDs: from 64- and 32-bit slots,
+    * from the packed vector one get() at a time, and
+    * decoded 4K at a time into a buffer, by the scalar
+    * loop and by the AVX2 unpacking
+    ***************************************/
+   void bench_scan()
+   {
+      const size_t num = 50000000;
+      const size_t chunk = 4096;
+      const int repeat = 10;
+      header("PackedIntVector", "sum 50M 20-bit IDs, 10 times");
+
+      custom::vector<uint64_t> wide(num);
+      custom::vector<uint32_t> narrow(num);
+      custom::packed_int_vector<20> packed;
+      packed.reserve(num);
+      std::mt19937 random(232);
+      for (size_t i = 0; i < num; i++)
+      {
+         uint32_t id = random() & 0xfffff;
+         wide[i] = id;
+         narrow[i] = id;
+         packed.push_back(id);
+      }
+
+      row("uint64_t slots: memory", (long)(wide.capacity() * sizeof(uint64_t) / 1024), "KB");
+      row("   uint32_t slots", (long)(narrow.capacity() * sizeof(uint32_t) / 1024), "KB");
+      row("   packed 20 bits", (long)(packed.bytes() / 1024), "KB");
+
+      row("sum: uint64_t slots", time([&]()
+      {
+         for (int r = 0; r < repeat; r++)
+         {
+            uint64_t total = 0;
+            for (size_t i = 0; i < num; i++)
+               total += wide[i];
+            doNotOptimize(total);
+         }
+      }), "ms");
+      row("   uint32_t slots", time([&]()
+      {
+         for (int r = 0; r < repeat; r++)
+         {
+            uint64_t total = 0;
+            for (size_t i = 0; i < num; i++)
+               total += narrow[i];
+            doNotOptimize(total);
+         }
+      }), "ms");
+      row("   packed get()", time([&]()
+      {
+         for (int r = 0; r < repeat; r++)
+         {
+            uint64_t total = 0;
+            for (size_t i = 0; i < num; i++)
+               total += packed.get(i);
+            doNotOptimize(total);
+         }
+      }), "ms");
+
+      const char * names[] = { "   packed decode, scalar", "   packed decode, scalar",
+                               "   packed decode, AVX2" };
+      custom::vector<uint32_t> buffer(chunk);
+      for (int level = custom::simd::SSE2; level <= custom::simd::supported(); level++)
+      {
+         custom::simd::setLevel((custom::simd::Level)level);
+         row(names[level], time([&]()
+         {
+            for (int r = 0; r < repeat; r++)
+            {
+               uint64_t total = 0;
+               for (size_t first = 0; first < num; first += chunk)
+               {
+                  size_t n = (num - first < chunk) ? num - first : chunk;
+                  packed.decode(first, n, &buffer[0]);
+                  for (size_t i = 0; i < n; i++)
+                     total += buffer[i];
+               }
+               doNotOptimize(total);
+            }
+         }), "ms");
+      }
+   }
+};
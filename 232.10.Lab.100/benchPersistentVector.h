@@ -0,0 +1,157 @@
+/***********************************************************************
+ * Header:
+ *    BENCH PERSISTENT VECTOR
+ * Summary:
+ *    Benchmarks for persistent_vector
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>      // for int64_t
+#include <random>       // for std::mt19937
+#include "persistent_vector.h"
+#include "vector.h"
+#include "benchmark.h"
+
+/***************************************************
+ * BENCH PERSISTENT VECTOR
+ ***************************************************/
+class BenchPersistentVector : public Benchmark
+{
+public:
+   void run()
+   {
+      bench_snapshot();
+      bench_build();
+      bench_scan();
+   }
+
+   /***************************************
+    * SNAPSHOT
+    * A writer makes 10 changes to a 1M-element table,
+    * then publishes a snapshot for readers, 1000 times
+    * over. custom::vector copies all 1M each time;
+    * persistent_vector copies the ~30 nodes changed.
+    ***************************************/
+   void bench_snapshot()
+   {
+      const size_t num = 1000000;
+      const int rounds = 1000;
+      const int edits = 10;
+      header("PersistentVector", "1000 snapshots of a 1M-int table, 10 edits apart");
+
+      custom::vector<int64_t> source(num, 0);
+      custom::transient_vector<int64_t> batch = custom::persistent_vector<int64_t>().transient();
+      for (size_t i = 0; i < num; i++)
+         batch.push_back(0);
+      custom::persistent_vector<int64_t> persistentSource = batch.persistent();
+
+      std::mt19937 random(232);
+      double msVector = time([&]()
+      {
+         custom::vector<int64_t> live(source);
+         custom::vector<int64_t> snapshot;
+         for (int round = 0; round < rounds; round++)
+         {
+            for (int edit = 0; edit < edits; edit++)
+               live[random() % num] = round;
+            snapshot = live;
+            doNotOptimize(snapshot[0]);
+         }
+      });
+      row("custom::vector deep copy", msVector, "ms");
+
+      random.seed(232);
+      double msPersistent = time([&]()
+      {
+         custom::persistent_vector<int64_t> live(persistentSource);
+         custom::persistent_vector<int64_t> snapshot;
+         for (int round = 0; round < rounds; round++)
+         {
+            for (int edit = 0; edit < edits; edit++)
+               live.set(random() % num, round);
+            snapshot = live;
+            doNotOptimize(snapshot[0]);
+         }
+      });
+      row("persistent_vector", msPersistent, "ms");
+   }
+
+   /***************************************
+    * BUILD
+    * Push 10M ints one at a time. A persistent
+    * push_back copies the tail every time; a transient
+    * one writes in place.
+    ***************************************/
+   void bench_build()
+   {
+      const size_t num = 10000000;
+      header("PersistentVector", "push_back of 10M ints");
+
+      double msVector = time([&]()
+      {
+         custom::vector<int> v;
+         for (size_t i = 0; i < num; i++)
+            v.push_back((int)i);
+         doNotOptimize(v.back());
+      });
+      row("custom::vector", msVector, "ms");
+
+      double msPersistent = time([&]()
+      {
+         custom::persistent_vector<int> v;
+         for (size_t i = 0; i < num; i++)
+            v.push_back((int)i);
+         doNotOptimize(v.back());
+      });
+      row("persistent_vector", msPersistent, "ms");
+
+      double msTransient = time([&]()
+      {
+         custom::transient_vector<int> t = custom::persistent_vector<int>().transient();
+         for (size_t i = 0; i < num; i++)
+            t.push_back((int)i);
+         custom::persistent_vector<int> v = t.persistent();
+         doNotOptimize(v.back());
+      });
+      row("transient_vector", msTransient, "ms");
+   }
+
+   /***************************************
+    * SCAN
+    * Sum 10M ints: the price of reading through
+    * the trie a leaf at a time
+    ***************************************/
+   void bench_scan()
+   {
+      const size_t num = 10000000;
+      header("PersistentVector", "sum of 10M ints");
+
+      custom::vector<int> v;
+      custom::transient_vector<int> t = custom::persistent_vector<int>().transient();
+      for (size_t i = 0; i < num; i++)
+      {
+         v.push_back((int)i);
+         t.push_back((int)i);
+      }
+      custom::persistent_vector<int> pv = t.persistent();
+
+      int64_t sum = 0;
+      double msVector = time([&]()
+      {
+         for (int value : v)
+            sum += value;
+      });
+      doNotOptimize(sum);
+      row("custom::vector", msVector, "ms");
+
+      sum = 0;
+      double msPersistent = time([&]()
+      {
+         for (int value : pv)
+            sum += value;
+      });
+      doNotOptimize(sum);
+      row("persistent_vector", msPersistent, "ms");
+   }
+};
@@ -0,0 +1,139 @@
+/***********************************************************************
+ * Header:
+ *    BENCH SIMD
+ * Summary:
+ *    Benchmarks for the simd algorithms
+ ************************************************************************/
+
+#pragma once
+
+#include <algorithm>    // for std::find, std::count, std::min_element
+#include <numeric>      // for std::accumulate
+#include <random>       // for std::mt19937
+#include <string>       // for std::to_string
+#include <cstdint>      // for int32_t
+#include "simd.h"
+#include "vector.h"
+#include "benchmark.h"
+
+/***************************************************
+ * BENCH SIMD
+ * Every case does 100M elements' worth of work, so
+ * small vectors are scanned many times over. A row
+ * is the best of 1K elements that fit in L1 and 100M
+ * that come from memory. The alignment rows sum floats
+ * at and just past a cache-line boundary.
+ ***************************************************/
+class BenchSimd : public Benchmark
+{
+public:
+   void run()
+   {
+      for (size_t num : { 1000, 100000, 10000000, 100000000 })
+         bench_size(num);
+      custom::simd::setLevel(custom::simd::AVX2);
+#ifdef SIMD_X86
+      if (custom::simd::supported() == custom::simd::AVX2)
+         for (size_t num : { 4096, 65536, 16777216 })
+            bench_alignment(num);
+#endif // SIMD_X86
+   }
+
+   /***************************************
+    * SIZE
+    * Search, reduce, and erase num ints: with a hand
+    * loop on vector::iterator, with the std:: algorithm,
+    * and with each level of the simd algorithms
+    ***************************************/
+   void bench_size(size_t num)
+   {
+      const size_t work = 100000000;
+      const size_t repeat = work / num;
+      header("Simd", std::to_string(num) + " elements, scanned " +
+                     std::to_string(repeat) + " times");
+
+      custom::vector<int32_t> v(num);
+      std::mt19937 random(232);
+      for (size_t i = 0; i < num; i++)
+         v[i] = (int32_t)(random() % 1000000) + 1;   // never 0, so find scans everything
+      custom::vector<float> f(num);
+      for (size_t i = 0; i < num; i++)
+         f[i] = (float)v[i];
+
+      // find a value that is not there
+      compare("find", repeat,
+         [&]() { auto it = v.begin(); while (it != v.end() && *it != 0) ++it; return it != v.end(); },
+         [&]() { return std::find(v.begin(), v.end(), 0) != v.end(); },
+         [&]() { return custom::simd::find(v, 0) != v.end(); });
+
+      compare("count", repeat,
+         [&]() { size_t n = 0; for (auto it = v.begin(); it != v.end(); ++it) if (*it == 26) n++; return n; },
+         [&]() { return (size_t)std::count(v.begin(), v.end(), 26); },
+         [&]() { return custom::simd::count(v, 26); });
+
+      compare("min_element", repeat,
+         [&]() { auto best = v.begin(); for (auto it = v.begin(); it != v.end(); ++it) if (*it < *best) best = it; return *best; },
+         [&]() { return *std::min_element(v.begin(), v.end()); },
+         [&]() { return *custom::simd::min_element(v); });
+
+      compare("sum of floats", repeat,
+         [&]() { float s = 0.0f; for (auto it = f.begin(); it != f.end(); ++it) s += *it; return s; },
+         [&]() { return std::accumulate(f.begin(), f.end(), 0.0f); },
+         [&]() { return custom::simd::sum(f); });
+
+      // erase removes what it finds, so each pass gets a fresh copy
+      custom::vector<int32_t> source(v);
+      for (size_t i = 0; i < num; i += 4)
+         source[i] = 0;
+      compare("erase a quarter (with copy)", repeat,
+         [&]() { v = source; auto out = v.begin(); for (auto it = v.begin(); it != v.end(); ++it) if (*it != 0) *out++ = *it; v.resize(out - v.begin()); return v.size(); },
+         [&]() { v = source; v.resize(std::remove(v.begin(), v.end(), 0) - v.begin()); return v.size(); },
+         [&]() { v = source; custom::simd::erase(v, 0); return v.size(); });
+   }
+
+#ifdef SIMD_X86
+   /***************************************
+    * ALIGNMENT
+    * The AVX2 sum of num floats from a 64-byte aligned
+    * buffer, then from one float past it: every other
+    * 32-byte load of the second straddles a cache line
+    ***************************************/
+   void bench_alignment(size_t num)
+   {
+      const size_t work = 100000000;
+      const size_t repeat = work / num;
+      header("Simd", std::to_string(num) + " floats, aligned and not, summed " +
+                     std::to_string(repeat) + " times");
+
+      custom::aligned_vector<float, 64> f(num + 16);
+      for (size_t i = 0; i < f.size(); i++)
+         f[i] = (float)(i % 1000);
+      const float * p = f.aligned_data();
+
+      row("sum: 64-byte aligned", time([&]() { for (size_t r = 0; r < repeat; r++)
+         doNotOptimize(custom::simd::detail::avx2::sum(p, num)); }), "ms");
+      row("   4 bytes past", time([&]() { for (size_t r = 0; r < repeat; r++)
+         doNotOptimize(custom::simd::detail::avx2::sum(p + 1, num)); }), "ms");
+   }
+#endif // SIMD_X86
+
+private:
+   /***************************************
+    * COMPARE
+    * Time the hand loop, the std:: algorithm, and
+    * then the simd algorithm at every level
+    ***************************************/
+   template <class Hand, class Std, class Simd>
+   void compare(const std::string & name, size_t repeat, Hand hand, Std stdAlgorithm, Simd simd)
+   {
+      row(name + ": hand loop", time([&]() { for (size_t r = 0; r < repeat; r++) doNotOptimize(hand()); }), "ms");
+      row("   std::", time([&]() { for (size_t r = 0; r < repeat; r++) doNotOptimize(stdAlgorithm()); }), "ms");
+
+      const char * names[] = { "   simd scalar", "   simd SSE2", "   simd AVX2" };
+      for (int level = custom::simd::SCALAR; level <= custom::simd::supported(); level++)
+      {
+         custom::simd::setLevel((custom::simd::Level)level);
+         row(names[level], time([&]() { for (size_t r = 0; r < repeat; r++) doNotOptimize(simd()); }), "ms");
+      }
+   }
+};
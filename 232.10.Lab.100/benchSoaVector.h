@@ -0,0 +1,96 @@
+/***********************************************************************
+ * Header:
+ *    BENCH SOA VECTOR
+ * Summary:
+ *    Benchmarks for soa_vector
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>      // for int64_t
+#include <array>        // for std::array
+#include "soa_vector.h"
+#include "vector.h"
+#include "benchmark.h"
+
+/***************************************************
+ * BENCH SOA VECTOR
+ ***************************************************/
+class BenchSoaVector : public Benchmark
+{
+public:
+   void run()
+   {
+      bench_sumField();
+   }
+
+   /***************************************
+    * SUM FIELD
+    * Sum the price of every record of a 10M-record
+    * table. As an array of structs each 48-byte record
+    * brings its id, quantity, and name into the cache
+    * along with its price. As a struct of arrays only
+    * the prices are read.
+    ***************************************/
+   void bench_sumField()
+   {
+      const size_t num = 10000000;
+      const int repeat = 10;
+      header("SoaVector", "sum one field of 10M 48-byte records, 10 times");
+
+      struct Record
+      {
+         int64_t id;
+         double  price;
+         double  quantity;
+         char    name[24];
+      };
+
+      custom::vector<Record> aos;
+      custom::soa_vector<int64_t, double, double, std::array<char, 24>> soa;
+      aos.reserve(num);
+      soa.reserve(num);
+      for (size_t i = 0; i < num; i++)
+      {
+         Record r = { (int64_t)i, (double)(i % 100), 1.0, "widget" };
+         aos.push_back(r);
+         soa.emplace_back(r.id, r.price, r.quantity, std::array<char, 24>{ 'w' });
+      }
+
+      double msAos = time([&]()
+      {
+         for (int r = 0; r < repeat; r++)
+         {
+            double sum = 0.0;
+            for (const Record & record : aos)
+               sum += record.price;
+            doNotOptimize(sum);
+         }
+      });
+      row("custom::vector<Record>", msAos, "ms");
+
+      double msSoa = time([&]()
+      {
+         for (int r = 0; r < repeat; r++)
+         {
+            double sum = 0.0;
+            for (double price : soa.field<1>())
+               sum += price;
+            doNotOptimize(sum);
+         }
+      });
+      row("soa_vector field<1>()", msSoa, "ms");
+
+      double msProxy = time([&]()
+      {
+         for (int r = 0; r < repeat; r++)
+         {
+            double sum = 0.0;
+            for (auto record : soa)
+               sum += std::get<1>(record);
+            doNotOptimize(sum);
+         }
+      });
+      row("soa_vector iterator", msProxy, "ms");
+   }
+};
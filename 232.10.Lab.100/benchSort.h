@@ -0,0 +1,122 @@
+/***********************************************************************
+ * Header:
+ *    BENCH SORT
+ * Summary:
+ *    Benchmarks for radix_sort and merge_sort
+ ************************************************************************/
+
+#pragma once
+
+#include <algorithm>    // for std::sort and std::copy
+#include <vector>       // for std::vector, the copy we sort today
+#include <random>       // for std::mt19937_64
+#include <string>       // for std::to_string
+#include <cstdint>      // for uint32_t and uint64_t
+#include "sort.h"
+#include "vector.h"
+#include "benchmark.h"
+
+/***************************************************
+ * BENCH SORT
+ * Each size sorts 10M elements' worth, so 1K is
+ * sorted 10K times over and 1B once. Every row puts
+ * the same unsorted keys back before each sort and
+ * times only the sort.
+ ***************************************************/
+class BenchSort : public Benchmark
+{
+public:
+   void run()
+   {
+      for (size_t num : { 1000, 1000000, 100000000, 1000000000 })
+         bench_size(num);
+   }
+
+   /***************************************
+    * SIZE
+    * Sort num random keys of each kind, and 16-byte
+    * records by a 64-bit key: by copying into a
+    * std::vector and back, with std::sort in place,
+    * with merge_sort, and with radix_sort
+    ***************************************/
+   void bench_size(size_t num)
+   {
+      const size_t work = 10000000;
+      const size_t repeat = (num < work) ? work / num : 1;
+      header("Sort", std::to_string(num) + " elements, sorted " +
+                     std::to_string(repeat) + " times");
+
+      struct Record
+      {
+         uint64_t key;
+         uint64_t payload;
+      };
+
+      compare<uint32_t>("uint32_t", num, repeat,
+         [](uint64_t r) { return (uint32_t)r; },
+         [](uint32_t lhs, uint32_t rhs) { return lhs < rhs; },
+         [](uint32_t t) { return t; });
+      compare<uint64_t>("uint64_t", num, repeat,
+         [](uint64_t r) { return r; },
+         [](uint64_t lhs, uint64_t rhs) { return lhs < rhs; },
+         [](uint64_t t) { return t; });
+      compare<float>("float", num, repeat,
+         [](uint64_t r) { return (float)((int64_t)r >> 20); },
+         [](float lhs, float rhs) { return lhs < rhs; },
+         [](float t) { return t; });
+      compare<Record>("record", num, repeat,
+         [](uint64_t r) { return Record{ r, r >> 32 }; },
+         [](const Record & lhs, const Record & rhs) { return lhs.key < rhs.key; },
+         [](const Record & r) { return r.key; });
+   }
+
+private:
+   /***************************************
+    * COMPARE
+    * Time each way of sorting num elements made by
+    * make(random number). Skip it if the unsorted
+    * keys, the vector, its scratch, and the copy
+    * would not fit in half the machine's memory.
+    ***************************************/
+   template <typename T, class Make, class Less, class KeyOf>
+   void compare(const std::string & name, size_t num, size_t repeat,
+                Make make, Less less, KeyOf key)
+   {
+      long needKB = (long)(num * sizeof(T) * 4 / 1024);
+      long haveKB = physicalKB();
+      if (haveKB >= 0 && needKB > haveKB / 2)
+      {
+         row(name + ": skipped, needs", needKB / 1024, "MB");
+         return;
+      }
+
+      custom::vector<T> source(num);
+      std::mt19937_64 random(232);
+      for (size_t i = 0; i < num; i++)
+         source[i] = make(random());
+      custom::vector<T> v;
+      custom::vector<T> scratch;
+      std::vector<T> copy;
+
+      auto sorts = [&](auto sort)
+      {
+         double ms = 0.0;
+         for (size_t r = 0; r < repeat; r++)
+         {
+            v = source;
+            ms += time(sort);
+         }
+         return ms;
+      };
+
+      row(name + ": std::sort, copied", sorts([&]()
+      {
+         copy.assign(v.begin(), v.end());
+         std::sort(copy.begin(), copy.end(), less);
+         std::copy(copy.begin(), copy.end(), v.begin());
+      }), "ms");
+      row("   std::sort in place", sorts([&]() { std::sort(v.begin(), v.end(), less); }), "ms");
+      row("   merge_sort", sorts([&]() { custom::merge_sort(v, less, scratch); }), "ms");
+      row("   radix_sort", sorts([&]() { custom::radix_sort(v, key, scratch); }), "ms");
+   }
+};
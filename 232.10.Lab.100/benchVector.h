@@ -0,0 +1,307 @@
+/***********************************************************************
+ * Header:
+ *    BENCH VECTOR
+ * Summary:
+ *    Benchmarks for vector
+ ************************************************************************/
+
+#pragma once
+
+#include <string>       // for std::string
+#include <type_traits>  // for std::true_type
+#include <algorithm>    // for std::sort
+#include <random>       // for std::mt19937
+#include <vector>       // for std::vector
+#include <cstdint>      // for uint64_t
+#include <memory_resource> // for std::pmr::monotonic_buffer_resource
+#if __has_include(<execution>)
+#include <execution>    // for std::execution::par (libstdc++ needs -ltbb)
+#endif
+#include "vector.h"
+#include "benchmark.h"
+
+/***************************************************
+ * COUNTED STRING
+ * A std::string that counts how often it is copied
+ * and moved. When NOEXCEPT is false the move constructor
+ * may throw, so vector must fall back to copying: the
+ * way every relocation used to work.
+ ***************************************************/
+template <bool NOEXCEPT>
+struct CountedString
+{
+   CountedString(const char * s) : s(s) {}
+   CountedString(const CountedString & rhs) : s(rhs.s) { numCopy++; }
+   CountedString(CountedString && rhs) noexcept(NOEXCEPT) : s(std::move(rhs.s)) { numMove++; }
+   CountedString & operator = (const CountedString & rhs) { s = rhs.s; numCopy++; return *this; }
+   CountedString & operator = (CountedString && rhs) noexcept(NOEXCEPT)
+   {
+      s = std::move(rhs.s);
+      numMove++;
+      return *this;
+   }
+
+   std::string s;
+   static inline long numCopy = 0;
+   static inline long numMove = 0;
+};
+
+/***************************************************
+ * OWNED BUFFER
+ * Owns a heap pointer but never points at itself, so
+ * it can be relocated with memcpy once it opts in below.
+ ***************************************************/
+struct OwnedBuffer
+{
+   OwnedBuffer(const char * s) : p(new std::string(s)) {}
+   OwnedBuffer(const OwnedBuffer & rhs) : p(new std::string(*rhs.p)) { numCopy++; }
+   OwnedBuffer(OwnedBuffer && rhs) noexcept : p(rhs.p) { rhs.p = nullptr; numMove++; }
+   ~OwnedBuffer() { delete p; }
+
+   std::string * p;
+   static inline long numCopy = 0;
+   static inline long numMove = 0;
+};
+
+template <>
+struct custom::is_trivially_relocatable<OwnedBuffer> : std::true_type {};
+
+/***************************************************
+ * UNMAPPED
+ * A plain 8-byte value that opts out of trivial
+ * relocation, so vector never maps its buffer and
+ * has to copy it element by element on every growth.
+ ***************************************************/
+struct Unmapped
+{
+   Unmapped(uint64_t v) : v(v) {}
+   uint64_t v;
+};
+
+template <>
+struct custom::is_trivially_relocatable<Unmapped> : std::false_type {};
+
+/***************************************************
+ * BENCH VECTOR
+ ***************************************************/
+class BenchVector : public Benchmark
+{
+public:
+   void run()
+   {
+      bench_growth();   // first, before the others leave the heap resident
+      bench_relocate();
+      bench_sort();
+      bench_allocator();
+      bench_parallel();
+   }
+
+   /***************************************
+    * RELOCATE
+    * Push 10M string-sized elements one at a time and
+    * count what the doubling growth costs
+    ***************************************/
+   void bench_relocate()
+   {
+      const size_t num = 10000000;
+      const char * text = "string long enough to heap allocate";
+      header("Vector", "push_back of 10M string-sized elements");
+
+      // the old behavior: every relocation copies
+      CountedString<false>::numCopy = CountedString<false>::numMove = 0;
+      double msCopy = time([&]()
+      {
+         custom::vector<CountedString<false>> v;
+         for (size_t i = 0; i < num; i++)
+            v.push_back(CountedString<false>(text));
+      });
+      row("copy relocation", msCopy, "ms");
+      row("", CountedString<false>::numCopy, "copies");
+
+      // noexcept move: relocation moves
+      CountedString<true>::numCopy = CountedString<true>::numMove = 0;
+      double msMove = time([&]()
+      {
+         custom::vector<CountedString<true>> v;
+         for (size_t i = 0; i < num; i++)
+            v.push_back(CountedString<true>(text));
+      });
+      row("move relocation", msMove, "ms");
+      row("", CountedString<true>::numCopy, "copies");
+      row("", CountedString<true>::numMove, "moves");
+
+      // opted in to trivial relocation: relocation is a memcpy
+      OwnedBuffer::numCopy = OwnedBuffer::numMove = 0;
+      double msMemcpy = time([&]()
+      {
+         custom::vector<OwnedBuffer> v;
+         for (size_t i = 0; i < num; i++)
+            v.push_back(OwnedBuffer(text));
+      });
+      row("memcpy relocation", msMemcpy, "ms");
+      row("", OwnedBuffer::numCopy, "copies");
+      row("", OwnedBuffer::numMove, "moves");
+   }
+
+   /***************************************
+    * SORT
+    * Sort 10M ints in place through the vector's own
+    * random-access iterators, serially and in parallel
+    ***************************************/
+   void bench_sort()
+   {
+      const size_t num = 10000000;
+      header("Vector", "std::sort of 10M ints through vector::iterator");
+
+      custom::vector<int> source;
+      source.reserve(num);
+      std::mt19937 random(232);
+      for (size_t i = 0; i < num; i++)
+         source.push_back((int)random());
+
+      custom::vector<int> v(source);
+      double msSeq = time([&]() { std::sort(v.begin(), v.end()); });
+      row("sequential", msSeq, "ms");
+
+#ifdef __cpp_lib_execution
+      v = source;
+      double msPar = time([&]() { std::sort(std::execution::par, v.begin(), v.end()); });
+      row("std::execution::par", msPar, "ms");
+#endif
+   }
+
+   /***************************************
+    * GROWTH
+    * Push 40M 8-byte values one at a time under each
+    * growth policy. Report the buffer size and the peak
+    * resident memory, then
+    * how long single pushes took: most cost nothing, but the
+    * ones that land on a full buffer pay for the reallocation.
+    ***************************************/
+   void bench_growth()
+   {
+      header("Vector", "push_back of 40M 8-byte values by growth policy");
+      growth<Unmapped,  custom::grow_double>("2x, copied");
+      growth<uint64_t,  custom::grow_double>("2x, mremap");
+      growth<uint64_t,  custom::grow_half  >("1.5x, mremap");
+      growth<uint64_t,  custom::grow_page  >("1.5x page-rounded, mremap");
+   }
+
+   template <class T, class G>
+   void growth(const std::string & label)
+   {
+      const size_t num = 40000000;
+      typedef custom::vector<T, std::allocator<T>, G> Vector;
+
+      // untouched capacity is address space, not memory, so report both
+      size_t capacity = 0;
+      long kb = peakKB([&]()
+      {
+         Vector v;
+         for (size_t i = 0; i < num; i++)
+            v.push_back(T(i));
+         capacity = v.capacity();
+         doNotOptimize(v.back());
+      });
+      row(label, capacity * sizeof(T) / 1048576.0, "MB reserved");
+      row("",    kb / 1024.0,                      "MB peak RSS");
+
+      // time each push on its own
+      Vector v;
+      latency(num, [&](size_t i) { v.push_back(T(i)); });
+   }
+
+   /***************************************
+    * PARALLEL
+    * Fill, copy, and resize a 100M-double vector (800MB)
+    * split across 1, 2, 4, ... threads. The buffers are
+    * fresh pages, so this includes the page faults of
+    * touching them for the first time.
+    ***************************************/
+   void bench_parallel()
+   {
+      const size_t num = 100000000;
+      header("Vector", "fill, copy, and resize of 100M doubles by thread count");
+
+      custom::parallelism saved = custom::parallelism::settings();
+      unsigned maxThreads = custom::parallelism::defaultThreads();
+      custom::vector<double> source(num, 2.5);
+      // 1, 2, 4, ... and finally every thread there is
+      std::vector<unsigned> counts;
+      for (unsigned threads = 1; threads < maxThreads; threads *= 2)
+         counts.push_back(threads);
+      counts.push_back(maxThreads);
+
+      for (unsigned threads : counts)
+      {
+         custom::parallelism::settings().threads = threads;
+         std::string label = std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+
+         double msFill = time([&]()
+         {
+            custom::vector<double> v(num, 7.0);
+            doNotOptimize(v.back());
+         });
+         row(label + ": vector(n, t)", msFill, "ms");
+
+         double msCopy = time([&]()
+         {
+            custom::vector<double> v(source);
+            doNotOptimize(v.back());
+         });
+         row("   vector(rhs)", msCopy, "ms");
+
+         double msResize = time([&]()
+         {
+            custom::vector<double> v;
+            v.resize(num, 7.0);
+            doNotOptimize(v.back());
+         });
+         row("   resize(n, t)", msResize, "ms");
+      }
+      custom::parallelism::settings() = saved;
+   }
+
+   /***************************************
+    * ALLOCATOR
+    * Build and destroy 100k short-lived vectors of
+    * 16 ints: once from the heap, once from an arena
+    * that is released all at once at the end of a batch
+    ***************************************/
+   void bench_allocator()
+   {
+      const size_t numVectors = 100000;
+      const size_t numBatch = 1000;
+      const int numElements = 16;
+      header("Vector", "100k short-lived vectors of 16 ints");
+
+      double msHeap = time([&]()
+      {
+         for (size_t i = 0; i < numVectors; i++)
+         {
+            custom::vector<int> v;
+            for (int j = 0; j < numElements; j++)
+               v.push_back(j);
+            doNotOptimize(v.back());
+         }
+      });
+      row("std::allocator", msHeap, "ms");
+
+      double msArena = time([&]()
+      {
+         static char buffer[1 << 20];
+         for (size_t i = 0; i < numVectors; i += numBatch)
+         {
+            std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+            for (size_t k = 0; k < numBatch; k++)
+            {
+               custom::pmr::vector<int> v(&arena);
+               for (int j = 0; j < numElements; j++)
+                  v.push_back(j);
+               doNotOptimize(v.back());
+            }
+         }
+      });
+      row("pmr::monotonic_buffer_resource", msArena, "ms");
+   }
+};
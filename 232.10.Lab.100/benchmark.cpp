@@ -0,0 +1,48 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Driver to measure the performance of vector.h, mapped_vector.h,
+ *    simd.h, soa_vector.h, deque.h, circular_buffer.h,
+ *    persistent_vector.h, sort.h, bitvector.h, packed_int_vector.h,
+ *    compressed_vector.h, and incremental_vector.h.
+ *    Build with optimizations on; timings from a debug build mean little.
+ *    With libstdc++, the parallel algorithms also need -ltbb.
+ ************************************************************************/
+
+#include "benchVector.h"       // for the vector benchmarks
+#include "benchMappedVector.h" // for the mapped vector benchmarks
+#include "benchSimd.h"         // for the simd algorithm benchmarks
+#include "benchSoaVector.h"    // for the struct-of-arrays benchmarks
+#include "benchDeque.h"        // for the deque benchmarks
+#include "benchCircularBuffer.h" // for the circular buffer benchmarks
+#include "benchPersistentVector.h" // for the persistent vector benchmarks
+#include "benchSort.h"         // for the sort benchmarks
+#include "benchBitvector.h"    // for the bitvector benchmarks
+#include "benchPackedIntVector.h" // for the packed int vector benchmarks
+#include "benchCompressedVector.h" // for the compressed vector benchmarks
+#include "benchIncrementalVector.h" // for the incremental vector benchmarks
+
+/**********************************************************************
+ * MAIN
+ * Run each of the benchmarks in turn
+ ***********************************************************************/
+int main()
+{
+   BenchVector().run();
+#ifdef MAPPED_VECTOR
+   BenchMappedVector().run();
+#endif
+   BenchSimd().run();
+   BenchSoaVector().run();
+   BenchDeque().run();
+   BenchCircularBuffer().run();
+   BenchPersistentVector().run();
+   BenchSort().run();
+   BenchBitvector().run();
+   BenchPackedIntVector().run();
+   BenchCompressedVector().run();
+   BenchIncrementalVector().run();
+
+   return 0;
+}
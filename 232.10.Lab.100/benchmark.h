@@ -0,0 +1,197 @@
+/***********************************************************************
+ * Header:
+ *    BENCHMARK
+ * Summary:
+ *    The base class to all the benchmark classes. Where a unit test
+ *    asks "is it right," a benchmark asks "how long did it take?"
+ ************************************************************************/
+
+#pragma once
+
+#include <iostream>  // for std::cout
+#include <iomanip>   // for std::setw
+#include <string>    // for std::string
+#include <chrono>    // for std::chrono::steady_clock
+#include <fstream>   // for /proc/self/status
+#include <vector>    // for std::vector, to hold the latency samples
+#include <algorithm> // for std::sort
+
+class Benchmark
+{
+protected:
+   /*************************************************************
+    * TIME
+    * Run the passed function once and return the wall time
+    * it took in milliseconds
+    *************************************************************/
+   template <class Function>
+   static double time(Function f)
+   {
+      auto begin = std::chrono::steady_clock::now();
+      f();
+      auto end = std::chrono::steady_clock::now();
+      return std::chrono::duration<double, std::milli>(end - begin).count();
+   }
+
+   /*************************************************************
+    * PEAK KB
+    * Run the passed function and return how far it pushed the
+    * resident memory above where it started, in kilobytes. The
+    * kernel's high-water mark is reset first, so an earlier
+    * benchmark's peak does not hide this one's.
+    * Returns -1 where this cannot be measured.
+    *************************************************************/
+   template <class Function>
+   static long peakKB(Function f)
+   {
+      {
+         std::ofstream clear("/proc/self/clear_refs");
+         if (!(clear << "5"))
+            return -1;
+      }
+      long before = statusKB("VmRSS:");
+      f();
+      long peak = statusKB("VmHWM:");
+      return (before < 0 || peak < 0) ? -1 : peak - before;
+   }
+
+   /*************************************************************
+    * PHYSICAL KB
+    * How much memory the machine has, in kilobytes, so a
+    * benchmark can skip a case that would only measure paging.
+    * Returns -1 where this cannot be measured.
+    *************************************************************/
+   static long physicalKB()
+   {
+      return statusKB("MemTotal:", "/proc/meminfo");
+   }
+
+   /*************************************************************
+    * LATENCY
+    * Call f(0) ... f(num - 1), timing each call on its own,
+    * and report the median, the tail, and the worst. A
+    * mean would hide the rare call that does all the work.
+    *************************************************************/
+   template <class Function>
+   static void latency(size_t num, Function f)
+   {
+      std::vector<float> ns = samples(num, f);
+      row("   p50",   (double)ns[num / 2],             "ns");
+      row("   p99",   (double)ns[num / 100 * 99],      "ns");
+      row("   p99.9", (double)ns[num / 1000 * 999],    "ns");
+      row("   p99.99",(double)ns[num / 10000 * 9999],  "ns");
+      row("   max",   (double)ns[num - 1] / 1000000.0, "ms");
+   }
+
+   /*************************************************************
+    * HISTOGRAM
+    * Time each call the same way, and report how many took
+    * under 100ns, under 1us, and so on by powers of ten: the
+    * shape of the tail, not just a few points on it
+    *************************************************************/
+   template <class Function>
+   static void histogram(size_t num, Function f)
+   {
+      static const char * labels[] =
+         { "   < 100ns", "   < 1us", "   < 10us", "   < 100us", "   < 1ms", "   >= 1ms" };
+      std::vector<float> ns = samples(num, f);
+      size_t i = 0;
+      float limit = 100.0f;
+      for (int bucket = 0; bucket < 6; bucket++, limit *= 10.0f)
+      {
+         size_t first = i;
+         while (i < num && (bucket == 5 || ns[i] < limit))
+            i++;
+         row(labels[bucket], (long)(i - first), "calls");
+      }
+      row("   p99.9", (double)ns[num / 1000 * 999],    "ns");
+      row("   max",   (double)ns[num - 1] / 1000000.0, "ms");
+   }
+
+   /*************************************************************
+    * HEADER
+    * Name the benchmark and the case being measured
+    *************************************************************/
+   static void header(const char * name, const std::string & description)
+   {
+      std::cout << name << ":\t" << description << "\n";
+   }
+
+   /*************************************************************
+    * ROW
+    * Report one measurement: a label, a number, and the units
+    *************************************************************/
+   static void row(const std::string & label, double value, const char * units)
+   {
+      std::cout.setf(std::ios::fixed | std::ios::showpoint);
+      std::cout.precision(2);
+      std::cout << "\t" << std::left << std::setw(32) << label
+                << std::right << std::setw(14) << value << " " << units << "\n";
+   }
+
+   /*************************************************************
+    * ROW
+    * Report one count, such as the number of copies made
+    *************************************************************/
+   static void row(const std::string & label, long count, const char * units)
+   {
+      std::cout << "\t" << std::left << std::setw(32) << label
+                << std::right << std::setw(11) << count << " " << units << "\n";
+   }
+
+   /*************************************************************
+    * DO NOT OPTIMIZE
+    * Keep the optimizer from discarding a result we computed
+    * only to measure how long it took to compute. Where the
+    * compiler allows, memory is also treated as changed, so a
+    * loop that computes the same result again really does.
+    *************************************************************/
+   template <class T>
+   static void doNotOptimize(const T & value)
+   {
+#if defined(__GNUC__) || defined(__clang__)
+      asm volatile("" : : "r"(&value) : "memory");
+#else
+      sink = (const volatile void *)&value;
+#endif
+   }
+
+private:
+   /*************************************************************
+    * SAMPLES
+    * How long each of f(0) ... f(num - 1) took in
+    * nanoseconds, sorted from fastest to slowest
+    *************************************************************/
+   template <class Function>
+   static std::vector<float> samples(size_t num, Function f)
+   {
+      std::vector<float> ns(num);
+      for (size_t i = 0; i < num; i++)
+      {
+         auto begin = std::chrono::steady_clock::now();
+         f(i);
+         auto end = std::chrono::steady_clock::now();
+         ns[i] = std::chrono::duration<float, std::nano>(end - begin).count();
+      }
+      std::sort(ns.begin(), ns.end());
+      return ns;
+   }
+
+   /*************************************************************
+    * STATUS KB
+    * Read one of the memory fields, such as "VmRSS:",
+    * out of /proc/self/status or another file like it
+    *************************************************************/
+   static long statusKB(const char * field, const char * file = "/proc/self/status")
+   {
+      std::ifstream status(file);
+      std::string line;
+      size_t length = std::string(field).size();
+      while (std::getline(status, line))
+         if (line.compare(0, length, field) == 0)
+            return std::stol(line.substr(length));
+      return -1;
+   }
+
+   static inline const volatile void * sink = nullptr;
+};
@@ -0,0 +1,326 @@
+/***********************************************************************
+ * Header:
+ *    BITVECTOR
+ * Summary:
+ *    A growable array of bools kept one bit each, 64 to a word,
+ *    where a vector<bool> spends a byte on every flag. Working a
+ *    word at a time, counting the set bits or finding the next
+ *    one looks at 64 flags per instruction.
+ *
+ *    This will contain the class definition of:
+ *        bitvector              : An array of bits
+ *        bitvector::reference   : A stand-in for one bit, to assign through
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>     // for uint64_t
+#include <cstddef>     // for size_t
+#include <cassert>     // because I am paranoid
+#include "vector.h"
+#ifdef _MSC_VER
+#include <intrin.h>    // for __popcnt64 and _BitScanForward64
+#endif
+
+class TestBitvector; // forward declaration for unit tests
+
+namespace custom
+{
+namespace detail
+{
+
+// the number of set bits in a word
+inline unsigned popCount64(uint64_t word)
+{
+#ifdef _MSC_VER
+   return (unsigned)__popcnt64(word);
+#else
+   return (unsigned)__builtin_popcountll(word);
+#endif
+}
+
+// the index of the lowest set bit of a non-zero word
+inline unsigned firstBit64(uint64_t word)
+{
+#ifdef _MSC_VER
+   unsigned long index;
+   _BitScanForward64(&index, word);
+   return index;
+#else
+   return (unsigned)__builtin_ctzll(word);
+#endif
+}
+
+} // namespace detail
+
+/*****************************************
+ * BITVECTOR
+ * Bit i is bit i % 64 of word i / 64. The bits of the
+ * last word past size() are always 0, so a word can be
+ * counted or searched without masking it first.
+ ****************************************/
+class bitvector
+{
+   friend class ::TestBitvector; // give unit tests access to the privates
+public:
+   class reference;
+
+   //
+   // Construct
+   //
+
+   bitvector() : numBits(0) {}
+   bitvector(size_t num, bool value = false) : numBits(0) { resize(num, value); }
+
+   //
+   // Access
+   //
+
+   bool test(size_t index) const
+   {
+      assert(index < numBits);
+      return (words[index / 64] >> (index % 64)) & 1;
+   }
+   bool operator [] (size_t index) const { return test(index); }
+   reference operator [] (size_t index);
+   bool front() const { return test(0);           }
+   bool back()  const { return test(numBits - 1); }
+
+   // the words themselves, for callers who work a word at a time
+   const vector<uint64_t> & data() const { return words; }
+
+   //
+   // Update
+   //
+
+   void set(size_t index, bool value = true)
+   {
+      assert(index < numBits);
+      uint64_t mask = uint64_t(1) << (index % 64);
+      uint64_t & word = words[index / 64];
+      word = value ? (word | mask) : (word & ~mask);
+   }
+   void reset(size_t index) { set(index, false); }
+   void flip(size_t index)
+   {
+      assert(index < numBits);
+      words[index / 64] ^= uint64_t(1) << (index % 64);
+   }
+
+   // set every bit in [first, last) to value
+   void set(size_t first, size_t last, bool value);
+
+   // combine with another bitvector of the same size
+   bitvector & operator &= (const bitvector & rhs);
+   bitvector & operator |= (const bitvector & rhs);
+   bitvector & operator ^= (const bitvector & rhs);
+
+   //
+   // Insert and remove
+   //
+
+   void push_back(bool value)
+   {
+      if (numBits % 64 == 0)
+         words.push_back(0);
+      numBits++;
+      set(numBits - 1, value);
+   }
+   void pop_back()
+   {
+      if (numBits == 0)
+         return;
+      reset(numBits - 1);
+      numBits--;
+      if (numBits % 64 == 0)
+         words.pop_back();
+   }
+   void resize(size_t num, bool value = false);
+   void reserve(size_t num) { words.reserve(numWords(num)); }
+   void clear()             { words.clear(); numBits = 0;    }
+
+   //
+   // Count and search
+   //
+
+   // how many bits are set
+   size_t count() const { return rank(numBits); }
+
+   // how many bits before index are set
+   size_t rank(size_t index) const;
+
+   // the first set bit at or after index, or size() if none
+   size_t find_next(size_t index) const;
+   size_t find_first() const { return find_next(0); }
+
+   //
+   // Status
+   //
+
+   size_t size()     const { return numBits;               }
+   bool   empty()    const { return numBits == 0;          }
+   size_t capacity() const { return words.capacity() * 64; }
+
+   // the memory the bits take up
+   size_t bytes() const { return words.capacity() * sizeof(uint64_t); }
+
+private:
+   static size_t numWords(size_t num) { return (num + 63) / 64; }
+
+   // clear the bits of the last word past size()
+   void trimLastWord()
+   {
+      if (numBits % 64)
+         words[numBits / 64] &= (uint64_t(1) << (numBits % 64)) - 1;
+   }
+
+   vector<uint64_t> words;   // the bits, 64 to a word
+   size_t  numBits;          // the number of bits in use
+};
+
+/**************************************************
+ * BITVECTOR REFERENCE
+ * There is no way to point at one bit, so the non-const
+ * subscript hands back one of these: it reads as the bit,
+ * and assigning to it sets the bit.
+ *************************************************/
+class bitvector::reference
+{
+   friend class bitvector;
+public:
+   operator bool () const { return (*word >> bit) & 1; }
+   reference & operator = (bool value)
+   {
+      uint64_t mask = uint64_t(1) << bit;
+      *word = value ? (*word | mask) : (*word & ~mask);
+      return *this;
+   }
+   reference & operator = (const reference & rhs) { return *this = (bool)rhs; }
+   void flip() { *word ^= uint64_t(1) << bit; }
+
+private:
+   reference(uint64_t * word, unsigned bit) : word(word), bit(bit) {}
+
+   uint64_t * word;   // the word the bit is in
+   unsigned   bit;    // which bit of it
+};
+
+/*****************************************
+ * BITVECTOR :: SUBSCRIPT
+ ****************************************/
+inline bitvector::reference bitvector :: operator [] (size_t index)
+{
+   assert(index < numBits);
+   return reference(&words[index / 64], (unsigned)(index % 64));
+}
+
+/*****************************************
+ * BITVECTOR :: SET RANGE
+ * The words wholly inside the range are filled;
+ * only the words at the two ends need a mask
+ ****************************************/
+inline void bitvector :: set(size_t first, size_t last, bool value)
+{
+   assert(first <= last && last <= numBits);
+   if (first == last)
+      return;
+
+   size_t iFirst = first / 64;
+   size_t iLast = (last - 1) / 64;
+   uint64_t firstMask = ~uint64_t(0) << (first % 64);
+   uint64_t lastMask = ~uint64_t(0) >> (63 - (last - 1) % 64);
+   if (iFirst == iLast)
+      firstMask &= lastMask;
+
+   words[iFirst] = value ? (words[iFirst] | firstMask) : (words[iFirst] & ~firstMask);
+   if (iFirst == iLast)
+      return;
+   for (size_t i = iFirst + 1; i < iLast; i++)
+      words[i] = value ? ~uint64_t(0) : 0;
+   words[iLast] = value ? (words[iLast] | lastMask) : (words[iLast] & ~lastMask);
+}
+
+/*****************************************
+ * BITVECTOR :: AND, OR, XOR
+ * A word at a time. The bits past size() are 0 in
+ * both, and none of these can make a 1 from two 0s.
+ ****************************************/
+inline bitvector & bitvector :: operator &= (const bitvector & rhs)
+{
+   assert(numBits == rhs.numBits);
+   for (size_t i = 0; i < words.size(); i++)
+      words[i] &= rhs.words[i];
+   return *this;
+}
+
+inline bitvector & bitvector :: operator |= (const bitvector & rhs)
+{
+   assert(numBits == rhs.numBits);
+   for (size_t i = 0; i < words.size(); i++)
+      words[i] |= rhs.words[i];
+   return *this;
+}
+
+inline bitvector & bitvector :: operator ^= (const bitvector & rhs)
+{
+   assert(numBits == rhs.numBits);
+   for (size_t i = 0; i < words.size(); i++)
+      words[i] ^= rhs.words[i];
+   return *this;
+}
+
+/*****************************************
+ * BITVECTOR :: RESIZE
+ * New bits are value. Shrinking clears the bits
+ * cut off the end of what is now the last word.
+ ****************************************/
+inline void bitvector :: resize(size_t num, bool value)
+{
+   size_t numOld = numBits;
+   words.resize(numWords(num), 0);
+   numBits = num;
+   if (num > numOld)
+      set(numOld, num, value);
+   else
+      trimLastWord();
+}
+
+/*****************************************
+ * BITVECTOR :: RANK
+ * Whole words are counted with one popcount each,
+ * then the part of the last word before index
+ ****************************************/
+inline size_t bitvector :: rank(size_t index) const
+{
+   assert(index <= numBits);
+   size_t total = 0;
+   size_t iWord = index / 64;
+   for (size_t i = 0; i < iWord; i++)
+      total += detail::popCount64(words[i]);
+   if (index % 64)
+      total += detail::popCount64(words[iWord] & ((uint64_t(1) << (index % 64)) - 1));
+   return total;
+}
+
+/*****************************************
+ * BITVECTOR :: FIND NEXT
+ * Skip the words with nothing set, then take the
+ * lowest bit of the first word that has one
+ ****************************************/
+inline size_t bitvector :: find_next(size_t index) const
+{
+   if (index >= numBits)
+      return numBits;
+
+   size_t iWord = index / 64;
+   uint64_t word = words[iWord] & (~uint64_t(0) << (index % 64));
+   while (word == 0)
+   {
+      if (++iWord == words.size())
+         return numBits;
+      word = words[iWord];
+   }
+   return iWord * 64 + detail::firstBit64(word);
+}
+
+} // namespace custom
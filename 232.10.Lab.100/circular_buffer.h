@@ -0,0 +1,422 @@
+/***********************************************************************
+ * Header:
+ *    CIRCULAR BUFFER
+ * Summary:
+ *    A bounded queue in one buffer that never grows. The ends chase
+ *    each other around it, so pushing and popping at either end
+ *    never allocates, and the buffer is a power of two long so
+ *    wrapping around is a mask rather than a divide.
+ *
+ *    This will contain the class definition of:
+ *        circular_buffer        : A fixed-capacity ring of elements
+ ************************************************************************/
+
+#pragma once
+
+#include <memory>      // for std::allocator
+#include <utility>     // for std::swap and std::move
+#include <type_traits> // for std::is_trivially_copyable
+#include <cstddef>     // for size_t
+#include <cstring>     // for memcpy
+
+class TestCircularBuffer; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * CIRCULAR BUFFER
+ * Element i lives at data[(iFront + i) & mask].
+ * When the buffer is full a push either fails
+ * (REJECT) or takes the place of the element at
+ * the other end (OVERWRITE).
+ ****************************************/
+template <typename T>
+class circular_buffer
+{
+   friend class ::TestCircularBuffer; // give unit tests access to the privates
+   typedef std::allocator<T>             Alloc;
+   typedef std::allocator_traits<Alloc>  AllocTraits;
+public:
+   // what a push onto a full buffer does
+   enum Policy { REJECT, OVERWRITE };
+
+   //
+   // Construct
+   //
+
+   // room for at least capacity elements, rounded up to a power of two
+   circular_buffer(size_t capacity, Policy policy = REJECT);
+   circular_buffer(const circular_buffer &  rhs);
+   circular_buffer(      circular_buffer && rhs);
+   ~circular_buffer();
+
+   //
+   // Assign
+   //
+
+   circular_buffer & operator = (const circular_buffer &  rhs);
+   circular_buffer & operator = (      circular_buffer && rhs);
+   void swap(circular_buffer & rhs);
+
+   //
+   // Access
+   //
+
+         T & operator [] (size_t index)       { return data[(iFront + index) & mask];           }
+   const T & operator [] (size_t index) const { return data[(iFront + index) & mask];           }
+         T & front()                          { return data[iFront];                            }
+   const T & front()                    const { return data[iFront];                            }
+         T & back()                           { return data[(iFront + numElements - 1) & mask]; }
+   const T & back()                     const { return data[(iFront + numElements - 1) & mask]; }
+
+   //
+   // Insert: each returns false if the buffer was full
+   // and the policy is REJECT
+   //
+
+   bool push_back (const T & t) { return emplace_back(t);             }
+   bool push_back (T && t)      { return emplace_back(std::move(t));  }
+   bool push_front(const T & t) { return emplace_front(t);            }
+   bool push_front(T && t)      { return emplace_front(std::move(t)); }
+   template <class ... Args>
+   bool emplace_back(Args && ... args);
+   template <class ... Args>
+   bool emplace_front(Args && ... args);
+
+   // copy num elements from source onto the back, returning
+   // how many were taken
+   size_t push_n(const T * source, size_t num);
+
+   //
+   // Remove
+   //
+
+   void clear();
+   void pop_back();
+   void pop_front();
+
+   // move up to num elements off the front into dest,
+   // returning how many there were
+   size_t pop_n(T * dest, size_t num);
+
+   //
+   // Status
+   //
+
+   size_t size()     const { return numElements;               }
+   size_t capacity() const { return data ? mask + 1 : 0;       }
+   bool   empty()    const { return numElements == 0;          }
+   bool   full()     const { return numElements == capacity(); }
+   Policy policy()   const { return fullPolicy;                }
+
+private:
+   static size_t roundUp(size_t num)
+   {
+      size_t power = 1;
+      while (power < num)
+         power *= 2;
+      return power;
+   }
+
+   // the contiguous run of num slots from index begin,
+   // or the part of it before the buffer wraps
+   size_t runLength(size_t begin, size_t num) const
+   {
+      size_t toEnd = capacity() - begin;
+      return (num < toEnd) ? num : toEnd;
+   }
+
+   // copy or move num elements between the ring and an array
+   static void copyIn (T * dest, const T * source, size_t num, Alloc & alloc);
+   static void moveOut(T * dest,       T * source, size_t num, Alloc & alloc);
+
+   Alloc   alloc;        // source of the buffer
+   T *     data;         // the ring, capacity() elements long
+   size_t  mask;         // capacity() - 1
+   size_t  iFront;       // where front() is
+   size_t  numElements;  // the number of items currently used
+   Policy  fullPolicy;   // what a push onto a full buffer does
+};
+
+/*****************************************
+ * CIRCULAR BUFFER :: NON-DEFAULT constructor
+ * The only allocation the buffer ever makes
+ ****************************************/
+template <typename T>
+circular_buffer <T> :: circular_buffer(size_t capacity, Policy policy) :
+   data(nullptr), mask(roundUp(capacity) - 1), iFront(0), numElements(0), fullPolicy(policy)
+{
+   data = AllocTraits::allocate(alloc, mask + 1);
+}
+
+/*****************************************
+ * CIRCULAR BUFFER :: COPY CONSTRUCTOR
+ ****************************************/
+template <typename T>
+circular_buffer <T> :: circular_buffer(const circular_buffer & rhs) :
+   circular_buffer(rhs.capacity(), rhs.fullPolicy)
+{
+   for (size_t i = 0; i < rhs.numElements; i++)
+      emplace_back(rhs[i]);
+}
+
+/*****************************************
+ * CIRCULAR BUFFER :: MOVE CONSTRUCTOR
+ * Take the buffer, leaving rhs with none: a
+ * capacity of 0, onto which every push fails
+ ****************************************/
+template <typename T>
+circular_buffer <T> :: circular_buffer(circular_buffer && rhs) :
+   data(rhs.data), mask(rhs.mask), iFront(rhs.iFront), numElements(rhs.numElements),
+   fullPolicy(rhs.fullPolicy)
+{
+   rhs.data = nullptr;
+   rhs.mask = 0;
+   rhs.iFront = 0;
+   rhs.numElements = 0;
+}
+
+/*****************************************
+ * CIRCULAR BUFFER :: DESTRUCTOR
+ ****************************************/
+template <typename T>
+circular_buffer <T> :: ~circular_buffer()
+{
+   if (data)
+   {
+      clear();
+      AllocTraits::deallocate(alloc, data, mask + 1);
+   }
+}
+
+/*****************************************
+ * CIRCULAR BUFFER :: ASSIGNMENT
+ ****************************************/
+template <typename T>
+circular_buffer <T> & circular_buffer <T> :: operator = (const circular_buffer & rhs)
+{
+   if (this != &rhs)
+   {
+      circular_buffer copy(rhs);
+      swap(copy);
+   }
+   return *this;
+}
+
+template <typename T>
+circular_buffer <T> & circular_buffer <T> :: operator = (circular_buffer && rhs)
+{
+   if (this != &rhs)
+   {
+      circular_buffer taken(std::move(rhs));
+      swap(taken);
+   }
+   return *this;
+}
+
+/*****************************************
+ * CIRCULAR BUFFER :: SWAP
+ ****************************************/
+template <typename T>
+void circular_buffer <T> :: swap(circular_buffer & rhs)
+{
+   std::swap(data,        rhs.data);
+   std::swap(mask,        rhs.mask);
+   std::swap(iFront,      rhs.iFront);
+   std::swap(numElements, rhs.numElements);
+   std::swap(fullPolicy,  rhs.fullPolicy);
+}
+
+/*****************************************
+ * CIRCULAR BUFFER :: EMPLACE BACK
+ * Full and OVERWRITE: the front element goes, and
+ * the new one takes its slot as the back
+ ****************************************/
+template <typename T>
+template <class ... Args>
+bool circular_buffer <T> :: emplace_back(Args && ... args)
+{
+   if (full())
+   {
+      if (fullPolicy == REJECT || data == nullptr)
+         return false;
+      // build it first: args may refer to the front
+      T t(std::forward<Args>(args)...);
+      data[iFront] = std::move(t);
+      iFront = (iFront + 1) & mask;
+      return true;
+   }
+
+   AllocTraits::construct(alloc, data + ((iFront + numElements) & mask),
+                          std::forward<Args>(args)...);
+   numElements++;
+   return true;
+}
+
+/*****************************************
+ * CIRCULAR BUFFER :: EMPLACE FRONT
+ * Full and OVERWRITE: the back element goes
+ ****************************************/
+template <typename T>
+template <class ... Args>
+bool circular_buffer <T> :: emplace_front(Args && ... args)
+{
+   size_t iNew = (iFront - 1) & mask;
+   if (full())
+   {
+      if (fullPolicy == REJECT || data == nullptr)
+         return false;
+      // the slot before the front is the back
+      T t(std::forward<Args>(args)...);
+      data[iNew] = std::move(t);
+      iFront = iNew;
+      return true;
+   }
+
+   AllocTraits::construct(alloc, data + iNew, std::forward<Args>(args)...);
+   iFront = iNew;
+   numElements++;
+   return true;
+}
+
+/*****************************************
+ * CIRCULAR BUFFER :: PUSH N
+ * The free space is at most two runs: to the end
+ * of the buffer, then from its start. Under
+ * OVERWRITE the oldest elements are dropped to make
+ * room, and only the last capacity() of source can
+ * survive, so the rest are never copied.
+ ****************************************/
+template <typename T>
+size_t circular_buffer <T> :: push_n(const T * source, size_t num)
+{
+   size_t numTaken = num;
+   if (fullPolicy == OVERWRITE)
+   {
+      if (num > capacity())
+      {
+         source += num - capacity();
+         num = capacity();
+      }
+      size_t numFree = capacity() - numElements;
+      for (size_t i = numFree; i < num; i++)
+         pop_front();
+   }
+   else if (num > capacity() - numElements)
+      num = numTaken = capacity() - numElements;
+
+   size_t iBack = (iFront + numElements) & mask;
+   size_t numFirst = runLength(iBack, num);
+   copyIn(data + iBack, source, numFirst, alloc);
+   numElements += numFirst;
+   copyIn(data, source + numFirst, num - numFirst, alloc);
+   numElements += num - numFirst;
+   return numTaken;
+}
+
+/*****************************************
+ * CIRCULAR BUFFER :: POP N
+ * The elements are at most two runs, moved out
+ * in order
+ ****************************************/
+template <typename T>
+size_t circular_buffer <T> :: pop_n(T * dest, size_t num)
+{
+   if (num > numElements)
+      num = numElements;
+
+   size_t numFirst = runLength(iFront, num);
+   moveOut(dest, data + iFront, numFirst, alloc);
+   moveOut(dest + numFirst, data, num - numFirst, alloc);
+   iFront = (iFront + num) & mask;
+   numElements -= num;
+   return num;
+}
+
+/*****************************************
+ * CIRCULAR BUFFER :: CLEAR
+ ****************************************/
+template <typename T>
+void circular_buffer <T> :: clear()
+{
+   if (!std::is_trivially_destructible<T>::value)
+      for (size_t i = 0; i < numElements; i++)
+         AllocTraits::destroy(alloc, &(*this)[i]);
+   iFront = 0;
+   numElements = 0;
+}
+
+/*****************************************
+ * CIRCULAR BUFFER :: POP BACK / POP FRONT
+ ****************************************/
+template <typename T>
+void circular_buffer <T> :: pop_back()
+{
+   if (numElements == 0)
+      return;
+   AllocTraits::destroy(alloc, &back());
+   numElements--;
+}
+
+template <typename T>
+void circular_buffer <T> :: pop_front()
+{
+   if (numElements == 0)
+      return;
+   AllocTraits::destroy(alloc, &front());
+   iFront = (iFront + 1) & mask;
+   numElements--;
+}
+
+/*****************************************
+ * CIRCULAR BUFFER :: COPY IN
+ * Construct num copies into empty slots. For
+ * plain data this is one memcpy. If a copy throws,
+ * the ones before it are undone.
+ ****************************************/
+template <typename T>
+void circular_buffer <T> :: copyIn(T * dest, const T * source, size_t num, Alloc & alloc)
+{
+   if (num == 0)
+      return;
+   if constexpr (std::is_trivially_copyable<T>::value)
+      memcpy((void *)dest, (const void *)source, num * sizeof(T));
+   else
+   {
+      size_t i = 0;
+      try
+      {
+         for (; i < num; i++)
+            AllocTraits::construct(alloc, dest + i, source[i]);
+      }
+      catch (...)
+      {
+         while (i > 0)
+            AllocTraits::destroy(alloc, dest + --i);
+         throw;
+      }
+   }
+}
+
+/*****************************************
+ * CIRCULAR BUFFER :: MOVE OUT
+ * Move num elements over the ones in dest,
+ * leaving their slots empty
+ ****************************************/
+template <typename T>
+void circular_buffer <T> :: moveOut(T * dest, T * source, size_t num, Alloc & alloc)
+{
+   if (num == 0)
+      return;
+   if constexpr (std::is_trivially_copyable<T>::value)
+      memcpy((void *)dest, (const void *)source, num * sizeof(T));
+   else
+      for (size_t i = 0; i < num; i++)
+      {
+         dest[i] = std::move(source[i]);
+         AllocTraits::destroy(alloc, source + i);
+      }
+}
+
+} // namespace custom
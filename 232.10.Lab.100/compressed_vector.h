@@ -0,0 +1,383 @@
+/***********************************************************************
+ * Header:
+ *    COMPRESSED VECTOR
+ * Summary:
+ *    A read-only column of 64-bit integers, such as sorted timestamps
+ *    or IDs, kept as the differences between neighbors rather than
+ *    the values themselves. The values are cut into blocks of 128.
+ *    Within a block, every difference has the smallest one taken
+ *    off, and what is left is packed into just as many bits as the
+ *    largest needs. Timestamps a steady millisecond apart take no
+ *    bits at all. A table with one entry per block says where each
+ *    block starts, so element i is found without decoding the
+ *    blocks before it.
+ *
+ *    This will contain the class definition of:
+ *        compressed_vector                 : A compressed column of uint64_t
+ *        compressed_vector::const_iterator : Decodes a block at a time
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>     // for uint64_t and uint32_t
+#include <cstddef>     // for size_t
+#include <cassert>     // because I am paranoid
+#include <utility>     // for std::index_sequence
+#include <iterator>    // for std::forward_iterator_tag
+#include "vector.h"
+#include "simd.h"              // for simd::level()
+#include "packed_int_vector.h" // for detail::unpackAvx2
+
+class TestCompressedVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * COMPRESSED VECTOR
+ * Block b holds elements [128b, 128b + 128). Its entry
+ * in blocks gives its first value, the smallest
+ * difference between neighbors in it, and where in words
+ * its 128 packed slots start, each width bits wide. Slot
+ * k is the difference between element k and element
+ * k - 1, less the smallest; slot 0 is unused. The
+ * arithmetic wraps, so values that are not sorted still
+ * come back right, they just do not shrink.
+ ****************************************/
+class compressed_vector
+{
+   friend class ::TestCompressedVector; // give unit tests access to the privates
+public:
+   static constexpr size_t blockSize = 128;
+
+   class const_iterator;
+
+   //
+   // Construct
+   //
+
+   compressed_vector() : numElements(0) {}
+   template <typename A, typename G>
+   explicit compressed_vector(const vector <uint64_t, A, G> & source);
+
+   //
+   // Access
+   //
+
+   // element index: one block entry, then part of one block
+   uint64_t operator [] (size_t index) const;
+
+   // the first element no less than value, or size() if none.
+   // Only meaningful when the elements are sorted.
+   size_t lower_bound(uint64_t value) const;
+
+   // decode block iBlock into dest, returning how many it holds
+   size_t decode(size_t iBlock, uint64_t * dest) const;
+
+   // decode every element into dest, which is resized to fit
+   template <typename A, typename G>
+   void decode(vector <uint64_t, A, G> & dest) const
+   {
+      dest.resize(numElements);
+      for (size_t b = 0; b < blocks.size(); b++)
+         decode(b, &dest[0] + b * blockSize);
+   }
+
+   //
+   // Iterator
+   //
+
+   const_iterator begin() const;
+   const_iterator end()   const;
+
+   //
+   // Status
+   //
+
+   size_t size()      const { return numElements;      }
+   bool   empty()     const { return numElements == 0; }
+   size_t numBlocks() const { return blocks.size();    }
+
+   // the memory the column takes up
+   size_t bytes() const
+   {
+      return blocks.capacity() * sizeof(Block) + words.capacity() * sizeof(uint64_t);
+   }
+
+private:
+   struct Block
+   {
+      uint64_t first;      // the block's first value
+      uint64_t minDelta;   // the smallest difference between neighbors
+      size_t   offset;     // where its slots start in words
+      size_t   width;      // bits in each slot, 0 to 64
+   };
+
+   // the words past the last block, so an unpack can load
+   // 16 bytes from the start of any group of 8 slots
+   static constexpr size_t padWords = 2;
+
+   // the number of elements in block iBlock
+   size_t blockCount(size_t iBlock) const
+   {
+      size_t rest = numElements - iBlock * blockSize;
+      return (rest < blockSize) ? rest : blockSize;
+   }
+
+   // slot k of a block
+   uint64_t slot(const Block & block, size_t k) const;
+
+   vector<Block>    blocks;      // one entry per block: the skip table
+   vector<uint64_t> words;       // every block's slots, packed
+   size_t           numElements; // the number of values
+};
+
+namespace detail
+{
+
+// how many bits value needs: 0 for 0
+inline size_t bitWidth(uint64_t value)
+{
+   size_t width = 0;
+   for (; value; value >>= 1)
+      width++;
+   return width;
+}
+
+#ifdef SIMD_X86
+/*****************************************
+ * UNPACKER
+ * unpackAvx2 for a width known only when the program
+ * runs: entry w unpacks w-bit slots, for w from 1 to 25
+ ****************************************/
+typedef void (*Unpacker)(const uint8_t * source, size_t numGroups, uint32_t * dest);
+
+template <size_t ... W>
+const Unpacker * unpackers(std::index_sequence<W ...>)
+{
+   static const Unpacker table[] = { nullptr, &unpackAvx2<W + 1> ... };
+   return table;
+}
+
+inline Unpacker unpacker(size_t width)
+{
+   return unpackers(std::make_index_sequence<25>())[width];
+}
+#endif // SIMD_X86
+
+} // namespace detail
+
+/**************************************************
+ * COMPRESSED VECTOR CONST ITERATOR
+ * Walks the elements in order. It keeps the block it
+ * is in decoded, so each step is a read from that
+ * buffer, and a whole block is decoded every 128 steps.
+ * That makes it a kilobyte: pass it by reference.
+ *************************************************/
+class compressed_vector::const_iterator
+{
+   friend class compressed_vector;
+public:
+   typedef std::forward_iterator_tag iterator_category;
+   typedef uint64_t                  value_type;
+   typedef std::ptrdiff_t            difference_type;
+   typedef const uint64_t *          pointer;
+   typedef const uint64_t &          reference;
+
+   const_iterator() : cv(nullptr), index(0) {}
+
+   const uint64_t & operator * () const { return buffer[index % blockSize]; }
+
+   const_iterator & operator ++ ()
+   {
+      if (++index % blockSize == 0 && index < cv->numElements)
+         cv->decode(index / blockSize, buffer);
+      return *this;
+   }
+   const_iterator operator ++ (int)
+   {
+      const_iterator old(*this);
+      ++(*this);
+      return old;
+   }
+
+   bool operator == (const const_iterator & rhs) const { return index == rhs.index; }
+   bool operator != (const const_iterator & rhs) const { return index != rhs.index; }
+
+private:
+   const_iterator(const compressed_vector * cv, size_t index) : cv(cv), index(index)
+   {
+      if (index < cv->numElements)
+         cv->decode(index / blockSize, buffer);
+   }
+
+   const compressed_vector * cv;   // the column we walk
+   size_t   index;                 // the element we are on
+   uint64_t buffer[blockSize];     // its block, decoded
+};
+
+/*****************************************
+ * COMPRESSED VECTOR :: CONSTRUCTOR
+ * Each block is passed over twice: once for the
+ * smallest and largest difference, which fix the
+ * width, then again to pack the slots. The column
+ * never grows, so the words are trimmed to fit.
+ ****************************************/
+template <typename A, typename G>
+compressed_vector :: compressed_vector(const vector <uint64_t, A, G> & source) :
+   numElements(source.size())
+{
+   size_t numBlocks = (numElements + blockSize - 1) / blockSize;
+   blocks.reserve(numBlocks);
+
+   for (size_t b = 0; b < numBlocks; b++)
+   {
+      const uint64_t * p = &source[0] + b * blockSize;
+      size_t num = blockCount(b);
+
+      uint64_t minDelta = (num > 1) ? p[1] - p[0] : 0;
+      uint64_t maxDelta = minDelta;
+      for (size_t k = 2; k < num; k++)
+      {
+         uint64_t delta = p[k] - p[k - 1];
+         minDelta = (delta < minDelta) ? delta : minDelta;
+         maxDelta = (delta > maxDelta) ? delta : maxDelta;
+      }
+
+      Block block = { p[0], minDelta, words.size(), detail::bitWidth(maxDelta - minDelta) };
+      blocks.push_back(block);
+
+      // 128 slots of width bits is exactly 2 * width words
+      words.resize(words.size() + 2 * block.width, 0);
+      uint64_t * slots = (block.width == 0) ? nullptr : &words[0] + block.offset;
+      for (size_t k = 1; k < num && block.width; k++)
+      {
+         uint64_t value = p[k] - p[k - 1] - minDelta;
+         size_t bit = k * block.width;
+         size_t offset = bit % 64;
+         slots[bit / 64] |= value << offset;
+         if (offset + block.width > 64)
+            slots[bit / 64 + 1] |= value >> (64 - offset);
+      }
+   }
+   words.resize(words.size() + padWords, 0);
+   words.shrink_to_fit();
+}
+
+/*****************************************
+ * COMPRESSED VECTOR :: SLOT
+ * The low part from the word the slot starts in,
+ * and if it spills over, the rest from the next
+ ****************************************/
+inline uint64_t compressed_vector :: slot(const Block & block, size_t k) const
+{
+   if (block.width == 0)
+      return 0;
+   const uint64_t * slots = &words[0] + block.offset;
+   size_t bit = k * block.width;
+   size_t offset = bit % 64;
+   uint64_t value = slots[bit / 64] >> offset;
+   if (offset + block.width > 64)
+      value |= slots[bit / 64 + 1] << (64 - offset);
+   return (block.width == 64) ? value : value & ((uint64_t(1) << block.width) - 1);
+}
+
+/*****************************************
+ * COMPRESSED VECTOR :: SUBSCRIPT
+ * The block's first value, plus the smallest
+ * difference for every step into the block, plus
+ * the slots up to the one we want
+ ****************************************/
+inline uint64_t compressed_vector :: operator [] (size_t index) const
+{
+   assert(index < numElements);
+   const Block & block = blocks[index / blockSize];
+   size_t k = index % blockSize;
+   uint64_t value = block.first + k * block.minDelta;
+   for (size_t j = 1; j <= k; j++)
+      value += slot(block, j);
+   return value;
+}
+
+/*****************************************
+ * COMPRESSED VECTOR :: LOWER BOUND
+ * Binary search the blocks' first values for the
+ * last block that starts before value, then decode
+ * just that block and look through it
+ ****************************************/
+inline size_t compressed_vector :: lower_bound(uint64_t value) const
+{
+   // the first block starting at or past value
+   size_t lo = 0;
+   size_t hi = blocks.size();
+   while (lo < hi)
+   {
+      size_t mid = lo + (hi - lo) / 2;
+      if (blocks[mid].first < value)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   if (lo == 0)
+      return 0;
+
+   // the block before it starts below value, so the answer is in it or next
+   uint64_t buffer[blockSize];
+   size_t num = decode(lo - 1, buffer);
+   size_t k = 0;
+   while (k < num && buffer[k] < value)
+      k++;
+   return (lo - 1) * blockSize + k;
+}
+
+/*****************************************
+ * COMPRESSED VECTOR :: DECODE
+ * Unpack the slots, then add them up from the first
+ * value. With AVX2, slots of up to 25 bits are unpacked
+ * 8 at a time by the same kernel as packed_int_vector.
+ ****************************************/
+inline size_t compressed_vector :: decode(size_t iBlock, uint64_t * dest) const
+{
+   const Block & block = blocks[iBlock];
+   size_t num = blockCount(iBlock);
+   uint64_t value = block.first;
+   dest[0] = value;
+
+   if (block.width == 0)
+   {
+      for (size_t k = 1; k < num; k++)
+         dest[k] = value += block.minDelta;
+      return num;
+   }
+
+#ifdef SIMD_X86
+   if (block.width <= 25 && simd::level() == simd::AVX2)
+   {
+      uint32_t slots[blockSize];
+      const uint8_t * bytes = reinterpret_cast<const uint8_t *>(&words[0] + block.offset);
+      detail::unpacker(block.width)(bytes, blockSize / 8, slots);
+      for (size_t k = 1; k < num; k++)
+         dest[k] = value += block.minDelta + slots[k];
+      return num;
+   }
+#endif // SIMD_X86
+
+   for (size_t k = 1; k < num; k++)
+      dest[k] = value += block.minDelta + slot(block, k);
+   return num;
+}
+
+/*****************************************
+ * COMPRESSED VECTOR :: BEGIN and END
+ ****************************************/
+inline compressed_vector::const_iterator compressed_vector :: begin() const
+{
+   return const_iterator(this, 0);
+}
+
+inline compressed_vector::const_iterator compressed_vector :: end() const
+{
+   return const_iterator(this, numElements);
+}
+
+} // namespace custom
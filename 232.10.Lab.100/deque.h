@@ -0,0 +1,577 @@
+/***********************************************************************
+ * Header:
+ *    DEQUE
+ * Summary:
+ *    A double-ended queue kept in fixed-size blocks. A map holds
+ *    a pointer to each block. Growing at either end adds a block,
+ *    and now and then a bigger map, but the elements themselves
+ *    never move: a pointer to an element stays good until that
+ *    element is removed, and no push ever copies the whole
+ *    collection.
+ *
+ *    This will contain the class definition of:
+ *        deque                  : A double-ended queue of blocks
+ *        deque::iterator        : An iterator through the deque
+ *        deque::const_iterator  : A read-only iterator through the deque
+ ************************************************************************/
+
+#pragma once
+
+#include <memory>      // for std::allocator
+#include <utility>     // for std::swap and std::move
+#include <iterator>    // for std::random_access_iterator_tag
+#include <cstddef>     // for size_t and std::ptrdiff_t
+#include <cstring>     // for memmove
+#include <initializer_list>
+
+class TestDeque; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * DEQUE
+ * Element i lives iFront + i cells past the start of
+ * the first block. The blocks in use are a run of the
+ * map, from iFirstBlock on, with room left on both sides
+ * so either end can grow.
+ ****************************************/
+template <typename T>
+class deque
+{
+   friend class ::TestDeque; // give unit tests access to the privates
+   typedef std::allocator<T>             Alloc;
+   typedef std::allocator_traits<Alloc>  AllocTraits;
+   typedef std::allocator<T *>           MapAlloc;
+public:
+   // elements per block: about a page, and a power of two
+   // so finding a block is a shift rather than a divide
+   static constexpr size_t blockSize()
+   {
+      size_t num = (sizeof(T) * 16 > 4096) ? 16 : 4096 / sizeof(T);
+      size_t power = 1;
+      while (power * 2 <= num)
+         power *= 2;
+      return power;
+   }
+
+   class iterator;
+   class const_iterator;
+
+   //
+   // Construct
+   //
+
+   deque() : map(nullptr), spare(nullptr), numMap(0), iFirstBlock(0),
+             numBlocks(0), iFront(0), numElements(0) {}
+   deque(size_t num);
+   deque(size_t num, const T & t);
+   deque(const std::initializer_list<T> & l);
+   deque(const deque &  rhs);
+   deque(      deque && rhs);
+   ~deque();
+
+   //
+   // Assign
+   //
+
+   deque & operator = (const deque &  rhs);
+   deque & operator = (      deque && rhs);
+   void swap(deque & rhs);
+
+   //
+   // Iterator
+   //
+
+   iterator       begin()        { return iterator(this, 0);                 }
+   iterator       end()          { return iterator(this, numElements);       }
+   const_iterator begin()  const { return const_iterator(this, 0);           }
+   const_iterator end()    const { return const_iterator(this, numElements); }
+   const_iterator cbegin() const { return begin();                           }
+   const_iterator cend()   const { return end();                             }
+
+   //
+   // Access
+   //
+
+         T & operator [] (size_t index)       { return *cell(index);           }
+   const T & operator [] (size_t index) const { return *cell(index);           }
+         T & front()                          { return *cell(0);               }
+   const T & front()                    const { return *cell(0);               }
+         T & back()                           { return *cell(numElements - 1); }
+   const T & back()                     const { return *cell(numElements - 1); }
+
+   //
+   // Insert
+   //
+
+   void push_back (const T & t) { emplace_back(t);             }
+   void push_back (T && t)      { emplace_back(std::move(t));  }
+   void push_front(const T & t) { emplace_front(t);            }
+   void push_front(T && t)      { emplace_front(std::move(t)); }
+   template <class ... Args>
+   T & emplace_back(Args && ... args);
+   template <class ... Args>
+   T & emplace_front(Args && ... args);
+
+   //
+   // Remove
+   //
+
+   void clear();
+   void pop_back();
+   void pop_front();
+
+   //
+   // Status
+   //
+
+   size_t size()  const { return numElements;      }
+   bool   empty() const { return numElements == 0; }
+
+private:
+   static constexpr size_t B = blockSize();
+
+   // where element index lives
+   T * cell(size_t index) const
+   {
+      size_t i = iFront + index;
+      return map[iFirstBlock + i / B] + i % B;
+   }
+
+   // take a block on or off either end of the run
+   void addBlockBack();
+   void addBlockFront();
+   void removeBlockBack()  { freeBlock(map[iFirstBlock + --numBlocks]); }
+   void removeBlockFront() { freeBlock(map[iFirstBlock++]); numBlocks--; }
+
+   // a block, reusing the spare if there is one
+   T * newBlock();
+   void freeBlock(T * block);
+
+   // make room in the map at both ends, moving only block pointers
+   void growMap();
+
+   // the last element is gone: give back the blocks
+   void emptied();
+
+   Alloc    alloc;        // source of the blocks
+   T **     map;          // a pointer to each block, with room around them
+   T *      spare;        // the last block given up, kept to save a trip to the heap
+   size_t   numMap;       // slots in the map
+   size_t   iFirstBlock;  // the map slot of the block holding front()
+   size_t   numBlocks;    // how many blocks are in use
+   size_t   iFront;       // where front() is within its block
+   size_t   numElements;  // the number of items currently used
+};
+
+/**************************************************
+ * DEQUE ITERATOR
+ * An iterator through the deque: which deque, and
+ * which element of it. Elements are found the same
+ * way operator[] finds them.
+ *************************************************/
+template <typename T>
+class deque <T> ::iterator
+{
+   friend class ::TestDeque;
+   friend class const_iterator;
+public:
+   typedef std::random_access_iterator_tag iterator_category;
+   typedef T                               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef T *                             pointer;
+   typedef T &                             reference;
+
+   iterator()                            : pDeque(nullptr), index(0) {}
+   iterator(deque * pDeque, size_t index) : pDeque(pDeque), index(index) {}
+
+   T & operator * ()                    const { return (*pDeque)[index];     }
+   T * operator -> ()                   const { return &(*pDeque)[index];    }
+   T & operator [] (difference_type n)  const { return (*pDeque)[index + n]; }
+
+   iterator & operator ++ ()                   { ++index; return *this;              }
+   iterator   operator ++ (int)                { iterator it(*this); ++index; return it; }
+   iterator & operator -- ()                   { --index; return *this;              }
+   iterator   operator -- (int)                { iterator it(*this); --index; return it; }
+   iterator & operator += (difference_type n)  { index += n; return *this;           }
+   iterator & operator -= (difference_type n)  { index -= n; return *this;           }
+   iterator   operator +  (difference_type n) const { return iterator(pDeque, index + n); }
+   iterator   operator -  (difference_type n) const { return iterator(pDeque, index - n); }
+   difference_type operator - (const iterator & rhs) const
+   {
+      return (difference_type)index - (difference_type)rhs.index;
+   }
+
+   bool operator == (const iterator & rhs) const { return index == rhs.index; }
+   bool operator != (const iterator & rhs) const { return index != rhs.index; }
+   bool operator <  (const iterator & rhs) const { return index <  rhs.index; }
+   bool operator >  (const iterator & rhs) const { return index >  rhs.index; }
+   bool operator <= (const iterator & rhs) const { return index <= rhs.index; }
+   bool operator >= (const iterator & rhs) const { return index >= rhs.index; }
+
+private:
+   deque * pDeque;
+   size_t index;
+};
+
+/**************************************************
+ * DEQUE CONST ITERATOR
+ * The same, without write access
+ *************************************************/
+template <typename T>
+class deque <T> ::const_iterator
+{
+   friend class ::TestDeque;
+public:
+   typedef std::random_access_iterator_tag iterator_category;
+   typedef T                               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef const T *                       pointer;
+   typedef const T &                       reference;
+
+   const_iterator()                                  : pDeque(nullptr), index(0) {}
+   const_iterator(const deque * pDeque, size_t index) : pDeque(pDeque), index(index) {}
+   const_iterator(const iterator & rhs)              : pDeque(rhs.pDeque), index(rhs.index) {}
+
+   const T & operator * ()                    const { return (*pDeque)[index];     }
+   const T * operator -> ()                   const { return &(*pDeque)[index];    }
+   const T & operator [] (difference_type n)  const { return (*pDeque)[index + n]; }
+
+   const_iterator & operator ++ ()                   { ++index; return *this;                    }
+   const_iterator   operator ++ (int)                { const_iterator it(*this); ++index; return it; }
+   const_iterator & operator -- ()                   { --index; return *this;                    }
+   const_iterator   operator -- (int)                { const_iterator it(*this); --index; return it; }
+   const_iterator & operator += (difference_type n)  { index += n; return *this;                 }
+   const_iterator & operator -= (difference_type n)  { index -= n; return *this;                 }
+   const_iterator   operator +  (difference_type n) const { return const_iterator(pDeque, index + n); }
+   const_iterator   operator -  (difference_type n) const { return const_iterator(pDeque, index - n); }
+   difference_type operator - (const const_iterator & rhs) const
+   {
+      return (difference_type)index - (difference_type)rhs.index;
+   }
+
+   bool operator == (const const_iterator & rhs) const { return index == rhs.index; }
+   bool operator != (const const_iterator & rhs) const { return index != rhs.index; }
+   bool operator <  (const const_iterator & rhs) const { return index <  rhs.index; }
+   bool operator >  (const const_iterator & rhs) const { return index >  rhs.index; }
+   bool operator <= (const const_iterator & rhs) const { return index <= rhs.index; }
+   bool operator >= (const const_iterator & rhs) const { return index >= rhs.index; }
+
+private:
+   const deque * pDeque;
+   size_t index;
+};
+
+/*****************************************
+ * DEQUE :: NON-DEFAULT constructors
+ ****************************************/
+template <typename T>
+deque <T> :: deque(size_t num) : deque()
+{
+   for (size_t i = 0; i < num; i++)
+      emplace_back();
+}
+
+template <typename T>
+deque <T> :: deque(size_t num, const T & t) : deque()
+{
+   for (size_t i = 0; i < num; i++)
+      emplace_back(t);
+}
+
+/*****************************************
+ * DEQUE :: INITIALIZATION LIST constructor
+ ****************************************/
+template <typename T>
+deque <T> :: deque(const std::initializer_list<T> & l) : deque()
+{
+   for (const T & t : l)
+      emplace_back(t);
+}
+
+/*****************************************
+ * DEQUE :: COPY CONSTRUCTOR
+ ****************************************/
+template <typename T>
+deque <T> :: deque(const deque & rhs) : deque()
+{
+   for (size_t i = 0; i < rhs.numElements; i++)
+      emplace_back(rhs[i]);
+}
+
+/*****************************************
+ * DEQUE :: MOVE CONSTRUCTOR
+ * Take the map, and with it every block
+ ****************************************/
+template <typename T>
+deque <T> :: deque(deque && rhs) : deque()
+{
+   swap(rhs);
+}
+
+/*****************************************
+ * DEQUE :: DESTRUCTOR
+ ****************************************/
+template <typename T>
+deque <T> :: ~deque()
+{
+   clear();
+   if (spare)
+      AllocTraits::deallocate(alloc, spare, B);
+   if (map)
+   {
+      MapAlloc mapAlloc;
+      mapAlloc.deallocate(map, numMap);
+   }
+}
+
+/*****************************************
+ * DEQUE :: ASSIGNMENT
+ ****************************************/
+template <typename T>
+deque <T> & deque <T> :: operator = (const deque & rhs)
+{
+   if (this != &rhs)
+   {
+      deque copy(rhs);
+      swap(copy);
+   }
+   return *this;
+}
+
+template <typename T>
+deque <T> & deque <T> :: operator = (deque && rhs)
+{
+   if (this != &rhs)
+   {
+      deque empty;
+      swap(empty);
+      swap(rhs);
+   }
+   return *this;
+}
+
+/*****************************************
+ * DEQUE :: SWAP
+ * Trade maps; no element moves
+ ****************************************/
+template <typename T>
+void deque <T> :: swap(deque & rhs)
+{
+   std::swap(map,         rhs.map);
+   std::swap(spare,       rhs.spare);
+   std::swap(numMap,      rhs.numMap);
+   std::swap(iFirstBlock, rhs.iFirstBlock);
+   std::swap(numBlocks,   rhs.numBlocks);
+   std::swap(iFront,      rhs.iFront);
+   std::swap(numElements, rhs.numElements);
+}
+
+/*****************************************
+ * DEQUE :: EMPLACE BACK
+ * Build the new element past the back, in a new block
+ * if the last one is full. Nothing already in the
+ * deque moves, so args may refer to one of its elements.
+ ****************************************/
+template <typename T>
+template <class ... Args>
+T & deque <T> :: emplace_back(Args && ... args)
+{
+   size_t iBack = iFront + numElements;
+   bool added = (iBack == numBlocks * B);
+   if (added)
+      addBlockBack();
+
+   T * p = map[iFirstBlock + iBack / B] + iBack % B;
+   try
+   {
+      AllocTraits::construct(alloc, p, std::forward<Args>(args)...);
+   }
+   catch (...)
+   {
+      if (added)
+         removeBlockBack();
+      throw;
+   }
+   numElements++;
+   return *p;
+}
+
+/*****************************************
+ * DEQUE :: EMPLACE FRONT
+ * Build the new element before the front, in a new
+ * block if the first one is full.
+ ****************************************/
+template <typename T>
+template <class ... Args>
+T & deque <T> :: emplace_front(Args && ... args)
+{
+   bool added = (iFront == 0);
+   if (added)
+      addBlockFront();
+
+   size_t iNew = added ? B - 1 : iFront - 1;
+   T * p = map[iFirstBlock] + iNew;
+   try
+   {
+      AllocTraits::construct(alloc, p, std::forward<Args>(args)...);
+   }
+   catch (...)
+   {
+      if (added)
+         removeBlockFront();
+      throw;
+   }
+   iFront = iNew;
+   numElements++;
+   return *p;
+}
+
+/*****************************************
+ * DEQUE :: CLEAR
+ ****************************************/
+template <typename T>
+void deque <T> :: clear()
+{
+   for (size_t i = 0; i < numElements; i++)
+      AllocTraits::destroy(alloc, cell(i));
+   numElements = 0;
+   emptied();
+}
+
+/*****************************************
+ * DEQUE :: POP BACK
+ * A block left empty goes back
+ ****************************************/
+template <typename T>
+void deque <T> :: pop_back()
+{
+   if (numElements == 0)
+      return;
+
+   AllocTraits::destroy(alloc, cell(--numElements));
+   if (numElements == 0)
+      emptied();
+   else if (iFront + numElements <= (numBlocks - 1) * B)
+      removeBlockBack();
+}
+
+/*****************************************
+ * DEQUE :: POP FRONT
+ ****************************************/
+template <typename T>
+void deque <T> :: pop_front()
+{
+   if (numElements == 0)
+      return;
+
+   AllocTraits::destroy(alloc, cell(0));
+   numElements--;
+   if (numElements == 0)
+      emptied();
+   else if (++iFront == B)
+   {
+      removeBlockFront();
+      iFront = 0;
+   }
+}
+
+/*****************************************
+ * DEQUE :: ADD BLOCK BACK / FRONT
+ ****************************************/
+template <typename T>
+void deque <T> :: addBlockBack()
+{
+   if (iFirstBlock + numBlocks == numMap)
+      growMap();
+   map[iFirstBlock + numBlocks] = newBlock();
+   numBlocks++;
+}
+
+template <typename T>
+void deque <T> :: addBlockFront()
+{
+   if (iFirstBlock == 0)
+      growMap();
+   map[iFirstBlock - 1] = newBlock();
+   iFirstBlock--;
+   numBlocks++;
+}
+
+/*****************************************
+ * DEQUE :: NEW BLOCK
+ ****************************************/
+template <typename T>
+T * deque <T> :: newBlock()
+{
+   T * block = spare;
+   if (block)
+      spare = nullptr;
+   else
+      block = AllocTraits::allocate(alloc, B);
+   return block;
+}
+
+/*****************************************
+ * DEQUE :: FREE BLOCK
+ * Keep one block back, so a deque that pushes and
+ * pops across a block boundary is not forever going
+ * to the heap
+ ****************************************/
+template <typename T>
+void deque <T> :: freeBlock(T * block)
+{
+   if (spare)
+      AllocTraits::deallocate(alloc, block, B);
+   else
+      spare = block;
+}
+
+/*****************************************
+ * DEQUE :: GROW MAP
+ * Center the blocks in the map with room on both
+ * sides. If the map is less than half full they only
+ * slide over; otherwise they go to a map twice the size.
+ * Either way at least a quarter of the map is free at
+ * each end, so this is amortized O(1) per block.
+ ****************************************/
+template <typename T>
+void deque <T> :: growMap()
+{
+   size_t numNew = (numMap >= 8 && numBlocks * 2 < numMap) ? numMap : numMap * 2;
+   if (numNew < 8)
+      numNew = 8;
+   size_t iNewFirst = (numNew - numBlocks) / 2;
+
+   if (numNew == numMap)
+      memmove(map + iNewFirst, map + iFirstBlock, numBlocks * sizeof(T *));
+   else
+   {
+      MapAlloc mapAlloc;
+      T ** mapNew = mapAlloc.allocate(numNew);
+      if (numBlocks)
+         memcpy(mapNew + iNewFirst, map + iFirstBlock, numBlocks * sizeof(T *));
+      if (map)
+         mapAlloc.deallocate(map, numMap);
+      map = mapNew;
+      numMap = numNew;
+   }
+   iFirstBlock = iNewFirst;
+}
+
+/*****************************************
+ * DEQUE :: EMPTIED
+ * No elements left: hand back the blocks and start
+ * the next element in the middle of the map
+ ****************************************/
+template <typename T>
+void deque <T> :: emptied()
+{
+   while (numBlocks > 0)
+      removeBlockBack();
+   iFirstBlock = numMap / 2;
+   iFront = 0;
+}
+
+} // namespace custom
@@ -0,0 +1,621 @@
+/***********************************************************************
+ * Header:
+ *    INCREMENTAL VECTOR
+ * Summary:
+ *    A growable array whose push_back never stops to copy everything.
+ *    When it runs out of room it allocates a buffer twice the size,
+ *    but leaves the elements where they are. Each push after that
+ *    moves a few of them across, so they have all moved before the
+ *    new buffer fills. A vector pushes in constant time on average,
+ *    but every so often one push copies the whole array; here every
+ *    push does about the same small amount of work.
+ *
+ *    The price: every access tests which buffer its element is in,
+ *    and while a move is on, the elements are not one contiguous
+ *    array, so there is no data() to hand to a C function.
+ *
+ *    This will contain the class definition of:
+ *        incremental_vector                 : A vector that grows a step at a time
+ *        incremental_vector::iterator       : An iterator through it
+ *        incremental_vector::const_iterator : A read-only iterator through it
+ ************************************************************************/
+
+#pragma once
+
+#include <memory>      // for std::allocator
+#include <utility>     // for std::swap and std::move
+#include <iterator>    // for std::random_access_iterator_tag
+#include <type_traits> // for std::is_nothrow_move_constructible
+#include <cstddef>     // for size_t and std::ptrdiff_t
+#include <cstring>     // for memcpy
+#include <new>         // for std::bad_alloc
+#include <cassert>     // because I am paranoid
+#include "vector.h"    // for is_trivially_relocatable
+#ifdef __linux__
+#include <sys/mman.h>  // for mmap and munmap
+#include <unistd.h>    // for sysconf
+#endif
+
+class TestIncrementalVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * INCREMENTAL VECTOR
+ * Element i lives at data[i], unless a move is on and
+ * it has not moved yet: then it is still at oldData[i].
+ * The elements yet to move are [iMoved, numOld), so
+ * with no move on, iMoved and numOld are both 0 and
+ * that range is empty.
+ ****************************************/
+template <typename T>
+class incremental_vector
+{
+   friend class ::TestIncrementalVector; // give unit tests access to the privates
+   typedef std::allocator<T>             Alloc;
+   typedef std::allocator_traits<Alloc>  AllocTraits;
+   static_assert(is_trivially_relocatable<T>::value || std::is_nothrow_move_constructible<T>::value,
+                 "elements move a few at a time, long after the push that began it: "
+                 "moving one must not throw");
+public:
+   // how many elements each push moves across: about 256 bytes
+   // of them, and never fewer than 2, so the old buffer is empty
+   // well before the new one is full
+   static constexpr size_t migrateStep = (sizeof(T) >= 128) ? 2 : 256 / sizeof(T);
+
+   class iterator;
+   class const_iterator;
+
+   //
+   // Construct
+   //
+
+   incremental_vector() : data(nullptr), numCapacity(0), numElements(0), oldData(nullptr),
+                          oldCapacity(0), iMoved(0), numOld(0), numReleased(0) {}
+   incremental_vector(const incremental_vector &  rhs);
+   incremental_vector(      incremental_vector && rhs);
+   ~incremental_vector();
+
+   //
+   // Assign
+   //
+
+   incremental_vector & operator = (const incremental_vector &  rhs);
+   incremental_vector & operator = (      incremental_vector && rhs);
+   void swap(incremental_vector & rhs);
+
+   //
+   // Iterator
+   //
+
+   iterator       begin()        { return iterator(this, 0);                 }
+   iterator       end()          { return iterator(this, numElements);       }
+   const_iterator begin()  const { return const_iterator(this, 0);           }
+   const_iterator end()    const { return const_iterator(this, numElements); }
+   const_iterator cbegin() const { return begin();                           }
+   const_iterator cend()   const { return end();                             }
+
+   //
+   // Access
+   //
+
+         T & operator [] (size_t index)       { return *slot(index);           }
+   const T & operator [] (size_t index) const { return *slot(index);           }
+         T & front()                          { return *slot(0);               }
+   const T & front()                    const { return *slot(0);               }
+         T & back()                           { return *slot(numElements - 1); }
+   const T & back()                     const { return *slot(numElements - 1); }
+
+   //
+   // Insert
+   //
+
+   void push_back(const T & t) { emplace_back(t);            }
+   void push_back(T && t)      { emplace_back(std::move(t)); }
+   template <class ... Args>
+   T & emplace_back(Args && ... args);
+
+   // room for at least num elements. Unlike a push, this
+   // finishes any move and then moves every element at once.
+   void reserve(size_t num);
+
+   //
+   // Remove
+   //
+
+   void clear();
+   void pop_back();
+
+   //
+   // Move
+   //
+
+   // move whatever is left in the old buffer now, at a time
+   // of the caller's choosing, rather than a step per push
+   void settle() { migrate(numOld - iMoved); }
+
+   // are some elements still in the old buffer?
+   bool migrating() const { return oldData != nullptr; }
+
+   //
+   // Status
+   //
+
+   size_t size()     const { return numElements;      }
+   size_t capacity() const { return numCapacity;      }
+   bool   empty()    const { return numElements == 0; }
+
+private:
+   // where element index lives. One unsigned compare: with no move
+   // on, index - 0 < 0 - 0 is never true.
+   T * slot(size_t index) const
+   {
+      return (index - iMoved < numOld - iMoved) ? oldData + index : data + index;
+   }
+
+   // the buffer is full: start a move into one twice the size
+   void grow();
+
+   // move up to num elements out of the old buffer
+   void migrate(size_t num);
+
+   // give back the front of the old buffer that has been moved,
+   // or all of it once the move is done
+   void releaseMoved();
+   void releaseOld();
+
+   // raw storage: huge buffers come straight from the kernel, so
+   // they can be given back a piece at a time as they empty
+   T *  allocate(size_t num);
+   void deallocate(T * p, size_t num);
+#ifdef __linux__
+   static bool isMapped(size_t num) { return num * sizeof(T) >= mapThreshold; }
+#else
+   static bool isMapped(size_t)     { return false; }
+#endif
+   static const size_t mapThreshold = 1 << 20; // bytes
+   static size_t pageSize();
+   static size_t mapBytes(size_t num)
+   {
+      return (num * sizeof(T) + pageSize() - 1) / pageSize() * pageSize();
+   }
+
+   Alloc    alloc;        // source of the smaller buffers
+   T *      data;         // the buffer elements are pushed into
+   size_t   numCapacity;  // the size of data
+   size_t   numElements;  // the number of items currently used
+   T *      oldData;      // the buffer being emptied, or nullptr
+   size_t   oldCapacity;  // the size of oldData
+   size_t   iMoved;       // elements before this have left oldData
+   size_t   numOld;       // elements from this on were never in oldData
+   size_t   numReleased;  // bytes at the front of oldData already given back
+};
+
+/**************************************************
+ * INCREMENTAL VECTOR ITERATOR
+ * Which vector, and which element of it. Elements are
+ * found the same way operator[] finds them, so an
+ * iterator stays good while elements move.
+ *************************************************/
+template <typename T>
+class incremental_vector <T> ::iterator
+{
+   friend class ::TestIncrementalVector;
+   friend class const_iterator;
+public:
+   typedef std::random_access_iterator_tag iterator_category;
+   typedef T                               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef T *                             pointer;
+   typedef T &                             reference;
+
+   iterator()                                      : pVector(nullptr), index(0) {}
+   iterator(incremental_vector * pVector, size_t index) : pVector(pVector), index(index) {}
+
+   T & operator * ()                    const { return (*pVector)[index];     }
+   T * operator -> ()                   const { return &(*pVector)[index];    }
+   T & operator [] (difference_type n)  const { return (*pVector)[index + n]; }
+
+   iterator & operator ++ ()                   { ++index; return *this;              }
+   iterator   operator ++ (int)                { iterator it(*this); ++index; return it; }
+   iterator & operator -- ()                   { --index; return *this;              }
+   iterator   operator -- (int)                { iterator it(*this); --index; return it; }
+   iterator & operator += (difference_type n)  { index += n; return *this;           }
+   iterator & operator -= (difference_type n)  { index -= n; return *this;           }
+   iterator   operator +  (difference_type n) const { return iterator(pVector, index + n); }
+   iterator   operator -  (difference_type n) const { return iterator(pVector, index - n); }
+   difference_type operator - (const iterator & rhs) const
+   {
+      return (difference_type)index - (difference_type)rhs.index;
+   }
+
+   bool operator == (const iterator & rhs) const { return index == rhs.index; }
+   bool operator != (const iterator & rhs) const { return index != rhs.index; }
+   bool operator <  (const iterator & rhs) const { return index <  rhs.index; }
+   bool operator >  (const iterator & rhs) const { return index >  rhs.index; }
+   bool operator <= (const iterator & rhs) const { return index <= rhs.index; }
+   bool operator >= (const iterator & rhs) const { return index >= rhs.index; }
+
+private:
+   incremental_vector * pVector;
+   size_t index;
+};
+
+/**************************************************
+ * INCREMENTAL VECTOR CONST ITERATOR
+ * The same, without write access
+ *************************************************/
+template <typename T>
+class incremental_vector <T> ::const_iterator
+{
+   friend class ::TestIncrementalVector;
+public:
+   typedef std::random_access_iterator_tag iterator_category;
+   typedef T                               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef const T *                       pointer;
+   typedef const T &                       reference;
+
+   const_iterator()                                   : pVector(nullptr), index(0) {}
+   const_iterator(const incremental_vector * pVector, size_t index) : pVector(pVector), index(index) {}
+   const_iterator(const iterator & rhs)               : pVector(rhs.pVector), index(rhs.index) {}
+
+   const T & operator * ()                    const { return (*pVector)[index];     }
+   const T * operator -> ()                   const { return &(*pVector)[index];    }
+   const T & operator [] (difference_type n)  const { return (*pVector)[index + n]; }
+
+   const_iterator & operator ++ ()                   { ++index; return *this;                    }
+   const_iterator   operator ++ (int)                { const_iterator it(*this); ++index; return it; }
+   const_iterator & operator -- ()                   { --index; return *this;                    }
+   const_iterator   operator -- (int)                { const_iterator it(*this); --index; return it; }
+   const_iterator & operator += (difference_type n)  { index += n; return *this;                 }
+   const_iterator & operator -= (difference_type n)  { index -= n; return *this;                 }
+   const_iterator   operator +  (difference_type n) const { return const_iterator(pVector, index + n); }
+   const_iterator   operator -  (difference_type n) const { return const_iterator(pVector, index - n); }
+   difference_type operator - (const const_iterator & rhs) const
+   {
+      return (difference_type)index - (difference_type)rhs.index;
+   }
+
+   bool operator == (const const_iterator & rhs) const { return index == rhs.index; }
+   bool operator != (const const_iterator & rhs) const { return index != rhs.index; }
+   bool operator <  (const const_iterator & rhs) const { return index <  rhs.index; }
+   bool operator >  (const const_iterator & rhs) const { return index >  rhs.index; }
+   bool operator <= (const const_iterator & rhs) const { return index <= rhs.index; }
+   bool operator >= (const const_iterator & rhs) const { return index >= rhs.index; }
+
+private:
+   const incremental_vector * pVector;
+   size_t index;
+};
+
+/*****************************************
+ * INCREMENTAL VECTOR :: COPY CONSTRUCTOR
+ * The copy is made settled: one buffer, just big enough
+ ****************************************/
+template <typename T>
+incremental_vector <T> :: incremental_vector(const incremental_vector & rhs) : incremental_vector()
+{
+   reserve(rhs.numElements);
+   for (size_t i = 0; i < rhs.numElements; i++)
+      emplace_back(rhs[i]);
+}
+
+/*****************************************
+ * INCREMENTAL VECTOR :: MOVE CONSTRUCTOR
+ * Take both buffers, move and all
+ ****************************************/
+template <typename T>
+incremental_vector <T> :: incremental_vector(incremental_vector && rhs) : incremental_vector()
+{
+   swap(rhs);
+}
+
+/*****************************************
+ * INCREMENTAL VECTOR :: DESTRUCTOR
+ ****************************************/
+template <typename T>
+incremental_vector <T> :: ~incremental_vector()
+{
+   clear();
+   deallocate(data, numCapacity);
+}
+
+/*****************************************
+ * INCREMENTAL VECTOR :: ASSIGNMENT
+ ****************************************/
+template <typename T>
+incremental_vector <T> & incremental_vector <T> :: operator = (const incremental_vector & rhs)
+{
+   if (this != &rhs)
+   {
+      incremental_vector copy(rhs);
+      swap(copy);
+   }
+   return *this;
+}
+
+template <typename T>
+incremental_vector <T> & incremental_vector <T> :: operator = (incremental_vector && rhs)
+{
+   if (this != &rhs)
+   {
+      incremental_vector empty;
+      swap(empty);
+      swap(rhs);
+   }
+   return *this;
+}
+
+/*****************************************
+ * INCREMENTAL VECTOR :: SWAP
+ * Trade buffers; no element moves
+ ****************************************/
+template <typename T>
+void incremental_vector <T> :: swap(incremental_vector & rhs)
+{
+   std::swap(data,        rhs.data);
+   std::swap(numCapacity, rhs.numCapacity);
+   std::swap(numElements, rhs.numElements);
+   std::swap(oldData,     rhs.oldData);
+   std::swap(oldCapacity, rhs.oldCapacity);
+   std::swap(iMoved,      rhs.iMoved);
+   std::swap(numOld,      rhs.numOld);
+   std::swap(numReleased, rhs.numReleased);
+}
+
+/*****************************************
+ * INCREMENTAL VECTOR :: EMPLACE BACK
+ * Build the new element past the back, in a new buffer
+ * if this one is full, and only then move the next few
+ * elements across. Building first means args may refer
+ * to one of our elements, even one about to move.
+ ****************************************/
+template <typename T>
+template <class ... Args>
+T & incremental_vector <T> :: emplace_back(Args && ... args)
+{
+   bool grown = (numElements == numCapacity);
+   if (grown)
+      grow();
+
+   T * p = data + numElements;
+   try
+   {
+      AllocTraits::construct(alloc, p, std::forward<Args>(args)...);
+   }
+   catch (...)
+   {
+      // nothing has moved yet: go back to the old buffer
+      if (grown)
+      {
+         deallocate(data, numCapacity);
+         data = oldData;
+         numCapacity = oldCapacity;
+         oldData = nullptr;
+         oldCapacity = iMoved = numOld = 0;
+      }
+      throw;
+   }
+   numElements++;
+   migrate(migrateStep);
+   return *p;
+}
+
+/*****************************************
+ * INCREMENTAL VECTOR :: RESERVE
+ * All at once, like vector::reserve
+ ****************************************/
+template <typename T>
+void incremental_vector <T> :: reserve(size_t num)
+{
+   if (num <= numCapacity)
+      return;
+   settle();
+
+   T * newData = allocate(num);
+   if constexpr (is_trivially_relocatable<T>::value)
+   {
+      if (numElements)
+         std::memcpy((void *)newData, (const void *)data, numElements * sizeof(T));
+   }
+   else
+      for (size_t i = 0; i < numElements; i++)
+      {
+         AllocTraits::construct(alloc, newData + i, std::move(data[i]));
+         AllocTraits::destroy(alloc, data + i);
+      }
+   deallocate(data, numCapacity);
+   data = newData;
+   numCapacity = num;
+}
+
+/*****************************************
+ * INCREMENTAL VECTOR :: CLEAR
+ * The buffer stays for the next pushes to fill
+ ****************************************/
+template <typename T>
+void incremental_vector <T> :: clear()
+{
+   for (size_t i = 0; i < numElements; i++)
+      AllocTraits::destroy(alloc, slot(i));
+   numElements = 0;
+   if (oldData)
+      releaseOld();
+}
+
+/*****************************************
+ * INCREMENTAL VECTOR :: POP BACK
+ * The back may not have moved yet. If it is the last
+ * one left to move, the move is done.
+ ****************************************/
+template <typename T>
+void incremental_vector <T> :: pop_back()
+{
+   if (numElements == 0)
+      return;
+
+   AllocTraits::destroy(alloc, slot(--numElements));
+   if (numElements < numOld)
+   {
+      numOld = numElements;
+      if (iMoved == numOld)
+         releaseOld();
+   }
+}
+
+/*****************************************
+ * INCREMENTAL VECTOR :: GROW
+ * A new buffer twice the size. Allocating it costs
+ * the same however big it is; only the pages later
+ * pushes touch are ever faulted in. Every push since
+ * the last grow moved at least one element, so the
+ * last move is always done by now.
+ ****************************************/
+template <typename T>
+void incremental_vector <T> :: grow()
+{
+   assert(!migrating());
+   size_t newCapacity = (numCapacity == 0) ? 1 : numCapacity * 2;
+   T * newData = allocate(newCapacity);
+
+   if (numElements)
+   {
+      oldData = data;
+      oldCapacity = numCapacity;
+      iMoved = 0;
+      numOld = numElements;
+      numReleased = 0;
+   }
+   else
+      deallocate(data, numCapacity);
+   data = newData;
+   numCapacity = newCapacity;
+}
+
+/*****************************************
+ * INCREMENTAL VECTOR :: MIGRATE
+ * Move up to num elements from the front of what is
+ * left in the old buffer to the same places in the new
+ ****************************************/
+template <typename T>
+void incremental_vector <T> :: migrate(size_t num)
+{
+   if (!oldData)
+      return;
+
+   size_t end = (numOld - iMoved > num) ? iMoved + num : numOld;
+   if constexpr (is_trivially_relocatable<T>::value)
+      std::memcpy((void *)(data + iMoved), (const void *)(oldData + iMoved),
+                  (end - iMoved) * sizeof(T));
+   else
+      for (size_t i = iMoved; i < end; i++)
+      {
+         AllocTraits::construct(alloc, data + i, std::move(oldData[i]));
+         AllocTraits::destroy(alloc, oldData + i);
+      }
+   iMoved = end;
+
+   if (iMoved == numOld)
+      releaseOld();
+   else
+      releaseMoved();
+}
+
+/*****************************************
+ * INCREMENTAL VECTOR :: RELEASE MOVED
+ * Freeing a huge buffer costs time in proportion to
+ * its size: 10ms for 256MB. So a mapped old buffer is
+ * given back 16 pages at a time as its front empties,
+ * and no one push ever pays for all of it.
+ ****************************************/
+template <typename T>
+void incremental_vector <T> :: releaseMoved()
+{
+#ifdef __linux__
+   if (!isMapped(oldCapacity))
+      return;
+   size_t chunk = 16 * pageSize();
+   size_t moved = iMoved * sizeof(T) / chunk * chunk;
+   if (moved > numReleased)
+   {
+      munmap((char *)oldData + numReleased, moved - numReleased);
+      numReleased = moved;
+   }
+#endif
+}
+
+/*****************************************
+ * INCREMENTAL VECTOR :: RELEASE OLD
+ * Give back what is left of the old buffer. Every
+ * element in it has moved or been destroyed.
+ ****************************************/
+template <typename T>
+void incremental_vector <T> :: releaseOld()
+{
+#ifdef __linux__
+   if (isMapped(oldCapacity))
+      munmap((char *)oldData + numReleased, mapBytes(oldCapacity) - numReleased);
+   else
+#endif
+      deallocate(oldData, oldCapacity);
+   oldData = nullptr;
+   oldCapacity = iMoved = numOld = numReleased = 0;
+}
+
+/*****************************************
+ * INCREMENTAL VECTOR :: ALLOCATE
+ * Raw storage for num elements
+ ****************************************/
+template <typename T>
+T * incremental_vector <T> :: allocate(size_t num)
+{
+#ifdef __linux__
+   if (isMapped(num))
+   {
+      void * p = mmap(nullptr, mapBytes(num), PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p == MAP_FAILED)
+         throw std::bad_alloc();
+      return static_cast<T *>(p);
+   }
+#endif
+   return (num == 0) ? nullptr : AllocTraits::allocate(alloc, num);
+}
+
+/*****************************************
+ * INCREMENTAL VECTOR :: DEALLOCATE
+ * Give raw storage back. The elements must
+ * already have been destroyed.
+ ****************************************/
+template <typename T>
+void incremental_vector <T> :: deallocate(T * p, size_t num)
+{
+   if (p == nullptr)
+      return;
+#ifdef __linux__
+   if (isMapped(num))
+   {
+      munmap(p, mapBytes(num));
+      return;
+   }
+#endif
+   AllocTraits::deallocate(alloc, p, num);
+}
+
+/*****************************************
+ * INCREMENTAL VECTOR :: PAGE SIZE
+ ****************************************/
+template <typename T>
+size_t incremental_vector <T> :: pageSize()
+{
+#ifdef __linux__
+   static const size_t size = sysconf(_SC_PAGESIZE);
+#else
+   static const size_t size = 4096;
+#endif
+   return size;
+}
+
+} // namespace custom
@@ -0,0 +1,409 @@
+/***********************************************************************
+ * Header:
+ *    MAPPED VECTOR
+ * Summary:
+ *    A vector that lives in a file. The file is mapped into memory,
+ *    so opening it again is not a load: the elements are simply
+ *    there, and the kernel pages them in as they are touched.
+ *
+ *    This will contain the class definition of:
+ *        mapped_vector          : A Vector backed by a memory-mapped file
+ ************************************************************************/
+
+#pragma once
+
+#include "vector.h" // for the iterators and grow_double
+
+#if __has_include(<sys/mman.h>)
+#define MAPPED_VECTOR
+
+#include <string>       // for std::string
+#include <stdexcept>    // for std::runtime_error
+#include <system_error> // for std::system_error
+#include <cerrno>       // for errno
+#include <cstdint>      // for uint64_t
+#include <sys/mman.h>   // for mmap, msync, and madvise
+#include <sys/stat.h>   // for fstat
+#include <fcntl.h>      // for open
+#include <unistd.h>     // for ftruncate and close
+
+class TestMappedVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * MAPPED VECTOR
+ * A vector of trivially copyable T whose buffer is a
+ * mapping of a file. The file holds a small header and
+ * then the raw elements, so the bytes on disk are the
+ * bytes in memory. Growing the vector grows the file.
+ * Changes reach the disk whenever the kernel writes
+ * them back, or right away through sync().
+ ****************************************/
+template <typename T>
+class mapped_vector
+{
+   static_assert(std::is_trivially_copyable<T>::value,
+                 "a mapped_vector holds raw bytes, so T must be trivially copyable");
+   friend class ::TestMappedVector; // give unit tests access to the privates
+public:
+   typedef typename vector <T> ::iterator               iterator;
+   typedef typename vector <T> ::const_iterator         const_iterator;
+   typedef typename vector <T> ::reverse_iterator       reverse_iterator;
+   typedef typename vector <T> ::const_reverse_iterator const_reverse_iterator;
+
+   // how the elements will be read, so the kernel can page accordingly
+   enum Advice { NORMAL, SEQUENTIAL, RANDOM, WILLNEED };
+
+   //
+   // Construct
+   //
+
+   mapped_vector(const std::string & path);
+   mapped_vector(mapped_vector && rhs) noexcept;
+   mapped_vector(const mapped_vector & rhs) = delete;
+   ~mapped_vector() { close(); }
+
+   //
+   // Assign
+   //
+
+   mapped_vector & operator = (mapped_vector && rhs) noexcept;
+   mapped_vector & operator = (const mapped_vector & rhs) = delete;
+   void swap(mapped_vector & rhs) noexcept
+   {
+      std::swap(fd,          rhs.fd);
+      std::swap(header,      rhs.header);
+      std::swap(numCapacity, rhs.numCapacity);
+   }
+
+   //
+   // Iterator
+   //
+
+   iterator       begin()        { return iterator(data());                  }
+   iterator       end()          { return iterator(data() + size());         }
+   const_iterator begin()  const { return const_iterator(data());            }
+   const_iterator end()    const { return const_iterator(data() + size());   }
+   const_iterator cbegin() const { return begin();                           }
+   const_iterator cend()   const { return end();                             }
+   reverse_iterator       rbegin()        { return reverse_iterator(end());         }
+   reverse_iterator       rend()          { return reverse_iterator(begin());       }
+   const_reverse_iterator rbegin()  const { return const_reverse_iterator(end());   }
+   const_reverse_iterator rend()    const { return const_reverse_iterator(begin()); }
+
+   //
+   // Access
+   //
+
+         T & operator [] (size_t index)       { return data()[index];      }
+   const T & operator [] (size_t index) const { return data()[index];      }
+         T & front()                          { return data()[0];          }
+   const T & front()                    const { return data()[0];          }
+         T & back()                           { return data()[size() - 1]; }
+   const T & back()                     const { return data()[size() - 1]; }
+
+   //
+   // Insert
+   //
+
+   void push_back(const T & t)
+   {
+      if (size() == numCapacity)
+      {
+         T copy(t); // t may live in the mapping we are about to move
+         remap(grow_double::grow(numCapacity, size() + 1, sizeof(T)));
+         data()[header->numElements++] = copy;
+      }
+      else
+         data()[header->numElements++] = t;
+   }
+   template <class ... Args>
+   T & emplace_back(Args && ... args)
+   {
+      push_back(T(std::forward<Args>(args)...));
+      return back();
+   }
+   void reserve(size_t newCapacity)
+   {
+      if (newCapacity > numCapacity)
+         remap(newCapacity);
+   }
+   void resize(size_t newElements)             { resize(newElements, T()); }
+   void resize(size_t newElements, const T & t);
+
+   //
+   // Remove
+   //
+
+   void clear()
+   {
+      if (header != nullptr)
+         header->numElements = 0;
+   }
+   void pop_back()
+   {
+      if (size() > 0)
+         header->numElements--;
+   }
+   iterator erase(iterator first, iterator last);
+   void shrink_to_fit()
+   {
+      if (size() < numCapacity)
+         remap(size());
+   }
+
+   //
+   // Status
+   //
+
+   // a vector that was moved from has no file and no mapping
+   size_t size()     const { return header ? header->numElements : 0; }
+   size_t capacity() const { return numCapacity;                      }
+   bool   empty()    const { return size() == 0;                      }
+
+   //
+   // File
+   //
+
+   void sync();
+   void advise(Advice advice);
+
+private:
+
+   // the start of the file: tells us how to read the rest of it
+   struct Header
+   {
+      char     magic[8];     // "MAPVEC1" and a null
+      uint64_t elementSize;  // sizeof(T) of the writer
+      uint64_t numElements;  // the number of items currently used
+      uint64_t unused[5];    // round up to a cache line, which aligns the elements
+   };
+
+   T *       data()       { return header ? reinterpret_cast<T *>(header + 1)       : nullptr; }
+   const T * data() const { return header ? reinterpret_cast<const T *>(header + 1) : nullptr; }
+
+   static size_t fileBytes(size_t num) { return sizeof(Header) + num * sizeof(T); }
+
+   // grow or shrink the file and its mapping to hold newCapacity elements
+   void remap(size_t newCapacity);
+
+   // trim the spare capacity off the file, unmap, and close
+   void close();
+
+   // report a failed system call
+   [[noreturn]] static void fail(const char * call)
+   {
+      throw std::system_error(errno, std::generic_category(),
+                              std::string("mapped_vector: ") + call);
+   }
+
+   int      fd;               // the open file
+   Header * header;           // the start of the mapping
+   size_t   numCapacity;      // the number of elements the file has room for
+};
+
+/*****************************************
+ * MAPPED VECTOR :: CONSTRUCTOR
+ * Open the file at path, creating an empty vector if it
+ * does not exist. An existing file is mapped as it is:
+ * nothing is read or parsed.
+ ****************************************/
+template <typename T>
+mapped_vector <T> :: mapped_vector(const std::string & path) :
+   fd(-1), header(nullptr), numCapacity(0)
+{
+   fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+   if (fd < 0)
+      fail("open");
+
+   try
+   {
+      struct stat st;
+      if (fstat(fd, &st) != 0)
+         fail("fstat");
+
+      // a new file: make room for the header of an empty vector
+      bool fresh = (st.st_size == 0);
+      if (fresh)
+      {
+         if (ftruncate(fd, sizeof(Header)) != 0)
+            fail("ftruncate");
+         st.st_size = sizeof(Header);
+      }
+
+      if ((size_t)st.st_size < sizeof(Header) ||
+          ((size_t)st.st_size - sizeof(Header)) % sizeof(T) != 0)
+         throw std::runtime_error("mapped_vector: " + path + " is not a mapped_vector of this type");
+
+      void * p = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (p == MAP_FAILED)
+         fail("mmap");
+      header = static_cast<Header *>(p);
+      numCapacity = (st.st_size - sizeof(Header)) / sizeof(T);
+
+      static const char magic[8] = "MAPVEC1";
+      if (fresh)
+      {
+         std::memcpy(header->magic, magic, sizeof(magic));
+         header->elementSize = sizeof(T);
+         header->numElements = 0;
+      }
+      else if (std::memcmp(header->magic, magic, sizeof(magic)) != 0 ||
+               header->elementSize != sizeof(T) ||
+               header->numElements > numCapacity)
+         throw std::runtime_error("mapped_vector: " + path + " is not a mapped_vector of this type");
+   }
+   catch (...)
+   {
+      if (header != nullptr)
+         munmap(header, fileBytes(numCapacity));
+      ::close(fd);
+      throw;
+   }
+}
+
+/*****************************************
+ * MAPPED VECTOR :: MOVE
+ * Take over the file and its mapping
+ ****************************************/
+template <typename T>
+mapped_vector <T> :: mapped_vector(mapped_vector && rhs) noexcept :
+   fd(-1), header(nullptr), numCapacity(0)
+{
+   swap(rhs);
+}
+
+template <typename T>
+mapped_vector <T> & mapped_vector <T> :: operator = (mapped_vector && rhs) noexcept
+{
+   if (this != &rhs)
+   {
+      close();
+      swap(rhs);
+   }
+   return *this;
+}
+
+/*****************************************
+ * MAPPED VECTOR :: CLOSE
+ * The spare capacity is only there for growth, so it is
+ * cut off the file. The kernel writes back the rest.
+ ****************************************/
+template <typename T>
+void mapped_vector <T> :: close()
+{
+   if (fd < 0)
+      return;
+   size_t num = size();
+   if (header != nullptr)
+      munmap(header, fileBytes(numCapacity));
+   // should this fail, the file merely keeps its spare capacity
+   int result = ftruncate(fd, fileBytes(num));
+   (void)result;
+   ::close(fd);
+   fd = -1;
+   header = nullptr;
+   numCapacity = 0;
+}
+
+/*****************************************
+ * MAPPED VECTOR :: REMAP
+ * Resize the file to hold newCapacity elements, then
+ * the mapping to match. Linux can move or extend the
+ * mapping in place; elsewhere the new mapping is made
+ * first and the old one dropped only once that worked,
+ * so a failure leaves the vector as it was. Either way
+ * no element is copied.
+ ****************************************/
+template <typename T>
+void mapped_vector <T> :: remap(size_t newCapacity)
+{
+   assert(newCapacity >= size());
+   size_t oldBytes = fileBytes(numCapacity);
+   size_t newBytes = fileBytes(newCapacity);
+
+   // grow the file first so the new pages have something behind them
+   if (newBytes > oldBytes && ftruncate(fd, newBytes) != 0)
+      fail("ftruncate");
+
+#ifdef __linux__
+   void * p = mremap(header, oldBytes, newBytes, MREMAP_MAYMOVE);
+   if (p == MAP_FAILED)
+      fail("mremap");
+#else
+   void * p = mmap(nullptr, newBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   if (p == MAP_FAILED)
+      fail("mmap");
+   munmap(header, oldBytes);
+#endif
+   header = static_cast<Header *>(p);
+   numCapacity = newCapacity;
+
+   if (newBytes < oldBytes && ftruncate(fd, newBytes) != 0)
+      fail("ftruncate");
+}
+
+/*****************************************
+ * MAPPED VECTOR :: RESIZE
+ ****************************************/
+template <typename T>
+void mapped_vector <T> :: resize(size_t newElements, const T & t)
+{
+   if (newElements > size())
+   {
+      T copy(t);
+      reserve(newElements);
+      std::fill(data() + size(), data() + newElements, copy);
+   }
+   if (header != nullptr)
+      header->numElements = newElements;
+}
+
+/*****************************************
+ * MAPPED VECTOR :: ERASE
+ ****************************************/
+template <typename T>
+typename mapped_vector <T> ::iterator
+mapped_vector <T> :: erase(iterator first, iterator last)
+{
+   if (first == last)
+      return first;
+   T * pFirst = &*first;
+   T * pLast  = &*last;
+   T * pEnd   = data() + size();
+   std::memmove(static_cast<void *>(pFirst), static_cast<const void *>(pLast),
+                (pEnd - pLast) * sizeof(T));
+   header->numElements -= pLast - pFirst;
+   return iterator(pFirst);
+}
+
+/*****************************************
+ * MAPPED VECTOR :: SYNC
+ * Block until every change so far is on disk
+ ****************************************/
+template <typename T>
+void mapped_vector <T> :: sync()
+{
+   if (msync(header, fileBytes(numCapacity), MS_SYNC) != 0)
+      fail("msync");
+}
+
+/*****************************************
+ * MAPPED VECTOR :: ADVISE
+ * Tell the kernel how the elements will be read: a
+ * sequential scan reads ahead aggressively, random
+ * access does not, and WILLNEED pages it all in now.
+ ****************************************/
+template <typename T>
+void mapped_vector <T> :: advise(Advice advice)
+{
+   static const int flags[] = { MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED };
+   if (madvise(header, fileBytes(numCapacity), flags[advice]) != 0)
+      fail("madvise");
+}
+
+} // namespace custom
+
+#endif // __has_include(<sys/mman.h>)
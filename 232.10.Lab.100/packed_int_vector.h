@@ -0,0 +1,321 @@
+/***********************************************************************
+ * Header:
+ *    PACKED INT VECTOR
+ * Summary:
+ *    A growable array of unsigned integers that each fit in Bits
+ *    bits, packed end to end with no padding. A 20-bit ID takes 20
+ *    bits rather than a 32- or 64-bit slot. Reading one element
+ *    costs a shift and a mask; reading many at once is a bulk
+ *    decode, eight at a time with AVX2 where the processor has it.
+ *
+ *    This will contain the class definition of:
+ *        packed_int_vector      : An array of Bits-bit unsigned integers
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>     // for uint32_t and uint64_t
+#include <cstddef>     // for size_t
+#include <cassert>     // because I am paranoid
+#include <cstring>     // for std::memcpy
+#include "vector.h"
+#include "simd.h"      // for simd::level() and the AVX2 intrinsics
+
+class TestPackedIntVector; // forward declaration for unit tests
+
+namespace custom
+{
+namespace detail
+{
+
+#ifdef SIMD_X86
+/*****************************************
+ * UNPACK TABLE
+ * How to unpack 8 Bits-bit values from the bytes they
+ * start in. Each 128-bit half of the register is loaded
+ * on its own, the second from half1 bytes on, since 8
+ * values can span more bytes than one half can shuffle.
+ * Then each lane gathers the 4 bytes its value starts in
+ * and shifts the value down to bit 0.
+ ****************************************/
+template <unsigned Bits>
+struct UnpackTable
+{
+   alignas(32) int8_t  control[32];   // which 4 bytes each lane takes
+   alignas(32) int32_t shifts[8];     // how far each lane shifts right
+   size_t half1;                      // where the second half loads from
+
+   UnpackTable()
+   {
+      half1 = 4 * Bits / 8;
+      for (unsigned lane = 0; lane < 8; lane++)
+      {
+         size_t bit = lane * Bits - (lane < 4 ? 0 : 8 * half1);
+         shifts[lane] = (int32_t)(bit % 8);
+         for (unsigned b = 0; b < 4; b++)
+            control[lane * 4 + b] = (int8_t)(bit / 8 + b);
+      }
+   }
+};
+
+/*****************************************
+ * UNPACK AVX2
+ * Decode numGroups groups of 8 values, the first
+ * starting on a byte boundary at source
+ ****************************************/
+template <unsigned Bits>
+SIMD_AVX2 void unpackAvx2(const uint8_t * source, size_t numGroups, uint32_t * dest)
+{
+   static const UnpackTable<Bits> table;
+   const __m256i control = _mm256_load_si256((const __m256i *)table.control);
+   const __m256i shifts  = _mm256_load_si256((const __m256i *)table.shifts);
+   const __m256i mask    = _mm256_set1_epi32((int)((uint32_t(1) << Bits) - 1));
+
+   for (size_t g = 0; g < numGroups; g++, source += Bits, dest += 8)
+   {
+      __m128i lo = _mm_loadu_si128((const __m128i *)source);
+      __m128i hi = _mm_loadu_si128((const __m128i *)(source + table.half1));
+      __m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+      x = _mm256_shuffle_epi8(x, control);
+      x = _mm256_srlv_epi32(x, shifts);
+      _mm256_storeu_si256((__m256i *)dest, _mm256_and_si256(x, mask));
+   }
+}
+#endif // SIMD_X86
+
+} // namespace detail
+
+/*****************************************
+ * PACKED INT VECTOR
+ * Element i is the Bits bits starting at bit i * Bits
+ * of the words, read as one little-endian run. An
+ * element that starts near the end of a word carries
+ * on into the next. The bits past the last element
+ * are always 0.
+ ****************************************/
+template <unsigned Bits>
+class packed_int_vector
+{
+   static_assert(Bits >= 1 && Bits <= 32, "a packed integer is from 1 to 32 bits");
+   friend class ::TestPackedIntVector; // give unit tests access to the privates
+public:
+   typedef uint32_t value_type;
+
+   // the largest value an element can hold
+   static constexpr uint32_t maxValue = (Bits == 32) ? ~uint32_t(0) : (uint32_t(1) << Bits) - 1;
+
+   //
+   // Construct
+   //
+
+   packed_int_vector() : numElements(0) {}
+   packed_int_vector(size_t num, uint32_t value = 0) : numElements(0) { resize(num, value); }
+
+   //
+   // Access
+   //
+
+   uint32_t get(size_t index) const;
+   uint32_t operator [] (size_t index) const { return get(index); }
+   uint32_t front() const { return get(0);               }
+   uint32_t back()  const { return get(numElements - 1); }
+
+   // unpack num elements from first on into dest
+   void decode(size_t first, size_t num, uint32_t * dest) const;
+
+   // unpack every element into dest, which is resized to fit
+   template <typename A, typename G>
+   void decode(vector <uint32_t, A, G> & dest) const
+   {
+      dest.resize(numElements);
+      if (numElements)
+         decode(0, numElements, &dest[0]);
+   }
+
+   //
+   // Update
+   //
+
+   // value must be no more than maxValue
+   void set(size_t index, uint32_t value);
+
+   //
+   // Insert and remove
+   //
+
+   void push_back(uint32_t value)
+   {
+      numElements++;
+      words.resize(numWords(numElements), 0);
+      set(numElements - 1, value);
+   }
+   void pop_back()
+   {
+      if (numElements == 0)
+         return;
+      set(numElements - 1, 0);
+      numElements--;
+      words.resize(numWords(numElements));
+   }
+   void resize(size_t num, uint32_t value = 0);
+   void reserve(size_t num) { words.reserve(numWords(num)); }
+   void clear()             { words.clear(); numElements = 0; }
+
+   //
+   // Status
+   //
+
+   size_t size()     const { return numElements;                     }
+   bool   empty()    const { return numElements == 0;                }
+   size_t capacity() const { return words.capacity() * 64 / Bits;    }
+
+   // the memory the elements take up
+   size_t bytes() const { return words.capacity() * sizeof(uint64_t); }
+
+private:
+   static size_t numWords(size_t num) { return (num * Bits + 63) / 64; }
+
+   // unpack the elements from first on, one at a time
+   void decodeScalar(size_t first, size_t num, uint32_t * dest) const;
+
+   vector<uint64_t> words;   // the elements, packed end to end
+   size_t  numElements;      // the number of elements in use
+};
+
+/*****************************************
+ * PACKED INT VECTOR :: GET
+ * The low part from the word the element starts
+ * in, and if it spills over, the rest from the next
+ ****************************************/
+template <unsigned Bits>
+uint32_t packed_int_vector <Bits> :: get(size_t index) const
+{
+   assert(index < numElements);
+   size_t bit = index * Bits;
+   size_t iWord = bit / 64;
+   unsigned offset = bit % 64;
+   uint64_t value = words[iWord] >> offset;
+   if (offset + Bits > 64)
+      value |= words[iWord + 1] << (64 - offset);
+   return (uint32_t)(value & maxValue);
+}
+
+/*****************************************
+ * PACKED INT VECTOR :: SET
+ * Clear the element's bits and or in the new value,
+ * in the next word too if it spills over
+ ****************************************/
+template <unsigned Bits>
+void packed_int_vector <Bits> :: set(size_t index, uint32_t value)
+{
+   assert(index < numElements);
+   assert(value <= maxValue);
+   size_t bit = index * Bits;
+   size_t iWord = bit / 64;
+   unsigned offset = bit % 64;
+   words[iWord] = (words[iWord] & ~(uint64_t(maxValue) << offset)) | (uint64_t(value) << offset);
+   if (offset + Bits > 64)
+   {
+      unsigned spill = offset + Bits - 64;
+      words[iWord + 1] = (words[iWord + 1] & ~(uint64_t(maxValue) >> (Bits - spill))) |
+                         (uint64_t(value) >> (Bits - spill));
+   }
+}
+
+/*****************************************
+ * PACKED INT VECTOR :: RESIZE
+ * New elements are value. Shrinking clears the bits
+ * past the new last element.
+ ****************************************/
+template <unsigned Bits>
+void packed_int_vector <Bits> :: resize(size_t num, uint32_t value)
+{
+   while (numElements > num)
+      pop_back();
+   words.resize(numWords(num), 0);
+   size_t numOld = numElements;
+   numElements = num;
+   if (value != 0)
+      for (size_t i = numOld; i < num; i++)
+         set(i, value);
+}
+
+/*****************************************
+ * PACKED INT VECTOR :: DECODE
+ * With AVX2, and Bits small enough that each value
+ * lies within the 4 bytes it starts in, the scalar
+ * loop only runs up to the first element on a byte
+ * boundary and for the last few; the groups of 8 in
+ * between are unpacked a register at a time. A group
+ * is only unpacked that way if both of its 16-byte
+ * loads lie inside the words.
+ ****************************************/
+template <unsigned Bits>
+void packed_int_vector <Bits> :: decode(size_t first, size_t num, uint32_t * dest) const
+{
+   assert(first + num <= numElements);
+#ifdef SIMD_X86
+   if constexpr (Bits <= 25)
+   {
+      if (simd::level() == simd::AVX2)
+      {
+         // a group of 8 starts on a byte boundary when its index is a multiple of 8
+         size_t numHead = (8 - first % 8) % 8;
+         if (numHead > num)
+            numHead = num;
+         decodeScalar(first, numHead, dest);
+         first += numHead;
+         dest += numHead;
+         num -= numHead;
+
+         size_t numBytes = words.size() * sizeof(uint64_t);
+         size_t startByte = first * Bits / 8;
+         size_t numGroups = num / 8;
+         size_t loadEnd = Bits / 2 + 16;   // past a group's first byte
+         if (numBytes < startByte + loadEnd)
+            numGroups = 0;
+         else if ((numBytes - startByte - loadEnd) / Bits + 1 < numGroups)
+            numGroups = (numBytes - startByte - loadEnd) / Bits + 1;
+         if (numGroups)
+         {
+            const uint8_t * bytes = reinterpret_cast<const uint8_t *>(&words[0]);
+            detail::unpackAvx2<Bits>(bytes + startByte, numGroups, dest);
+            first += numGroups * 8;
+            dest += numGroups * 8;
+            num -= numGroups * 8;
+         }
+      }
+   }
+#endif // SIMD_X86
+   decodeScalar(first, num, dest);
+}
+
+/*****************************************
+ * PACKED INT VECTOR :: DECODE SCALAR
+ * An element is at most 32 bits starting somewhere in
+ * a byte, so the 8 bytes from that byte hold all of
+ * it: one load, a shift, and a mask, with no test for
+ * whether it spills into the next word. The words are
+ * read as little-endian bytes, as on x86 and ARM. The
+ * last few elements, whose 8 bytes would run past the
+ * words, go through get().
+ ****************************************/
+template <unsigned Bits>
+void packed_int_vector <Bits> :: decodeScalar(size_t first, size_t num, uint32_t * dest) const
+{
+   if (num == 0)
+      return;
+   const uint8_t * bytes = reinterpret_cast<const uint8_t *>(&words[0]);
+   size_t numBytes = words.size() * sizeof(uint64_t);
+   size_t i = 0;
+   for (size_t bit = first * Bits; i < num && bit / 8 + 8 <= numBytes; i++, bit += Bits)
+   {
+      uint64_t window;
+      std::memcpy(&window, bytes + bit / 8, sizeof(window));
+      dest[i] = (uint32_t)((window >> (bit % 8)) & maxValue);
+   }
+   for (; i < num; i++)
+      dest[i] = get(first + i);
+}
+
+} // namespace custom
@@ -0,0 +1,686 @@
+/***********************************************************************
+ * Header:
+ *    PERSISTENT VECTOR
+ * Summary:
+ *    A vector whose copies share everything they have in common.
+ *    The elements live in the leaves of a 32-way trie, and the last
+ *    leaf, the tail, is kept to one side so push_back rarely touches
+ *    the trie at all. Copying a persistent_vector copies two
+ *    pointers. Changing one copies only the nodes on the path to
+ *    the change, at most log32(n) of them, and leaves every other
+ *    copy as it was: a snapshot costs nothing until it differs.
+ *
+ *    Building a vector one path copy at a time is wasteful, so a
+ *    transient_vector edits in place the nodes it made itself, and
+ *    hands back a persistent_vector when the batch is done.
+ *
+ *    This will contain the class definition of:
+ *        persistent_vector                 : A vector with O(1) copies
+ *        persistent_vector::const_iterator : A read-only iterator
+ *        transient_vector                  : A persistent_vector being edited in bulk
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>      // for std::atomic
+#include <new>         // for placement new
+#include <utility>     // for std::swap and std::move
+#include <iterator>    // for std::forward_iterator_tag
+#include <cstddef>     // for size_t and std::ptrdiff_t
+#include <initializer_list>
+
+class TestPersistentVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+template <typename T>
+class transient_vector;
+
+/*****************************************
+ * PERSISTENT VECTOR
+ * Element i is in the tail if it is one of the last
+ * (up to) 32. Otherwise the trie finds it five bits at
+ * a time, from bit shift down to bit 0. Nodes count
+ * their owners, and a node with more than one is never
+ * changed.
+ ****************************************/
+template <typename T>
+class persistent_vector
+{
+   friend class ::TestPersistentVector; // give unit tests access to the privates
+   friend class transient_vector<T>;
+
+   static const unsigned BITS  = 5;
+   static const size_t   WIDTH = (size_t)1 << BITS;
+   static const size_t   MASK  = WIDTH - 1;
+
+public:
+   class const_iterator;
+
+   //
+   // Construct
+   //
+
+   persistent_vector() : root(nullptr), tail(nullptr), shift(BITS), numElements(0) {}
+   persistent_vector(const std::initializer_list<T> & l);
+   persistent_vector(const persistent_vector & rhs);
+   persistent_vector(persistent_vector && rhs) : persistent_vector() { swap(rhs); }
+   ~persistent_vector()
+   {
+      release(root, shift);
+      release(tail, 0);
+   }
+
+   //
+   // Assign
+   //
+
+   persistent_vector & operator = (const persistent_vector & rhs)
+   {
+      persistent_vector copy(rhs);
+      swap(copy);
+      return *this;
+   }
+   persistent_vector & operator = (persistent_vector && rhs)
+   {
+      persistent_vector taken(std::move(rhs));
+      swap(taken);
+      return *this;
+   }
+   void swap(persistent_vector & rhs)
+   {
+      std::swap(root,        rhs.root);
+      std::swap(tail,        rhs.tail);
+      std::swap(shift,       rhs.shift);
+      std::swap(numElements, rhs.numElements);
+   }
+
+   //
+   // Iterator
+   //
+
+   const_iterator begin() const { return const_iterator(this, 0);           }
+   const_iterator end()   const { return const_iterator(this, numElements); }
+
+   //
+   // Access: read-only, since an element may be shared
+   //
+
+   const T & operator [] (size_t index) const { return leafFor(index)->values()[index & MASK]; }
+   const T & front()                    const { return (*this)[0];                             }
+   const T & back()                     const { return (*this)[numElements - 1];               }
+
+   //
+   // Update: each changes only this copy
+   //
+
+   void push_back(const T & t)          { pushBack(0, t);            }
+   void push_back(T && t)               { pushBack(0, std::move(t)); }
+   void set(size_t index, const T & t)  { assign(0, index, t);       }
+   void pop_back()                      { popBack(0);                }
+
+   // start a batch of edits
+   transient_vector<T> transient() const { return transient_vector<T>(*this); }
+
+   //
+   // Status
+   //
+
+   size_t size()  const { return numElements;      }
+   bool   empty() const { return numElements == 0; }
+
+private:
+   /*****************************************
+    * NODE
+    * A branch of the trie or a leaf of elements. owner
+    * is the transient that made it, and so may edit it
+    * in place, or 0 for none.
+    ****************************************/
+   struct Node
+   {
+      explicit Node(size_t owner) : refs(1), owner(owner) {}
+      std::atomic<size_t> refs;
+      size_t owner;
+   };
+
+   struct Branch : Node
+   {
+      explicit Branch(size_t owner) : Node(owner)
+      {
+         for (size_t i = 0; i < WIDTH; i++)
+            child[i] = nullptr;
+      }
+      Node * child[WIDTH];
+   };
+
+   struct Leaf : Node
+   {
+      explicit Leaf(size_t owner) : Node(owner), num(0) {}
+            T * values()       { return reinterpret_cast<T *>(buffer);       }
+      const T * values() const { return reinterpret_cast<const T *>(buffer); }
+      size_t num;                                      // elements in use
+      alignas(T) unsigned char buffer[WIDTH * sizeof(T)];
+   };
+
+   // index of the first element in the tail
+   size_t tailOffset() const
+   {
+      return (numElements < WIDTH) ? 0 : ((numElements - 1) >> BITS) << BITS;
+   }
+
+   // the leaf holding element index
+   const Leaf * leafFor(size_t index) const;
+
+   // the work of the updates. edit is the transient doing
+   // them, or 0 to copy every node touched.
+   template <class ... Args>
+   void pushBack(size_t edit, Args && ... args);
+   void assign(size_t edit, size_t index, const T & t);
+   void popBack(size_t edit);
+
+   Node * pushTail(unsigned level, Node * parent, Leaf * full, size_t edit);
+   Node * newPath (unsigned level, Node * node, size_t edit);
+   Node * assign  (unsigned level, Node * node, size_t index, const T & t, size_t edit);
+   Node * popTail (unsigned level, Node * node, size_t edit);
+
+   // node itself if edit may change it, otherwise a copy that it may
+   static Leaf *   editable(Leaf *   leaf,   size_t edit);
+   static Branch * editable(Branch * branch, size_t edit);
+
+   // count one more or one fewer owner of a node at this
+   // level; the last owner out frees it and what it holds
+   static void addRef(Node * node)
+   {
+      if (node)
+         node->refs.fetch_add(1, std::memory_order_relaxed);
+   }
+   static void release(Node * node, unsigned level);
+
+   // a number no other transient has used
+   static size_t nextOwner()
+   {
+      static std::atomic<size_t> next(1);
+      return next++;
+   }
+
+   Node *   root;         // the trie, or nullptr while it is empty
+   Leaf *   tail;         // the last 1 to 32 elements, or nullptr if there are none
+   unsigned shift;        // the bit the root indexes from: 5 for a root of leaves
+   size_t   numElements;  // the number of items currently used
+};
+
+/**************************************************
+ * PERSISTENT VECTOR CONST ITERATOR
+ * Walks a leaf at a time: the trie is only searched
+ * once every 32 elements.
+ *************************************************/
+template <typename T>
+class persistent_vector <T> ::const_iterator
+{
+   friend class ::TestPersistentVector;
+public:
+   typedef std::forward_iterator_tag iterator_category;
+   typedef T                         value_type;
+   typedef std::ptrdiff_t            difference_type;
+   typedef const T *                 pointer;
+   typedef const T &                 reference;
+
+   const_iterator() : pVector(nullptr), index(0), values(nullptr) {}
+   const_iterator(const persistent_vector * pVector, size_t index) :
+      pVector(pVector), index(index), values(nullptr)
+   {
+      if (index < pVector->numElements)
+         values = pVector->leafFor(index)->values();
+   }
+
+   const T & operator * ()  const { return values[index & MASK];  }
+   const T * operator -> () const { return &values[index & MASK]; }
+
+   const_iterator & operator ++ ()
+   {
+      if ((++index & MASK) == 0 && index < pVector->numElements)
+         values = pVector->leafFor(index)->values();
+      return *this;
+   }
+   const_iterator operator ++ (int)
+   {
+      const_iterator it(*this);
+      ++(*this);
+      return it;
+   }
+
+   bool operator == (const const_iterator & rhs) const { return index == rhs.index; }
+   bool operator != (const const_iterator & rhs) const { return index != rhs.index; }
+
+private:
+   const persistent_vector * pVector;
+   size_t index;
+   const T * values;   // the leaf holding element index
+};
+
+/*****************************************
+ * TRANSIENT VECTOR
+ * A persistent_vector opened for editing. Nodes it
+ * makes are tagged with its owner number, and it
+ * changes those in place; anything it shares with
+ * another vector it copies the first time, as
+ * persistent_vector would. persistent() ends the
+ * batch: the number is never used again, so nothing
+ * the result holds can change.
+ ****************************************/
+template <typename T>
+class transient_vector
+{
+   friend class ::TestPersistentVector;
+   friend class persistent_vector<T>;
+public:
+   transient_vector(transient_vector && rhs) : v(std::move(rhs.v)), owner(rhs.owner) {}
+   transient_vector(const transient_vector &) = delete;
+   transient_vector & operator = (const transient_vector &) = delete;
+
+   const T & operator [] (size_t index) const { return v[index]; }
+   size_t size()  const { return v.size();  }
+   bool   empty() const { return v.empty(); }
+
+   void push_back(const T & t)          { v.pushBack(owner, t);            }
+   void push_back(T && t)               { v.pushBack(owner, std::move(t)); }
+   void set(size_t index, const T & t)  { v.assign(owner, index, t);       }
+   void pop_back()                      { v.popBack(owner);                }
+
+   // the edits as a persistent_vector. This transient is left empty.
+   persistent_vector<T> persistent()
+   {
+      owner = persistent_vector<T>::nextOwner();
+      return persistent_vector<T>(std::move(v));
+   }
+
+private:
+   transient_vector(const persistent_vector<T> & v) :
+      v(v), owner(persistent_vector<T>::nextOwner()) {}
+
+   persistent_vector<T> v;
+   size_t owner;
+};
+
+/*****************************************
+ * PERSISTENT VECTOR :: INITIALIZATION LIST constructor
+ * Built as one batch
+ ****************************************/
+template <typename T>
+persistent_vector <T> :: persistent_vector(const std::initializer_list<T> & l) :
+   persistent_vector()
+{
+   transient_vector<T> batch = transient();
+   for (const T & t : l)
+      batch.push_back(t);
+   *this = batch.persistent();
+}
+
+/*****************************************
+ * PERSISTENT VECTOR :: COPY CONSTRUCTOR
+ * Share the trie and the tail: O(1)
+ ****************************************/
+template <typename T>
+persistent_vector <T> :: persistent_vector(const persistent_vector & rhs) :
+   root(rhs.root), tail(rhs.tail), shift(rhs.shift), numElements(rhs.numElements)
+{
+   addRef(root);
+   addRef(tail);
+}
+
+/*****************************************
+ * PERSISTENT VECTOR :: LEAF FOR
+ ****************************************/
+template <typename T>
+const typename persistent_vector <T> ::Leaf * persistent_vector <T> :: leafFor(size_t index) const
+{
+   if (index >= tailOffset())
+      return tail;
+
+   const Node * node = root;
+   for (unsigned level = shift; level > 0; level -= BITS)
+      node = static_cast<const Branch *>(node)->child[(index >> level) & MASK];
+   return static_cast<const Leaf *>(node);
+}
+
+/*****************************************
+ * PERSISTENT VECTOR :: PUSH BACK
+ * While the tail has room the new element goes
+ * there. A full tail is hung in the trie and a new
+ * tail started; only then is the trie changed.
+ ****************************************/
+template <typename T>
+template <class ... Args>
+void persistent_vector <T> :: pushBack(size_t edit, Args && ... args)
+{
+   if (tail && numElements - tailOffset() < WIDTH)
+   {
+      Leaf * leaf = editable(tail, edit);
+      try
+      {
+         new (leaf->values() + leaf->num) T(std::forward<Args>(args)...);
+      }
+      catch (...)
+      {
+         if (leaf != tail)
+            release(leaf, 0);
+         throw;
+      }
+      leaf->num++;
+      if (leaf != tail)
+      {
+         release(tail, 0);
+         tail = leaf;
+      }
+      numElements++;
+      return;
+   }
+
+   // build the element first: args may refer to the old tail
+   Leaf * leaf = new Leaf(edit);
+   try
+   {
+      new (leaf->values()) T(std::forward<Args>(args)...);
+   }
+   catch (...)
+   {
+      delete leaf;
+      throw;
+   }
+   leaf->num = 1;
+
+   // the full tail joins the trie, which grows a level if it is full
+   if (tail)
+   {
+      if ((numElements >> BITS) > ((size_t)1 << shift))
+      {
+         Branch * newRoot = new Branch(edit);
+         newRoot->child[0] = root;
+         newRoot->child[1] = newPath(shift, tail, edit);
+         root = newRoot;
+         shift += BITS;
+      }
+      else
+      {
+         Node * newRoot = pushTail(shift, root, tail, edit);
+         if (newRoot != root)
+         {
+            release(root, shift);
+            root = newRoot;
+         }
+      }
+   }
+   tail = leaf;
+   numElements++;
+}
+
+/*****************************************
+ * PERSISTENT VECTOR :: PUSH TAIL
+ * Hang the full leaf on the path to the last slot
+ * of the trie, copying each node on the way down
+ * unless edit already owns it
+ ****************************************/
+template <typename T>
+typename persistent_vector <T> ::Node * persistent_vector <T> :: pushTail(unsigned level, Node * parent, Leaf * full, size_t edit)
+{
+   Branch * branch = parent ? editable(static_cast<Branch *>(parent), edit) : new Branch(edit);
+   size_t iChild = ((numElements - 1) >> level) & MASK;
+
+   if (level == BITS)
+      branch->child[iChild] = full;
+   else
+   {
+      Node * old = branch->child[iChild];
+      Node * now = old ? pushTail(level - BITS, old, full, edit)
+                       : newPath(level - BITS, full, edit);
+      if (now != old)
+      {
+         branch->child[iChild] = now;
+         release(old, level - BITS);
+      }
+   }
+   return branch;
+}
+
+/*****************************************
+ * PERSISTENT VECTOR :: NEW PATH
+ * A chain of single-child branches from level
+ * down to node
+ ****************************************/
+template <typename T>
+typename persistent_vector <T> ::Node * persistent_vector <T> :: newPath(unsigned level, Node * node, size_t edit)
+{
+   if (level == 0)
+      return node;
+   Branch * branch = new Branch(edit);
+   branch->child[0] = newPath(level - BITS, node, edit);
+   return branch;
+}
+
+/*****************************************
+ * PERSISTENT VECTOR :: ASSIGN
+ * Copy the path to element index, and change
+ * the copy
+ ****************************************/
+template <typename T>
+void persistent_vector <T> :: assign(size_t edit, size_t index, const T & t)
+{
+   if (index >= tailOffset())
+   {
+      Node * leaf = assign(0, tail, index, t, edit);
+      if (leaf != tail)
+      {
+         release(tail, 0);
+         tail = static_cast<Leaf *>(leaf);
+      }
+      return;
+   }
+
+   Node * newRoot = assign(shift, root, index, t, edit);
+   if (newRoot != root)
+   {
+      release(root, shift);
+      root = newRoot;
+   }
+}
+
+template <typename T>
+typename persistent_vector <T> ::Node * persistent_vector <T> :: assign(unsigned level, Node * node, size_t index, const T & t, size_t edit)
+{
+   if (level == 0)
+   {
+      Leaf * leaf = editable(static_cast<Leaf *>(node), edit);
+      try
+      {
+         leaf->values()[index & MASK] = t;
+      }
+      catch (...)
+      {
+         if (leaf != node)
+            release(leaf, 0);
+         throw;
+      }
+      return leaf;
+   }
+
+   Branch * branch = editable(static_cast<Branch *>(node), edit);
+   size_t iChild = (index >> level) & MASK;
+   Node * old = branch->child[iChild];
+   Node * now;
+   try
+   {
+      now = assign(level - BITS, old, index, t, edit);
+   }
+   catch (...)
+   {
+      if (branch != node)
+         release(branch, level);
+      throw;
+   }
+   if (now != old)
+   {
+      branch->child[iChild] = now;
+      release(old, level - BITS);
+   }
+   return branch;
+}
+
+/*****************************************
+ * PERSISTENT VECTOR :: POP BACK
+ * Usually the last element just leaves the tail.
+ * When it was the only one there, the last leaf of
+ * the trie becomes the tail, and a root left with a
+ * single child gives way to that child.
+ ****************************************/
+template <typename T>
+void persistent_vector <T> :: popBack(size_t edit)
+{
+   if (numElements == 0)
+      return;
+
+   if (numElements == 1)
+   {
+      release(tail, 0);
+      tail = nullptr;
+      numElements = 0;
+      return;
+   }
+
+   if (numElements - tailOffset() > 1)
+   {
+      Leaf * leaf = editable(tail, edit);
+      leaf->values()[--leaf->num].~T();
+      if (leaf != tail)
+      {
+         release(tail, 0);
+         tail = leaf;
+      }
+      numElements--;
+      return;
+   }
+
+   Leaf * newTail = const_cast<Leaf *>(leafFor(numElements - 2));
+   addRef(newTail);
+
+   Node * newRoot = popTail(shift, root, edit);
+   if (newRoot != root)
+   {
+      release(root, shift);
+      root = newRoot;
+   }
+   if (root == nullptr)
+      shift = BITS;
+   else if (shift > BITS && static_cast<Branch *>(root)->child[1] == nullptr)
+   {
+      Node * only = static_cast<Branch *>(root)->child[0];
+      addRef(only);
+      release(root, shift);
+      root = only;
+      shift -= BITS;
+   }
+
+   release(tail, 0);
+   tail = newTail;
+   numElements--;
+}
+
+/*****************************************
+ * PERSISTENT VECTOR :: POP TAIL
+ * Take the last leaf off the trie. A branch left
+ * with no children is dropped: nullptr.
+ ****************************************/
+template <typename T>
+typename persistent_vector <T> ::Node * persistent_vector <T> :: popTail(unsigned level, Node * node, size_t edit)
+{
+   size_t iChild = ((numElements - 2) >> level) & MASK;
+   Node * now = nullptr;
+   if (level > BITS)
+   {
+      now = popTail(level - BITS, static_cast<Branch *>(node)->child[iChild], edit);
+      if (now == nullptr && iChild == 0)
+         return nullptr;
+   }
+   else if (iChild == 0)
+      return nullptr;
+
+   Branch * branch = editable(static_cast<Branch *>(node), edit);
+   Node * old = branch->child[iChild];
+   if (now != old)
+   {
+      branch->child[iChild] = now;
+      release(old, level - BITS);
+   }
+   return branch;
+}
+
+/*****************************************
+ * PERSISTENT VECTOR :: EDITABLE
+ * A node made by this same transient can be changed
+ * in place. Any other may be shared, so the change
+ * goes to a copy that shares its children instead.
+ ****************************************/
+template <typename T>
+typename persistent_vector <T> ::Leaf * persistent_vector <T> :: editable(Leaf * leaf, size_t edit)
+{
+   if (edit != 0 && leaf->owner == edit)
+      return leaf;
+
+   Leaf * copy = new Leaf(edit);
+   try
+   {
+      for (; copy->num < leaf->num; copy->num++)
+         new (copy->values() + copy->num) T(leaf->values()[copy->num]);
+   }
+   catch (...)
+   {
+      release(copy, 0);
+      throw;
+   }
+   return copy;
+}
+
+template <typename T>
+typename persistent_vector <T> ::Branch * persistent_vector <T> :: editable(Branch * branch, size_t edit)
+{
+   if (edit != 0 && branch->owner == edit)
+      return branch;
+
+   Branch * copy = new Branch(edit);
+   for (size_t i = 0; i < WIDTH; i++)
+   {
+      copy->child[i] = branch->child[i];
+      addRef(copy->child[i]);
+   }
+   return copy;
+}
+
+/*****************************************
+ * PERSISTENT VECTOR :: RELEASE
+ * One fewer owner. The last one out destroys the
+ * elements of a leaf, or lets go of a branch's
+ * children.
+ ****************************************/
+template <typename T>
+void persistent_vector <T> :: release(Node * node, unsigned level)
+{
+   if (node == nullptr || node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+      return;
+
+   if (level == 0)
+   {
+      Leaf * leaf = static_cast<Leaf *>(node);
+      for (size_t i = 0; i < leaf->num; i++)
+         leaf->values()[i].~T();
+      delete leaf;
+   }
+   else
+   {
+      Branch * branch = static_cast<Branch *>(node);
+      for (size_t i = 0; i < WIDTH; i++)
+         release(branch->child[i], level - BITS);
+      delete branch;
+   }
+}
+
+} // namespace custom
@@ -0,0 +1,569 @@
+/***********************************************************************
+ * Header:
+ *    SIMD
+ * Summary:
+ *    Search and reduction algorithms over a vector of numbers that
+ *    look at 4 (SSE2) or 8 (AVX2) elements per instruction. Which
+ *    one runs is decided when the program runs, not when it is
+ *    compiled, so one build uses AVX2 where the processor has it.
+ *
+ *    This will contain the definitions of:
+ *        simd::find        : The first element equal to a value
+ *        simd::count       : How many elements equal a value
+ *        simd::min_element : The first smallest element
+ *        simd::max_element : The first largest element
+ *        simd::sum         : All the elements added together
+ *        simd::erase       : Remove every element equal to a value
+ *        simd::erase_if    : Remove every element matching a predicate
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>     // for int32_t
+#include <cstddef>     // for size_t
+#include <type_traits> // for std::is_same
+#include "vector.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_X86
+#include <immintrin.h> // for the SSE2 and AVX2 intrinsics
+#ifdef _MSC_VER
+#include <intrin.h>    // for __cpuidex and _BitScanForward
+#define SIMD_AVX2
+#else
+#define SIMD_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+class TestSimd; // forward declaration for unit tests
+
+namespace custom
+{
+namespace simd
+{
+
+/*****************************************
+ * LEVEL
+ * The instruction sets we know how to use,
+ * from slowest to fastest
+ ****************************************/
+enum Level { SCALAR, SSE2, AVX2 };
+
+/*****************************************
+ * SUPPORTED
+ * The best level this processor can run
+ ****************************************/
+inline Level supported()
+{
+#ifdef SIMD_X86
+#ifdef _MSC_VER
+   int info[4];
+   __cpuid(info, 1);
+   bool osSavesAVX = (info[2] & (1 << 27)) && ((_xgetbv(0) & 6) == 6);
+   __cpuidex(info, 7, 0);
+   static const bool avx2 = osSavesAVX && (info[1] & (1 << 5));
+#else
+   static const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+   return avx2 ? AVX2 : SSE2;
+#else
+   return SCALAR;
+#endif
+}
+
+/*****************************************
+ * LEVEL
+ * The level the algorithms will use: the best one
+ * supported unless setLevel() asked for less, which
+ * is how the tests and benchmarks compare them
+ ****************************************/
+inline Level & levelLimit()
+{
+   static Level limit = AVX2;
+   return limit;
+}
+
+inline Level level()
+{
+   Level best = supported();
+   return (levelLimit() < best) ? levelLimit() : best;
+}
+
+inline void setLevel(Level limit)
+{
+   levelLimit() = limit;
+}
+
+namespace detail
+{
+
+/*****************************************
+ * SCALAR
+ * One element at a time: the fallback for processors
+ * without SIMD and for the tail of every SIMD loop
+ ****************************************/
+namespace scalar
+{
+template <typename T>
+size_t find(const T * p, size_t begin, size_t n, T value)
+{
+   for (size_t i = begin; i < n; i++)
+      if (p[i] == value)
+         return i;
+   return n;
+}
+
+template <typename T>
+size_t count(const T * p, size_t begin, size_t n, T value)
+{
+   size_t num = 0;
+   for (size_t i = begin; i < n; i++)
+      num += (p[i] == value);
+   return num;
+}
+
+// the smallest value, or the largest when MAX
+template <bool MAX, typename T>
+T extreme(const T * p, size_t begin, size_t n, T best)
+{
+   for (size_t i = begin; i < n; i++)
+      if (MAX ? (best < p[i]) : (p[i] < best))
+         best = p[i];
+   return best;
+}
+
+template <typename T>
+T sum(const T * p, size_t begin, size_t n, T total)
+{
+   // signed overflow is undefined, so integers wrap through unsigned
+   typedef typename std::conditional_t<std::is_integral<T>::value,
+                                       std::make_unsigned<T>,
+                                       std::enable_if<true, T>>::type Sum;
+   Sum s = (Sum)total;
+   for (size_t i = begin; i < n; i++)
+      s += (Sum)p[i];
+   return (T)s;
+}
+
+// copy every kept element down to out; no branch on the predicate
+template <typename T, class Predicate>
+size_t compact(T * p, size_t begin, size_t n, size_t out, Predicate pred)
+{
+   for (size_t i = begin; i < n; i++)
+   {
+      T t = p[i];
+      p[out] = t;
+      out += !pred(t);
+   }
+   return out;
+}
+} // namespace scalar
+
+#ifdef SIMD_X86
+
+// the index of the lowest set bit of a non-zero mask
+inline unsigned firstBit(unsigned mask)
+{
+#ifdef _MSC_VER
+   unsigned long index;
+   _BitScanForward(&index, mask);
+   return index;
+#else
+   return __builtin_ctz(mask);
+#endif
+}
+
+inline unsigned popCount(unsigned mask)
+{
+#ifdef _MSC_VER
+   return __popcnt(mask);
+#else
+   return __builtin_popcount(mask);
+#endif
+}
+
+/*****************************************
+ * SSE2
+ * Four elements at a time. Every x86-64 processor has it.
+ * SSE2 has no 32-bit integer min or max, so those are
+ * built from a compare and a select.
+ ****************************************/
+namespace sse2
+{
+inline __m128i load(const int32_t * p) { return _mm_loadu_si128((const __m128i *)p); }
+inline __m128  load(const float * p)   { return _mm_loadu_ps(p); }
+inline int equal(__m128i a, __m128i b) { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))); }
+inline int equal(__m128 a, __m128 b)   { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+inline __m128i splat(int32_t t)        { return _mm_set1_epi32(t); }
+inline __m128  splat(float t)          { return _mm_set1_ps(t); }
+inline __m128i add(__m128i a, __m128i b) { return _mm_add_epi32(a, b); }
+inline __m128  add(__m128 a, __m128 b)   { return _mm_add_ps(a, b); }
+inline __m128i select(__m128i mask, __m128i a, __m128i b)
+{
+   return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+inline __m128i min(__m128i a, __m128i b) { return select(_mm_cmplt_epi32(a, b), a, b); }
+inline __m128i max(__m128i a, __m128i b) { return select(_mm_cmpgt_epi32(a, b), a, b); }
+inline __m128  min(__m128 a, __m128 b)   { return _mm_min_ps(a, b); }
+inline __m128  max(__m128 a, __m128 b)   { return _mm_max_ps(a, b); }
+inline void store(int32_t * p, __m128i x) { _mm_storeu_si128((__m128i *)p, x); }
+inline void store(float * p, __m128 x)    { _mm_storeu_ps(p, x); }
+
+template <typename T>
+size_t find(const T * p, size_t n, T value)
+{
+   auto key = splat(value);
+   size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+      if (int mask = equal(load(p + i), key))
+         return i + firstBit(mask);
+   return scalar::find(p, i, n, value);
+}
+
+// a match is all ones, which is -1: subtracting it counts one per lane
+inline __m128i matches(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+inline __m128i matches(__m128 a, __m128 b)   { return _mm_castps_si128(_mm_cmpeq_ps(a, b)); }
+
+template <typename T>
+size_t count(const T * p, size_t n, T value)
+{
+   auto key = splat(value);
+   __m128i counts = _mm_setzero_si128();
+   size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+      counts = _mm_sub_epi32(counts, matches(load(p + i), key));
+   uint32_t lanes[4];
+   _mm_storeu_si128((__m128i *)lanes, counts);
+   return (size_t)lanes[0] + lanes[1] + lanes[2] + lanes[3] + scalar::count(p, i, n, value);
+}
+
+// n must be at least 1
+template <bool MAX, typename T>
+T extreme(const T * p, size_t n)
+{
+   if (n < 4)
+      return scalar::extreme<MAX>(p, 1, n, p[0]);
+   auto best = load(p);
+   size_t i = 4;
+   for (; i + 4 <= n; i += 4)
+      best = MAX ? max(best, load(p + i)) : min(best, load(p + i));
+   T lanes[4];
+   store(lanes, best);
+   return scalar::extreme<MAX>(p, i, n, scalar::extreme<MAX>(lanes, 1, 4, lanes[0]));
+}
+
+template <typename T>
+T sum(const T * p, size_t n)
+{
+   auto total = splat(T(0));
+   size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+      total = add(total, load(p + i));
+   T lanes[4];
+   store(lanes, total);
+   return scalar::sum(p, i, n, scalar::sum(lanes, 0, 4, T(0)));
+}
+} // namespace sse2
+
+/*****************************************
+ * AVX2
+ * Eight elements at a time. Each function is compiled
+ * for AVX2 on its own, so the rest of the program does
+ * not need the instructions to start.
+ ****************************************/
+namespace avx2
+{
+SIMD_AVX2 inline __m256i load(const int32_t * p) { return _mm256_loadu_si256((const __m256i *)p); }
+SIMD_AVX2 inline __m256  load(const float * p)   { return _mm256_loadu_ps(p); }
+SIMD_AVX2 inline int equal(__m256i a, __m256i b)
+{
+   return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)));
+}
+SIMD_AVX2 inline int equal(__m256 a, __m256 b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+SIMD_AVX2 inline __m256i splat(int32_t t)        { return _mm256_set1_epi32(t); }
+SIMD_AVX2 inline __m256  splat(float t)          { return _mm256_set1_ps(t); }
+SIMD_AVX2 inline __m256i add(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+SIMD_AVX2 inline __m256  add(__m256 a, __m256 b)   { return _mm256_add_ps(a, b); }
+SIMD_AVX2 inline __m256i min(__m256i a, __m256i b) { return _mm256_min_epi32(a, b); }
+SIMD_AVX2 inline __m256i max(__m256i a, __m256i b) { return _mm256_max_epi32(a, b); }
+SIMD_AVX2 inline __m256  min(__m256 a, __m256 b)   { return _mm256_min_ps(a, b); }
+SIMD_AVX2 inline __m256  max(__m256 a, __m256 b)   { return _mm256_max_ps(a, b); }
+SIMD_AVX2 inline void store(int32_t * p, __m256i x) { _mm256_storeu_si256((__m256i *)p, x); }
+SIMD_AVX2 inline void store(float * p, __m256 x)    { _mm256_storeu_ps(p, x); }
+SIMD_AVX2 inline __m256i bits(__m256i x)            { return x; }
+SIMD_AVX2 inline __m256i bits(__m256 x)             { return _mm256_castps_si256(x); }
+
+template <typename T>
+SIMD_AVX2 size_t find(const T * p, size_t n, T value)
+{
+   auto key = splat(value);
+   size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+      if (int mask = equal(load(p + i), key))
+         return i + firstBit(mask);
+   return scalar::find(p, i, n, value);
+}
+
+SIMD_AVX2 inline __m256i matches(__m256i a, __m256i b) { return _mm256_cmpeq_epi32(a, b); }
+SIMD_AVX2 inline __m256i matches(__m256 a, __m256 b)
+{
+   return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+}
+
+template <typename T>
+SIMD_AVX2 size_t count(const T * p, size_t n, T value)
+{
+   auto key = splat(value);
+   __m256i counts = _mm256_setzero_si256();
+   size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+      counts = _mm256_sub_epi32(counts, matches(load(p + i), key));
+   uint32_t lanes[8];
+   _mm256_storeu_si256((__m256i *)lanes, counts);
+   size_t num = 0;
+   for (uint32_t lane : lanes)
+      num += lane;
+   return num + scalar::count(p, i, n, value);
+}
+
+// n must be at least 1
+template <bool MAX, typename T>
+SIMD_AVX2 T extreme(const T * p, size_t n)
+{
+   if (n < 8)
+      return scalar::extreme<MAX>(p, 1, n, p[0]);
+   auto best = load(p);
+   size_t i = 8;
+   for (; i + 8 <= n; i += 8)
+      best = MAX ? max(best, load(p + i)) : min(best, load(p + i));
+   T lanes[8];
+   store(lanes, best);
+   return scalar::extreme<MAX>(p, i, n, scalar::extreme<MAX>(lanes, 1, 8, lanes[0]));
+}
+
+template <typename T>
+SIMD_AVX2 T sum(const T * p, size_t n)
+{
+   auto total = splat(T(0));
+   size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+      total = add(total, load(p + i));
+   T lanes[8];
+   store(lanes, total);
+   return scalar::sum(p, i, n, scalar::sum(lanes, 0, 8, T(0)));
+}
+
+/*****************************************
+ * AVX2 COMPACT TABLE
+ * For each 8-bit mask of lanes to keep, the lane
+ * indices that pack those lanes to the front
+ ****************************************/
+struct CompactTable
+{
+   alignas(32) int32_t lanes[256][8];
+   CompactTable()
+   {
+      for (int mask = 0; mask < 256; mask++)
+      {
+         int out = 0;
+         for (int lane = 0; lane < 8; lane++)
+            if (mask & (1 << lane))
+               lanes[mask][out++] = lane;
+         while (out < 8)
+            lanes[mask][out++] = 0;
+      }
+   }
+};
+
+inline const CompactTable & compactTable()
+{
+   static const CompactTable table;
+   return table;
+}
+
+// remove every element equal to value; returns the number kept
+template <typename T>
+SIMD_AVX2 size_t erase(T * p, size_t n, T value)
+{
+   const CompactTable & table = compactTable();
+   auto key = splat(value);
+   size_t out = 0;
+   size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+   {
+      auto x = load(p + i);
+      int keep = ~equal(x, key) & 0xff;
+      __m256i index = _mm256_load_si256((const __m256i *)table.lanes[keep]);
+      // out <= i, so these 8 slots are only ones we have already read
+      _mm256_storeu_si256((__m256i *)(p + out),
+                          _mm256_permutevar8x32_epi32(bits(x), index));
+      out += popCount(keep);
+   }
+   return scalar::compact(p, i, n, out, [value](T t) { return t == value; });
+}
+} // namespace avx2
+
+#endif // SIMD_X86
+
+/*****************************************
+ * HAS KERNEL
+ * The element types the SIMD kernels are written for
+ ****************************************/
+template <typename T>
+constexpr bool hasKernel = std::is_same<T, int32_t>::value || std::is_same<T, float>::value;
+
+// the elements of a vector as a plain array
+template <typename T, typename A, typename G>
+T * elements(vector <T, A, G> & v) { return v.empty() ? nullptr : &v[0]; }
+template <typename T, typename A, typename G>
+const T * elements(const vector <T, A, G> & v) { return v.empty() ? nullptr : &v[0]; }
+
+} // namespace detail
+
+/*****************************************
+ * SIMD :: FIND
+ * The first element equal to value, or end()
+ ****************************************/
+template <typename T, typename A, typename G>
+typename vector <T, A, G> ::iterator find(vector <T, A, G> & v, T value)
+{
+   static_assert(std::is_arithmetic<T>::value, "simd algorithms work on numbers");
+   const T * p = detail::elements(v);
+   size_t n = v.size();
+   size_t index;
+#ifdef SIMD_X86
+   if constexpr (detail::hasKernel<T>)
+      index = (level() == AVX2) ? detail::avx2::find(p, n, value) :
+              (level() == SSE2) ? detail::sse2::find(p, n, value) :
+                                  detail::scalar::find(p, 0, n, value);
+   else
+#endif
+      index = detail::scalar::find(p, 0, n, value);
+   return v.begin() + index;
+}
+
+/*****************************************
+ * SIMD :: COUNT
+ * The number of elements equal to value
+ ****************************************/
+template <typename T, typename A, typename G>
+size_t count(const vector <T, A, G> & v, T value)
+{
+   static_assert(std::is_arithmetic<T>::value, "simd algorithms work on numbers");
+   const T * p = detail::elements(v);
+   size_t n = v.size();
+#ifdef SIMD_X86
+   if constexpr (detail::hasKernel<T>)
+      return (level() == AVX2) ? detail::avx2::count(p, n, value) :
+             (level() == SSE2) ? detail::sse2::count(p, n, value) :
+                                 detail::scalar::count(p, 0, n, value);
+#endif
+   return detail::scalar::count(p, 0, n, value);
+}
+
+/*****************************************
+ * SIMD :: MIN ELEMENT and MAX ELEMENT
+ * The first smallest or largest element, or end() when
+ * empty. One pass finds the value and a second finds where
+ * it first appears: both read the vector at full speed.
+ * The vector may not hold a NaN.
+ ****************************************/
+template <bool MAX, typename T, typename A, typename G>
+typename vector <T, A, G> ::iterator extremeElement(vector <T, A, G> & v)
+{
+   static_assert(std::is_arithmetic<T>::value, "simd algorithms work on numbers");
+   if (v.empty())
+      return v.end();
+   const T * p = detail::elements(v);
+   size_t n = v.size();
+   T best;
+#ifdef SIMD_X86
+   if constexpr (detail::hasKernel<T>)
+      best = (level() == AVX2) ? detail::avx2::extreme<MAX>(p, n) :
+             (level() == SSE2) ? detail::sse2::extreme<MAX>(p, n) :
+                                 detail::scalar::extreme<MAX>(p, 1, n, p[0]);
+   else
+#endif
+      best = detail::scalar::extreme<MAX>(p, 1, n, p[0]);
+   return find(v, best);
+}
+
+template <typename T, typename A, typename G>
+typename vector <T, A, G> ::iterator min_element(vector <T, A, G> & v)
+{
+   return extremeElement<false>(v);
+}
+
+template <typename T, typename A, typename G>
+typename vector <T, A, G> ::iterator max_element(vector <T, A, G> & v)
+{
+   return extremeElement<true>(v);
+}
+
+/*****************************************
+ * SIMD :: SUM
+ * Every element added together. Integers wrap on
+ * overflow. Floating point is added in several running
+ * totals at once, so the rounding can differ slightly
+ * from a loop that adds one element at a time.
+ ****************************************/
+template <typename T, typename A, typename G>
+T sum(const vector <T, A, G> & v)
+{
+   static_assert(std::is_arithmetic<T>::value, "simd algorithms work on numbers");
+   const T * p = detail::elements(v);
+   size_t n = v.size();
+#ifdef SIMD_X86
+   if constexpr (detail::hasKernel<T>)
+      return (level() == AVX2) ? detail::avx2::sum(p, n) :
+             (level() == SSE2) ? detail::sse2::sum(p, n) :
+                                 detail::scalar::sum(p, 0, n, T(0));
+#endif
+   return detail::scalar::sum(p, 0, n, T(0));
+}
+
+/*****************************************
+ * SIMD :: ERASE IF
+ * Remove every element for which pred is true, keeping
+ * the order of the rest. The predicate could be anything,
+ * so it is called once per element, but the compaction
+ * never branches on its answer.
+ * Returns the number of elements removed.
+ ****************************************/
+template <typename T, typename A, typename G, class Predicate>
+size_t erase_if(vector <T, A, G> & v, Predicate pred)
+{
+   static_assert(std::is_arithmetic<T>::value, "simd algorithms work on numbers");
+   size_t n = v.size();
+   size_t kept = detail::scalar::compact(detail::elements(v), 0, n, 0, pred);
+   v.resize(kept);
+   return n - kept;
+}
+
+/*****************************************
+ * SIMD :: ERASE
+ * Remove every element equal to value, keeping the
+ * order of the rest. With AVX2, eight elements are
+ * compared and packed down with one permute.
+ * Returns the number of elements removed.
+ ****************************************/
+template <typename T, typename A, typename G>
+size_t erase(vector <T, A, G> & v, T value)
+{
+   static_assert(std::is_arithmetic<T>::value, "simd algorithms work on numbers");
+   T * p = detail::elements(v);
+   size_t n = v.size();
+   size_t kept;
+#ifdef SIMD_X86
+   if constexpr (detail::hasKernel<T>)
+      kept = (level() == AVX2) ? detail::avx2::erase(p, n, value) :
+             detail::scalar::compact(p, 0, n, 0, [value](T t) { return t == value; });
+   else
+#endif
+      kept = detail::scalar::compact(p, 0, n, 0, [value](T t) { return t == value; });
+   v.resize(kept);
+   return n - kept;
+}
+
+} // namespace simd
+} // namespace custom
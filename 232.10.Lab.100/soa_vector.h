@@ -0,0 +1,331 @@
+/***********************************************************************
+ * Header:
+ *    SOA VECTOR
+ * Summary:
+ *    A table of records stored one field at a time: a struct of
+ *    arrays rather than an array of structs. A scan of one field
+ *    then reads only that field, so every byte of every cache line
+ *    it pulls in is one it wanted.
+ *
+ *    This will contain the class definition of:
+ *        span                   : A view of a contiguous run of elements
+ *        soa_vector             : A Vector of records, one vector per field
+ *        soa_vector::iterator   : An iterator through the records
+ *        soa_vector::const_iterator : A read-only iterator through the records
+ ************************************************************************/
+
+#pragma once
+
+#include <tuple>       // for std::tuple
+#include <utility>     // for std::index_sequence
+#include <iterator>    // for std::input_iterator_tag
+#include <cstddef>     // for size_t and std::ptrdiff_t
+#include "vector.h"
+
+class TestSoaVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * SPAN
+ * A pointer and a length: a view of elements that
+ * live somewhere else, good until that storage moves
+ ****************************************/
+template <typename T>
+class span
+{
+public:
+   span() : first(nullptr), num(0) {}
+   span(T * first, size_t num) : first(first), num(num) {}
+
+   T *    begin()                    const { return first;        }
+   T *    end()                      const { return first + num;  }
+   T &    operator [] (size_t index) const { return first[index]; }
+   T *    data()                     const { return first;        }
+   size_t size()                     const { return num;          }
+   bool   empty()                    const { return num == 0;     }
+
+private:
+   T *    first;
+   size_t num;
+};
+
+/*****************************************
+ * SOA VECTOR
+ * One custom::vector per field, all the same length.
+ * Record i is element i of every one of them.
+ ****************************************/
+template <typename ... Fields>
+class soa_vector
+{
+   static_assert(sizeof...(Fields) > 0, "a record needs at least one field");
+   friend class ::TestSoaVector; // give unit tests access to the privates
+public:
+   // a whole record, by value and by reference
+   typedef std::tuple<Fields ...>          value_type;
+   typedef std::tuple<Fields & ...>        reference;
+   typedef std::tuple<const Fields & ...>  const_reference;
+
+   // the type of field I
+   template <size_t I>
+   using field_type = typename std::tuple_element<I, value_type>::type;
+
+   class iterator;
+   class const_iterator;
+
+   //
+   // Construct
+   //
+
+   soa_vector() {}
+
+   //
+   // Iterator
+   //
+
+   iterator       begin()       { return iterator(this, 0);            }
+   iterator       end()         { return iterator(this, size());       }
+   const_iterator begin() const { return const_iterator(this, 0);      }
+   const_iterator end()   const { return const_iterator(this, size()); }
+
+   //
+   // Access
+   //
+
+   reference       operator [] (size_t index)       { return record(index, indices()); }
+   const_reference operator [] (size_t index) const { return record(index, indices()); }
+
+   // every value of field I, side by side
+   template <size_t I>
+   span<field_type<I>> field()
+   {
+      auto & column = std::get<I>(columns);
+      return span<field_type<I>>(column.empty() ? nullptr : &column[0], column.size());
+   }
+   template <size_t I>
+   span<const field_type<I>> field() const
+   {
+      const auto & column = std::get<I>(columns);
+      return span<const field_type<I>>(column.empty() ? nullptr : &column[0], column.size());
+   }
+
+   //
+   // Insert
+   //
+
+   void push_back(const value_type & t) { pushBack(t, indices()); }
+   void push_back(value_type && t)      { pushBack(std::move(t), indices()); }
+   template <class ... Args>
+   reference emplace_back(Args && ... args)
+   {
+      static_assert(sizeof...(Args) == sizeof...(Fields), "one value per field");
+      emplaceBack(indices(), std::forward<Args>(args)...);
+      return (*this)[size() - 1];
+   }
+   void reserve(size_t newCapacity)
+   {
+      forEachColumn([newCapacity](auto & column) { column.reserve(newCapacity); });
+   }
+   void resize(size_t newElements)
+   {
+      forEachColumn([newElements](auto & column) { column.resize(newElements); });
+   }
+
+   //
+   // Remove
+   //
+
+   void clear()    { forEachColumn([](auto & column) { column.clear(); });    }
+   void pop_back() { forEachColumn([](auto & column) { column.pop_back(); }); }
+
+   //
+   // Status
+   //
+
+   size_t size()     const { return std::get<0>(columns).size();     }
+   size_t capacity() const { return std::get<0>(columns).capacity(); }
+   bool   empty()    const { return size() == 0;                     }
+
+private:
+   typedef std::index_sequence_for<Fields ...> Indices;
+   static Indices indices() { return Indices(); }
+
+   template <size_t ... I>
+   reference record(size_t index, std::index_sequence<I ...>)
+   {
+      return reference(std::get<I>(columns)[index] ...);
+   }
+   template <size_t ... I>
+   const_reference record(size_t index, std::index_sequence<I ...>) const
+   {
+      return const_reference(std::get<I>(columns)[index] ...);
+   }
+
+   // Every column grows first, so only a field's constructor can
+   // throw partway. Then the fields already added are taken back
+   // off, leaving every column the same length.
+   template <class Tuple, size_t ... I>
+   void pushBack(Tuple && t, std::index_sequence<I ...>)
+   {
+      reserve(growTo());
+      size_t numDone = 0;
+      try
+      {
+         ((std::get<I>(columns).push_back(std::get<I>(std::forward<Tuple>(t))), ++numDone), ...);
+      }
+      catch (...)
+      {
+         popColumns(numDone);
+         throw;
+      }
+   }
+   template <size_t ... I, class ... Args>
+   void emplaceBack(std::index_sequence<I ...>, Args && ... args)
+   {
+      reserve(growTo());
+      size_t numDone = 0;
+      try
+      {
+         ((std::get<I>(columns).emplace_back(std::forward<Args>(args)), ++numDone), ...);
+      }
+      catch (...)
+      {
+         popColumns(numDone);
+         throw;
+      }
+   }
+
+   // pop_back the first numColumns columns
+   void popColumns(size_t numColumns)
+   {
+      size_t i = 0;
+      forEachColumn([&](auto & column)
+      {
+         if (i++ < numColumns)
+            column.pop_back();
+      });
+   }
+
+   // the capacity every column needs for one more record
+   size_t growTo() const
+   {
+      return (size() < capacity()) ? capacity() : grow_double::grow(capacity(), size() + 1, 0);
+   }
+
+   template <class Function>
+   void forEachColumn(Function f)
+   {
+      std::apply([&f](auto & ... column) { (f(column), ...); }, columns);
+   }
+
+   std::tuple<vector<Fields> ...> columns;   // one vector per field
+};
+
+/**************************************************
+ * SOA VECTOR ITERATOR
+ * An iterator through the records. There is no record
+ * object to point at, so dereferencing gives a tuple of
+ * references to the fields: a proxy that reads and
+ * writes through to the columns.
+ *
+ * It has all the arithmetic of a random access
+ * iterator, but a random access (or even a forward)
+ * iterator must give value_type & from *it, and a
+ * proxy cannot. So it claims only to be an input
+ * iterator, and algorithms that would swap or move
+ * records through it, std::sort among them, do not
+ * take it.
+ *************************************************/
+template <typename ... Fields>
+class soa_vector <Fields ...> ::iterator
+{
+   friend class ::TestSoaVector;
+   friend class const_iterator;
+public:
+   typedef std::input_iterator_tag         iterator_category;
+   typedef std::tuple<Fields ...>          value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef void                            pointer;
+   typedef std::tuple<Fields & ...>        reference;
+
+   iterator()                              : pSoa(nullptr), index(0) {}
+   iterator(soa_vector * pSoa, size_t index) : pSoa(pSoa), index(index) {}
+
+   reference operator * ()                      const { return (*pSoa)[index];     }
+   reference operator [] (difference_type n)    const { return (*pSoa)[index + n]; }
+
+   iterator & operator ++ ()                   { ++index; return *this;              }
+   iterator   operator ++ (int)                { iterator it(*this); ++index; return it; }
+   iterator & operator -- ()                   { --index; return *this;              }
+   iterator   operator -- (int)                { iterator it(*this); --index; return it; }
+   iterator & operator += (difference_type n)  { index += n; return *this;           }
+   iterator & operator -= (difference_type n)  { index -= n; return *this;           }
+   iterator   operator +  (difference_type n) const { return iterator(pSoa, index + n); }
+   iterator   operator -  (difference_type n) const { return iterator(pSoa, index - n); }
+   difference_type operator - (const iterator & rhs) const
+   {
+      return (difference_type)index - (difference_type)rhs.index;
+   }
+
+   bool operator == (const iterator & rhs) const { return index == rhs.index; }
+   bool operator != (const iterator & rhs) const { return index != rhs.index; }
+   bool operator <  (const iterator & rhs) const { return index <  rhs.index; }
+   bool operator >  (const iterator & rhs) const { return index >  rhs.index; }
+   bool operator <= (const iterator & rhs) const { return index <= rhs.index; }
+   bool operator >= (const iterator & rhs) const { return index >= rhs.index; }
+
+private:
+   soa_vector * pSoa;
+   size_t index;
+};
+
+/**************************************************
+ * SOA VECTOR CONST ITERATOR
+ * The same, through a const soa_vector: the tuple
+ * holds const references.
+ *************************************************/
+template <typename ... Fields>
+class soa_vector <Fields ...> ::const_iterator
+{
+   friend class ::TestSoaVector;
+public:
+   typedef std::input_iterator_tag         iterator_category;
+   typedef std::tuple<Fields ...>          value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef void                            pointer;
+   typedef std::tuple<const Fields & ...>  reference;
+
+   const_iterator()                                    : pSoa(nullptr), index(0) {}
+   const_iterator(const soa_vector * pSoa, size_t index) : pSoa(pSoa), index(index) {}
+   const_iterator(const iterator & rhs)                : pSoa(rhs.pSoa), index(rhs.index) {}
+
+   reference operator * ()                      const { return (*pSoa)[index];     }
+   reference operator [] (difference_type n)    const { return (*pSoa)[index + n]; }
+
+   const_iterator & operator ++ ()                   { ++index; return *this;                    }
+   const_iterator   operator ++ (int)                { const_iterator it(*this); ++index; return it; }
+   const_iterator & operator -- ()                   { --index; return *this;                    }
+   const_iterator   operator -- (int)                { const_iterator it(*this); --index; return it; }
+   const_iterator & operator += (difference_type n)  { index += n; return *this;                 }
+   const_iterator & operator -= (difference_type n)  { index -= n; return *this;                 }
+   const_iterator   operator +  (difference_type n) const { return const_iterator(pSoa, index + n); }
+   const_iterator   operator -  (difference_type n) const { return const_iterator(pSoa, index - n); }
+   difference_type operator - (const const_iterator & rhs) const
+   {
+      return (difference_type)index - (difference_type)rhs.index;
+   }
+
+   bool operator == (const const_iterator & rhs) const { return index == rhs.index; }
+   bool operator != (const const_iterator & rhs) const { return index != rhs.index; }
+   bool operator <  (const const_iterator & rhs) const { return index <  rhs.index; }
+   bool operator >  (const const_iterator & rhs) const { return index >  rhs.index; }
+   bool operator <= (const const_iterator & rhs) const { return index <= rhs.index; }
+   bool operator >= (const const_iterator & rhs) const { return index >= rhs.index; }
+
+private:
+   const soa_vector * pSoa;
+   size_t index;
+};
+
+} // namespace custom
@@ -0,0 +1,381 @@
+/***********************************************************************
+ * Header:
+ *    SORT
+ * Summary:
+ *    Sorting a vector in place, without first copying it into a
+ *    std::vector. Numbers, and records sorted by a number, are
+ *    sorted a byte of the key at a time rather than by comparing;
+ *    anything else is merge sorted, split across the thread pool
+ *    when the vector is huge. Either way the sort needs one
+ *    scratch buffer as long as the vector, and a caller that sorts
+ *    again and again can pass the same scratch vector every time.
+ *
+ *    This will contain the definitions of:
+ *        radix_sort        : Stable sort on an integer or floating key
+ *        merge_sort        : Stable sort by comparison, in parallel
+ *        sort              : radix_sort for numbers, else merge_sort
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>     // for uint8_t ... uint64_t
+#include <cstddef>     // for size_t
+#include <cstring>     // for std::memcpy
+#include <functional>  // for std::less
+#include <type_traits> // for std::is_integral and std::is_floating_point
+#include <utility>     // for std::move, std::swap, and std::declval
+#include "vector.h"
+#include "thread_pool.h"
+
+namespace custom
+{
+namespace detail
+{
+
+/*****************************************
+ * SORT CUTOFFS
+ * Runs this short are insertion sorted. Each byte
+ * of a radix key costs a pass that clears and sums
+ * 256 buckets, so below radixCutoff elements per
+ * byte, radix_sort merge sorts on the key instead.
+ ****************************************/
+const size_t insertionCutoff = 32;
+const size_t radixCutoff     = 128;
+
+/*****************************************
+ * UNSIGNED OF
+ * The unsigned integer as wide as a key
+ ****************************************/
+template <size_t Bytes> struct unsignedOf;
+template <> struct unsignedOf<1> { typedef uint8_t  type; };
+template <> struct unsignedOf<2> { typedef uint16_t type; };
+template <> struct unsignedOf<4> { typedef uint32_t type; };
+template <> struct unsignedOf<8> { typedef uint64_t type; };
+
+/*****************************************
+ * RADIX BITS
+ * The key as an unsigned integer that orders the
+ * same way. Signed integers have their sign bit
+ * flipped so negatives come first. Negative floats
+ * have every bit flipped, since a larger magnitude
+ * is a smaller number, and positive floats only the
+ * sign bit. That puts -0 before +0, and NaNs at the
+ * ends according to their sign.
+ ****************************************/
+template <typename K>
+typename unsignedOf<sizeof(K)>::type radixBits(K key)
+{
+   static_assert(std::is_integral<K>::value || std::is_floating_point<K>::value,
+                 "a radix key must be an integer or floating-point number");
+   typedef typename unsignedOf<sizeof(K)>::type U;
+   const U signBit = U(1) << (sizeof(K) * 8 - 1);
+
+   U bits;
+   std::memcpy(&bits, &key, sizeof(K));
+   if constexpr (std::is_floating_point<K>::value)
+      return (bits & signBit) ? U(~bits) : U(bits ^ signBit);
+   else if constexpr (std::is_signed<K>::value)
+      return U(bits ^ signBit);
+   else
+      return bits;
+}
+
+/*****************************************
+ * INSERTION SORT
+ * Stable, and the fastest way to sort a handful
+ ****************************************/
+template <typename T, class Compare>
+void insertionSort(T * p, size_t num, Compare & less)
+{
+   for (size_t i = 1; i < num; i++)
+   {
+      if (!less(p[i], p[i - 1]))
+         continue;
+      T t(std::move(p[i]));
+      size_t j = i;
+      for (; j > 0 && less(t, p[j - 1]); j--)
+         p[j] = std::move(p[j - 1]);
+      p[j] = std::move(t);
+   }
+}
+
+/*****************************************
+ * MERGE
+ * Move the sorted runs a and b into dest. On a
+ * tie, a goes first, which keeps the sort stable.
+ ****************************************/
+template <typename T, class Compare>
+void merge(T * a, size_t numA, T * b, size_t numB, T * dest, Compare & less)
+{
+   T * aEnd = a + numA;
+   T * bEnd = b + numB;
+   while (a != aEnd && b != bEnd)
+      *dest++ = less(*b, *a) ? std::move(*b++) : std::move(*a++);
+   while (a != aEnd)
+      *dest++ = std::move(*a++);
+   while (b != bEnd)
+      *dest++ = std::move(*b++);
+}
+
+/*****************************************
+ * MERGE SPLIT
+ * How many of the first num elements of the merge
+ * of a and b come from a. Then the merge can be cut
+ * at num, and both sides merged at the same time.
+ ****************************************/
+template <typename T, class Compare>
+size_t mergeSplit(const T * a, size_t numA, const T * b, size_t numB, size_t num,
+                  Compare & less)
+{
+   size_t lo = (num > numB) ? num - numB : 0;
+   size_t hi = (num < numA) ? num : numA;
+   while (lo < hi)
+   {
+      // is a[mid] after the first num?
+      size_t mid = lo + (hi - lo) / 2;
+      if (less(b[num - mid - 1], a[mid]))
+         hi = mid;
+      else
+         lo = mid + 1;
+   }
+   return lo;
+}
+
+/*****************************************
+ * MERGE SORT
+ * Sort the num elements at a, leaving them in a or,
+ * if intoB, in b; whichever one they do not end up
+ * in is scratch. Each half is sorted into the other
+ * buffer, then merged back, so nothing is copied
+ * just to get it into the right place.
+ ****************************************/
+template <typename T, class Compare>
+void mergeSort(T * a, T * b, size_t num, bool intoB, Compare & less)
+{
+   if (num <= insertionCutoff)
+   {
+      insertionSort(a, num, less);
+      if (intoB)
+         for (size_t i = 0; i < num; i++)
+            b[i] = std::move(a[i]);
+      return;
+   }
+
+   size_t half = num / 2;
+   mergeSort(a,        b,        half,       !intoB, less);
+   mergeSort(a + half, b + half, num - half, !intoB, less);
+   if (intoB)
+      merge(a, half, a + half, num - half, b, less);
+   else
+      merge(b, half, b + half, num - half, a, less);
+}
+
+/*****************************************
+ * ELEMENTS
+ * Where a vector's elements start
+ ****************************************/
+template <typename T, typename A, typename G>
+T * sortElements(vector <T, A, G> & v) { return v.empty() ? nullptr : &v[0]; }
+
+} // namespace detail
+
+/*****************************************
+ * MERGE SORT
+ * A stable sort by less. Above the parallelism
+ * threshold, the vector is cut into a power of two
+ * pieces, one per thread, each piece is sorted, and
+ * then pairs of pieces are merged until one is left.
+ * Every merge is itself cut into pieces, so all the
+ * threads stay busy through the last merge too.
+ *
+ * T must be default constructible so the scratch
+ * vector can hold it. If less throws, v still holds
+ * valid elements, but not necessarily the ones it had.
+ ****************************************/
+template <typename T, typename A, typename G, class Compare>
+void merge_sort(vector <T, A, G> & v, Compare less, vector <T, A, G> & scratch)
+{
+   size_t num = v.size();
+   if (num <= detail::insertionCutoff)
+   {
+      detail::insertionSort(detail::sortElements(v), num, less);
+      return;
+   }
+   scratch.resize(num);
+
+   // how many pieces: a power of two no more than the threads
+   size_t numPieces = 1;
+   size_t numRounds = 0;
+   if (num * sizeof(T) >= parallelism::settings().threshold && !thread_pool::inTask())
+      while (numPieces * 2 <= parallelism::settings().threads &&
+             num / (numPieces * 2) > detail::insertionCutoff)
+      {
+         numPieces *= 2;
+         numRounds++;
+      }
+   auto begin = [&](size_t i) { return num * i / numPieces; };
+
+   // sort the pieces into scratch if an odd number of rounds
+   // of merging is to follow, so the last round lands in v
+   bool intoScratch = (numRounds % 2) == 1;
+   T * from = intoScratch ? &scratch[0] : &v[0];
+   T * to   = intoScratch ? &v[0] : &scratch[0];
+   thread_pool::shared().run(numPieces, [&](size_t i)
+   {
+      detail::mergeSort(&v[0] + begin(i), &scratch[0] + begin(i),
+                        begin(i + 1) - begin(i), intoScratch, less);
+   });
+
+   // merge pairs of runs, each run width pieces wide
+   for (size_t width = 1; width < numPieces; width *= 2)
+   {
+      thread_pool::shared().run(numPieces, [&](size_t i)
+      {
+         // this task's part of the merge of runs [lo, mid) and [mid, hi)
+         size_t iFirst = i / (2 * width) * (2 * width);
+         size_t lo  = begin(iFirst);
+         size_t mid = begin(iFirst + width);
+         size_t hi  = begin(iFirst + 2 * width);
+         size_t part = i - iFirst;
+         size_t outBegin = (hi - lo) * part       / (2 * width);
+         size_t outEnd   = (hi - lo) * (part + 1) / (2 * width);
+
+         T * a = from + lo;
+         T * b = from + mid;
+         size_t aBegin = detail::mergeSplit(a, mid - lo, b, hi - mid, outBegin, less);
+         size_t aEnd   = detail::mergeSplit(a, mid - lo, b, hi - mid, outEnd,   less);
+         detail::merge(a + aBegin, aEnd - aBegin,
+                       b + (outBegin - aBegin), (outEnd - aEnd) - (outBegin - aBegin),
+                       to + lo + outBegin, less);
+      });
+      std::swap(from, to);
+   }
+}
+
+template <typename T, typename A, typename G, class Compare>
+void merge_sort(vector <T, A, G> & v, Compare less)
+{
+   vector <T, A, G> scratch;
+   merge_sort(v, less, scratch);
+}
+
+template <typename T, typename A, typename G>
+void merge_sort(vector <T, A, G> & v)
+{
+   merge_sort(v, std::less<T>());
+}
+
+/*****************************************
+ * RADIX SORT
+ * A stable sort on key(t), an integer or floating
+ * point number, one byte at a time from the lowest.
+ * One pass counts every byte of every key; then each
+ * byte takes one pass that moves the elements into
+ * their buckets, back and forth between v and scratch.
+ * A byte that is the same in every key, such as the
+ * top bytes of small numbers, is skipped.
+ *
+ * key is called once per element per pass, so it
+ * should be a field, not a computation. T must be
+ * default constructible so the scratch vector can
+ * hold it.
+ ****************************************/
+template <typename T, typename A, typename G, class KeyOf>
+void radix_sort(vector <T, A, G> & v, KeyOf key, vector <T, A, G> & scratch)
+{
+   size_t num = v.size();
+   auto bits = [&](const T & t) { return detail::radixBits(key(t)); };
+   const size_t numBytes = sizeof(bits(std::declval<const T &>()));
+   if (num < detail::radixCutoff * numBytes)
+   {
+      merge_sort(v, [&](const T & lhs, const T & rhs) { return bits(lhs) < bits(rhs); },
+                 scratch);
+      return;
+   }
+
+   // count every byte of every key in one pass
+   size_t counts[numBytes][256] = {};
+   T * p = &v[0];
+   for (size_t i = 0; i < num; i++)
+   {
+      auto b = bits(p[i]);
+      for (size_t d = 0; d < numBytes; d++)
+         counts[d][(b >> (d * 8)) & 0xff]++;
+   }
+
+   T * from = p;
+   T * to = nullptr;
+   for (size_t d = 0; d < numBytes; d++)
+   {
+      // every key has the same byte here: nothing moves
+      if (counts[d][(bits(from[0]) >> (d * 8)) & 0xff] == num)
+         continue;
+      if (to == nullptr)
+      {
+         scratch.resize(num);
+         to = &scratch[0];
+      }
+
+      // where each bucket starts
+      size_t next[256];
+      size_t total = 0;
+      for (size_t digit = 0; digit < 256; digit++)
+      {
+         next[digit] = total;
+         total += counts[d][digit];
+      }
+
+      for (size_t i = 0; i < num; i++)
+         to[next[(bits(from[i]) >> (d * 8)) & 0xff]++] = std::move(from[i]);
+      std::swap(from, to);
+   }
+
+   // an odd number of passes left the elements in scratch
+   if (from != p)
+      v.swap(scratch);
+}
+
+template <typename T, typename A, typename G, class KeyOf>
+void radix_sort(vector <T, A, G> & v, KeyOf key)
+{
+   vector <T, A, G> scratch;
+   radix_sort(v, key, scratch);
+}
+
+template <typename T, typename A, typename G>
+void radix_sort(vector <T, A, G> & v)
+{
+   radix_sort(v, [](T t) { return t; });
+}
+
+/*****************************************
+ * SORT
+ * Numbers of up to 8 bytes are radix sorted;
+ * everything else, long double and anything sorted
+ * by a comparison included, is merge sorted. Either
+ * way the sort is stable.
+ ****************************************/
+template <typename T, typename A, typename G>
+void sort(vector <T, A, G> & v, vector <T, A, G> & scratch)
+{
+   if constexpr ((std::is_integral<T>::value || std::is_floating_point<T>::value) &&
+                 sizeof(T) <= 8)
+      radix_sort(v, [](T t) { return t; }, scratch);
+   else
+      merge_sort(v, std::less<T>(), scratch);
+}
+
+template <typename T, typename A, typename G>
+void sort(vector <T, A, G> & v)
+{
+   vector <T, A, G> scratch;
+   sort(v, scratch);
+}
+
+template <typename T, typename A, typename G, class Compare>
+void sort(vector <T, A, G> & v, Compare less)
+{
+   merge_sort(v, less);
+}
+
+} // namespace custom
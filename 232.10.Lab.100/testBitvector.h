@@ -0,0 +1,233 @@
+/***********************************************************************
+ * Header:
+ *    TEST BITVECTOR
+ * Summary:
+ *    Unit tests for bitvector
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "bitvector.h"
+#include "unitTest.h"
+
+#include <cstdint>
+
+class TestBitvector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_fill();
+
+      // Access
+      test_subscript_reference();
+
+      // Update
+      test_setRange_acrossWords();
+      test_setRange_oneWord();
+      test_and_or_xor();
+
+      // Insert and remove
+      test_pushback_newWord();
+      test_popback_dropsWord();
+      test_resize_shrinkClearsTail();
+
+      // Count and search
+      test_rank_partialWord();
+      test_findNext_skipsWords();
+
+      // Footprint
+      test_bytes_eighthOfBools();
+
+      report("Bitvector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // 70 set bits: a full word and 6 bits of the next
+   void test_construct_fill()
+   {  // setup
+      // exercise
+      custom::bitvector b(70, true);
+      // verify
+      assertUnit(b.numBits == 70);
+      assertUnit(b.words.size() == 2);
+      assertUnit(b.words[0] == ~uint64_t(0));
+      assertUnit(b.words[1] == 0x3f);
+      assertUnit(b.count() == 70);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // assign through the subscript, bit from bit
+   void test_subscript_reference()
+   {  // setup
+      custom::bitvector b(10);
+      // exercise
+      b[3] = true;
+      b[5] = b[3];
+      b[9].flip();
+      // verify
+      assertUnit(b.words[0] == 0x228);
+      assertUnit(b[5]);
+      assertUnit(!b[4]);
+   }  // teardown
+
+   /***************************************
+    * UPDATE
+    ***************************************/
+
+   // a range over three words fills the middle one whole
+   void test_setRange_acrossWords()
+   {  // setup
+      custom::bitvector b(200);
+      // exercise
+      b.set(60, 130, true);
+      // verify
+      //    word 0        word 1        word 2
+      //    1111000...0   1111...1111   0...0011
+      assertUnit(b.words[0] == uint64_t(0xf) << 60);
+      assertUnit(b.words[1] == ~uint64_t(0));
+      assertUnit(b.words[2] == 0x3);
+      assertUnit(b.words[3] == 0);
+      assertUnit(b.count() == 70);
+   }  // teardown
+
+   // a range inside one word, cleared
+   void test_setRange_oneWord()
+   {  // setup
+      custom::bitvector b(64, true);
+      // exercise
+      b.set(4, 8, false);
+      // verify
+      assertUnit(b.words[0] == ~uint64_t(0xf0));
+   }  // teardown
+
+   // and, or, and xor a word at a time
+   void test_and_or_xor()
+   {  // setup
+      custom::bitvector lhs(100);
+      custom::bitvector rhs(100);
+      lhs.set(0, 70, true);
+      rhs.set(50, 100, true);
+      custom::bitvector both(lhs);
+      custom::bitvector either(lhs);
+      custom::bitvector one(lhs);
+      // exercise
+      both &= rhs;
+      either |= rhs;
+      one ^= rhs;
+      // verify
+      assertUnit(both.count() == 20);
+      assertUnit(both.find_first() == 50);
+      assertUnit(either.count() == 100);
+      assertUnit(one.count() == 80);
+      assertUnit(!one[60]);
+   }  // teardown
+
+   /***************************************
+    * INSERT AND REMOVE
+    ***************************************/
+
+   // the 65th bit starts a second word
+   void test_pushback_newWord()
+   {  // setup
+      custom::bitvector b;
+      for (int i = 0; i < 64; i++)
+         b.push_back(i % 2 == 0);
+      assertUnit(b.words.size() == 1);
+      // exercise
+      b.push_back(true);
+      // verify
+      assertUnit(b.words.size() == 2);
+      assertUnit(b.words[0] == 0x5555555555555555);
+      assertUnit(b.words[1] == 1);
+      assertUnit(b.size() == 65);
+      assertUnit(b.back());
+   }  // teardown
+
+   // popping the only bit of the last word lets the word go
+   void test_popback_dropsWord()
+   {  // setup
+      custom::bitvector b(65, true);
+      // exercise
+      b.pop_back();
+      // verify
+      assertUnit(b.words.size() == 1);
+      assertUnit(b.size() == 64);
+      assertUnit(b.count() == 64);
+   }  // teardown
+
+   // shrinking clears the cut bits, so growing again brings back 0s
+   void test_resize_shrinkClearsTail()
+   {  // setup
+      custom::bitvector b(100, true);
+      // exercise
+      b.resize(70);
+      assertUnit(b.words[1] == 0x3f);
+      b.resize(100);
+      // verify
+      assertUnit(b.count() == 70);
+      assertUnit(!b[70]);
+      assertUnit(!b[99]);
+   }  // teardown
+
+   /***************************************
+    * COUNT AND SEARCH
+    ***************************************/
+
+   // whole words, then part of one
+   void test_rank_partialWord()
+   {  // setup
+      custom::bitvector b(300);
+      for (size_t i = 0; i < 300; i += 3)
+         b.set(i);
+      // exercise and verify
+      assertUnit(b.rank(0) == 0);
+      assertUnit(b.rank(1) == 1);
+      assertUnit(b.rank(64) == 22);
+      assertUnit(b.rank(200) == 67);
+      assertUnit(b.rank(300) == 100);
+   }  // teardown
+
+   // the next set bit is three words away
+   void test_findNext_skipsWords()
+   {  // setup
+      custom::bitvector b(300);
+      b.set(5);
+      b.set(250);
+      // exercise and verify
+      assertUnit(b.find_first() == 5);
+      assertUnit(b.find_next(5) == 5);
+      assertUnit(b.find_next(6) == 250);
+      assertUnit(b.find_next(251) == 300);
+      assertUnit(custom::bitvector(10).find_first() == 10);
+   }  // teardown
+
+   /***************************************
+    * FOOTPRINT
+    ***************************************/
+
+   // a vector<bool> of 80K flags takes 80KB; the bitvector 10KB
+   void test_bytes_eighthOfBools()
+   {  // setup
+      // exercise
+      custom::vector<bool> v(80000);
+      custom::bitvector b(80000);
+      // verify
+      assertUnit(v.capacity() * sizeof(bool) == 80000);
+      assertUnit(b.bytes() == 10000);
+      assertUnit(v.capacity() * sizeof(bool) == 8 * b.bytes());
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,336 @@
+/***********************************************************************
+ * Header:
+ *    TEST CIRCULAR BUFFER
+ * Summary:
+ *    Unit tests for circular_buffer
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "circular_buffer.h"
+#include "spy.h"
+#include "unitTest.h"
+
+class TestCircularBuffer : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_roundsUp();
+      test_constructCopy_wrapped();
+      test_constructMove_standard();
+      test_constructMove_sourceUsable();
+
+      // Insert
+      test_pushback_wraps();
+      test_pushfront_wraps();
+      test_pushback_fullReject();
+      test_pushback_fullOverwrite();
+      test_pushfront_fullOverwrite();
+      test_pushN_wraps();
+      test_pushN_reject();
+      test_pushN_overwriteMore();
+
+      // Remove
+      test_popN_wraps();
+      test_popN_spy();
+      test_clear_spyDestroy();
+
+      report("CircularBuffer");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // the capacity is rounded up to a power of two
+   void test_construct_roundsUp()
+   {  // setup
+      // exercise
+      custom::circular_buffer<int> cb(5);
+      // verify
+      assertUnit(cb.data != nullptr);
+      assertUnit(cb.mask == 7);
+      assertUnit(cb.capacity() == 8);
+      assertUnit(cb.numElements == 0);
+      assertUnit(cb.empty());
+      assertUnit(cb.policy() == custom::circular_buffer<int>::REJECT);
+   }  // teardown
+
+   // a copy reads the same, even when the source wraps around
+   void test_constructCopy_wrapped()
+   {  // setup
+      custom::circular_buffer<Spy> cbSrc(4);
+      setupWrapped(cbSrc);
+      Spy::reset();
+      // exercise
+      custom::circular_buffer<Spy> cbDest(cbSrc);
+      // verify
+      assertUnit(Spy::numCopy() == 3);
+      assertUnit(cbDest.capacity() == 4);
+      assertUnit(cbDest.size() == 3);
+      assertUnit(cbDest[0].get() == 26);
+      assertUnit(cbDest[1].get() == 49);
+      assertUnit(cbDest[2].get() == 67);
+   }  // teardown
+
+   // move takes the buffer
+   void test_constructMove_standard()
+   {  // setup
+      custom::circular_buffer<Spy> cbSrc(4);
+      cbSrc.push_back(Spy(26));
+      Spy * data = cbSrc.data;
+      Spy::reset();
+      // exercise
+      custom::circular_buffer<Spy> cbDest(std::move(cbSrc));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(cbDest.data == data);
+      assertUnit(cbSrc.data == nullptr);
+      assertUnit(cbDest.front().get() == 26);
+   }  // teardown
+
+   // what move leaves behind has no room, but pushing onto it is safe
+   void test_constructMove_sourceUsable()
+   {  // setup
+      custom::circular_buffer<int> cbSrc(4, custom::circular_buffer<int>::OVERWRITE);
+      cbSrc.push_back(26);
+      custom::circular_buffer<int> cbDest(std::move(cbSrc));
+      int source[2] = { 49, 67 };
+      // exercise
+      bool pushedBack  = cbSrc.push_back(49);
+      bool pushedFront = cbSrc.push_front(67);
+      size_t numPushed = cbSrc.push_n(source, 2);
+      // verify
+      assertUnit(!pushedBack);
+      assertUnit(!pushedFront);
+      assertUnit(numPushed == 2);
+      assertUnit(cbSrc.capacity() == 0);
+      assertUnit(cbSrc.size() == 0);
+      assertUnit(cbSrc.full());
+      cbSrc = cbDest;
+      assertUnit(cbSrc.capacity() == 4);
+      assertUnit(cbSrc.front() == 26);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push_back past the end of the buffer wraps to its start
+   void test_pushback_wraps()
+   {  // setup
+      custom::circular_buffer<int> cb(4);
+      // exercise
+      setupWrapped(cb);
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 67 |    | 26 | 49 |
+      //    +----+----+----+----+
+      //      back      front
+      assertUnit(cb.iFront == 2);
+      assertUnit(cb.size() == 3);
+      assertUnit(cb.data[0] == 67);
+      assertUnit(cb.front() == 26);
+      assertUnit(cb.back() == 67);
+   }  // teardown
+
+   // push_front onto an empty buffer starts at the last slot
+   void test_pushfront_wraps()
+   {  // setup
+      custom::circular_buffer<int> cb(4);
+      // exercise
+      cb.push_front(26);
+      cb.push_front(11);
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    |    |    | 11 | 26 |
+      //    +----+----+----+----+
+      assertUnit(cb.iFront == 2);
+      assertUnit(cb.front() == 11);
+      assertUnit(cb.back() == 26);
+   }  // teardown
+
+   // a full REJECT buffer turns the push away
+   void test_pushback_fullReject()
+   {  // setup
+      custom::circular_buffer<int> cb(2);
+      cb.push_back(26);
+      cb.push_back(49);
+      // exercise
+      bool taken = cb.push_back(67);
+      // verify
+      assertUnit(!taken);
+      assertUnit(cb.full());
+      assertUnit(cb.front() == 26);
+      assertUnit(cb.back() == 49);
+   }  // teardown
+
+   // a full OVERWRITE buffer drops the oldest
+   void test_pushback_fullOverwrite()
+   {  // setup
+      custom::circular_buffer<Spy> cb(2, custom::circular_buffer<Spy>::OVERWRITE);
+      cb.push_back(Spy(26));
+      cb.push_back(Spy(49));
+      // exercise
+      bool taken = cb.push_back(cb.front());
+      // verify
+      assertUnit(taken);
+      assertUnit(cb.size() == 2);
+      assertUnit(cb.front().get() == 49);
+      assertUnit(cb.back().get() == 26);
+   }  // teardown
+
+   // push_front onto a full OVERWRITE buffer drops the back
+   void test_pushfront_fullOverwrite()
+   {  // setup
+      custom::circular_buffer<int> cb(2, custom::circular_buffer<int>::OVERWRITE);
+      cb.push_back(26);
+      cb.push_back(49);
+      // exercise
+      cb.push_front(11);
+      // verify
+      assertUnit(cb.size() == 2);
+      assertUnit(cb.front() == 11);
+      assertUnit(cb.back() == 26);
+   }  // teardown
+
+   // push_n copies in two runs when the free space wraps
+   void test_pushN_wraps()
+   {  // setup
+      custom::circular_buffer<int> cb(4);
+      setupWrapped(cb);
+      cb.pop_front();
+      int source[] = { 89, 99 };
+      // exercise
+      size_t num = cb.push_n(source, 2);
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 67 | 89 | 99 | 49 |
+      //    +----+----+----+----+
+      assertUnit(num == 2);
+      assertUnit(cb.full());
+      assertUnit(cb.data[1] == 89);
+      assertUnit(cb.data[2] == 99);
+      assertUnit(cb.back() == 99);
+   }  // teardown
+
+   // push_n onto a REJECT buffer takes only what fits
+   void test_pushN_reject()
+   {  // setup
+      custom::circular_buffer<Spy> cb(4);
+      cb.push_back(Spy(26));
+      Spy source[] = { Spy(49), Spy(67), Spy(89), Spy(99) };
+      Spy::reset();
+      // exercise
+      size_t num = cb.push_n(source, 4);
+      // verify
+      assertUnit(num == 3);
+      assertUnit(Spy::numCopy() == 3);
+      assertUnit(cb.size() == 4);
+      assertUnit(cb.back().get() == 89);
+   }  // teardown
+
+   // push_n of more than the capacity keeps the newest
+   void test_pushN_overwriteMore()
+   {  // setup
+      custom::circular_buffer<int> cb(4, custom::circular_buffer<int>::OVERWRITE);
+      cb.push_back(11);
+      int source[] = { 0, 1, 2, 3, 4, 5 };
+      // exercise
+      size_t num = cb.push_n(source, 6);
+      // verify
+      assertUnit(num == 6);
+      assertUnit(cb.size() == 4);
+      assertUnit(cb[0] == 2);
+      assertUnit(cb[3] == 5);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // pop_n moves a wrapped run out in order
+   void test_popN_wraps()
+   {  // setup
+      custom::circular_buffer<int> cb(4);
+      setupWrapped(cb);
+      int dest[5] = { 0, 0, 0, 0, 0 };
+      // exercise
+      size_t num = cb.pop_n(dest, 5);
+      // verify
+      assertUnit(num == 3);
+      assertUnit(cb.empty());
+      assertUnit(cb.iFront == 1);
+      assertUnit(dest[0] == 26);
+      assertUnit(dest[1] == 49);
+      assertUnit(dest[2] == 67);
+      assertUnit(dest[3] == 0);
+   }  // teardown
+
+   // pop_n of objects moves them, never copies
+   void test_popN_spy()
+   {  // setup
+      custom::circular_buffer<Spy> cb(4);
+      setupWrapped(cb);
+      Spy dest[2];
+      Spy::reset();
+      // exercise
+      size_t num = cb.pop_n(dest, 2);
+      // verify
+      assertUnit(num == 2);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssignMove() == 2);
+      assertUnit(Spy::numDestructor() == 2);
+      assertUnit(dest[1].get() == 49);
+      assertUnit(cb.size() == 1);
+      assertUnit(cb.front().get() == 67);
+   }  // teardown
+
+   // clear destroys every element, wrapped or not
+   void test_clear_spyDestroy()
+   {  // setup
+      custom::circular_buffer<Spy> cb(4);
+      setupWrapped(cb);
+      Spy::reset();
+      // exercise
+      cb.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(Spy::numDelete() == 3);
+      assertUnit(cb.empty());
+      assertUnit(cb.iFront == 0);
+   }  // teardown
+
+private:
+   /*************************************************************
+    * SETUP WRAPPED
+    * Three elements of a 4-element buffer, wrapped around the end
+    *      0    1    2    3
+    *    +----+----+----+----+
+    *    | 67 |    | 26 | 49 |
+    *    +----+----+----+----+
+    *************************************************************/
+   template <class T>
+   void setupWrapped(custom::circular_buffer<T> & cb)
+   {
+      cb.push_back(T(0));
+      cb.push_back(T(0));
+      cb.push_back(T(26));
+      cb.push_back(T(49));
+      cb.pop_front();
+      cb.pop_front();
+      cb.push_back(T(67));
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,269 @@
+/***********************************************************************
+ * Header:
+ *    TEST COMPRESSED VECTOR
+ * Summary:
+ *    Unit tests for compressed_vector. The decode tests run at every
+ *    simd level this processor supports.
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "compressed_vector.h"
+#include "unitTest.h"
+
+#include <cstdint>
+#include <random>
+
+class TestCompressedVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_empty();
+      test_construct_partialBlock();
+      test_construct_steadyNoBits();
+      test_construct_unsortedFullWidth();
+
+      // Access
+      test_subscript_everyElement();
+      test_lowerBound_sorted();
+
+      // Decode
+      test_decode_everyLevel();
+      test_decode_widths();
+
+      // Iterator
+      test_iterator_acrossBlocks();
+
+      // Footprint
+      test_bytes_smallGaps();
+
+      custom::simd::setLevel(custom::simd::AVX2);
+      report("CompressedVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // nothing to compress
+   void test_construct_empty()
+   {  // setup
+      custom::vector<uint64_t> source;
+      // exercise
+      custom::compressed_vector cv(source);
+      // verify
+      assertUnit(cv.empty());
+      assertUnit(cv.blocks.size() == 0);
+      assertUnit(cv.begin() == cv.end());
+   }  // teardown
+
+   // 130 values: a full block and a block of 2
+   void test_construct_partialBlock()
+   {  // setup
+      custom::vector<uint64_t> source = sequence(130, 1000, 7);
+      source[129] = 1000 + 128 * 7 + 3;
+      // exercise
+      custom::compressed_vector cv(source);
+      // verify
+      //    block 0: first 1000, every step 7, no bits
+      //    block 1: first 1896, one step of 3, no bits
+      assertUnit(cv.size() == 130);
+      assertUnit(cv.blocks.size() == 2);
+      assertUnit(cv.blocks[0].first == 1000);
+      assertUnit(cv.blocks[0].minDelta == 7);
+      assertUnit(cv.blocks[0].width == 0);
+      assertUnit(cv.blocks[1].first == 1896);
+      assertUnit(cv.blocks[1].minDelta == 3);
+      assertUnit(cv[129] == 1899);
+   }  // teardown
+
+   // timestamps a steady millisecond apart need no slots at all
+   void test_construct_steadyNoBits()
+   {  // setup
+      custom::vector<uint64_t> source = sequence(1280, 1700000000000000000, 1000000);
+      // exercise
+      custom::compressed_vector cv(source);
+      // verify
+      assertUnit(cv.blocks.size() == 10);
+      assertUnit(cv.words.size() == custom::compressed_vector::padWords);
+      assertUnit(cv[1279] == 1700000000000000000 + 1279 * 1000000ull);
+   }  // teardown
+
+   // values that go down as well as up still come back
+   void test_construct_unsortedFullWidth()
+   {  // setup
+      custom::vector<uint64_t> source = randomValues(300, 64);
+      source[5] = 0;
+      source[6] = ~uint64_t(0);
+      // exercise
+      custom::compressed_vector cv(source);
+      custom::vector<uint64_t> out;
+      cv.decode(out);
+      // verify
+      assertUnit(cv.blocks[0].width == 64);
+      assertUnit(equal(out, source));
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // the subscript agrees with the source everywhere
+   void test_subscript_everyElement()
+   {  // setup
+      custom::vector<uint64_t> source = sortedGaps(1000, 5000);
+      // exercise
+      custom::compressed_vector cv(source);
+      // verify
+      bool same = true;
+      for (size_t i = 0; i < source.size(); i++)
+         same = same && (cv[i] == source[i]);
+      assertUnit(same);
+   }  // teardown
+
+   // lower_bound finds the first element no less than the value
+   void test_lowerBound_sorted()
+   {  // setup
+      custom::vector<uint64_t> source = sequence(1000, 100, 10);
+      custom::compressed_vector cv(source);
+      // exercise and verify
+      assertUnit(cv.lower_bound(0) == 0);
+      assertUnit(cv.lower_bound(100) == 0);
+      assertUnit(cv.lower_bound(101) == 1);
+      assertUnit(cv.lower_bound(1380) == 128);
+      assertUnit(cv.lower_bound(1381) == 129);
+      assertUnit(cv.lower_bound(10090) == 999);
+      assertUnit(cv.lower_bound(10091) == 1000);
+   }  // teardown
+
+   /***************************************
+    * DECODE
+    ***************************************/
+
+   // gaps of up to 5000 take 13 bits: the AVX2 unpacking can take them
+   void test_decode_everyLevel()
+   {
+      custom::vector<uint64_t> source = sortedGaps(1001, 5000);
+      custom::compressed_vector cv(source);
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<uint64_t> out;
+         // exercise
+         cv.decode(out);
+         // verify
+         assertUnit(cv.blocks[0].width == 13);
+         assertUnit(equal(out, source));
+      }  // teardown
+   }
+
+   // every width from 1 to 64, one per block
+   void test_decode_widths()
+   {
+      custom::vector<uint64_t> source;
+      std::mt19937_64 random(232);
+      uint64_t value = 0;
+      for (size_t width = 1; width <= 64; width++)
+         for (size_t k = 0; k < 128; k++)
+         {
+            // one gap of exactly 2^width - 1 fixes the block's width
+            uint64_t mask = (width == 64) ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+            value += (k == 64) ? mask : (random() & mask);
+            source.push_back(value);
+         }
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::compressed_vector cv(source);
+         custom::vector<uint64_t> out;
+         // exercise
+         cv.decode(out);
+         // verify
+         assertUnit(equal(out, source));
+      }  // teardown
+   }
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // the iterator walks every element, decoding a block at a time
+   void test_iterator_acrossBlocks()
+   {  // setup
+      custom::vector<uint64_t> source = sortedGaps(300, 100);
+      custom::compressed_vector cv(source);
+      // exercise
+      size_t i = 0;
+      bool same = true;
+      for (auto it = cv.begin(); it != cv.end(); ++it)
+         same = same && (*it == source[i++]);
+      // verify
+      assertUnit(same);
+      assertUnit(i == 300);
+   }  // teardown
+
+   /***************************************
+    * FOOTPRINT
+    ***************************************/
+
+   // 12800 sorted IDs with gaps under 16: 4 bits each, not 64
+   void test_bytes_smallGaps()
+   {  // setup
+      custom::vector<uint64_t> source = sortedGaps(12800, 16);
+      // exercise
+      custom::compressed_vector cv(source);
+      // verify
+      //    100 blocks * (8 words of slots + a 32-byte entry) + padding
+      assertUnit(cv.bytes() == 100 * (8 * 8 + 32) + 2 * 8);
+      assertUnit(cv.bytes() * 10 < source.size() * sizeof(uint64_t));
+   }  // teardown
+
+private:
+   // first, first + step, first + 2 * step, ...
+   static custom::vector<uint64_t> sequence(size_t num, uint64_t first, uint64_t step)
+   {
+      custom::vector<uint64_t> v(num);
+      for (size_t i = 0; i < num; i++)
+         v[i] = first + i * step;
+      return v;
+   }
+
+   // sorted, with random gaps below maxGap
+   static custom::vector<uint64_t> sortedGaps(size_t num, uint64_t maxGap)
+   {
+      std::mt19937_64 random(232);
+      custom::vector<uint64_t> v(num);
+      uint64_t value = random();
+      for (size_t i = 0; i < num; i++)
+         v[i] = value += random() % maxGap;
+      return v;
+   }
+
+   // random values of up to width bits
+   static custom::vector<uint64_t> randomValues(size_t num, size_t width)
+   {
+      std::mt19937_64 random(232);
+      custom::vector<uint64_t> v(num);
+      for (size_t i = 0; i < num; i++)
+         v[i] = random() >> (64 - width);
+      return v;
+   }
+
+   static bool equal(const custom::vector<uint64_t> & lhs, const custom::vector<uint64_t> & rhs)
+   {
+      if (lhs.size() != rhs.size())
+         return false;
+      for (size_t i = 0; i < lhs.size(); i++)
+         if (lhs[i] != rhs[i])
+            return false;
+      return true;
+   }
+};
+
+#endif // DEBUG
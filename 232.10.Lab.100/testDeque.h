@@ -0,0 +1,419 @@
+/***********************************************************************
+ * Header:
+ *    TEST DEQUE
+ * Summary:
+ *    Unit tests for deque
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "deque.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <algorithm>  // for std::sort
+
+class TestDeque : public UnitTest
+{
+   // elements per block: 1024 ints, 512 spies
+   static const size_t B = custom::deque<int>::blockSize();
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_sizeSpy();
+      test_constructCopy_standard();
+      test_constructMove_standard();
+
+      // Assign
+      test_assign_standard();
+      test_swap_standard();
+
+      // Insert
+      test_pushback_empty();
+      test_pushback_newBlock();
+      test_pushfront_empty();
+      test_pushfront_newBlock();
+      test_push_pointersStable();
+      test_pushback_alias();
+      test_pushfront_recentersMap();
+
+      // Access
+      test_index_bothEnds();
+      test_iterator_sort();
+
+      // Remove
+      test_popback_freesBlock();
+      test_popfront_freesBlock();
+      test_pop_emptied();
+      test_clear_spyDestroy();
+
+      report("Deque");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor: no map, no blocks
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::deque<int> d;
+      // verify
+      assertUnit(d.map == nullptr);
+      assertUnit(d.spare == nullptr);
+      assertUnit(d.numMap == 0);
+      assertUnit(d.numBlocks == 0);
+      assertUnit(d.numElements == 0);
+      assertUnit(d.empty());
+   }  // teardown
+
+   // non-default constructor: num default-constructed elements
+   void test_construct_sizeSpy()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::deque<Spy> d(3);
+      // verify
+      assertUnit(Spy::numDefault() == 3);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(d.numBlocks == 1);
+      assertUnit(d.size() == 3);
+   }  // teardown
+
+   // copy across two blocks
+   void test_constructCopy_standard()
+   {  // setup
+      custom::deque<int> dSrc;
+      for (size_t i = 0; i < B + 5; i++)
+         dSrc.push_back((int)i);
+      // exercise
+      custom::deque<int> dDest(dSrc);
+      // verify
+      assertUnit(dDest.size() == B + 5);
+      assertUnit(dDest.numBlocks == 2);
+      assertUnit(&dDest[0] != &dSrc[0]);
+      assertUnit(dDest[0] == 0);
+      assertUnit(dDest[B + 4] == (int)B + 4);
+      assertUnit(dSrc.size() == B + 5);
+   }  // teardown
+
+   // move takes the blocks: the elements stay where they were
+   void test_constructMove_standard()
+   {  // setup
+      custom::deque<Spy> dSrc{ Spy(26), Spy(49) };
+      Spy * p = &dSrc[0];
+      Spy::reset();
+      // exercise
+      custom::deque<Spy> dDest(std::move(dSrc));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(&dDest[0] == p);
+      assertUnit(dDest.size() == 2);
+      assertUnit(dSrc.empty());
+      assertUnit(dSrc.map == nullptr);
+   }  // teardown
+
+   /***************************************
+    * ASSIGN
+    ***************************************/
+
+   // assign a bigger deque over a smaller one
+   void test_assign_standard()
+   {  // setup
+      custom::deque<int> dSrc{ 26, 49, 67 };
+      custom::deque<int> dDest{ 11 };
+      // exercise
+      dDest = dSrc;
+      // verify
+      assertUnit(dDest.size() == 3);
+      assertUnit(dDest[0] == 26);
+      assertUnit(dDest[2] == 67);
+      assertUnit(dSrc.size() == 3);
+   }  // teardown
+
+   // swap trades maps
+   void test_swap_standard()
+   {  // setup
+      custom::deque<int> dLHS{ 26, 49 };
+      custom::deque<int> dRHS{ 11, 22, 33 };
+      int ** mapLHS = dLHS.map;
+      int ** mapRHS = dRHS.map;
+      // exercise
+      dLHS.swap(dRHS);
+      // verify
+      assertUnit(dLHS.map == mapRHS);
+      assertUnit(dRHS.map == mapLHS);
+      assertUnit(dLHS.size() == 3);
+      assertUnit(dRHS.size() == 2);
+      assertUnit(dLHS[0] == 11);
+      assertUnit(dRHS[0] == 26);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the first push_back makes a map and puts a block in the middle
+   void test_pushback_empty()
+   {  // setup
+      custom::deque<int> d;
+      // exercise
+      d.push_back(26);
+      // verify
+      //    map:  0   1   2   3   4   5   6   7
+      //        +---+---+---+---+---+---+---+---+
+      //        |   |   |   |   | * |   |   |   |
+      //        +---+---+---+---+---+---+---+---+
+      //                          |
+      //                        +----+----+-----+
+      //                        | 26 |    | ... |
+      //                        +----+----+-----+
+      assertUnit(d.numMap == 8);
+      assertUnit(d.iFirstBlock == 4);
+      assertUnit(d.numBlocks == 1);
+      assertUnit(d.iFront == 0);
+      assertUnit(d.size() == 1);
+      assertUnit(d.front() == 26);
+      assertUnit(d.back() == 26);
+   }  // teardown
+
+   // a full block: the next push_back starts another
+   void test_pushback_newBlock()
+   {  // setup
+      custom::deque<int> d;
+      for (size_t i = 0; i < B; i++)
+         d.push_back((int)i);
+      assertUnit(d.numBlocks == 1);
+      // exercise
+      d.push_back(99);
+      // verify
+      assertUnit(d.numBlocks == 2);
+      assertUnit(d.map[5] == &d.back());
+      assertUnit(d.back() == 99);
+      assertUnit(d.size() == B + 1);
+   }  // teardown
+
+   // the first push_front starts at the end of its block
+   void test_pushfront_empty()
+   {  // setup
+      custom::deque<int> d;
+      // exercise
+      d.push_front(26);
+      // verify
+      assertUnit(d.numBlocks == 1);
+      assertUnit(d.iFirstBlock == 3);
+      assertUnit(d.iFront == B - 1);
+      assertUnit(d.front() == 26);
+   }  // teardown
+
+   // push_front before the first cell of a block adds a block before it
+   void test_pushfront_newBlock()
+   {  // setup
+      custom::deque<int> d{ 26, 49 };
+      // exercise
+      d.push_front(11);
+      // verify
+      //          block 3                 block 4
+      //        +-----+-----+----+      +----+----+-----+
+      //        | ... |     | 11 |      | 26 | 49 | ... |
+      //        +-----+-----+----+      +----+----+-----+
+      assertUnit(d.numBlocks == 2);
+      assertUnit(d.iFirstBlock == 3);
+      assertUnit(d.iFront == B - 1);
+      assertUnit(d.size() == 3);
+      assertUnit(d[0] == 11);
+      assertUnit(d[1] == 26);
+      assertUnit(d[2] == 49);
+   }  // teardown
+
+   // elements never move, however many blocks and maps come after them
+   void test_push_pointersStable()
+   {  // setup
+      custom::deque<int> d;
+      d.push_back(26);
+      int * p = &d.front();
+      // exercise
+      for (size_t i = 0; i < 20 * B; i++)
+      {
+         d.push_back((int)i);
+         d.push_front((int)i);
+      }
+      // verify
+      assertUnit(d.numMap > 8);
+      assertUnit(&d[20 * B] == p);
+      assertUnit(*p == 26);
+   }  // teardown
+
+   // push_back of one of the deque's own elements as a block fills
+   void test_pushback_alias()
+   {  // setup
+      custom::deque<int> d;
+      for (size_t i = 0; i < B; i++)
+         d.push_back((int)i + 26);
+      // exercise
+      d.push_back(d.front());
+      // verify
+      assertUnit(d.size() == B + 1);
+      assertUnit(d.back() == 26);
+   }  // teardown
+
+   // pushing past the start of the map: grow it, or slide the blocks over
+   void test_pushfront_recentersMap()
+   {  // setup
+      custom::deque<int> d;
+      for (size_t i = 0; i < 4 * B; i++)
+         d.push_front((int)i);
+      assertUnit(d.iFirstBlock == 0);
+      assertUnit(d.numBlocks == 4);
+      int ** map = d.map;
+      int * pBack = &d.back();
+      // exercise
+      d.push_front(99);
+      // verify: a full map doubles, with the blocks in the middle
+      //    map:  0       5   6   7   8   9              15
+      //        +---+---+---+---+---+---+---+---+---+---+---+
+      //        |   |...| * | * | * | * | * |   |...|   |   |
+      //        +---+---+---+---+---+---+---+---+---+---+---+
+      assertUnit(d.map != map);
+      assertUnit(d.numMap == 16);
+      assertUnit(d.iFirstBlock == 5);
+      assertUnit(d.numBlocks == 5);
+      assertUnit(d.front() == 99);
+      assertUnit(&d.back() == pBack);
+      // a map less than half full only slides the blocks over
+      while (d.numBlocks > 1)
+         d.pop_back();
+      for (size_t i = 0; i < 6 * B; i++)
+         d.push_front((int)i);
+      assertUnit(d.numMap == 16);
+      assertUnit(d.numBlocks == 7);
+      assertUnit(d.back() == 99);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // pushed from both ends, read in order
+   void test_index_bothEnds()
+   {  // setup
+      custom::deque<int> d;
+      // exercise
+      for (int i = 0; i < (int)B; i++)
+      {
+         d.push_back(i);
+         d.push_front(-i - 1);
+      }
+      // verify
+      bool inOrder = true;
+      for (size_t i = 0; i < d.size(); i++)
+         inOrder = inOrder && (d[i] == (int)i - (int)B);
+      assertUnit(inOrder);
+      assertUnit(d.size() == 2 * B);
+      assertUnit(d.front() == -(int)B);
+      assertUnit(d.back() == (int)B - 1);
+   }  // teardown
+
+   // the iterators are random access, good enough for std::sort
+   void test_iterator_sort()
+   {  // setup
+      custom::deque<int> d;
+      for (size_t i = 0; i < 3 * B; i++)
+         d.push_front((int)((i * 7919) % (3 * B)));
+      // exercise
+      std::sort(d.begin(), d.end());
+      // verify
+      bool inOrder = true;
+      for (size_t i = 0; i < d.size(); i++)
+         inOrder = inOrder && (d[i] == (int)i);
+      assertUnit(inOrder);
+      assertUnit(d.end() - d.begin() == (long)(3 * B));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // pop_back out of a block gives it up; the first is kept as the spare
+   void test_popback_freesBlock()
+   {  // setup
+      custom::deque<int> d;
+      for (size_t i = 0; i < B + 1; i++)
+         d.push_back((int)i);
+      int * block = d.map[5];
+      // exercise
+      d.pop_back();
+      // verify
+      assertUnit(d.numBlocks == 1);
+      assertUnit(d.spare == block);
+      assertUnit(d.back() == (int)B - 1);
+      // and the next block comes from the spare
+      d.push_back(99);
+      assertUnit(d.map[5] == block);
+      assertUnit(d.spare == nullptr);
+   }  // teardown
+
+   // pop_front past the end of the first block gives it up
+   void test_popfront_freesBlock()
+   {  // setup
+      custom::deque<int> d;
+      for (size_t i = 0; i < B + 1; i++)
+         d.push_back((int)i);
+      // exercise
+      for (size_t i = 0; i < B; i++)
+         d.pop_front();
+      // verify
+      assertUnit(d.numBlocks == 1);
+      assertUnit(d.iFirstBlock == 5);
+      assertUnit(d.iFront == 0);
+      assertUnit(d.size() == 1);
+      assertUnit(d.front() == (int)B);
+   }  // teardown
+
+   // popping the last element starts over in the middle of the map
+   void test_pop_emptied()
+   {  // setup
+      custom::deque<int> d;
+      for (int i = 0; i < 5; i++)
+         d.push_front(i);
+      // exercise
+      while (!d.empty())
+         d.pop_back();
+      d.pop_back();
+      // verify
+      assertUnit(d.numBlocks == 0);
+      assertUnit(d.iFirstBlock == 4);
+      assertUnit(d.iFront == 0);
+      assertUnit(d.spare != nullptr);
+      assertUnit(d.numMap == 8);
+   }  // teardown
+
+   // clear destroys every element in every block
+   void test_clear_spyDestroy()
+   {  // setup
+      custom::deque<Spy> d;
+      for (int i = 0; i < 1000; i++)
+         d.push_back(Spy(i));
+      for (int i = 0; i < 1000; i++)
+         d.push_front(Spy(i));
+      Spy::reset();
+      // exercise
+      d.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 2000);
+      assertUnit(Spy::numDelete() == 2000);
+      assertUnit(d.empty());
+      assertUnit(d.numBlocks == 0);
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,340 @@
+/***********************************************************************
+ * Header:
+ *    TEST INCREMENTAL VECTOR
+ * Summary:
+ *    Unit tests for incremental_vector
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "incremental_vector.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <algorithm>  // for std::sort
+#include <cstdint>    // for uint64_t
+
+class TestIncrementalVector : public UnitTest
+{
+   // 256 bytes, so each push moves just 2 across
+   struct Wide
+   {
+      Wide(int value = 0) : value(value) {}
+      int  value;
+      char pad[252];
+   };
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructCopy_midMove();
+      test_constructMove_midMove();
+
+      // Insert
+      test_pushback_empty();
+      test_pushback_startsMove();
+      test_pushback_finishesMove();
+      test_pushback_alias();
+      test_pushback_spyMoves();
+      test_pushback_releasesPages();
+
+      // Access
+      test_index_midMove();
+      test_iterator_sort();
+
+      // Remove
+      test_popback_notMoved();
+      test_clear_spyDestroy();
+
+      // Move
+      test_settle_movesRest();
+      test_reserve_settles();
+
+      report("IncrementalVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor: no buffers
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::incremental_vector<int> v;
+      // verify
+      assertUnit(v.data == nullptr);
+      assertUnit(v.oldData == nullptr);
+      assertUnit(v.numCapacity == 0);
+      assertUnit(v.numElements == 0);
+      assertUnit(v.empty());
+   }  // teardown
+
+   // a copy made in the middle of a move is one settled buffer
+   void test_constructCopy_midMove()
+   {  // setup
+      custom::incremental_vector<Wide> v = filled(9);
+      assertUnit(v.migrating());
+      // exercise
+      custom::incremental_vector<Wide> copy(v);
+      // verify
+      assertUnit(!copy.migrating());
+      assertUnit(copy.numCapacity == 9);
+      assertUnit(values(copy, 9));
+      assertUnit(values(v, 9));
+   }  // teardown
+
+   // a move takes both buffers, mid-move and all
+   void test_constructMove_midMove()
+   {  // setup
+      custom::incremental_vector<Wide> v = filled(9);
+      Wide * oldData = v.oldData;
+      // exercise
+      custom::incremental_vector<Wide> moved(std::move(v));
+      // verify
+      assertUnit(v.data == nullptr);
+      assertUnit(v.oldData == nullptr);
+      assertUnit(moved.oldData == oldData);
+      assertUnit(values(moved, 9));
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the first push makes a buffer of 1, with nothing to move
+   void test_pushback_empty()
+   {  // setup
+      custom::incremental_vector<int> v;
+      // exercise
+      v.push_back(7);
+      // verify
+      assertUnit(v.numCapacity == 1);
+      assertUnit(!v.migrating());
+      assertUnit(v[0] == 7);
+   }  // teardown
+
+   // the ninth push finds 8 full: a buffer of 16, and 2 move
+   void test_pushback_startsMove()
+   {  // setup
+      custom::incremental_vector<Wide> v = filled(8);
+      // exercise
+      v.push_back(Wide(8));
+      // verify
+      //    oldData  [ . . 2 3 4 5 6 7 ]
+      //    data     [ 0 1 . . . . . . 8 . . . . . . . ]
+      assertUnit(v.numCapacity == 16);
+      assertUnit(v.oldCapacity == 8);
+      assertUnit(v.iMoved == 2);
+      assertUnit(v.numOld == 8);
+      assertUnit(v.slot(1) == v.data + 1);
+      assertUnit(v.slot(2) == v.oldData + 2);
+      assertUnit(v.slot(8) == v.data + 8);
+   }  // teardown
+
+   // 3 more pushes of 2 each move the other 6, and the old buffer goes
+   void test_pushback_finishesMove()
+   {  // setup
+      custom::incremental_vector<Wide> v = filled(9);
+      // exercise
+      v.push_back(Wide(9));
+      v.push_back(Wide(10));
+      assertUnit(v.migrating());
+      v.push_back(Wide(11));
+      // verify
+      assertUnit(!v.migrating());
+      assertUnit(v.iMoved == 0);
+      assertUnit(v.numOld == 0);
+      assertUnit(values(v, 12));
+   }  // teardown
+
+   // push a copy of an element that is about to move
+   void test_pushback_alias()
+   {  // setup
+      custom::incremental_vector<Wide> v = filled(8);
+      // exercise
+      v.push_back(v[0]);
+      // verify
+      assertUnit(v[8].value == 0);
+      assertUnit(v[0].value == 0);
+   }  // teardown
+
+   // moving across moves each Spy, never copies one
+   void test_pushback_spyMoves()
+   {  // setup
+      custom::incremental_vector<Spy> v;
+      for (int i = 0; i < 64; i++)
+         v.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      v.push_back(Spy(64));
+      v.settle();
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 65);
+      assertUnit(Spy::numDestructor() == 65);
+      assertUnit(v[0] == Spy(0));
+      assertUnit(v[64] == Spy(64));
+   }  // teardown
+
+#ifdef __linux__
+   // a mapped old buffer goes back 16 pages at a time as it empties
+   void test_pushback_releasesPages()
+   {  // setup
+      custom::incremental_vector<uint64_t> v;
+      for (uint64_t i = 0; i < 131072; i++)
+         v.push_back(i);
+      size_t chunk = 16 * custom::incremental_vector<uint64_t>::pageSize();
+      // exercise
+      for (uint64_t i = 131072; i < 131072 + 300; i++)
+         v.push_back(i);
+      // verify
+      //    300 pushes of 32 moved 9600 elements: 76800 bytes,
+      //    of which the whole chunks are given back
+      assertUnit(v.oldCapacity == 131072);
+      assertUnit(v.iMoved == 300 * 32);
+      assertUnit(v.numReleased == 9600 * 8 / chunk * chunk);
+      assertUnit(v.numReleased > 0);
+      assertUnit(v[0] == 0);
+      assertUnit(v[131071] == 131071);
+   }  // teardown
+#else
+   void test_pushback_releasesPages() {}
+#endif // __linux__
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // every element reads right, whichever buffer it is in
+   void test_index_midMove()
+   {  // setup
+      custom::incremental_vector<Wide> v = filled(64);
+      v.push_back(Wide(64));
+      // exercise
+      v[1].value = 100;
+      v[40].value = 400;
+      // verify
+      assertUnit(v.migrating());
+      assertUnit(v[1].value == 100);
+      assertUnit(v.oldData[40].value == 400);
+      bool same = true;
+      for (int i = 2; i < 65; i++)
+         same = same && (i == 40 || v[i].value == i);
+      assertUnit(same);
+      assertUnit(v.front().value == 0);
+      assertUnit(v.back().value == 64);
+   }  // teardown
+
+   // std::sort through the iterators, across both buffers
+   void test_iterator_sort()
+   {  // setup
+      custom::incremental_vector<Wide> v;
+      for (int i = 0; i < 40; i++)
+         v.push_back(Wide((i * 7) % 40));
+      assertUnit(v.migrating());
+      // exercise
+      std::sort(v.begin(), v.end(), [](const Wide & lhs, const Wide & rhs)
+      {
+         return lhs.value < rhs.value;
+      });
+      // verify
+      assertUnit(values(v, 40));
+      assertUnit(v.end() - v.begin() == 40);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // popping elements that never moved ends the move early
+   void test_popback_notMoved()
+   {  // setup
+      custom::incremental_vector<Wide> v = filled(9);
+      // exercise
+      //    oldData  [ . . 2 3 4 5 6 7 ]
+      //    data     [ 0 1 . . . . . . 8 . . . . . . . ]
+      v.pop_back();
+      assertUnit(v.numOld == 8);
+      for (int i = 0; i < 6; i++)
+         v.pop_back();
+      // verify
+      assertUnit(v.size() == 2);
+      assertUnit(!v.migrating());
+      assertUnit(values(v, 2));
+   }  // teardown
+
+   // clear destroys every Spy, moved or not
+   void test_clear_spyDestroy()
+   {  // setup
+      custom::incremental_vector<Spy> v;
+      for (int i = 0; i < 65; i++)
+         v.push_back(Spy(i));
+      assertUnit(v.migrating());
+      Spy::reset();
+      // exercise
+      v.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 65);
+      assertUnit(Spy::numDelete() == 65);
+      assertUnit(!v.migrating());
+      assertUnit(v.numCapacity == 128);
+   }  // teardown
+
+   /***************************************
+    * MOVE
+    ***************************************/
+
+   // settle moves everything left at once
+   void test_settle_movesRest()
+   {  // setup
+      custom::incremental_vector<Wide> v = filled(65);
+      assertUnit(v.iMoved == 2);
+      // exercise
+      v.settle();
+      // verify
+      assertUnit(!v.migrating());
+      assertUnit(values(v, 65));
+   }  // teardown
+
+   // reserve settles first, then moves everything into a bigger buffer
+   void test_reserve_settles()
+   {  // setup
+      custom::incremental_vector<Wide> v = filled(9);
+      // exercise
+      v.reserve(100);
+      // verify
+      assertUnit(!v.migrating());
+      assertUnit(v.numCapacity == 100);
+      assertUnit(values(v, 9));
+   }  // teardown
+
+private:
+   // Wide(0) ... Wide(num - 1), pushed one at a time
+   static custom::incremental_vector<Wide> filled(int num)
+   {
+      custom::incremental_vector<Wide> v;
+      for (int i = 0; i < num; i++)
+         v.push_back(Wide(i));
+      return v;
+   }
+
+   // does v hold 0 ... num - 1?
+   static bool values(const custom::incremental_vector<Wide> & v, int num)
+   {
+      if (v.size() != (size_t)num)
+         return false;
+      for (int i = 0; i < num; i++)
+         if (v[i].value != i)
+            return false;
+      return true;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,351 @@
+/***********************************************************************
+ * Header:
+ *    TEST MAPPED VECTOR
+ * Summary:
+ *    Unit tests for mapped_vector
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "mapped_vector.h"
+#include "unitTest.h"
+
+#ifdef MAPPED_VECTOR
+
+#include <cstdio>     // for std::remove
+#include <fstream>    // for std::ofstream
+#include <stdexcept>  // for std::runtime_error
+#include <system_error> // for std::system_error
+
+class TestMappedVector : public UnitTest
+{
+   const char * path = "testMappedVector.bin";
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_newFile();
+      test_construct_reopen();
+      test_construct_wrongType();
+      test_construct_zeroHeader();
+      test_constructMove_standard();
+      test_constructMove_sourceUsable();
+
+      // Insert
+      test_pushback_growsFile();
+      test_pushback_alias();
+      test_resize_fill();
+
+      // Remove
+      test_erase_middle();
+      test_shrink_truncates();
+
+      // File
+      test_sync_standard();
+      test_advise_standard();
+
+      report("MappedVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // a missing file becomes an empty vector
+   void test_construct_newFile()
+   {  // setup
+      std::remove(path);
+      {
+         // exercise
+         custom::mapped_vector<int> v(path);
+         // verify
+         assertUnit(v.fd >= 0);
+         assertUnit(v.header != nullptr);
+         assertUnit(v.numCapacity == 0);
+         assertUnit(v.empty());
+      }
+      assertUnit(fileSize() == 64);
+      std::remove(path);
+   }  // teardown
+
+   // an existing file comes back just as it was left
+   void test_construct_reopen()
+   {  // setup
+      std::remove(path);
+      {
+         custom::mapped_vector<double> v(path);
+         v.push_back(2.6);
+         v.push_back(4.9);
+         v.push_back(6.7);
+      }
+      // exercise
+      custom::mapped_vector<double> v(path);
+      // verify
+      //      0     1     2
+      //    +-----+-----+-----+
+      //    | 2.6 | 4.9 | 6.7 |
+      //    +-----+-----+-----+
+      assertUnit(v.numCapacity == 3);
+      assertUnit(v.size() == 3);
+      if (v.size() == 3)
+      {
+         assertUnit(v[0] == 2.6);
+         assertUnit(v[1] == 4.9);
+         assertUnit(v[2] == 6.7);
+      }
+      std::remove(path);
+   }  // teardown
+
+   // a file that is not a mapped_vector<T> is refused
+   void test_construct_wrongType()
+   {  // setup
+      std::remove(path);
+      {
+         custom::mapped_vector<char> v(path);
+         v.push_back('a');
+      }
+      // exercise
+      bool thrown = false;
+      try
+      {
+         custom::mapped_vector<double> v(path);
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      std::remove(path);
+   }  // teardown
+
+   // an existing file is never taken for a new one, even if its header is zeros
+   void test_construct_zeroHeader()
+   {  // setup
+      std::remove(path);
+      {
+         std::ofstream fout(path, std::ios::binary);
+         char zeros[64] = {};
+         fout.write(zeros, sizeof(zeros));
+      }
+      // exercise
+      bool thrown = false;
+      try
+      {
+         custom::mapped_vector<int> v(path);
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(fileSize() == 64);
+      std::remove(path);
+   }  // teardown
+
+   // move hands over the file
+   void test_constructMove_standard()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<int> vSrc(path);
+      vSrc.push_back(26);
+      int fd = vSrc.fd;
+      // exercise
+      custom::mapped_vector<int> vDest(std::move(vSrc));
+      // verify
+      assertUnit(vDest.fd == fd);
+      assertUnit(vSrc.fd == -1);
+      assertUnit(vSrc.header == nullptr);
+      assertUnit(vDest.size() == 1);
+      assertUnit(vDest[0] == 26);
+      std::remove(path);
+   }  // teardown
+
+   // what move leaves behind has no file, but asking about it is safe
+   void test_constructMove_sourceUsable()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<int> vSrc(path);
+      vSrc.push_back(26);
+      custom::mapped_vector<int> vDest(std::move(vSrc));
+      // exercise
+      vSrc.clear();
+      vSrc.pop_back();
+      vSrc.resize(0);
+      bool thrown = false;
+      try
+      {
+         vSrc.push_back(49);
+      }
+      catch (const std::system_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(vSrc.size() == 0);
+      assertUnit(vSrc.empty());
+      assertUnit(vSrc.capacity() == 0);
+      assertUnit(vSrc.begin() == vSrc.end());
+      assertUnit(thrown);
+      assertUnit(vDest.size() == 1);
+      std::remove(path);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push_back past capacity doubles the file
+   void test_pushback_growsFile()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<int> v(path);
+      // exercise
+      for (int i = 0; i < 5; i++)
+         v.push_back(i * 10);
+      // verify
+      //      0    1    2    3    4    5    6    7
+      //    +----+----+----+----+----+----+----+----+
+      //    | 0  | 10 | 20 | 30 | 40 |    |    |    |
+      //    +----+----+----+----+----+----+----+----+
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.size() == 5);
+      assertUnit(fileSize() == 64 + 8 * sizeof(int));
+      assertUnit(v[4] == 40);
+      std::remove(path);
+   }  // teardown
+
+   // push_back of an element of the full vector itself
+   void test_pushback_alias()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<int> v(path);
+      v.push_back(26);
+      v.push_back(49);
+      // exercise
+      v.push_back(v[0]);
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(v[2] == 26);
+      std::remove(path);
+   }  // teardown
+
+   // resize fills the new elements
+   void test_resize_fill()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<int> v(path);
+      v.push_back(26);
+      // exercise
+      v.resize(4, 99);
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 99 | 99 | 99 |
+      //    +----+----+----+----+
+      assertUnit(v.size() == 4);
+      assertUnit(v[0] == 26);
+      assertUnit(v[3] == 99);
+      std::remove(path);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase closes the gap
+   void test_erase_middle()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<int> v(path);
+      for (int i : { 26, 49, 67, 89 })
+         v.push_back(i);
+      // exercise
+      auto it = v.erase(v.begin() + 1, v.begin() + 3);
+      // verify
+      assertUnit(*it == 89);
+      assertUnit(v.size() == 2);
+      assertUnit(v[0] == 26 && v[1] == 89);
+      std::remove(path);
+   }  // teardown
+
+   // shrink_to_fit gives the spare capacity back to the file system
+   void test_shrink_truncates()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<int> v(path);
+      v.reserve(100);
+      v.push_back(26);
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.numCapacity == 1);
+      assertUnit(fileSize() == 64 + sizeof(int));
+      assertUnit(v[0] == 26);
+      std::remove(path);
+   }  // teardown
+
+   /***************************************
+    * FILE
+    ***************************************/
+
+   // sync writes everything and keeps the mapping usable
+   void test_sync_standard()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<int> v(path);
+      v.push_back(26);
+      // exercise
+      v.sync();
+      // verify
+      std::ifstream fin(path, std::ios::binary);
+      fin.seekg(64);
+      int value = 0;
+      fin.read(reinterpret_cast<char *>(&value), sizeof(value));
+      assertUnit(value == 26);
+      v.push_back(49);
+      assertUnit(v.size() == 2);
+      std::remove(path);
+   }  // teardown
+
+   // every hint is accepted
+   void test_advise_standard()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<int> v(path);
+      v.resize(1000);
+      // exercise
+      bool thrown = false;
+      try
+      {
+         v.advise(custom::mapped_vector<int>::SEQUENTIAL);
+         v.advise(custom::mapped_vector<int>::RANDOM);
+         v.advise(custom::mapped_vector<int>::WILLNEED);
+         v.advise(custom::mapped_vector<int>::NORMAL);
+      }
+      catch (...)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(!thrown);
+      std::remove(path);
+   }  // teardown
+
+private:
+   // the size of the file on disk
+   long fileSize()
+   {
+      std::ifstream fin(path, std::ios::binary | std::ios::ate);
+      return (long)fin.tellg();
+   }
+};
+
+#endif // MAPPED_VECTOR
+#endif // DEBUG
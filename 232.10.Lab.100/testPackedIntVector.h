@@ -0,0 +1,267 @@
+/***********************************************************************
+ * Header:
+ *    TEST PACKED INT VECTOR
+ * Summary:
+ *    Unit tests for packed_int_vector. The decode tests run at every
+ *    simd level this processor supports, so the AVX2 unpacking is
+ *    held to the answers of get().
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "packed_int_vector.h"
+#include "unitTest.h"
+
+#include <cstdint>
+#include <random>
+
+class TestPackedIntVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_fill();
+
+      // Update
+      test_set_spansWords();
+      test_set_overwrites();
+      test_set_fullWidth();
+
+      // Insert and remove
+      test_pushback_grows();
+      test_popback_clearsBits();
+      test_resize_shrinkThenGrow();
+
+      // Decode
+      test_decode_all();
+      test_decode_offset();
+      test_decode_oddWidths();
+
+      // Footprint
+      test_bytes_thirdOf64();
+
+      custom::simd::setLevel(custom::simd::AVX2);
+      report("PackedIntVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // 10 20-bit values take 200 bits: 4 words
+   void test_construct_fill()
+   {  // setup
+      // exercise
+      custom::packed_int_vector<20> v(10, 0xabcde);
+      // verify
+      assertUnit(v.numElements == 10);
+      assertUnit(v.words.size() == 4);
+      assertUnit(v[0] == 0xabcde);
+      assertUnit(v[3] == 0xabcde);
+      assertUnit(v[9] == 0xabcde);
+      assertUnit(v.words[3] >> 8 == 0);
+   }  // teardown
+
+   /***************************************
+    * UPDATE
+    ***************************************/
+
+   // element 3 starts at bit 60: 4 bits in word 0, 16 in word 1
+   void test_set_spansWords()
+   {  // setup
+      custom::packed_int_vector<20> v(5);
+      v.set(2, 0x12345);
+      v.set(4, 0x6789a);
+      // exercise
+      v.set(3, 0xfffff);
+      // verify
+      //    word 0                       word 1
+      //    | [0] | [1] | [2] |[3]..     ..3]| [4] |
+      assertUnit(v.words[0] >> 60 == 0xf);
+      assertUnit((v.words[1] & 0xffff) == 0xffff);
+      assertUnit(v[2] == 0x12345);
+      assertUnit(v[3] == 0xfffff);
+      assertUnit(v[4] == 0x6789a);
+   }  // teardown
+
+   // a smaller value clears the bits of the larger one
+   void test_set_overwrites()
+   {  // setup
+      custom::packed_int_vector<20> v(5);
+      v.set(3, 0xfffff);
+      // exercise
+      v.set(3, 1);
+      // verify
+      assertUnit(v[3] == 1);
+      assertUnit(v.words[0] >> 60 == 1);
+      assertUnit(v.words[1] == 0);
+   }  // teardown
+
+   // 32-bit elements, two to a word
+   void test_set_fullWidth()
+   {  // setup
+      custom::packed_int_vector<32> v(3);
+      // exercise
+      v.set(1, 0xffffffff);
+      // verify
+      assertUnit(v.words[0] == 0xffffffff00000000);
+      assertUnit(v[0] == 0);
+      assertUnit(v[1] == 0xffffffff);
+   }  // teardown
+
+   /***************************************
+    * INSERT AND REMOVE
+    ***************************************/
+
+   // words are added as the bits run past the last one
+   void test_pushback_grows()
+   {  // setup
+      custom::packed_int_vector<7> v;
+      // exercise
+      for (uint32_t i = 0; i < 100; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(v.size() == 100);
+      assertUnit(v.words.size() == 11);
+      bool inOrder = true;
+      for (uint32_t i = 0; i < 100; i++)
+         inOrder = inOrder && (v[i] == i);
+      assertUnit(inOrder);
+   }  // teardown
+
+   // pop_back leaves nothing behind past the end
+   void test_popback_clearsBits()
+   {  // setup
+      custom::packed_int_vector<20> v(4, 0xfffff);
+      // exercise
+      v.pop_back();
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(v.words.size() == 1);
+      assertUnit(v.words[0] >> 60 == 0);
+   }  // teardown
+
+   // shrink, then grow: the new elements are 0
+   void test_resize_shrinkThenGrow()
+   {  // setup
+      custom::packed_int_vector<20> v(10, 0xabcde);
+      // exercise
+      v.resize(3);
+      v.resize(10);
+      // verify
+      assertUnit(v[2] == 0xabcde);
+      assertUnit(v[3] == 0);
+      assertUnit(v[9] == 0);
+   }  // teardown
+
+   /***************************************
+    * DECODE
+    ***************************************/
+
+   // decode all of 1003 random 20-bit values
+   void test_decode_all()
+   {
+      custom::packed_int_vector<20> v = randomValues<20>(1003);
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<uint32_t> out;
+         // exercise
+         v.decode(out);
+         // verify
+         assertUnit(out.size() == 1003);
+         assertUnit(matches(v, 0, out));
+      }  // teardown
+   }
+
+   // decode from an element that does not start on a byte
+   void test_decode_offset()
+   {
+      custom::packed_int_vector<20> v = randomValues<20>(200);
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<uint32_t> out(150);
+         // exercise
+         v.decode(5, 150, &out[0]);
+         // verify
+         assertUnit(matches(v, 5, out));
+      }  // teardown
+   }
+
+   // widths that straddle bytes differently, and ones too wide for AVX2
+   void test_decode_oddWidths()
+   {
+      custom::packed_int_vector<1>  v1  = randomValues<1>(517);
+      custom::packed_int_vector<7>  v7  = randomValues<7>(517);
+      custom::packed_int_vector<25> v25 = randomValues<25>(517);
+      custom::packed_int_vector<31> v31 = randomValues<31>(517);
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<uint32_t> out1, out7, out25, out31;
+         // exercise
+         v1.decode(out1);
+         v7.decode(out7);
+         v25.decode(out25);
+         v31.decode(out31);
+         // verify
+         assertUnit(matches(v1,  0, out1));
+         assertUnit(matches(v7,  0, out7));
+         assertUnit(matches(v25, 0, out25));
+         assertUnit(matches(v31, 0, out31));
+      }  // teardown
+   }
+
+   /***************************************
+    * FOOTPRINT
+    ***************************************/
+
+   // 100K 20-bit IDs: 250KB packed against 800KB in 64-bit slots
+   // and 400KB in 32-bit ones
+   void test_bytes_thirdOf64()
+   {  // setup
+      custom::vector<uint64_t> slots;
+      custom::vector<uint32_t> narrowSlots;
+      custom::packed_int_vector<20> v;
+      // exercise
+      slots.reserve(100000);
+      narrowSlots.reserve(100000);
+      v.reserve(100000);
+      // verify
+      assertUnit(v.bytes() == 250000);
+      assertUnit(slots.capacity() * sizeof(uint64_t) == 800000);
+      assertUnit(v.bytes() * 3 < slots.capacity() * sizeof(uint64_t));
+      assertUnit(v.bytes() * 8 == narrowSlots.capacity() * sizeof(uint32_t) * 5);
+   }  // teardown
+
+private:
+   // num random values that fit in Bits bits
+   template <unsigned Bits>
+   static custom::packed_int_vector<Bits> randomValues(size_t num)
+   {
+      std::mt19937 random(232);
+      custom::packed_int_vector<Bits> v;
+      for (size_t i = 0; i < num; i++)
+         v.push_back((uint32_t)random() & custom::packed_int_vector<Bits>::maxValue);
+      return v;
+   }
+
+   // does out hold v's elements from first on?
+   template <unsigned Bits>
+   static bool matches(const custom::packed_int_vector<Bits> & v, size_t first,
+                       const custom::vector<uint32_t> & out)
+   {
+      for (size_t i = 0; i < out.size(); i++)
+         if (out[i] != v[first + i])
+            return false;
+      return true;
+   }
+};
+
+#endif // DEBUG
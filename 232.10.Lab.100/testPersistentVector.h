@@ -0,0 +1,369 @@
+/***********************************************************************
+ * Header:
+ *    TEST PERSISTENT VECTOR
+ * Summary:
+ *    Unit tests for persistent_vector and transient_vector
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "persistent_vector.h"
+#include "spy.h"
+#include "unitTest.h"
+
+class TestPersistentVector : public UnitTest
+{
+   typedef custom::persistent_vector<int> PV;
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructCopy_shares();
+
+      // Insert
+      test_pushback_tail();
+      test_pushback_tailIntoTrie();
+      test_pushback_newLevel();
+      test_pushback_copyUnchanged();
+
+      // Update
+      test_set_pathCopy();
+      test_set_tail();
+
+      // Remove
+      test_popback_tail();
+      test_popback_trieIntoTail();
+      test_popback_dropLevel();
+
+      // Iterate
+      test_iterator_all();
+
+      // Transient
+      test_transient_editsInPlace();
+      test_transient_sourceUnchanged();
+      test_transient_persistentSeals();
+      test_transient_spyNoLeaks();
+
+      report("PersistentVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor: no trie, no tail
+   void test_construct_default()
+   {  // setup
+      // exercise
+      PV v;
+      // verify
+      assertUnit(v.root == nullptr);
+      assertUnit(v.tail == nullptr);
+      assertUnit(v.shift == 5);
+      assertUnit(v.numElements == 0);
+      assertUnit(v.empty());
+   }  // teardown
+
+   // a copy is two more owners, not more elements
+   void test_constructCopy_shares()
+   {  // setup
+      PV vSrc = sequence(100);
+      // exercise
+      PV vDest(vSrc);
+      // verify
+      assertUnit(vDest.root == vSrc.root);
+      assertUnit(vDest.tail == vSrc.tail);
+      assertUnit(vSrc.root->refs == 2);
+      assertUnit(vSrc.tail->refs == 2);
+      assertUnit(vDest.size() == 100);
+      assertUnit(vDest[99] == 99);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the first 32 elements all go in the tail
+   void test_pushback_tail()
+   {  // setup
+      PV v;
+      // exercise
+      for (int i = 0; i < 32; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(v.root == nullptr);
+      assertUnit(v.tail->num == 32);
+      assertUnit(v.size() == 32);
+      assertUnit(v[31] == 31);
+   }  // teardown
+
+   // the 33rd hangs the full tail in the trie and starts a new one
+   void test_pushback_tailIntoTrie()
+   {  // setup
+      PV v = sequence(32);
+      const void * full = v.tail;
+      // exercise
+      v.push_back(32);
+      // verify
+      //    root:  +---+---+-----+
+      //           | * |   | ... |
+      //           +---+---+-----+
+      //             |
+      //           [0..31]        tail: [32]
+      assertUnit(v.root != nullptr);
+      assertUnit(v.shift == 5);
+      assertUnit(branch(v.root)->child[0] == full);
+      assertUnit(branch(v.root)->child[1] == nullptr);
+      assertUnit(v.tail->num == 1);
+      assertUnit(v[0] == 0);
+      assertUnit(v[32] == 32);
+   }  // teardown
+
+   // past 32 leaves the trie grows a level
+   void test_pushback_newLevel()
+   {  // setup
+      // exercise
+      PV v = sequence(32 * 32 + 33);
+      // verify
+      assertUnit(v.shift == 10);
+      assertUnit(branch(v.root)->child[1] != nullptr);
+      assertUnit(branch(v.root)->child[2] == nullptr);
+      assertUnit(v.size() == 1057);
+      bool inOrder = true;
+      for (size_t i = 0; i < v.size(); i++)
+         inOrder = inOrder && (v[i] == (int)i);
+      assertUnit(inOrder);
+   }  // teardown
+
+   // pushing onto a copy leaves the original alone
+   void test_pushback_copyUnchanged()
+   {  // setup
+      PV vSrc = sequence(40);
+      PV vDest(vSrc);
+      // exercise
+      vDest.push_back(99);
+      // verify
+      assertUnit(vSrc.size() == 40);
+      assertUnit(vDest.size() == 41);
+      assertUnit(vDest.tail != vSrc.tail);
+      assertUnit(vDest.root == vSrc.root);
+      assertUnit(vSrc.tail->num == 8);
+      assertUnit(vDest[40] == 99);
+   }  // teardown
+
+   /***************************************
+    * UPDATE
+    ***************************************/
+
+   // set copies the path to one leaf; the other leaves are still shared
+   void test_set_pathCopy()
+   {  // setup
+      PV vSrc = sequence(100);
+      PV vDest(vSrc);
+      // exercise
+      vDest.set(5, 99);
+      // verify
+      //    vSrc.root   vDest.root
+      //       |   \     /   |
+      //    [0..31] [32..63] [0..31]'   and [64..95] shared too
+      assertUnit(vSrc[5] == 5);
+      assertUnit(vDest[5] == 99);
+      assertUnit(vDest.root != vSrc.root);
+      assertUnit(branch(vDest.root)->child[0] != branch(vSrc.root)->child[0]);
+      assertUnit(branch(vDest.root)->child[1] == branch(vSrc.root)->child[1]);
+      assertUnit(branch(vDest.root)->child[2] == branch(vSrc.root)->child[2]);
+      assertUnit(vDest.tail == vSrc.tail);
+   }  // teardown
+
+   // set in the tail copies only the tail
+   void test_set_tail()
+   {  // setup
+      PV vSrc = sequence(40);
+      PV vDest(vSrc);
+      // exercise
+      vDest.set(35, 99);
+      // verify
+      assertUnit(vSrc[35] == 35);
+      assertUnit(vDest[35] == 99);
+      assertUnit(vDest.root == vSrc.root);
+      assertUnit(vDest.tail != vSrc.tail);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // pop_back from a tail with more than one element
+   void test_popback_tail()
+   {  // setup
+      PV vSrc = sequence(40);
+      PV vDest(vSrc);
+      // exercise
+      vDest.pop_back();
+      // verify
+      assertUnit(vDest.size() == 39);
+      assertUnit(vDest.back() == 38);
+      assertUnit(vSrc.size() == 40);
+      assertUnit(vSrc.back() == 39);
+   }  // teardown
+
+   // popping the last element of the tail brings the last leaf back out
+   void test_popback_trieIntoTail()
+   {  // setup
+      PV v = sequence(33);
+      const void * leaf = branch(v.root)->child[0];
+      // exercise
+      v.pop_back();
+      // verify
+      assertUnit(v.root == nullptr);
+      assertUnit(v.tail == leaf);
+      assertUnit(v.tail->refs == 1);
+      assertUnit(v.size() == 32);
+      assertUnit(v.back() == 31);
+   }  // teardown
+
+   // a root left with one child gives way to it
+   void test_popback_dropLevel()
+   {  // setup
+      PV v = sequence(32 * 32 + 33);
+      assertUnit(v.shift == 10);
+      const void * left = branch(v.root)->child[0];
+      // exercise
+      v.pop_back();
+      // verify
+      assertUnit(v.shift == 5);
+      assertUnit(v.root == left);
+      assertUnit(v.size() == 1056);
+      bool inOrder = true;
+      for (size_t i = 0; i < v.size(); i++)
+         inOrder = inOrder && (v[i] == (int)i);
+      assertUnit(inOrder);
+   }  // teardown
+
+   /***************************************
+    * ITERATE
+    ***************************************/
+
+   // the iterator visits every element in order, across leaves and tail
+   void test_iterator_all()
+   {  // setup
+      PV v = sequence(1057);
+      // exercise
+      int expected = 0;
+      bool inOrder = true;
+      for (int value : v)
+         inOrder = inOrder && (value == expected++);
+      // verify
+      assertUnit(inOrder);
+      assertUnit(expected == 1057);
+   }  // teardown
+
+   /***************************************
+    * TRANSIENT
+    ***************************************/
+
+   // a transient changes the nodes it made without copying them
+   void test_transient_editsInPlace()
+   {  // setup
+      PV v;
+      custom::transient_vector<int> t = v.transient();
+      for (int i = 0; i < 100; i++)
+         t.push_back(i);
+      const void * root = t.v.root;
+      const void * tail = t.v.tail;
+      // exercise
+      t.push_back(100);
+      t.set(5, 99);
+      // verify
+      assertUnit(t.v.root == root);
+      assertUnit(t.v.tail == tail);
+      assertUnit(t.v.tail->owner == t.owner);
+      assertUnit(t[5] == 99);
+      assertUnit(t.size() == 101);
+   }  // teardown
+
+   // the vector a transient came from keeps its elements
+   void test_transient_sourceUnchanged()
+   {  // setup
+      PV v = sequence(40);
+      custom::transient_vector<int> t = v.transient();
+      // exercise
+      t.set(3, 99);
+      t.set(35, 99);
+      t.pop_back();
+      // verify
+      assertUnit(v.size() == 40);
+      assertUnit(v[3] == 3);
+      assertUnit(v[35] == 35);
+      assertUnit(t.size() == 39);
+      assertUnit(t[3] == 99);
+      assertUnit(t[35] == 99);
+   }  // teardown
+
+   // once persistent, a later transient has to copy
+   void test_transient_persistentSeals()
+   {  // setup
+      custom::transient_vector<int> tFirst = PV().transient();
+      for (int i = 0; i < 40; i++)
+         tFirst.push_back(i);
+      PV v = tFirst.persistent();
+      // exercise
+      custom::transient_vector<int> tSecond = v.transient();
+      tSecond.set(0, 99);
+      tSecond.set(39, 99);
+      // verify
+      assertUnit(tFirst.empty());
+      assertUnit(v[0] == 0);
+      assertUnit(v[39] == 39);
+      assertUnit(tSecond[0] == 99);
+      assertUnit(tSecond.v.root != v.root);
+   }  // teardown
+
+   // every element of every snapshot is destroyed exactly once
+   void test_transient_spyNoLeaks()
+   {  // setup
+      Spy::reset();
+      {
+         custom::persistent_vector<Spy> v;
+         custom::transient_vector<Spy> t = v.transient();
+         for (int i = 0; i < 2000; i++)
+            t.push_back(Spy(i));
+         v = t.persistent();
+         // exercise
+         custom::persistent_vector<Spy> snapshots[4] = { v, v, v, v };
+         snapshots[1].set(1500, Spy(99));
+         snapshots[2].push_back(Spy(99));
+         for (int i = 0; i < 1000; i++)
+            snapshots[3].pop_back();
+         v.set(0, Spy(99));
+         assertUnit(snapshots[0][1500].get() == 1500);
+         assertUnit(snapshots[1][1500].get() == 99);
+         assertUnit(snapshots[3].size() == 1000);
+      }
+      // verify
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+
+private:
+   // 0, 1, 2, ... : num elements, pushed one at a time
+   PV sequence(int num)
+   {
+      PV v;
+      for (int i = 0; i < num; i++)
+         v.push_back(i);
+      return v;
+   }
+
+   static PV::Branch * branch(PV::Node * node)
+   {
+      return static_cast<PV::Branch *>(node);
+   }
+};
+
+#endif // DEBUG
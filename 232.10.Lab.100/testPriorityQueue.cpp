@@ -18,6 +18,18 @@
 #include "testPriorityQueue.h"  // for the priority queue unit tests
 #include "testSpy.h"            // for the spy unit tests
 #include "testVector.h"         // for the vector unit tests
+#include "testSmallVector.h"    // for the small vector unit tests
+#include "testMappedVector.h"   // for the mapped vector unit tests
+#include "testSimd.h"           // for the simd algorithm unit tests
+#include "testSoaVector.h"      // for the struct-of-arrays unit tests
+#include "testDeque.h"          // for the deque unit tests
+#include "testCircularBuffer.h" // for the circular buffer unit tests
+#include "testPersistentVector.h" // for the persistent vector unit tests
+#include "testSort.h"           // for the sort unit tests
+#include "testBitvector.h"      // for the bitvector unit tests
+#include "testPackedIntVector.h" // for the packed int vector unit tests
+#include "testCompressedVector.h" // for the compressed vector unit tests
+#include "testIncrementalVector.h" // for the incremental vector unit tests
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -30,6 +42,20 @@ int main()
    // unit tests
    TestSpy().run();
    TestVector().run();
+   TestSmallVector().run();
+#ifdef MAPPED_VECTOR
+   TestMappedVector().run();
+#endif
+   TestSimd().run();
+   TestSoaVector().run();
+   TestDeque().run();
+   TestCircularBuffer().run();
+   TestPersistentVector().run();
+   TestSort().run();
+   TestBitvector().run();
+   TestPackedIntVector().run();
+   TestCompressedVector().run();
+   TestIncrementalVector().run();
    TestPQueue().run();
 #endif // DEBUG
    
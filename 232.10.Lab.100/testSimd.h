@@ -0,0 +1,276 @@
+/***********************************************************************
+ * Header:
+ *    TEST SIMD
+ * Summary:
+ *    Unit tests for the simd algorithms. Each test runs at every
+ *    level this processor supports, so the SSE2 and AVX2 kernels
+ *    are held to the answers of the scalar loop.
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "simd.h"
+#include "unitTest.h"
+
+#include <cstdint>
+
+class TestSimd : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Search
+      test_find_empty();
+      test_find_eachPosition();
+      test_find_missing();
+      test_find_float();
+      test_count_standard();
+      test_minElement_firstOfTies();
+      test_maxElement_float();
+      test_maxElement_short();
+
+      // Reduce
+      test_sum_int();
+      test_sum_float();
+
+      // Remove
+      test_erase_value();
+      test_erase_float();
+      test_eraseIf_odd();
+
+      custom::simd::setLevel(custom::simd::AVX2);
+      report("Simd");
+   }
+
+   /***************************************
+    * SEARCH
+    ***************************************/
+
+   // nothing to find in an empty vector
+   void test_find_empty()
+   {
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<int32_t> v;
+         // exercise
+         auto it = custom::simd::find(v, 26);
+         // verify
+         assertUnit(it == v.end());
+      }  // teardown
+   }
+
+   // find each element of a 37-element vector: in the body and the tail
+   void test_find_eachPosition()
+   {
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<int32_t> v = sequence(37);
+         // exercise and verify
+         for (int32_t i = 0; i < 37; i++)
+            assertUnit(custom::simd::find(v, i * 3) - v.begin() == i);
+      }  // teardown
+   }
+
+   // a value that is not there gives end()
+   void test_find_missing()
+   {
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<int32_t> v = sequence(37);
+         // exercise
+         auto it = custom::simd::find(v, 4);
+         // verify
+         assertUnit(it == v.end());
+      }  // teardown
+   }
+
+   // find the first of two equal floats
+   void test_find_float()
+   {
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<float> v(21, 1.5f);
+         v[13] = 2.5f;
+         v[17] = 2.5f;
+         // exercise
+         auto it = custom::simd::find(v, 2.5f);
+         // verify
+         assertUnit(it - v.begin() == 13);
+      }  // teardown
+   }
+
+   // count every 3rd element of 50
+   void test_count_standard()
+   {
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<int32_t> v(50, 7);
+         for (size_t i = 0; i < 50; i += 3)
+            v[i] = 26;
+         // exercise
+         size_t num = custom::simd::count(v, 26);
+         // verify
+         assertUnit(num == 17);
+      }  // teardown
+   }
+
+   // the smallest value appears twice: the first one is found
+   void test_minElement_firstOfTies()
+   {
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<int32_t> v = sequence(41);
+         v[22] = -5;
+         v[38] = -5;
+         // exercise
+         auto it = custom::simd::min_element(v);
+         // verify
+         assertUnit(it - v.begin() == 22);
+         assertUnit(*it == -5);
+      }  // teardown
+   }
+
+   // the largest float sits in the tail
+   void test_maxElement_float()
+   {
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<float> v(19, -1.0f);
+         v[18] = 99.5f;
+         // exercise
+         auto it = custom::simd::max_element(v);
+         // verify
+         assertUnit(it - v.begin() == 18);
+      }  // teardown
+   }
+
+   // fewer elements than one register
+   void test_maxElement_short()
+   {
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<int32_t> v{ 26, 67, 49 };
+         // exercise
+         auto it = custom::simd::max_element(v);
+         // verify
+         assertUnit(it - v.begin() == 1);
+      }  // teardown
+   }
+
+   /***************************************
+    * REDUCE
+    ***************************************/
+
+   // 0 + 3 + ... + 3*36
+   void test_sum_int()
+   {
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<int32_t> v = sequence(37);
+         // exercise
+         int32_t total = custom::simd::sum(v);
+         // verify
+         assertUnit(total == 3 * 36 * 37 / 2);
+      }  // teardown
+   }
+
+   // a sum of floats that is exact whatever the order
+   void test_sum_float()
+   {
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<float> v(29, 0.5f);
+         // exercise
+         float total = custom::simd::sum(v);
+         // verify
+         assertUnit(total == 14.5f);
+      }  // teardown
+   }
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase every 26, keeping the rest in order
+   void test_erase_value()
+   {
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<int32_t> v = sequence(37);
+         for (size_t i = 0; i < 37; i += 2)
+            v[i] = 26;
+         // exercise
+         size_t num = custom::simd::erase(v, 26);
+         // verify
+         assertUnit(num == 19);
+         assertUnit(v.size() == 18);
+         bool inOrder = true;
+         for (size_t i = 0; i < v.size(); i++)
+            inOrder = inOrder && (v[i] == (int32_t)(2 * i + 1) * 3);
+         assertUnit(inOrder);
+      }  // teardown
+   }
+
+   // erase floats down to nothing
+   void test_erase_float()
+   {
+      for (int level = 0; level <= custom::simd::supported(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<float> v(23, 2.5f);
+         // exercise
+         size_t num = custom::simd::erase(v, 2.5f);
+         // verify
+         assertUnit(num == 23);
+         assertUnit(v.empty());
+      }  // teardown
+   }
+
+   // erase every odd element
+   void test_eraseIf_odd()
+   {  // setup
+      custom::vector<int32_t> v = sequence(10);
+      // exercise
+      size_t num = custom::simd::erase_if(v, [](int32_t i) { return i % 2 != 0; });
+      // verify
+      //      0    1    2    3    4
+      //    +----+----+----+----+----+
+      //    | 0  | 6  | 12 | 18 | 24 |
+      //    +----+----+----+----+----+
+      assertUnit(num == 5);
+      assertUnit(v.size() == 5);
+      if (v.size() == 5)
+      {
+         assertUnit(v[0] == 0);
+         assertUnit(v[1] == 6);
+         assertUnit(v[4] == 24);
+      }
+   }  // teardown
+
+private:
+   // 0, 3, 6, ... : num elements, all distinct
+   custom::vector<int32_t> sequence(int32_t num)
+   {
+      custom::vector<int32_t> v;
+      for (int32_t i = 0; i < num; i++)
+         v.push_back(i * 3);
+      return v;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,439 @@
+/***********************************************************************
+ * Header:
+ *    TEST SMALL VECTOR
+ * Summary:
+ *    Unit tests for small_vector
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "vector.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <list>
+#include <stdexcept>  // for std::runtime_error
+
+class TestSmallVector : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_sizeInline();
+      test_construct_sizeHeap();
+      test_constructCopy_inline();
+      test_constructMove_inline();
+      test_constructMove_heap();
+
+      // Assign
+      test_assignMove_heapToInline();
+      test_swap_inlineInline();
+      test_swap_inlineHeap();
+      test_swap_heapHeap();
+
+      // Insert
+      test_pushback_staysInline();
+      test_pushback_spills();
+      test_reserve_throwUndone();
+      test_emplace_middle();
+      test_insert_listRange();
+
+      // Remove
+      test_erase_middle();
+      test_shrink_backInline();
+      test_clear_spyDestroy();
+
+      report("SmallVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor: no heap, capacity is N
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::small_vector<int, 4> v;
+      // verify
+      assertUnit(v.isInline());
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 0);
+      assertUnit(v.empty());
+   }  // teardown
+
+   // non-default constructor that fits inline
+   void test_construct_sizeInline()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> v(3);
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    |    |    |    |    |   inline
+      //    +----+----+----+----+
+      assertUnit(Spy::numDefault() == 3);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(v.isInline());
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 3);
+   }  // teardown
+
+   // non-default constructor that is too big to fit inline
+   void test_construct_sizeHeap()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> v(6, Spy(7));
+      // verify
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+
+      //    | 7  | 7  | 7  | 7  | 7  | 7  |   heap
+      //    +----+----+----+----+----+----+
+      assertUnit(Spy::numCopy() == 6);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(!v.isInline());
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 6);
+      if (v.numElements == 6)
+      {
+         assertUnit(v.data[0].get() == 7);
+         assertUnit(v.data[5].get() == 7);
+      }
+   }  // teardown
+
+   // copy an inline vector: a new inline vector
+   void test_constructCopy_inline()
+   {  // setup
+      custom::small_vector<Spy, 4> vSrc{ Spy(26), Spy(49) };
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> vDest(vSrc);
+      // verify
+      assertUnit(Spy::numCopy() == 2);
+      assertUnit(vDest.isInline());
+      assertUnit(vDest.data != vSrc.data);
+      assertUnit(vDest.numElements == 2);
+      assertUnit(vSrc.numElements == 2);
+      if (vDest.numElements == 2)
+      {
+         assertUnit(vDest.data[0].get() == 26);
+         assertUnit(vDest.data[1].get() == 49);
+      }
+   }  // teardown
+
+   // move an inline vector: each element moves, none is copied
+   void test_constructMove_inline()
+   {  // setup
+      custom::small_vector<Spy, 4> vSrc{ Spy(26), Spy(49), Spy(67) };
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> vDest(std::move(vSrc));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 3);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(vDest.isInline());
+      assertUnit(vDest.numElements == 3);
+      assertUnit(vSrc.isInline());
+      assertUnit(vSrc.numElements == 0);
+      if (vDest.numElements == 3)
+      {
+         assertUnit(vDest.data[0].get() == 26);
+         assertUnit(vDest.data[2].get() == 67);
+      }
+   }  // teardown
+
+   // move a heap vector: the buffer is stolen, no element is touched
+   void test_constructMove_heap()
+   {  // setup
+      custom::small_vector<Spy, 2> vSrc{ Spy(26), Spy(49), Spy(67) };
+      Spy * pData = vSrc.data;
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 2> vDest(std::move(vSrc));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(vDest.data == pData);
+      assertUnit(vDest.numElements == 3);
+      assertUnit(vSrc.isInline());
+      assertUnit(vSrc.numCapacity == 2);
+      assertUnit(vSrc.numElements == 0);
+   }  // teardown
+
+   /***************************************
+    * ASSIGN
+    ***************************************/
+
+   // move a heap vector onto an inline one
+   void test_assignMove_heapToInline()
+   {  // setup
+      custom::small_vector<Spy, 2> vSrc{ Spy(26), Spy(49), Spy(67) };
+      custom::small_vector<Spy, 2> vDest{ Spy(11) };
+      Spy * pData = vSrc.data;
+      Spy::reset();
+      // exercise
+      vDest = std::move(vSrc);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 1);
+      assertUnit(vDest.data == pData);
+      assertUnit(vDest.numElements == 3);
+      assertUnit(vSrc.isInline());
+      assertUnit(vSrc.numElements == 0);
+   }  // teardown
+
+   // swap two inline vectors
+   void test_swap_inlineInline()
+   {  // setup
+      custom::small_vector<Spy, 4> vLHS{ Spy(26), Spy(49) };
+      custom::small_vector<Spy, 4> vRHS{ Spy(11), Spy(22), Spy(33) };
+      Spy::reset();
+      // exercise
+      vLHS.swap(vRHS);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(vLHS.isInline());
+      assertUnit(vRHS.isInline());
+      assertUnit(vLHS.numElements == 3);
+      assertUnit(vRHS.numElements == 2);
+      if (vLHS.numElements == 3 && vRHS.numElements == 2)
+      {
+         assertUnit(vLHS.data[0].get() == 11);
+         assertUnit(vLHS.data[2].get() == 33);
+         assertUnit(vRHS.data[0].get() == 26);
+         assertUnit(vRHS.data[1].get() == 49);
+      }
+   }  // teardown
+
+   // swap an inline vector with a heap one
+   void test_swap_inlineHeap()
+   {  // setup
+      custom::small_vector<Spy, 2> vLHS{ Spy(26) };
+      custom::small_vector<Spy, 2> vRHS{ Spy(11), Spy(22), Spy(33) };
+      Spy * pData = vRHS.data;
+      Spy::reset();
+      // exercise
+      vLHS.swap(vRHS);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(vLHS.data == pData);
+      assertUnit(vLHS.numElements == 3);
+      assertUnit(vRHS.isInline());
+      assertUnit(vRHS.numElements == 1);
+      if (vLHS.numElements == 3 && vRHS.numElements == 1)
+      {
+         assertUnit(vLHS.data[1].get() == 22);
+         assertUnit(vRHS.data[0].get() == 26);
+      }
+   }  // teardown
+
+   // swap two heap vectors: only the pointers trade places
+   void test_swap_heapHeap()
+   {  // setup
+      custom::small_vector<Spy, 1> vLHS{ Spy(26), Spy(49) };
+      custom::small_vector<Spy, 1> vRHS{ Spy(11), Spy(22), Spy(33) };
+      Spy * pLHS = vLHS.data;
+      Spy * pRHS = vRHS.data;
+      Spy::reset();
+      // exercise
+      vLHS.swap(vRHS);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(vLHS.data == pRHS);
+      assertUnit(vRHS.data == pLHS);
+      assertUnit(vLHS.numElements == 3);
+      assertUnit(vRHS.numElements == 2);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push_back up to N never leaves the object
+   void test_pushback_staysInline()
+   {  // setup
+      custom::small_vector<int, 4> v;
+      // exercise
+      for (int i = 0; i < 4; i++)
+         v.push_back(i * 10);
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 0  | 10 | 20 | 30 |   inline
+      //    +----+----+----+----+
+      assertUnit(v.isInline());
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 4);
+      assertUnit(v[3] == 30);
+   }  // teardown
+
+   // push_back of element N + 1 moves everything to the heap
+   void test_pushback_spills()
+   {  // setup
+      custom::small_vector<Spy, 2> v{ Spy(26), Spy(49) };
+      Spy s(67);
+      Spy::reset();
+      // exercise
+      v.push_back(s);
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 |    |   heap
+      //    +----+----+----+----+
+      assertUnit(Spy::numCopy() == 1);
+      assertUnit(Spy::numCopyMove() == 3);
+      assertUnit(!v.isInline());
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 3);
+      if (v.numElements == 3)
+      {
+         assertUnit(v.data[0].get() == 26);
+         assertUnit(v.data[1].get() == 49);
+         assertUnit(v.data[2].get() == 67);
+      }
+   }  // teardown
+
+   // a copy throws as the elements spill to the heap: the ones already
+   // copied are destroyed and the inline elements are left as they were
+   void test_reserve_throwUndone()
+   {  // setup
+      Fragile::numLive = 0;
+      custom::small_vector<Fragile, 3> v(3);
+      Fragile::numUntilThrow = 3;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         v.reserve(8);
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(Fragile::numLive == 3);
+      assertUnit(v.isInline());
+      assertUnit(v.numElements == 3);
+   }  // teardown
+
+   // emplace into the middle of an inline vector
+   void test_emplace_middle()
+   {  // setup
+      custom::small_vector<int, 4> v{ 26, 67 };
+      // exercise
+      auto it = v.emplace(v.begin() + 1, 49);
+      // verify
+      assertUnit(v.isInline());
+      assertUnit(*it == 49);
+      assertUnit(v.numElements == 3);
+      assertUnit(v[0] == 26 && v[1] == 49 && v[2] == 67);
+   }  // teardown
+
+   // insert a non-contiguous range that pushes the vector to the heap
+   void test_insert_listRange()
+   {  // setup
+      custom::small_vector<int, 3> v{ 26, 67 };
+      std::list<int> l{ 31, 42, 55 };
+      // exercise
+      auto it = v.insert(v.begin() + 1, l.begin(), l.end());
+      // verify
+      assertUnit(!v.isInline());
+      assertUnit(*it == 31);
+      assertUnit(v.numElements == 5);
+      if (v.numElements == 5)
+      {
+         assertUnit(v[0] == 26);
+         assertUnit(v[1] == 31);
+         assertUnit(v[3] == 55);
+         assertUnit(v[4] == 67);
+      }
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase from the middle
+   void test_erase_middle()
+   {  // setup
+      custom::small_vector<int, 4> v{ 26, 49, 67, 89 };
+      // exercise
+      auto it = v.erase(v.begin() + 1, v.begin() + 3);
+      // verify
+      assertUnit(*it == 89);
+      assertUnit(v.numElements == 2);
+      assertUnit(v[0] == 26 && v[1] == 89);
+   }  // teardown
+
+   // shrink a heap vector that fits inline again
+   void test_shrink_backInline()
+   {  // setup
+      custom::small_vector<Spy, 2> v{ Spy(26), Spy(49), Spy(67) };
+      v.pop_back();
+      Spy::reset();
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 2);
+      assertUnit(v.isInline());
+      assertUnit(v.numCapacity == 2);
+      assertUnit(v.numElements == 2);
+      if (v.numElements == 2)
+      {
+         assertUnit(v.data[0].get() == 26);
+         assertUnit(v.data[1].get() == 49);
+      }
+   }  // teardown
+
+   // clear destroys every element and keeps the buffer
+   void test_clear_spyDestroy()
+   {  // setup
+      custom::small_vector<Spy, 4> v{ Spy(26), Spy(49), Spy(67) };
+      Spy::reset();
+      // exercise
+      v.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(Spy::numDelete() == 3);
+      assertUnit(v.isInline());
+      assertUnit(v.numElements == 0);
+   }  // teardown
+
+private:
+   /*************************************************************
+    * FRAGILE
+    * Throws from its constructor once numUntilThrow reaches 0,
+    * and has no move, so relocating it copies
+    *************************************************************/
+   struct Fragile
+   {
+      Fragile()
+      {
+         if (--numUntilThrow == 0)
+            throw std::runtime_error("fragile");
+         numLive++;
+      }
+      Fragile(const Fragile &) : Fragile() {}
+      ~Fragile() { numLive--; }
+      static inline int numLive = 0;
+      static inline int numUntilThrow = 0;
+   };
+};
+
+#endif // DEBUG
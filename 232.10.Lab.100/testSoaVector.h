@@ -0,0 +1,266 @@
+/***********************************************************************
+ * Header:
+ *    TEST SOA VECTOR
+ * Summary:
+ *    Unit tests for soa_vector
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "soa_vector.h"
+#include "unitTest.h"
+
+#include <string>
+#include <tuple>
+
+class TestSoaVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+
+      // Insert
+      test_pushback_tuple();
+      test_emplaceback_fields();
+      test_reserve_everyColumn();
+      test_resize_grow();
+
+      // Access
+      test_subscript_writeThrough();
+      test_field_span();
+      test_field_empty();
+
+      // Iterator
+      test_iterator_walk();
+      test_iterator_update();
+      test_iterator_const();
+
+      // Remove
+      test_popback_standard();
+      test_clear_standard();
+
+      report("SoaVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // no records, no columns allocated
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::soa_vector<int, double> v;
+      // verify
+      assertUnit(v.size() == 0);
+      assertUnit(v.empty());
+      assertUnit(std::get<0>(v.columns).capacity() == 0);
+      assertUnit(std::get<1>(v.columns).capacity() == 0);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push_back splits the tuple across the columns
+   void test_pushback_tuple()
+   {  // setup
+      custom::soa_vector<int, std::string> v;
+      // exercise
+      v.push_back(std::make_tuple(26, std::string("twenty six")));
+      v.push_back(std::make_tuple(49, std::string("forty nine")));
+      // verify
+      //             0              1
+      //          +-------------+-------------+
+      //    int   | 26          | 49          |
+      //          +-------------+-------------+
+      //    str   | twenty six  | forty nine  |
+      //          +-------------+-------------+
+      assertUnit(v.size() == 2);
+      assertUnit(std::get<0>(v.columns).size() == 2);
+      assertUnit(std::get<1>(v.columns).size() == 2);
+      assertUnit(std::get<0>(v.columns)[1] == 49);
+      assertUnit(std::get<1>(v.columns)[0] == "twenty six");
+   }  // teardown
+
+   // emplace_back takes one value per field
+   void test_emplaceback_fields()
+   {  // setup
+      custom::soa_vector<int, std::string> v;
+      // exercise
+      auto record = v.emplace_back(67, "sixty seven");
+      // verify
+      assertUnit(v.size() == 1);
+      assertUnit(std::get<0>(record) == 67);
+      assertUnit(std::get<1>(record) == "sixty seven");
+   }  // teardown
+
+   // reserve reaches every column
+   void test_reserve_everyColumn()
+   {  // setup
+      custom::soa_vector<char, int, double> v;
+      // exercise
+      v.reserve(10);
+      // verify
+      assertUnit(std::get<0>(v.columns).capacity() == 10);
+      assertUnit(std::get<1>(v.columns).capacity() == 10);
+      assertUnit(std::get<2>(v.columns).capacity() == 10);
+      assertUnit(v.size() == 0);
+   }  // teardown
+
+   // resize adds value-initialized records
+   void test_resize_grow()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      v.emplace_back(26, 2.6);
+      // exercise
+      v.resize(3);
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(std::get<0>(v[0]) == 26);
+      assertUnit(std::get<0>(v[2]) == 0);
+      assertUnit(std::get<1>(v[2]) == 0.0);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // a record is references into the columns
+   void test_subscript_writeThrough()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      v.emplace_back(26, 2.6);
+      v.emplace_back(49, 4.9);
+      // exercise
+      std::get<1>(v[1]) = 9.9;
+      // verify
+      assertUnit(std::get<1>(v.columns)[1] == 9.9);
+      assertUnit(std::get<1>(v.columns)[0] == 2.6);
+   }  // teardown
+
+   // a field is one contiguous run
+   void test_field_span()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      v.emplace_back(26, 2.6);
+      v.emplace_back(49, 4.9);
+      v.emplace_back(67, 6.7);
+      // exercise
+      custom::span<int> ids = v.field<0>();
+      // verify
+      assertUnit(ids.size() == 3);
+      assertUnit(ids.data() == &std::get<0>(v.columns)[0]);
+      int sum = 0;
+      for (int id : ids)
+         sum += id;
+      assertUnit(sum == 26 + 49 + 67);
+   }  // teardown
+
+   // an empty field is an empty span
+   void test_field_empty()
+   {  // setup
+      const custom::soa_vector<int, double> v;
+      // exercise
+      custom::span<const double> values = v.field<1>();
+      // verify
+      assertUnit(values.empty());
+      assertUnit(values.begin() == values.end());
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walk the records in order
+   void test_iterator_walk()
+   {  // setup
+      custom::soa_vector<int, char> v;
+      v.emplace_back(1, 'a');
+      v.emplace_back(2, 'b');
+      v.emplace_back(3, 'c');
+      // exercise
+      std::string letters;
+      int sum = 0;
+      for (auto record : v)
+      {
+         sum += std::get<0>(record);
+         letters += std::get<1>(record);
+      }
+      // verify
+      assertUnit(sum == 6);
+      assertUnit(letters == "abc");
+      assertUnit(v.end() - v.begin() == 3);
+      assertUnit(std::get<1>(v.begin()[2]) == 'c');
+   }  // teardown
+
+   // write through a dereferenced iterator
+   void test_iterator_update()
+   {  // setup
+      custom::soa_vector<int, char> v;
+      v.emplace_back(1, 'a');
+      v.emplace_back(2, 'b');
+      // exercise
+      for (auto it = v.begin(); it != v.end(); ++it)
+         std::get<0>(*it) *= 10;
+      // verify
+      assertUnit(std::get<0>(v.columns)[0] == 10);
+      assertUnit(std::get<0>(v.columns)[1] == 20);
+   }  // teardown
+
+   // walk a const soa_vector, and say no more than a proxy can
+   void test_iterator_const()
+   {  // setup
+      custom::soa_vector<int, char> v;
+      v.emplace_back(1, 'a');
+      v.emplace_back(2, 'b');
+      const custom::soa_vector<int, char> & cv = v;
+      // exercise
+      int sum = 0;
+      for (auto it = cv.begin(); it != cv.end(); ++it)
+         sum += std::get<0>(*it);
+      // verify
+      assertUnit(sum == 3);
+      assertUnit(cv.end() - cv.begin() == 2);
+      assertUnit(std::get<1>(cv.begin()[1]) == 'b');
+      assertUnit((std::is_same<custom::soa_vector<int, char>::iterator::iterator_category,
+                               std::input_iterator_tag>::value));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // pop_back shortens every column
+   void test_popback_standard()
+   {  // setup
+      custom::soa_vector<int, std::string> v;
+      v.emplace_back(26, "a");
+      v.emplace_back(49, "b");
+      // exercise
+      v.pop_back();
+      // verify
+      assertUnit(v.size() == 1);
+      assertUnit(std::get<1>(v.columns).size() == 1);
+   }  // teardown
+
+   // clear empties every column
+   void test_clear_standard()
+   {  // setup
+      custom::soa_vector<int, std::string> v;
+      v.emplace_back(26, "a");
+      // exercise
+      v.clear();
+      // verify
+      assertUnit(v.empty());
+      assertUnit(std::get<1>(v.columns).size() == 0);
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,390 @@
+/***********************************************************************
+ * Header:
+ *    TEST SORT
+ * Summary:
+ *    Unit tests for radix_sort, merge_sort, and sort. Every result
+ *    is held to std::stable_sort on a copy of the same input.
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "sort.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <random>
+#include <limits>
+
+class TestSort : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Radix
+      test_radix_empty();
+      test_radix_unsigned();
+      test_radix_signed();
+      test_radix_float();
+      test_radix_double();
+      test_radix_skipsSameBytes();
+      test_radix_keyStable();
+      test_radix_short();
+      test_radix_scratchReused();
+
+      // Merge
+      test_merge_strings();
+      test_merge_comparatorStable();
+      test_merge_spyMovesOnly();
+      test_merge_parallelTwo();
+      test_merge_parallelFour();
+      test_merge_parallelUneven();
+
+      // Sort
+      test_sort_picksRadix();
+      test_sort_picksMerge();
+      test_sort_longDouble();
+
+      report("Sort");
+   }
+
+   /***************************************
+    * RADIX
+    ***************************************/
+
+   // nothing to sort
+   void test_radix_empty()
+   {  // setup
+      custom::vector<uint32_t> v;
+      // exercise
+      custom::radix_sort(v);
+      // verify
+      assertUnit(v.empty());
+   }  // teardown
+
+   // random 32-bit keys, every byte in play
+   void test_radix_unsigned()
+   {  // setup
+      custom::vector<uint32_t> v = randomKeys<uint32_t>(5000);
+      std::vector<uint32_t> expected(v.begin(), v.end());
+      std::stable_sort(expected.begin(), expected.end());
+      // exercise
+      custom::radix_sort(v);
+      // verify
+      assertUnit(std::equal(v.begin(), v.end(), expected.begin()));
+   }  // teardown
+
+   // negatives come before positives
+   void test_radix_signed()
+   {  // setup
+      custom::vector<int64_t> v = randomKeys<int64_t>(5000);
+      v[0] = std::numeric_limits<int64_t>::min();
+      v[1] = std::numeric_limits<int64_t>::max();
+      v[2] = -1;
+      v[3] = 0;
+      std::vector<int64_t> expected(v.begin(), v.end());
+      std::stable_sort(expected.begin(), expected.end());
+      // exercise
+      custom::radix_sort(v);
+      // verify
+      assertUnit(v[0] == std::numeric_limits<int64_t>::min());
+      assertUnit(v[4999] == std::numeric_limits<int64_t>::max());
+      assertUnit(std::equal(v.begin(), v.end(), expected.begin()));
+   }  // teardown
+
+   // negative floats run backwards in their bits; -0 sorts before +0
+   void test_radix_float()
+   {  // setup
+      custom::vector<float> v(1000);
+      for (size_t i = 0; i < v.size(); i++)
+         v[i] = (float)((int)(i * 7919 % 1000) - 500) / 4.0f;
+      v[0] = 0.0f;
+      v[1] = -0.0f;
+      v[2] = -std::numeric_limits<float>::infinity();
+      std::vector<float> expected(v.begin(), v.end());
+      std::stable_sort(expected.begin(), expected.end());
+      // exercise
+      custom::radix_sort(v);
+      // verify
+      assertUnit(v[0] == -std::numeric_limits<float>::infinity());
+      assertUnit(std::equal(v.begin(), v.end(), expected.begin()));
+      size_t iZero = std::find(v.begin(), v.end(), 0.0f) - v.begin();
+      assertUnit(std::signbit(v[iZero]));
+      assertUnit(!std::signbit(v[iZero + 1]));
+   }  // teardown
+
+   // doubles, with every byte of the key different
+   void test_radix_double()
+   {  // setup
+      custom::vector<double> v(2000);
+      std::mt19937_64 random(232);
+      for (size_t i = 0; i < v.size(); i++)
+         v[i] = ((double)random() - 9.2e18) * 1e-3;
+      std::vector<double> expected(v.begin(), v.end());
+      std::stable_sort(expected.begin(), expected.end());
+      // exercise
+      custom::radix_sort(v);
+      // verify
+      assertUnit(std::equal(v.begin(), v.end(), expected.begin()));
+   }  // teardown
+
+   // keys under 256 take one pass, so they end up in the scratch buffer
+   void test_radix_skipsSameBytes()
+   {  // setup
+      custom::vector<uint32_t> v(1000);
+      for (size_t i = 0; i < v.size(); i++)
+         v[i] = (uint32_t)(999 - i) % 200;
+      custom::vector<uint32_t> scratch(1000);
+      uint32_t * pScratch = &scratch[0];
+      // exercise
+      custom::radix_sort(v, [](uint32_t t) { return t; }, scratch);
+      // verify
+      //    one pass: v <---swap---> scratch
+      assertUnit(&v[0] == pScratch);
+      assertUnit(std::is_sorted(v.begin(), v.end()));
+      assertUnit(v[0] == 0);
+      assertUnit(v[999] == 199);
+   }  // teardown
+
+   // records sorted on a field keep their order among equal keys
+   void test_radix_keyStable()
+   {  // setup
+      custom::vector<Record> v(2000);
+      for (size_t i = 0; i < v.size(); i++)
+         v[i] = Record{ (int16_t)((int)(i * 37 % 101) - 50), (int)i };
+      std::vector<Record> expected(v.begin(), v.end());
+      std::stable_sort(expected.begin(), expected.end(),
+                       [](const Record & lhs, const Record & rhs) { return lhs.key < rhs.key; });
+      // exercise
+      custom::radix_sort(v, [](const Record & r) { return r.key; });
+      // verify
+      assertUnit(std::equal(v.begin(), v.end(), expected.begin()));
+   }  // teardown
+
+   // too short for buckets: merge sorted on the key, still stable
+   void test_radix_short()
+   {  // setup
+      custom::vector<Record> v(100);
+      for (size_t i = 0; i < v.size(); i++)
+         v[i] = Record{ (int16_t)(i % 3 == 0 ? -1 : 1), (int)i };
+      // exercise
+      custom::radix_sort(v, [](const Record & r) { return r.key; });
+      // verify
+      assertUnit(v[0].key == -1 && v[0].order == 0);
+      assertUnit(v[33].key == -1 && v[33].order == 99);
+      assertUnit(v[34].key == 1 && v[34].order == 1);
+      assertUnit(v[99].key == 1 && v[99].order == 98);
+   }  // teardown
+
+   // the second sort with the same scratch allocates nothing new
+   void test_radix_scratchReused()
+   {  // setup
+      custom::vector<uint32_t> scratch;
+      custom::vector<uint32_t> v = randomKeys<uint32_t>(4000);
+      custom::radix_sort(v, [](uint32_t t) { return t; }, scratch);
+      uint32_t * pScratch = &scratch[0];
+      v = randomKeys<uint32_t>(4000);
+      // exercise
+      custom::radix_sort(v, [](uint32_t t) { return t; }, scratch);
+      // verify
+      //    four passes: the elements end up back in v, and scratch
+      //    keeps the buffer it grew the first time
+      assertUnit(&scratch[0] == pScratch);
+      assertUnit(scratch.size() == 4000);
+      assertUnit(std::is_sorted(v.begin(), v.end()));
+   }  // teardown
+
+   /***************************************
+    * MERGE
+    ***************************************/
+
+   // strings in alphabetical order
+   void test_merge_strings()
+   {  // setup
+      custom::vector<std::string> v;
+      for (int i = 0; i < 500; i++)
+         v.push_back(std::to_string(i * 7919 % 500));
+      std::vector<std::string> expected(v.begin(), v.end());
+      std::stable_sort(expected.begin(), expected.end());
+      // exercise
+      custom::merge_sort(v);
+      // verify
+      assertUnit(std::equal(v.begin(), v.end(), expected.begin()));
+   }  // teardown
+
+   // a comparison that sees only part of the element keeps ties in order
+   void test_merge_comparatorStable()
+   {  // setup
+      custom::vector<Record> v(777);
+      for (size_t i = 0; i < v.size(); i++)
+         v[i] = Record{ (int16_t)(i % 10), (int)i };
+      auto byKey = [](const Record & lhs, const Record & rhs) { return lhs.key > rhs.key; };
+      std::vector<Record> expected(v.begin(), v.end());
+      std::stable_sort(expected.begin(), expected.end(), byKey);
+      // exercise
+      custom::merge_sort(v, byKey);
+      // verify
+      assertUnit(v[0].key == 9);
+      assertUnit(std::equal(v.begin(), v.end(), expected.begin()));
+   }  // teardown
+
+   // elements are moved between v and scratch, never copied
+   void test_merge_spyMovesOnly()
+   {  // setup
+      custom::vector<Spy> v;
+      for (int i = 0; i < 200; i++)
+         v.push_back(Spy(i * 7919 % 200));
+      Spy::reset();
+      // exercise
+      custom::merge_sort(v);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      bool inOrder = true;
+      for (int i = 0; i < 200; i++)
+         inOrder = inOrder && (v[i].get() == i);
+      assertUnit(inOrder);
+   }  // teardown
+
+   // two pieces and one round of merging: the pieces sort into scratch
+   void test_merge_parallelTwo()
+   {  // setup
+      ParallelSettings settings(2);
+      custom::vector<int> v = randomInts(1000);
+      std::vector<int> expected(v.begin(), v.end());
+      std::stable_sort(expected.begin(), expected.end());
+      // exercise
+      custom::merge_sort(v);
+      // verify
+      assertUnit(std::equal(v.begin(), v.end(), expected.begin()));
+   }  // teardown
+
+   // four pieces, two rounds, each merge split four ways
+   void test_merge_parallelFour()
+   {  // setup
+      ParallelSettings settings(4);
+      custom::vector<Record> v(1000);
+      for (size_t i = 0; i < v.size(); i++)
+         v[i] = Record{ (int16_t)(i * 7919 % 13), (int)i };
+      auto byKey = [](const Record & lhs, const Record & rhs) { return lhs.key < rhs.key; };
+      std::vector<Record> expected(v.begin(), v.end());
+      std::stable_sort(expected.begin(), expected.end(), byKey);
+      // exercise
+      custom::merge_sort(v, byKey);
+      // verify
+      assertUnit(std::equal(v.begin(), v.end(), expected.begin()));
+   }  // teardown
+
+   // six threads make four pieces; 1001 does not divide evenly
+   void test_merge_parallelUneven()
+   {  // setup
+      ParallelSettings settings(6);
+      custom::vector<int> v = randomInts(1001);
+      std::vector<int> expected(v.begin(), v.end());
+      std::stable_sort(expected.begin(), expected.end());
+      // exercise
+      custom::merge_sort(v);
+      // verify
+      assertUnit(std::equal(v.begin(), v.end(), expected.begin()));
+   }  // teardown
+
+   /***************************************
+    * SORT
+    ***************************************/
+
+   // numbers are radix sorted: one pass leaves them in scratch's buffer
+   void test_sort_picksRadix()
+   {  // setup
+      custom::vector<uint16_t> v(500);
+      for (size_t i = 0; i < v.size(); i++)
+         v[i] = (uint16_t)(499 - i) % 100;
+      custom::vector<uint16_t> scratch(500);
+      uint16_t * pScratch = &scratch[0];
+      // exercise
+      custom::sort(v, scratch);
+      // verify
+      assertUnit(&v[0] == pScratch);
+      assertUnit(std::is_sorted(v.begin(), v.end()));
+   }  // teardown
+
+   // anything else is merge sorted with <
+   void test_sort_picksMerge()
+   {  // setup
+      custom::vector<std::string> v{ "pear", "apple", "fig", "apple" };
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(v[0] == "apple");
+      assertUnit(v[1] == "apple");
+      assertUnit(v[2] == "fig");
+      assertUnit(v[3] == "pear");
+   }  // teardown
+
+   // long double has no 8-byte key, so it is merge sorted
+   void test_sort_longDouble()
+   {  // setup
+      custom::vector<long double> v{ 2.5L, -1.0L, 0.0L, -7.25L, 1e300L, 2.5L };
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(v[0] == -7.25L);
+      assertUnit(v[1] == -1.0L);
+      assertUnit(v[2] == 0.0L);
+      assertUnit(v[3] == 2.5L);
+      assertUnit(v[4] == 2.5L);
+      assertUnit(v[5] == 1e300L);
+   }  // teardown
+
+private:
+   // a key and where it started, to check stability
+   struct Record
+   {
+      int16_t key;
+      int     order;
+      bool operator == (const Record & rhs) const { return key == rhs.key && order == rhs.order; }
+   };
+
+   template <typename T>
+   static custom::vector<T> randomKeys(size_t num)
+   {
+      std::mt19937_64 random(232);
+      custom::vector<T> v(num);
+      for (size_t i = 0; i < num; i++)
+         v[i] = (T)random();
+      return v;
+   }
+
+   static custom::vector<int> randomInts(size_t num)
+   {
+      std::mt19937 random(232);
+      custom::vector<int> v(num);
+      for (size_t i = 0; i < num; i++)
+         v[i] = (int)(random() % 100);
+      return v;
+   }
+
+   /*************************************************************
+    * PARALLEL SETTINGS
+    * Split every sort numThreads ways for the life of
+    * a test, then put the settings back
+    *************************************************************/
+   struct ParallelSettings
+   {
+      ParallelSettings(unsigned numThreads) : saved(custom::parallelism::settings())
+      {
+         custom::parallelism::settings().threshold = 1;
+         custom::parallelism::settings().threads = numThreads;
+      }
+      ~ParallelSettings() { custom::parallelism::settings() = saved; }
+      custom::parallelism saved;
+   };
+};
+
+#endif // DEBUG
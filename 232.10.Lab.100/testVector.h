@@ -13,11 +13,23 @@
 
 #include <vector>
 #include "vector.h"
+#include "spy.h"
 #include "unitTest.h"
 
 
 #include <cassert>
 #include <memory>
+#include <list>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <memory_resource>
+#include <atomic>
+#include <stdexcept>
+#include <cstdint>
+#include <mutex>
+#include <thread>
 
 #include <iostream>
 
@@ -51,6 +63,7 @@ public:
       test_assign_sameSize();
       test_assign_rightBigger();
       test_assign_leftBigger();
+      test_assign_rightBiggerRoom();
       test_assignMove_empty();
       test_assignMove_sameSize();
       test_assignMove_rightBigger();
@@ -59,6 +72,10 @@ public:
       test_swap_sameSize();
       test_swap_rightBigger();
       test_swap_leftBigger();
+      test_allocator_pmrBuffer();
+      test_allocator_pmrCopy();
+      test_allocator_pmrMoveSameResource();
+      test_allocator_pmrMoveOtherResource();
 
       // Iterator
       test_iterator_beginEmpty();
@@ -70,6 +87,15 @@ public:
       test_iterator_construct_default();
       test_iterator_construct_pointer();
       test_iterator_construct_index();
+      test_iterator_traits();
+      test_iterator_arithmetic();
+      test_iterator_compare();
+      test_iterator_subscript();
+      test_constIterator_read();
+      test_constIterator_fromIterator();
+      test_reverseIterator_walk();
+      test_iterator_sort();
+      test_iterator_lowerBound();
 
       // Access
       test_subscript_read();
@@ -86,6 +112,38 @@ public:
       test_pushback_moveEmpty();
       test_pushback_moveExcessCapacity();
       test_pushback_moveRequireReallocate();
+      test_emplaceback_empty();
+      test_emplaceback_excessCapacity();
+      test_emplaceback_requireReallocate();
+      test_emplaceback_aliasReallocate();
+      test_emplace_empty();
+      test_emplace_front();
+      test_emplace_middleReallocate();
+      test_emplace_end();
+      test_growth_half();
+      test_growth_page();
+      test_growth_mappedAlias();
+      test_aligned_everyReallocation();
+      test_aligned_page();
+      test_aligned_mapped();
+      test_parallel_fillValue();
+      test_parallel_fillDefault();
+      test_parallel_copy();
+      test_parallel_resize();
+      test_parallel_throw();
+      test_parallel_pmrSerial();
+      test_parallel_spySerial();
+      test_insertRange_empty();
+      test_insertRange_middleExcessCapacity();
+      test_insertRange_frontLongRange();
+      test_insertRange_requireReallocate();
+      test_insertRange_spyOneReallocate();
+      test_insertRange_input();
+      test_append_forward();
+      test_append_input();
+      test_assignRange_grow();
+      test_assignRange_shrink();
+      test_assignRange_spyReuse();
       test_resize_emptyZero();
       test_resize_emptyFourDefault();
       test_resize_emptyFourValue();
@@ -99,6 +157,9 @@ public:
       test_reserve_fourTen();
       test_reserve_standardZero();
       test_reserve_standardTen();
+      test_reserve_spyNoDefault();
+      test_pushback_spyNoDefault();
+      test_reserve_spyMove();
 
       // Remove
       test_popback_empty();
@@ -107,10 +168,15 @@ public:
       test_clear_empty();
       test_clear_full();
       test_clear_partiallyFilled();
+      test_clear_spyDestroy();
+      test_eraseRange_middle();
+      test_eraseRange_all();
+      test_eraseRange_spy();
       test_shrink_empty();
       test_shrink_toEmpty();
       test_shrink_standard();
       test_shrink_twoExtraSlots();
+      test_shrink_spyMove();
 
       // Status
       test_size_empty();
@@ -260,7 +326,7 @@ public:
          //    | 26 | 49 |    |    |
          //    +----+----+----+----+
          custom::vector<int> v;
-         v.data = new int[4];
+         v.data = std::allocator<int>().allocate(4);
          v.data[0] = 99;
          v.data[1] = 99;
          v.numElements = 2;
@@ -319,7 +385,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[4];
+      vSrc.data = std::allocator<int>().allocate(4);
       vSrc.data[0] = 26;
       vSrc.data[1] = 49;
       vSrc.numElements = 2;
@@ -403,7 +469,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[4];\
+      vSrc.data = std::allocator<int>().allocate(4);\
       vSrc.data[0] = 26;
       vSrc.data[1] = 49;
       vSrc.numElements = 2;
@@ -626,7 +692,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = std::allocator<int>().allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -650,7 +716,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = std::allocator<int>().allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -674,7 +740,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = std::allocator<int>().allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -735,6 +801,85 @@ public:
       teardownStandardFixture(v);
    }
    
+   // reserve must not construct anything in the spare capacity
+   void test_reserve_spyNoDefault()
+   {  // setup
+      //      0    1
+      //    +----+----+
+      //    | 26 | 49 |
+      //    +----+----+
+      custom::vector<Spy> v{ Spy(26), Spy(49) };
+      Spy::reset();
+      // exercise
+      v.reserve(10);
+      // verify
+      //      0    1    2    3    4    5    6    7    8    9
+      //    +----+----+----+----+----+----+----+----+----+----+
+      //    | 26 | 49 |    |    |    |    |    |    |    |    |
+      //    +----+----+----+----+----+----+----+----+----+----+
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopy() + Spy::numCopyMove() == 2);
+      assertUnit(Spy::numDestructor() == 2);
+      assertUnit(v.numCapacity == 10);
+      assertUnit(v.numElements == 2);
+      if (v.numElements == 2)
+      {
+         assertUnit(v.data[0].get() == 26);
+         assertUnit(v.data[1].get() == 49);
+      }
+   }  // teardown
+
+   // growing through push_back constructs only the new element
+   void test_pushback_spyNoDefault()
+   {  // setup
+      custom::vector<Spy> v;
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      for (int i = 0; i < 5; i++)
+         v.push_back(s);
+      // verify
+      //      0    1    2    3    4    5    6    7
+      //    +----+----+----+----+----+----+----+----+
+      //    | 99 | 99 | 99 | 99 | 99 |    |    |    |
+      //    +----+----+----+----+----+----+----+----+
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.numElements == 5);
+   }  // teardown
+
+   // Spy has a noexcept move, so growing moves rather than copies
+   void test_reserve_spyMove()
+   {  // setup
+      //      0    1    2
+      //    +----+----+----+
+      //    | 26 | 49 | 67 |
+      //    +----+----+----+
+      custom::vector<Spy> v{ Spy(26), Spy(49), Spy(67) };
+      Spy::reset();
+      // exercise
+      v.reserve(6);
+      // verify
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+
+      //    | 26 | 49 | 67 |    |    |    |
+      //    +----+----+----+----+----+----+
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 3);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 3);
+      if (v.numElements == 3)
+      {
+         assertUnit(v.data[0].get() == 26);
+         assertUnit(v.data[1].get() == 49);
+         assertUnit(v.data[2].get() == 67);
+      }
+   }  // teardown
+
    // shrink an empty fixture
    void test_shrink_empty()
    {  // setup
@@ -753,7 +898,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = std::allocator<int>().allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -787,7 +932,7 @@ public:
       //    | 26 | 49 | 67 | 89 |    |    |
       //    +----+----+----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[6];
+      v.data = std::allocator<int>().allocate(6);
       v.data[0] = 26;
       v.data[1] = 49;
       v.data[2] = 67;
@@ -805,6 +950,35 @@ public:
       teardownStandardFixture(v);
    }
    
+   // shrinking moves the Spies into the smaller buffer
+   void test_shrink_spyMove()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 |    |    |
+      //    +----+----+----+----+
+      custom::vector<Spy> v{ Spy(26), Spy(49) };
+      v.reserve(4);
+      Spy::reset();
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      //      0    1
+      //    +----+----+
+      //    | 26 | 49 |
+      //    +----+----+
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 2);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(v.numCapacity == 2);
+      assertUnit(v.numElements == 2);
+      if (v.numElements == 2)
+      {
+         assertUnit(v.data[0].get() == 26);
+         assertUnit(v.data[1].get() == 49);
+      }
+   }  // teardown
+
    /***************************************
     * SIZE EMPTY CAPACITY
     ***************************************/
@@ -966,7 +1140,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vDest;
-      vDest.data = new int[2];
+      vDest.data = std::allocator<int>().allocate(2);
       vDest.data[0] = 99;
       vDest.data[1] = 99;
       vDest.numElements = 2;
@@ -990,6 +1164,33 @@ public:
       teardownStandardFixture(vDest);
    }
    
+   // assignment when the destination has fewer elements than the source
+   // but room for all of them: nothing past the copies is destroyed
+   void test_assign_rightBiggerRoom()
+   {  // setup
+      custom::vector<Spy> vSrc{ Spy(26), Spy(49), Spy(67), Spy(89) };
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 11 | 99 |    |    |
+      //    +----+----+----+----+
+      custom::vector<Spy> vDest{ Spy(11), Spy(99) };
+      vDest.reserve(4);
+      Spy::reset();
+      // exercise
+      vDest = vSrc;
+      // verify
+      assertUnit(Spy::numAssign() == 2);
+      assertUnit(Spy::numCopy() == 2);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(vDest.numCapacity == 4);
+      assertUnit(vDest.numElements == 4);
+      if (vDest.numElements == 4)
+      {
+         assertUnit(vDest.data[0].get() == 26);
+         assertUnit(vDest.data[3].get() == 89);
+      }
+   }  // teardown
+
    // assignment when the destination is bigger than the source
    void test_assign_leftBigger()
    {  // setup
@@ -998,7 +1199,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[2];
+      vSrc.data = std::allocator<int>().allocate(2);
       vSrc.data[0] = 99;
       vSrc.data[1] = 99;
       vSrc.numElements = 2;
@@ -1103,7 +1304,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vDest;
-      vDest.data = new int[2];
+      vDest.data = std::allocator<int>().allocate(2);
       vDest.data[0] = 99;
       vDest.data[1] = 99;
       vDest.numElements = 2;
@@ -1130,7 +1331,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[2];
+      vSrc.data = std::allocator<int>().allocate(2);
       vSrc.data[0] = 99;
       vSrc.data[1] = 99;
       vSrc.numElements = 2;
@@ -1240,7 +1441,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vDest;
-      vDest.data = new int[2];
+      vDest.data = std::allocator<int>().allocate(2);
       vDest.data[0] = 99;
       vDest.data[1] = 99;
       vDest.numElements = 2;
@@ -1279,7 +1480,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[2];
+      vSrc.data = std::allocator<int>().allocate(2);
       vSrc.data[0] = 99;
       vSrc.data[1] = 99;
       vSrc.numElements = 2;
@@ -1520,7 +1721,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = std::allocator<int>().allocate(4);
       v.data[0] = 26;
       v.data[1] = 49;
       v.numElements = 2;
@@ -1587,7 +1788,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = std::allocator<int>().allocate(4);
       v.data[0] = 26;
       v.data[1] = 49;
       v.numElements = 2;
@@ -1605,6 +1806,98 @@ public:
       // teardown
       teardownStandardFixture(v);
    }
+
+   // clear calls the destructor on each element but keeps the buffer
+   void test_clear_spyDestroy()
+   {  // setup
+      //      0    1    2
+      //    +----+----+----+
+      //    | 26 | 49 | 67 |
+      //    +----+----+----+
+      custom::vector<Spy> v{ Spy(26), Spy(49), Spy(67) };
+      Spy::reset();
+      // exercise
+      v.clear();
+      // verify
+      //      0    1    2
+      //    +----+----+----+
+      //    |    |    |    |
+      //    +----+----+----+
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(Spy::numDelete() == 3);
+      assertUnit(v.numCapacity == 3);
+      assertUnit(v.numElements == 0);
+   }  // teardown
+
+   // erase from the middle: the tail closes the gap
+   void test_eraseRange_middle()
+   {  // setup
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+
+      //    | 26 | 11 | 12 | 49 | 67 | 89 |
+      //    +----+----+----+----+----+----+
+      custom::vector<int> v{ 26, 11, 12, 49, 67, 89 };
+      custom::vector<int>::iterator first = ++v.begin();
+      custom::vector<int>::iterator last = first;
+      ++(++last);
+      // exercise
+      custom::vector<int>::iterator it = v.erase(first, last);
+      // verify
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |    |    |
+      //    +----+----+----+----+----+----+
+      assertUnit(it.p == v.data + 1);
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 4);
+      if (v.numElements == 4)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[1] == 49);
+         assertUnit(v.data[2] == 67);
+         assertUnit(v.data[3] == 89);
+      }
+   }  // teardown
+
+   // erase everything
+   void test_eraseRange_all()
+   {  // setup
+      custom::vector<int> v{ 26, 49, 67, 89 };
+      // exercise
+      custom::vector<int>::iterator it = v.erase(v.begin(), v.end());
+      // verify
+      assertUnit(it.p == v.data);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 0);
+   }  // teardown
+
+   // erase the Spies: each removed one is destroyed exactly once
+   void test_eraseRange_spy()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v{ Spy(26), Spy(49), Spy(67), Spy(89) };
+      Spy::reset();
+      // exercise
+      v.erase(v.begin(), ++v.begin());
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 49 | 67 | 89 |    |
+      //    +----+----+----+----+
+      assertUnit(Spy::numAssignMove() == 3);
+      assertUnit(Spy::numDestructor() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(v.numElements == 3);
+      if (v.numElements == 3)
+      {
+         assertUnit(v.data[0].get() == 49);
+         assertUnit(v.data[1].get() == 67);
+         assertUnit(v.data[2].get() == 89);
+      }
+   }  // teardown
    
    
    /***************************************
@@ -1645,7 +1938,7 @@ public:
       //    | 26 | 49 | 67 |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = std::allocator<int>().allocate(4);
       v.data[0] = 26;
       v.data[1] = 49;
       v.data[2] = 67;
@@ -1675,7 +1968,7 @@ public:
       //    | 26 | 49 | 67 |
       //    +----+----+----+
       custom::vector<int> v;
-      v.data = new int[3];
+      v.data = std::allocator<int>().allocate(3);
       v.data[0] = 26;
       v.data[1] = 49;
       v.data[2] = 67;
@@ -1744,7 +2037,7 @@ public:
       //    | 26 | 49 | 67 |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = std::allocator<int>().allocate(4);
       
       v.data[0] = 26;
       v.data[1] = 49;
@@ -1777,7 +2070,7 @@ public:
       //    | 26 | 49 | 67 |
       //    +----+----+----+
       custom::vector<int> v;
-      v.data = new int[3];
+      v.data = std::allocator<int>().allocate(3);
       
       v.data[0] = 26;
       v.data[1] = 49;
@@ -1813,125 +2106,896 @@ public:
    
    
    /***************************************
-    * ITERATOR
+    * EMPLACE
     ***************************************/
-   
-   // empty iterator
-   void test_iterator_beginEmpty()
+
+   // build an element in place at the back of an empty vector
+   void test_emplaceback_empty()
    {  // setup
-      custom::vector<int> v;
+      custom::vector<Spy> v;
+      Spy::reset();
       // exercise
-      custom::vector<int>::iterator it = v.begin();
+      Spy & s = v.emplace_back(99);
       // verify
-      assertUnit(it.p == nullptr);
-      assertEmptyFixture(v);
+      //      0
+      //    +----+
+      //    | 99 |
+      //    +----+
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(v.numCapacity == 1);
+      assertUnit(v.numElements == 1);
+      assertUnit(&s == v.data);
+      if (v.numElements == 1)
+         assertUnit(v.data[0].get() == 99);
    }  // teardown
-   
-   // iterator the first element
-   void test_iterator_beginFull()
+
+   // emplace into spare capacity: no temporary, no move, no destructor
+   void test_emplaceback_excessCapacity()
    {  // setup
       //      0    1    2    3
       //    +----+----+----+----+
-      //    | 26 | 49 | 67 | 89 |
+      //    | 26 | 49 |    |    |
       //    +----+----+----+----+
-      custom::vector<int> v;
-      setupStandardFixture(v);
+      custom::vector<Spy> v{ Spy(26), Spy(49) };
+      v.reserve(4);
+      Spy::reset();
       // exercise
-      custom::vector<int>::iterator it = v.begin();
+      Spy & s = v.emplace_back(99);
       // verify
       //      0    1    2    3
       //    +----+----+----+----+
-      //    | 26 | 49 | 67 | 89 |
+      //    | 26 | 49 | 99 |    |
       //    +----+----+----+----+
-      //      it
-      assertUnit(it.p == &(v.data[0]));
-      if (it.p)
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 3);
+      assertUnit(&s == v.data + 2);
+      if (v.numElements == 3)
       {
-         assertUnit(*(it.p) == 26);
+         assertUnit(v.data[0].get() == 26);
+         assertUnit(v.data[1].get() == 49);
+         assertUnit(v.data[2].get() == 99);
       }
-      
-      assertStandardFixture(v);
-      // teardown
-      teardownStandardFixture(v);
-   }
-   
-   // iterator the end() method
-   void test_iterator_endFull()
+   }  // teardown
+
+   // emplace when full: only the existing elements are moved
+   void test_emplaceback_requireReallocate()
    {  // setup
+      //      0    1
+      //    +----+----+
+      //    | 26 | 49 |
+      //    +----+----+
+      custom::vector<Spy> v{ Spy(26), Spy(49) };
+      Spy::reset();
+      // exercise
+      v.emplace_back(99);
+      // verify
       //      0    1    2    3
       //    +----+----+----+----+
-      //    | 26 | 49 | 67 | 89 |
+      //    | 26 | 49 | 99 |    |
       //    +----+----+----+----+
-      custom::vector<int> v;
-      setupStandardFixture(v);
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 2);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 3);
+      if (v.numElements == 3)
+      {
+         assertUnit(v.data[0].get() == 26);
+         assertUnit(v.data[1].get() == 49);
+         assertUnit(v.data[2].get() == 99);
+      }
+   }  // teardown
+
+   // copy an element of the vector onto its own back while it grows
+   void test_emplaceback_aliasReallocate()
+   {  // setup
+      //      0    1
+      //    +----+----+
+      //    | 26 | 49 |
+      //    +----+----+
+      custom::vector<Spy> v{ Spy(26), Spy(49) };
       // exercise
-      custom::vector<int>::iterator it = v.end();
+      v.emplace_back(v[0]);
       // verify
       //      0    1    2    3
       //    +----+----+----+----+
-      //    | 26 | 49 | 67 | 89 |
+      //    | 26 | 49 | 26 |    |
       //    +----+----+----+----+
-      //                           it
-      assertUnit(it.p == &(v.data[4]));
-      assertStandardFixture(v);
-      // teardown
-      teardownStandardFixture(v);
-   }
-   
-   // iterator use the decrement operator
-   void test_iterator_incrementFull()
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 3);
+      if (v.numElements == 3)
+      {
+         assertUnit(v.data[0].get() == 26);
+         assertUnit(v.data[1].get() == 49);
+         assertUnit(v.data[2].get() == 26);
+      }
+   }  // teardown
+
+   // emplace into an empty vector at begin()
+   void test_emplace_empty()
+   {  // setup
+      custom::vector<Spy> v;
+      Spy::reset();
+      // exercise
+      custom::vector<Spy>::iterator it = v.emplace(v.begin(), 99);
+      // verify
+      //      0
+      //    +----+
+      //    | 99 |
+      //    +----+
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(v.numElements == 1);
+      assertUnit(it.p == v.data);
+      if (v.numElements == 1)
+         assertUnit(v.data[0].get() == 99);
+   }  // teardown
+
+   // emplace at the front with spare capacity shifts everything back
+   void test_emplace_front()
    {  // setup
       //      0    1    2    3
       //    +----+----+----+----+
-      //    | 26 | 49 | 67 | 89 |
+      //    | 26 | 49 | 67 |    |
       //    +----+----+----+----+
-      //           it
-      custom::vector<int> v;
-      setupStandardFixture(v);
-      custom::vector<int>::iterator it;
-      it.p = &(v.data[1]);
+      custom::vector<int> v{ 26, 49, 67 };
+      v.reserve(4);
       // exercise
-      ++it;
+      custom::vector<int>::iterator it = v.emplace(v.begin(), 11);
       // verify
       //      0    1    2    3
       //    +----+----+----+----+
-      //    | 26 | 49 | 67 | 89 |
+      //    | 11 | 26 | 49 | 67 |
       //    +----+----+----+----+
-      //                it
-      assertUnit(*(it.p) == int(67));
-      assertStandardFixture(v);
-      // teardown
-      teardownStandardFixture(v);
-   }
-   
-   // iterator use the decrement operator
-   void test_iterator_dereferenceReadFull()
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 4);
+      assertUnit(it.p == v.data);
+      if (v.numElements == 4)
+      {
+         assertUnit(v.data[0] == 11);
+         assertUnit(v.data[1] == 26);
+         assertUnit(v.data[2] == 49);
+         assertUnit(v.data[3] == 67);
+      }
+   }  // teardown
+
+   // emplace in the middle of a full vector builds in the new buffer
+   void test_emplace_middleReallocate()
    {  // setup
       //      0    1    2    3
       //    +----+----+----+----+
       //    | 26 | 49 | 67 | 89 |
       //    +----+----+----+----+
-      //           it
-      custom::vector<int> v;
-      setupStandardFixture(v);
-      custom::vector<int>::iterator it;
-      it.p = &(v.data[1]);
-      // exercise
-      int value = *it;
-      // verify
-      assertUnit(value == int(49));
-      assertUnit(it.p == &(v.data[1]));
-      assertStandardFixture(v);
-      // teardown
-      teardownStandardFixture(v);
-   }
-   
-   // iterator change a value
-   void test_iterator_dereferenceUpdate()
+      custom::vector<Spy> v{ Spy(26), Spy(49), Spy(67), Spy(89) };
+      Spy::reset();
+      // exercise
+      custom::vector<Spy>::iterator it = v.emplace(++(++v.begin()), 55);
+      // verify
+      //      0    1    2    3    4    5    6    7
+      //    +----+----+----+----+----+----+----+----+
+      //    | 26 | 49 | 55 | 67 | 89 |    |    |    |
+      //    +----+----+----+----+----+----+----+----+
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 4);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.numElements == 5);
+      assertUnit(it.p == v.data + 2);
+      if (v.numElements == 5)
+      {
+         assertUnit(v.data[0].get() == 26);
+         assertUnit(v.data[1].get() == 49);
+         assertUnit(v.data[2].get() == 55);
+         assertUnit(v.data[3].get() == 67);
+         assertUnit(v.data[4].get() == 89);
+      }
+   }  // teardown
+
+   // emplace at end() is the same as emplace_back()
+   void test_emplace_end()
    {  // setup
       //      0    1    2    3
       //    +----+----+----+----+
-      //    | 26 | 49 | 67 | 89 |
+      //    | 26 | 49 |    |    |
+      //    +----+----+----+----+
+      custom::vector<Spy> v{ Spy(26), Spy(49) };
+      v.reserve(4);
+      Spy::reset();
+      // exercise
+      v.emplace(v.end(), 99);
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 99 |    |
+      //    +----+----+----+----+
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(v.numElements == 3);
+      if (v.numElements == 3)
+         assertUnit(v.data[2].get() == 99);
+   }  // teardown
+
+   /***************************************
+    * GROWTH POLICY
+    ***************************************/
+
+   // grow_half: 1, 2, 3, 4, 6
+   void test_growth_half()
+   {  // setup
+      custom::vector<int, std::allocator<int>, custom::grow_half> v;
+      // exercise
+      for (int i = 0; i < 5; i++)
+         v.push_back(i);
+      // verify
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+
+      //    | 0  | 1  | 2  | 3  | 4  |    |
+      //    +----+----+----+----+----+----+
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 5);
+      assertUnit(v.data[4] == 4);
+   }  // teardown
+
+   // grow_page: past one page, the buffer is a whole number of pages
+   void test_growth_page()
+   {  // setup
+      custom::vector<char, std::allocator<char>, custom::grow_page> v;
+      // exercise
+      for (int i = 0; i < 5000; i++)
+         v.push_back('a');
+      // verify
+      assertUnit(v.numElements == 5000);
+      assertUnit(v.numCapacity >= 5000);
+      assertUnit(v.numCapacity % custom::grow_page::pageSize == 0);
+   }  // teardown
+
+   // grow a full, mapped buffer by emplacing one of its own elements
+   void test_growth_mappedAlias()
+   {  // setup
+      const int num = 1 << 19;  // 2MB of ints: well past the mapping threshold
+      custom::vector<int> v;
+      for (int i = 0; i < num; i++)
+         v.push_back(i);
+      // exercise
+      v.emplace(v.begin() + 1, v.back());
+      // verify
+      assertUnit(v.numElements == num + 1);
+      assertUnit(v.numCapacity == 2 * num);
+      if (v.numElements == num + 1)
+      {
+         assertUnit(v.data[0] == 0);
+         assertUnit(v.data[1] == num - 1);
+         assertUnit(v.data[2] == 1);
+         assertUnit(v.data[num] == num - 1);
+      }
+   }  // teardown
+
+   /***************************************
+    * ALIGNED
+    ***************************************/
+
+   // every buffer a growing aligned_vector has is on a cache line
+   void test_aligned_everyReallocation()
+   {  // setup
+      custom::aligned_vector<float, 64> v;
+      bool aligned = true;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+      {
+         v.push_back((float)i);
+         aligned = aligned && ((uintptr_t)v.aligned_data() % 64 == 0);
+      }
+      v.shrink_to_fit();
+      aligned = aligned && ((uintptr_t)v.aligned_data() % 64 == 0);
+      // verify
+      assertUnit(aligned);
+      assertUnit(v.alignment == 64);
+      assertUnit(v.aligned_data() == v.data);
+      assertUnit(v[999] == 999.0f);
+   }  // teardown
+
+   // page alignment, kept by a copy
+   void test_aligned_page()
+   {  // setup
+      custom::aligned_vector<int, 4096> vSrc{ 26, 49, 67 };
+      // exercise
+      custom::aligned_vector<int, 4096> vDest(vSrc);
+      // verify
+      assertUnit((uintptr_t)vSrc.aligned_data()  % 4096 == 0);
+      assertUnit((uintptr_t)vDest.aligned_data() % 4096 == 0);
+      assertUnit(vDest.size() == 3);
+      assertUnit(vDest[2] == 67);
+      assertUnit(custom::vector<int>::alignment == alignof(int));
+   }  // teardown
+
+   // growing from an allocated buffer to a mapped one and back keeps the promise
+   void test_aligned_mapped()
+   {  // setup
+      const int num = 1 << 19;  // 2MB of ints: well past the mapping threshold
+      custom::aligned_vector<int, 64> v;
+      bool aligned = true;
+      // exercise
+      for (int i = 0; i < num; i++)
+      {
+         v.push_back(i);
+         aligned = aligned && ((uintptr_t)v.aligned_data() % 64 == 0);
+      }
+      v.resize(10);
+      v.shrink_to_fit();
+      // verify
+      assertUnit(aligned);
+      assertUnit((uintptr_t)v.aligned_data() % 64 == 0);
+      assertUnit(v.size() == 10);
+      assertUnit(v[9] == 9);
+   }  // teardown
+
+   /***************************************
+    * PARALLEL
+    * Every fill and copy here is far above the
+    * threshold, so plain data is split four ways
+    ***************************************/
+
+   // fill constructor with a value
+   void test_parallel_fillValue()
+   {  // setup
+      ParallelSettings settings(4);
+      // exercise
+      custom::vector<int> v(1000, 7);
+      // verify
+      assertUnit(v.numElements == 1000);
+      assertUnit(std::count(v.data, v.data + 1000, 7) == 1000);
+   }  // teardown
+
+   // fill constructor with value-initialized elements
+   void test_parallel_fillDefault()
+   {  // setup
+      ParallelSettings settings(4);
+      // exercise
+      custom::vector<double> v(1001);
+      // verify
+      assertUnit(v.numElements == 1001);
+      assertUnit(std::count(v.data, v.data + 1001, 0.0) == 1001);
+   }  // teardown
+
+   // copy constructor
+   void test_parallel_copy()
+   {  // setup
+      custom::vector<int> vSrc;
+      for (int i = 0; i < 999; i++)
+         vSrc.push_back(i);
+      ParallelSettings settings(4);
+      // exercise
+      custom::vector<int> vDest(vSrc);
+      // verify
+      assertUnit(vDest.numElements == 999);
+      assertUnit(vDest.data != vSrc.data);
+      assertUnit(std::equal(vSrc.data, vSrc.data + 999, vDest.data));
+   }  // teardown
+
+   // resize fills only the new elements
+   void test_parallel_resize()
+   {  // setup
+      custom::vector<int> v{ 26, 49 };
+      ParallelSettings settings(4);
+      // exercise
+      v.resize(1000, 5);
+      // verify
+      assertUnit(v.numElements == 1000);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 49);
+      assertUnit(std::count(v.data + 2, v.data + 1000, 5) == 998);
+   }  // teardown
+
+   // one piece throws: the exception comes out of the constructor
+   void test_parallel_throw()
+   {  // setup
+      ParallelSettings settings(4);
+      Fragile::numBuilt = 0;
+      Fragile::numUntilThrow = 600;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         custom::vector<Fragile> v(1000);
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(Fragile::numBuilt >= 599);
+   }  // teardown
+
+   // a memory_resource is not thread-safe, so a pmr vector fills on this thread
+   void test_parallel_pmrSerial()
+   {  // setup
+      ParallelSettings settings(4);
+      ThreadLog log;
+      std::pmr::string value("long enough to need a buffer of its own");
+      // exercise
+      custom::pmr::vector<std::pmr::string> v(1000, value, &log);
+      // verify
+      assertUnit(v.numElements == 1000);
+      assertUnit(log.numAllocate >= 1000);
+      assertUnit(!log.otherThread);
+      assertUnit(v.data[999] == value);
+   }  // teardown
+
+   // a copy constructor may count, so Spy is copied on this thread
+   void test_parallel_spySerial()
+   {  // setup
+      custom::vector<Spy> vSrc(1000);
+      ParallelSettings settings(4);
+      Spy::reset();
+      // exercise
+      custom::vector<Spy> vDest(vSrc);
+      // verify
+      assertUnit(!custom::vector<Spy>::canParallel);
+      assertUnit(Spy::numCopy() == 1000);
+      assertUnit(vDest.numElements == 1000);
+   }  // teardown
+
+   /***************************************
+    * RANGE INSERT, APPEND, AND ASSIGN
+    ***************************************/
+
+   // insert a range into an empty vector
+   void test_insertRange_empty()
+   {  // setup
+      custom::vector<int> v;
+      int a[] = { 26, 49, 67, 89 };
+      // exercise
+      v.insert(v.begin(), a, a + 4);
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      assertStandardFixture(v);
+   }  // teardown
+
+   // insert fewer elements than follow the insertion point
+   void test_insertRange_middleExcessCapacity()
+   {  // setup
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+
+      //    | 26 | 89 | 90 | 91 |    |    |
+      //    +----+----+----+----+----+----+
+      custom::vector<int> v{ 26, 89, 90, 91 };
+      v.reserve(6);
+      int * p = v.data;
+      int a[] = { 49, 67 };
+      // exercise
+      custom::vector<int>::iterator it = v.insert(++v.begin(), a, a + 2);
+      // verify
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+
+      //    | 26 | 49 | 67 | 89 | 90 | 91 |
+      //    +----+----+----+----+----+----+
+      assertUnit(v.data == p);
+      assertUnit(it.p == v.data + 1);
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 6);
+      if (v.numElements == 6)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[1] == 49);
+         assertUnit(v.data[2] == 67);
+         assertUnit(v.data[3] == 89);
+         assertUnit(v.data[4] == 90);
+         assertUnit(v.data[5] == 91);
+      }
+   }  // teardown
+
+   // insert more Spies than follow the insertion point
+   void test_insertRange_frontLongRange()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 67 | 89 |    |    |
+      //    +----+----+----+----+
+      custom::vector<Spy> v{ Spy(67), Spy(89) };
+      v.reserve(5);
+      std::list<Spy> l{ Spy(11), Spy(26), Spy(49) };
+      // exercise
+      v.insert(v.begin(), l.begin(), l.end());
+      // verify
+      //      0    1    2    3    4
+      //    +----+----+----+----+----+
+      //    | 11 | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+----+
+      assertUnit(v.numCapacity == 5);
+      assertUnit(v.numElements == 5);
+      if (v.numElements == 5)
+      {
+         assertUnit(v.data[0].get() == 11);
+         assertUnit(v.data[1].get() == 26);
+         assertUnit(v.data[2].get() == 49);
+         assertUnit(v.data[3].get() == 67);
+         assertUnit(v.data[4].get() == 89);
+      }
+   }  // teardown
+
+   // insert more than fits: grow to exactly what is needed
+   void test_insertRange_requireReallocate()
+   {  // setup
+      //      0    1
+      //    +----+----+
+      //    | 26 | 89 |
+      //    +----+----+
+      custom::vector<int> v{ 26, 89 };
+      std::vector<int> a{ 49, 67, 68, 69, 70 };
+      // exercise
+      v.insert(++v.begin(), a.begin(), a.end());
+      // verify
+      //      0    1    2    3    4    5    6
+      //    +----+----+----+----+----+----+----+
+      //    | 26 | 49 | 67 | 68 | 69 | 70 | 89 |
+      //    +----+----+----+----+----+----+----+
+      assertUnit(v.numCapacity == 7);
+      assertUnit(v.numElements == 7);
+      if (v.numElements == 7)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[1] == 49);
+         assertUnit(v.data[5] == 70);
+         assertUnit(v.data[6] == 89);
+      }
+   }  // teardown
+
+   // a batch insert copies each new element once and moves each old one once
+   void test_insertRange_spyOneReallocate()
+   {  // setup
+      custom::vector<Spy> v{ Spy(26), Spy(89) };
+      std::vector<Spy> batch;
+      for (int i = 0; i < 100; i++)
+         batch.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      v.insert(++v.begin(), batch.begin(), batch.end());
+      // verify
+      assertUnit(Spy::numCopy() == 100);
+      assertUnit(Spy::numCopyMove() == 2);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(v.numElements == 102);
+      assertUnit(v.numCapacity == 102);
+      if (v.numElements == 102)
+      {
+         assertUnit(v.data[0].get() == 26);
+         assertUnit(v.data[1].get() == 0);
+         assertUnit(v.data[100].get() == 99);
+         assertUnit(v.data[101].get() == 89);
+      }
+   }  // teardown
+
+   // a single-pass range cannot be measured: it still lands in order
+   void test_insertRange_input()
+   {  // setup
+      //      0    1
+      //    +----+----+
+      //    | 26 | 89 |
+      //    +----+----+
+      custom::vector<int> v{ 26, 89 };
+      std::istringstream in("49 67");
+      // exercise
+      v.insert(++v.begin(), std::istream_iterator<int>(in), std::istream_iterator<int>());
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      assertStandardFixture(v);
+   }  // teardown
+
+   // append a list: one allocation
+   void test_append_forward()
+   {  // setup
+      //      0    1
+      //    +----+----+
+      //    | 26 | 49 |
+      //    +----+----+
+      custom::vector<int> v{ 26, 49 };
+      std::list<int> l{ 67, 89 };
+      // exercise
+      v.append(l.begin(), l.end());
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      assertStandardFixture(v);
+   }  // teardown
+
+   // append from a stream
+   void test_append_input()
+   {  // setup
+      custom::vector<int> v;
+      std::istringstream in("26 49 67 89");
+      // exercise
+      v.append(std::istream_iterator<int>(in), std::istream_iterator<int>());
+      // verify
+      assertUnit(v.numElements == 4);
+      if (v.numElements == 4)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[3] == 89);
+      }
+   }  // teardown
+
+   // assign more than the capacity
+   void test_assignRange_grow()
+   {  // setup
+      custom::vector<int> v{ 99 };
+      int a[] = { 26, 49, 67, 89 };
+      // exercise
+      v.assign(a, a + 4);
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      assertStandardFixture(v);
+   }  // teardown
+
+   // assign fewer: the capacity is kept
+   void test_assignRange_shrink()
+   {  // setup
+      custom::vector<int> v{ 1, 2, 3, 4, 5, 6 };
+      int a[] = { 26, 49 };
+      // exercise
+      v.assign(a, a + 2);
+      // verify
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+
+      //    | 26 | 49 |    |    |    |    |
+      //    +----+----+----+----+----+----+
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 2);
+      if (v.numElements == 2)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[1] == 49);
+      }
+   }  // teardown
+
+   // assign into spare capacity assigns the live and constructs the rest
+   void test_assignRange_spyReuse()
+   {  // setup
+      custom::vector<Spy> v{ Spy(1), Spy(2) };
+      v.reserve(4);
+      std::vector<Spy> a{ Spy(26), Spy(49), Spy(67), Spy(89) };
+      Spy::reset();
+      // exercise
+      v.assign(a.begin(), a.end());
+      // verify
+      assertUnit(Spy::numAssign() == 2);
+      assertUnit(Spy::numCopy() == 2);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 4);
+      if (v.numElements == 4)
+      {
+         assertUnit(v.data[0].get() == 26);
+         assertUnit(v.data[3].get() == 89);
+      }
+   }  // teardown
+
+   /***************************************
+    * ALLOCATOR
+    ***************************************/
+
+   // the buffer comes from the memory resource, not the heap
+   void test_allocator_pmrBuffer()
+   {  // setup
+      char buffer[1024];
+      std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer),
+                                                   std::pmr::null_memory_resource());
+      custom::pmr::vector<int> v(&resource);
+      // exercise
+      v.push_back(26);
+      v.push_back(49);
+      v.push_back(67);
+      v.push_back(89);
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      assertUnit((char *)v.data >= buffer);
+      assertUnit((char *)(v.data + v.numCapacity) <= buffer + sizeof(buffer));
+      assertUnit(v.get_allocator().resource() == &resource);
+      assertUnit(v.numElements == 4);
+      if (v.numElements == 4)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[3] == 89);
+      }
+   }  // teardown
+
+   // a polymorphic allocator does not follow a copy
+   void test_allocator_pmrCopy()
+   {  // setup
+      std::pmr::monotonic_buffer_resource resource;
+      custom::pmr::vector<int> vSrc({ 26, 49, 67, 89 }, &resource);
+      // exercise
+      custom::pmr::vector<int> vDest(vSrc);
+      // verify
+      assertUnit(vDest.get_allocator().resource() == std::pmr::get_default_resource());
+      assertUnit(vDest.data != vSrc.data);
+      assertUnit(vDest.numElements == 4);
+      if (vDest.numElements == 4)
+         assertUnit(vDest.data[3] == 89);
+   }  // teardown
+
+   // move between vectors on the same resource steals the buffer
+   void test_allocator_pmrMoveSameResource()
+   {  // setup
+      std::pmr::monotonic_buffer_resource resource;
+      custom::pmr::vector<int> vSrc({ 26, 49, 67, 89 }, &resource);
+      custom::pmr::vector<int> vDest(&resource);
+      int * p = vSrc.data;
+      // exercise
+      vDest = std::move(vSrc);
+      // verify
+      assertUnit(vDest.data == p);
+      assertUnit(vDest.numElements == 4);
+      assertUnit(vSrc.numElements == 0);
+   }  // teardown
+
+   // move between resources moves the elements into our own buffer
+   void test_allocator_pmrMoveOtherResource()
+   {  // setup
+      std::pmr::monotonic_buffer_resource resourceSrc;
+      std::pmr::monotonic_buffer_resource resourceDest;
+      custom::pmr::vector<int> vSrc({ 26, 49, 67, 89 }, &resourceSrc);
+      custom::pmr::vector<int> vDest(&resourceDest);
+      int * p = vSrc.data;
+      // exercise
+      vDest = std::move(vSrc);
+      // verify
+      assertUnit(vDest.data != p);
+      assertUnit(vDest.get_allocator().resource() == &resourceDest);
+      assertUnit(vDest.numElements == 4);
+      if (vDest.numElements == 4)
+      {
+         assertUnit(vDest.data[0] == 26);
+         assertUnit(vDest.data[3] == 89);
+      }
+      assertUnit(vSrc.numElements == 0);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+   
+   // empty iterator
+   void test_iterator_beginEmpty()
+   {  // setup
+      custom::vector<int> v;
+      // exercise
+      custom::vector<int>::iterator it = v.begin();
+      // verify
+      assertUnit(it.p == nullptr);
+      assertEmptyFixture(v);
+   }  // teardown
+   
+   // iterator the first element
+   void test_iterator_beginFull()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      // exercise
+      custom::vector<int>::iterator it = v.begin();
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      //      it
+      assertUnit(it.p == &(v.data[0]));
+      if (it.p)
+      {
+         assertUnit(*(it.p) == 26);
+      }
+      
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+   
+   // iterator the end() method
+   void test_iterator_endFull()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      // exercise
+      custom::vector<int>::iterator it = v.end();
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      //                           it
+      assertUnit(it.p == &(v.data[4]));
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+   
+   // iterator use the decrement operator
+   void test_iterator_incrementFull()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      //           it
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      custom::vector<int>::iterator it;
+      it.p = &(v.data[1]);
+      // exercise
+      ++it;
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      //                it
+      assertUnit(*(it.p) == int(67));
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+   
+   // iterator use the decrement operator
+   void test_iterator_dereferenceReadFull()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      //           it
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      custom::vector<int>::iterator it;
+      it.p = &(v.data[1]);
+      // exercise
+      int value = *it;
+      // verify
+      assertUnit(value == int(49));
+      assertUnit(it.p == &(v.data[1]));
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+   
+   // iterator change a value
+   void test_iterator_dereferenceUpdate()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
       //    +----+----+----+----+
       //           it
       custom::vector<int> v;
@@ -2004,7 +3068,231 @@ public:
       teardownStandardFixture(v);
    }
 
-   
+
+   // the standard library sees a random-access iterator
+   void test_iterator_traits()
+   {
+      typedef std::iterator_traits<custom::vector<int>::iterator> Traits;
+      typedef std::iterator_traits<custom::vector<int>::const_iterator> ConstTraits;
+      assertUnit((std::is_same<Traits::iterator_category, std::random_access_iterator_tag>::value));
+      assertUnit((std::is_same<Traits::difference_type, std::ptrdiff_t>::value));
+      assertUnit((std::is_same<Traits::reference, int &>::value));
+      assertUnit((std::is_same<ConstTraits::iterator_category, std::random_access_iterator_tag>::value));
+      assertUnit((std::is_same<ConstTraits::reference, const int &>::value));
+   }
+
+   // jump forward and back by more than one
+   void test_iterator_arithmetic()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      custom::vector<int>::iterator it = v.begin();
+      // exercise
+      custom::vector<int>::iterator it3 = it + 3;
+      custom::vector<int>::iterator it1 = it3 - 2;
+      custom::vector<int>::iterator it2 = 2 + it;
+      it += 4;
+      // verify
+      assertUnit(it3.p == v.data + 3);
+      assertUnit(it1.p == v.data + 1);
+      assertUnit(it2.p == v.data + 2);
+      assertUnit(it == v.end());
+      assertUnit(v.end() - v.begin() == 4);
+      assertUnit(it1 - it3 == -2);
+      it -= 4;
+      assertUnit(it == v.begin());
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // iterators are ordered by position
+   void test_iterator_compare()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      custom::vector<int>::iterator itLow(v.data + 1);
+      custom::vector<int>::iterator itHigh(v.data + 2);
+      // verify
+      assertUnit(itLow < itHigh);
+      assertUnit(itHigh > itLow);
+      assertUnit(itLow <= itLow);
+      assertUnit(itHigh >= itLow);
+      assertUnit(!(itHigh < itLow));
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // read and write through the subscript of an iterator
+   void test_iterator_subscript()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      custom::vector<int>::iterator it(v.data + 1);
+      // exercise
+      it[1] = 99;
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 99 | 89 |
+      //    +----+----+----+----+
+      assertUnit(it[-1] == 26);
+      assertUnit(it[0] == 49);
+      assertUnit(v.data[2] == 99);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // walk a const vector
+   void test_constIterator_read()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      const custom::vector<int> & vConst = v;
+      // exercise
+      int sum = 0;
+      for (custom::vector<int>::const_iterator it = vConst.begin(); it != vConst.end(); ++it)
+         sum += *it;
+      // verify
+      assertUnit(sum == 26 + 49 + 67 + 89);
+      assertUnit(vConst.cend() - vConst.cbegin() == 4);
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // an iterator becomes a const_iterator, and the two compare
+   void test_constIterator_fromIterator()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      // exercise
+      custom::vector<int>::const_iterator it = v.begin();
+      // verify
+      assertUnit(it.p == v.data);
+      assertUnit(it == v.begin());
+      assertUnit(v.begin() == it);
+      assertUnit(it < v.end());
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // walk backwards with the reverse iterators
+   void test_reverseIterator_walk()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      int a[4];
+      int i = 0;
+      // exercise
+      for (custom::vector<int>::reverse_iterator it = v.rbegin(); it != v.rend(); ++it)
+         a[i++] = *it;
+      // verify
+      assertUnit(i == 4);
+      assertUnit(a[0] == 89);
+      assertUnit(a[1] == 67);
+      assertUnit(a[2] == 49);
+      assertUnit(a[3] == 26);
+      assertUnit(*v.crbegin() == 89);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // std::sort needs random access
+   void test_iterator_sort()
+   {  // setup
+      custom::vector<int> v{ 89, 26, 67, 49 };
+      // exercise
+      std::sort(v.begin(), v.end());
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      assertStandardFixture(v);
+   }  // teardown
+
+   // binary search over the vector
+   void test_iterator_lowerBound()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      // exercise
+      custom::vector<int>::iterator it = std::lower_bound(v.begin(), v.end(), 50);
+      // verify
+      assertUnit(it.p == v.data + 2);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   /*************************************************************
+    * PARALLEL SETTINGS
+    * Split every fill and copy numThreads ways for the
+    * life of a test, then put the settings back
+    *************************************************************/
+   struct ParallelSettings
+   {
+      ParallelSettings(unsigned numThreads) : saved(custom::parallelism::settings())
+      {
+         custom::parallelism::settings().threshold = 1;
+         custom::parallelism::settings().threads = numThreads;
+      }
+      ~ParallelSettings() { custom::parallelism::settings() = saved; }
+      custom::parallelism saved;
+   };
+
+   /*************************************************************
+    * FRAGILE
+    * Plain data whose constructor throws once numUntilThrow
+    * of them have been made, counting the ones it built. The
+    * counts are atomic because the threads of a fill share them.
+    *************************************************************/
+   struct Fragile
+   {
+      Fragile() : value(0)
+      {
+         if (--numUntilThrow == 0)
+            throw std::runtime_error("fragile");
+         numBuilt++;
+      }
+      int value;
+      static inline std::atomic<int> numBuilt{ 0 };
+      static inline std::atomic<int> numUntilThrow{ 0 };
+   };
+
+   /*************************************************************
+    * THREAD LOG
+    * A memory_resource that notes whether it was ever asked
+    * for memory by a thread other than the one that made it
+    *************************************************************/
+   struct ThreadLog : std::pmr::memory_resource
+   {
+      void * do_allocate(size_t num, size_t alignment) override
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         numAllocate++;
+         if (std::this_thread::get_id() != owner)
+            otherThread = true;
+         return std::pmr::new_delete_resource()->allocate(num, alignment);
+      }
+      void do_deallocate(void * p, size_t num, size_t alignment) override
+      {
+         std::pmr::new_delete_resource()->deallocate(p, num, alignment);
+      }
+      bool do_is_equal(const std::pmr::memory_resource & rhs) const noexcept override
+      {
+         return this == &rhs;
+      }
+      std::mutex      mutex;
+      std::thread::id owner = std::this_thread::get_id();
+      size_t          numAllocate = 0;
+      bool            otherThread = false;
+   };
+
    /*************************************************************
     * SETUP STANDARD FIXTURE
     *      0    1    2    3
@@ -2017,7 +3305,7 @@ public:
       
       try
       {
-         v.data = new int[4];
+         v.data = std::allocator<int>().allocate(4);
          v.data[0] = 26;
          v.data[1] = 49;
          v.data[2] = 67;